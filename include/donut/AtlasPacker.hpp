@@ -1,8 +1,14 @@
 #ifndef DONUT_ATLAS_PACKER_HPP
 #define DONUT_ATLAS_PACKER_HPP
 
-#include <cstddef> // std::size_t
-#include <vector>  // std::vector
+#include <donut/modules/fwd/utilities.hpp>
+
+#include <algorithm> // std::max, std::min, std::stable_sort
+#include <cstddef>   // std::size_t
+#include <limits>    // std::numeric_limits
+#include <numeric>   // std::iota
+#include <span>      // std::span
+#include <vector>    // std::vector
 
 namespace donut {
 
@@ -13,8 +19,10 @@ namespace donut {
  *         pixels.
  * \tparam Padding empty space to reserve between inserted rectangles, in
  *         pixels.
+ * \tparam Strategy packing algorithm to use, see AtlasPackingStrategy. Defaults
+ *         to AtlasPackingStrategy::SHELF.
  */
-template <std::size_t InitialResolution, std::size_t Padding>
+template <std::size_t InitialResolution, std::size_t Padding, AtlasPackingStrategy Strategy>
 class AtlasPacker {
 public:
 	/**
@@ -34,13 +42,28 @@ public:
 	 */
 	static constexpr std::size_t PADDING = Padding;
 
+	/**
+	 * The packing strategy that was passed to the Strategy template parameter.
+	 */
+	static constexpr AtlasPackingStrategy STRATEGY = Strategy;
+
 	/**
 	 * The minimum ratio between the height of a new rectangle and the size of
 	 * an existing row in the atlas for the new rectangle to be considered large
 	 * enough to deserve a space in that row.
+	 *
+	 * \note Only used by AtlasPackingStrategy::SHELF.
 	 */
 	static constexpr float MINIMUM_ROW_HEIGHT_RATIO = 0.7f;
 
+	/**
+	 * Size of a rectangle to be inserted using insertRectangles().
+	 */
+	struct RectangleSize {
+		std::size_t width;  ///< Width of the rectangle, in pixels.
+		std::size_t height; ///< Height of the rectangle, in pixels.
+	};
+
 	/**
 	 * Result of the insertRectangle() function.
 	 */
@@ -65,6 +88,44 @@ public:
 		bool resized;
 	};
 
+	/**
+	 * Create a packer for an empty atlas at the initial resolution.
+	 */
+	AtlasPacker() = default;
+
+	/**
+	 * Create a packer for an existing atlas whose bottom region is already
+	 * occupied, such as an atlas that was packed offline, so that new
+	 * rectangles are inserted above that region.
+	 *
+	 * \param resolution current width of the square atlas region, in pixels.
+	 *        Must be the initial resolution multiplied by a power of the
+	 *        growth factor, as returned by getResolution().
+	 * \param usedHeight height, in pixels, of the region at the bottom of the
+	 *        atlas that spans its full width and must not receive any new
+	 *        rectangles, including the padding of the rectangles within it.
+	 *        Must not exceed the resolution.
+	 *
+	 * \note The atlas does not grow until a new rectangle doesn't fit in the
+	 *       space above the used region.
+	 */
+	AtlasPacker(std::size_t resolution, std::size_t usedHeight)
+		: resolution(resolution) {
+		if constexpr (STRATEGY == AtlasPackingStrategy::SKYLINE_BOTTOM_LEFT) {
+			skyline.front() = SkylineSegment{.x = 0, .y = usedHeight, .width = resolution};
+		} else if constexpr (STRATEGY == AtlasPackingStrategy::MAX_RECTS_BEST_SHORT_SIDE_FIT) {
+			freeRectangles.clear();
+			if (usedHeight < resolution) {
+				freeRectangles.push_back(FreeRectangle{.x = 0, .y = usedHeight, .width = resolution, .height = resolution - usedHeight});
+			}
+		} else {
+			// A full row covering the used region keeps new rows above it, while still allowing its extension into the atlas after it grows.
+			if (usedHeight > 0) {
+				rows.emplace_back(0, usedHeight).width = resolution;
+			}
+		}
+	}
+
 	/**
 	 * Find and reserve a suitable space for a new axis-aligned rectangle to be
 	 * inserted into the atlas.
@@ -75,11 +136,96 @@ public:
 	 * \return see InsertRectangleResult.
 	 *
 	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \sa insertRectangles()
 	 */
 	[[nodiscard]] InsertRectangleResult insertRectangle(std::size_t width, std::size_t height) {
 		const std::size_t paddedWidth = width + PADDING * std::size_t{2};
 		const std::size_t paddedHeight = height + PADDING * std::size_t{2};
+		if constexpr (STRATEGY == AtlasPackingStrategy::SKYLINE_BOTTOM_LEFT) {
+			return insertRectangleSkyline(paddedWidth, paddedHeight);
+		} else if constexpr (STRATEGY == AtlasPackingStrategy::MAX_RECTS_BEST_SHORT_SIDE_FIT) {
+			return insertRectangleMaxRects(paddedWidth, paddedHeight);
+		} else {
+			return insertRectangleShelf(paddedWidth, paddedHeight);
+		}
+	}
+
+	/**
+	 * Find and reserve suitable spaces for a batch of new axis-aligned
+	 * rectangles to be inserted into the atlas.
+	 *
+	 * The rectangles are inserted in order of decreasing height, which
+	 * generally results in a much tighter packing than inserting them one by
+	 * one in an arbitrary order.
+	 *
+	 * \param sizes sizes of the new rectangles, in pixels.
+	 *
+	 * \return a list of results, where each element corresponds to the
+	 *         rectangle at the same index in the input list. The resized flag
+	 *         of each result reflects whether the atlas needed to grow at the
+	 *         time that particular rectangle was inserted. See
+	 *         InsertRectangleResult.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \sa insertRectangle()
+	 */
+	[[nodiscard]] std::vector<InsertRectangleResult> insertRectangles(std::span<const RectangleSize> sizes) {
+		std::vector<std::size_t> insertionOrder(sizes.size());
+		std::iota(insertionOrder.begin(), insertionOrder.end(), std::size_t{0});
+		std::stable_sort(insertionOrder.begin(), insertionOrder.end(), [&](std::size_t a, std::size_t b) -> bool {
+			if (sizes[a].height != sizes[b].height) {
+				return sizes[a].height > sizes[b].height;
+			}
+			return sizes[a].width > sizes[b].width;
+		});
+
+		std::vector<InsertRectangleResult> results(sizes.size());
+		for (const std::size_t i : insertionOrder) {
+			results[i] = insertRectangle(sizes[i].width, sizes[i].height);
+		}
+		return results;
+	}
+
+	/**
+	 * Get the current required resolution of the atlas.
+	 *
+	 * \return the width of the square atlas region, in pixels.
+	 */
+	[[nodiscard]] std::size_t getResolution() const noexcept {
+		return resolution;
+	}
+
+private:
+	struct Row {
+		Row(std::size_t top, std::size_t height) noexcept
+			: top(top)
+			, height(height) {}
+
+		std::size_t top;
+		std::size_t width = 0;
+		std::size_t height;
+	};
+
+	struct SkylineSegment {
+		std::size_t x;
+		std::size_t y;
+		std::size_t width;
+	};
+
+	struct FreeRectangle {
+		std::size_t x;
+		std::size_t y;
+		std::size_t width;
+		std::size_t height;
+
+		[[nodiscard]] bool contains(const FreeRectangle& other) const noexcept {
+			return other.x >= x && other.y >= y && other.x + other.width <= x + width && other.y + other.height <= y + height;
+		}
+	};
 
+	[[nodiscard]] InsertRectangleResult insertRectangleShelf(std::size_t paddedWidth, std::size_t paddedHeight) {
 		Row* rowPointer = nullptr;
 		for (Row& row : rows) {
 			if (const float heightRatio = static_cast<float>(paddedHeight) / static_cast<float>(row.height);
@@ -108,27 +254,196 @@ public:
 		return InsertRectangleResult{x, y, resized};
 	}
 
-	/**
-	 * Get the current required resolution of the atlas.
-	 *
-	 * \return the width of the square atlas region, in pixels.
-	 */
-	[[nodiscard]] std::size_t getResolution() const noexcept {
-		return resolution;
+	[[nodiscard]] InsertRectangleResult insertRectangleSkyline(std::size_t paddedWidth, std::size_t paddedHeight) {
+		bool resized = false;
+		std::size_t bestIndex = skyline.size();
+		std::size_t bestY = 0;
+		while (true) {
+			std::size_t bestTop = std::numeric_limits<std::size_t>::max();
+			std::size_t bestSegmentWidth = std::numeric_limits<std::size_t>::max();
+			for (std::size_t i = 0; i < skyline.size(); ++i) {
+				const std::size_t x = skyline[i].x;
+				if (paddedWidth > resolution - x) {
+					break;
+				}
+
+				// Find the height at which the rectangle would rest on the skyline segments that it spans.
+				std::size_t y = 0;
+				for (std::size_t j = i, remainingWidth = paddedWidth; remainingWidth > 0; ++j) {
+					y = std::max(y, skyline[j].y);
+					remainingWidth -= std::min(remainingWidth, skyline[j].width);
+				}
+				if (paddedHeight > resolution - y) {
+					continue;
+				}
+
+				const std::size_t top = y + paddedHeight;
+				if (top < bestTop || (top == bestTop && skyline[i].width < bestSegmentWidth)) {
+					bestIndex = i;
+					bestY = y;
+					bestTop = top;
+					bestSegmentWidth = skyline[i].width;
+				}
+			}
+			if (bestIndex != skyline.size()) {
+				break;
+			}
+
+			const std::size_t oldResolution = resolution;
+			resolution *= GROWTH_FACTOR;
+			resized = true;
+			if (skyline.back().y == 0) {
+				skyline.back().width += resolution - oldResolution;
+			} else {
+				skyline.push_back(SkylineSegment{.x = oldResolution, .y = 0, .width = resolution - oldResolution});
+			}
+		}
+
+		const std::size_t x = skyline[bestIndex].x;
+		const std::size_t right = x + paddedWidth;
+
+		// Replace the covered part of the skyline with a new segment on top of the rectangle.
+		skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(bestIndex), SkylineSegment{.x = x, .y = bestY + paddedHeight, .width = paddedWidth});
+		std::size_t end = bestIndex + 1;
+		while (end < skyline.size() && skyline[end].x + skyline[end].width <= right) {
+			++end;
+		}
+		if (end < skyline.size() && skyline[end].x < right) {
+			skyline[end].width -= right - skyline[end].x;
+			skyline[end].x = right;
+		}
+		skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(bestIndex + 1), skyline.begin() + static_cast<std::ptrdiff_t>(end));
+
+		// Merge neighboring segments at the same height.
+		if (bestIndex + 1 < skyline.size() && skyline[bestIndex + 1].y == skyline[bestIndex].y) {
+			skyline[bestIndex].width += skyline[bestIndex + 1].width;
+			skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(bestIndex + 1));
+		}
+		if (bestIndex > 0 && skyline[bestIndex - 1].y == skyline[bestIndex].y) {
+			skyline[bestIndex - 1].width += skyline[bestIndex].width;
+			skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(bestIndex));
+		}
+
+		return InsertRectangleResult{x + PADDING, bestY + PADDING, resized};
 	}
 
-private:
-	struct Row {
-		Row(std::size_t top, std::size_t height) noexcept
-			: top(top)
-			, height(height) {}
+	[[nodiscard]] InsertRectangleResult insertRectangleMaxRects(std::size_t paddedWidth, std::size_t paddedHeight) {
+		bool resized = false;
+		std::size_t bestIndex = freeRectangles.size();
+		while (true) {
+			std::size_t bestShortSideFit = std::numeric_limits<std::size_t>::max();
+			std::size_t bestLongSideFit = std::numeric_limits<std::size_t>::max();
+			for (std::size_t i = 0; i < freeRectangles.size(); ++i) {
+				const FreeRectangle& freeRectangle = freeRectangles[i];
+				if (paddedWidth <= freeRectangle.width && paddedHeight <= freeRectangle.height) {
+					const std::size_t leftoverHorizontal = freeRectangle.width - paddedWidth;
+					const std::size_t leftoverVertical = freeRectangle.height - paddedHeight;
+					const std::size_t shortSideFit = std::min(leftoverHorizontal, leftoverVertical);
+					const std::size_t longSideFit = std::max(leftoverHorizontal, leftoverVertical);
+					if (shortSideFit < bestShortSideFit || (shortSideFit == bestShortSideFit && longSideFit < bestLongSideFit)) {
+						bestIndex = i;
+						bestShortSideFit = shortSideFit;
+						bestLongSideFit = longSideFit;
+					}
+				}
+			}
+			if (bestIndex != freeRectangles.size()) {
+				break;
+			}
 
-		std::size_t top;
-		std::size_t width = 0;
-		std::size_t height;
-	};
+			// Extend the free rectangles that touch the old border into the new space, and cover the rest with two new strips.
+			const std::size_t oldResolution = resolution;
+			resolution *= GROWTH_FACTOR;
+			resized = true;
+			for (FreeRectangle& freeRectangle : freeRectangles) {
+				if (freeRectangle.x + freeRectangle.width == oldResolution) {
+					freeRectangle.width = resolution - freeRectangle.x;
+				}
+				if (freeRectangle.y + freeRectangle.height == oldResolution) {
+					freeRectangle.height = resolution - freeRectangle.y;
+				}
+			}
+			freeRectangles.push_back(FreeRectangle{.x = oldResolution, .y = 0, .width = resolution - oldResolution, .height = resolution});
+			freeRectangles.push_back(FreeRectangle{.x = 0, .y = oldResolution, .width = resolution, .height = resolution - oldResolution});
+			pruneFreeRectangles();
+			bestIndex = freeRectangles.size();
+		}
+
+		const FreeRectangle placed{.x = freeRectangles[bestIndex].x, .y = freeRectangles[bestIndex].y, .width = paddedWidth, .height = paddedHeight};
+
+		// Split every free rectangle that intersects the placed rectangle into the maximal free rectangles around it.
+		splitFreeRectangles.clear();
+		std::erase_if(freeRectangles, [&](const FreeRectangle& freeRectangle) -> bool {
+			if (placed.x >= freeRectangle.x + freeRectangle.width || placed.x + placed.width <= freeRectangle.x || placed.y >= freeRectangle.y + freeRectangle.height ||
+				placed.y + placed.height <= freeRectangle.y) {
+				return false;
+			}
+			if (placed.x > freeRectangle.x) {
+				splitFreeRectangles.push_back(FreeRectangle{.x = freeRectangle.x, .y = freeRectangle.y, .width = placed.x - freeRectangle.x, .height = freeRectangle.height});
+			}
+			if (placed.x + placed.width < freeRectangle.x + freeRectangle.width) {
+				splitFreeRectangles.push_back(FreeRectangle{
+					.x = placed.x + placed.width,
+					.y = freeRectangle.y,
+					.width = freeRectangle.x + freeRectangle.width - (placed.x + placed.width),
+					.height = freeRectangle.height,
+				});
+			}
+			if (placed.y > freeRectangle.y) {
+				splitFreeRectangles.push_back(FreeRectangle{.x = freeRectangle.x, .y = freeRectangle.y, .width = freeRectangle.width, .height = placed.y - freeRectangle.y});
+			}
+			if (placed.y + placed.height < freeRectangle.y + freeRectangle.height) {
+				splitFreeRectangles.push_back(FreeRectangle{
+					.x = freeRectangle.x,
+					.y = placed.y + placed.height,
+					.width = freeRectangle.width,
+					.height = freeRectangle.y + freeRectangle.height - (placed.y + placed.height),
+				});
+			}
+			return true;
+		});
+		for (const FreeRectangle& splitFreeRectangle : splitFreeRectangles) {
+			addFreeRectangle(splitFreeRectangle);
+		}
+		return InsertRectangleResult{placed.x + PADDING, placed.y + PADDING, resized};
+	}
+
+	void addFreeRectangle(const FreeRectangle& newFreeRectangle) {
+		for (const FreeRectangle& freeRectangle : freeRectangles) {
+			if (freeRectangle.contains(newFreeRectangle)) {
+				return;
+			}
+		}
+		std::erase_if(freeRectangles, [&](const FreeRectangle& freeRectangle) -> bool { return newFreeRectangle.contains(freeRectangle); });
+		freeRectangles.push_back(newFreeRectangle);
+	}
+
+	void pruneFreeRectangles() noexcept {
+		for (std::size_t i = 0; i < freeRectangles.size(); ++i) {
+			for (std::size_t j = i + 1; j < freeRectangles.size();) {
+				if (freeRectangles[i].contains(freeRectangles[j])) {
+					freeRectangles[j] = freeRectangles.back();
+					freeRectangles.pop_back();
+				} else if (freeRectangles[j].contains(freeRectangles[i])) {
+					freeRectangles[i] = freeRectangles[j];
+					freeRectangles[j] = freeRectangles.back();
+					freeRectangles.pop_back();
+					j = i + 1;
+				} else {
+					++j;
+				}
+			}
+		}
+	}
 
 	std::vector<Row> rows{};
+	std::vector<SkylineSegment> skyline = (STRATEGY == AtlasPackingStrategy::SKYLINE_BOTTOM_LEFT)
+		? std::vector<SkylineSegment>{SkylineSegment{.x = 0, .y = 0, .width = INITIAL_RESOLUTION}}
+		: std::vector<SkylineSegment>{};
+	std::vector<FreeRectangle> freeRectangles = (STRATEGY == AtlasPackingStrategy::MAX_RECTS_BEST_SHORT_SIDE_FIT)
+		? std::vector<FreeRectangle>{FreeRectangle{.x = 0, .y = 0, .width = INITIAL_RESOLUTION, .height = INITIAL_RESOLUTION}}
+		: std::vector<FreeRectangle>{};
+	std::vector<FreeRectangle> splitFreeRectangles{};
 	std::size_t resolution = INITIAL_RESOLUTION;
 };
 
@@ -21,6 +21,8 @@ namespace reflection = donut::reflection; // NOLINT(misc-unused-alias-decls)
 namespace unicode = donut::unicode;       // NOLINT(misc-unused-alias-decls)
 namespace xml = donut::xml;               // NOLINT(misc-unused-alias-decls)
 
+using donut::AtlasPackingStrategy; // NOLINT(misc-unused-using-decls)
+
 using donut::AtlasPacker; // NOLINT(misc-unused-using-decls)
 
 using donut::Color; // NOLINT(misc-unused-using-decls)
@@ -0,0 +1,167 @@
+#ifndef DONUT_GRAPHICS_ANIMATION_HPP
+#define DONUT_GRAPHICS_ANIMATION_HPP
+
+#include <donut/math.hpp>
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <span>    // std::span
+#include <vector>  // std::vector
+
+namespace donut::graphics {
+
+/**
+ * Local transformation of a single joint of a Skeleton, relative to its
+ * parent joint.
+ */
+struct JointTransform {
+	vec3 translation{0.0f, 0.0f, 0.0f};    ///< Translation relative to the parent joint.
+	quat rotation{1.0f, 0.0f, 0.0f, 0.0f}; ///< Unit quaternion rotation relative to the parent joint.
+	vec3 scale{1.0f, 1.0f, 1.0f};          ///< Scale along each local axis.
+};
+
+/**
+ * Hierarchy of joints that the vertices of a skinned mesh are bound to.
+ *
+ * Each joint has an index, which is the value that is stored in
+ * Model::Object::SkinnedVertex::joints to refer to it. Since those indices
+ * are stored as 8-bit integers, a skeleton can have at most 256 joints.
+ */
+struct Skeleton {
+	/** Value of a parent index that means that the joint is a root joint. */
+	static constexpr std::uint32_t NO_PARENT = 0xFFFFFFFF;
+
+	/**
+	 * Index of the parent of each joint, or NO_PARENT for root joints.
+	 *
+	 * \warning Every parent must have a lower index than its children, so
+	 *          that the joints can be transformed in a single pass.
+	 */
+	std::vector<std::uint32_t> parents{};
+
+	/**
+	 * Matrix of each joint that transforms vertices from the space of the
+	 * mesh to the local space of the joint in its bind pose.
+	 */
+	std::vector<mat4> inverseBindMatrices{};
+
+	/**
+	 * Local transformation of each joint in the pose that the mesh was
+	 * modeled in, which is used for joints that are not animated.
+	 */
+	std::vector<JointTransform> bindPose{};
+};
+
+/**
+ * Sequence of keyframes that animates a single component of the
+ * transformation of a joint, stored as separate arrays of times and values.
+ *
+ * \tparam T type of the animated value.
+ */
+template <typename T>
+struct AnimationTrack {
+	std::vector<float> times{}; ///< Time of each keyframe, in seconds, in strictly increasing order.
+	std::vector<T> values{};    ///< Value of each keyframe, with the same length as times.
+};
+
+/**
+ * Keyframe animation of the joints of a Skeleton.
+ *
+ * Each list of tracks is indexed by joint. Lists may be shorter than the
+ * number of joints, and tracks may be empty, in which case the corresponding
+ * component of the pose is not affected by the clip.
+ *
+ * A single clip is meant to be shared by many animated instances, which each
+ * sample it at their own time using their own AnimationCursor.
+ */
+struct AnimationClip {
+	std::vector<AnimationTrack<vec3>> translationTracks{}; ///< Translation of each joint, linearly interpolated.
+	std::vector<AnimationTrack<quat>> rotationTracks{};    ///< Rotation of each joint, interpolated along the shortest path.
+	std::vector<AnimationTrack<vec3>> scaleTracks{};       ///< Scale of each joint, linearly interpolated.
+	float duration = 0.0f;                                 ///< Length of the clip, in seconds.
+};
+
+/**
+ * Cached keyframe positions of a single animated instance within the tracks
+ * of an AnimationClip.
+ *
+ * Sampling a clip at increasing times, which is the common case for playback,
+ * only has to step forward from the cached keyframe of each track, which
+ * makes sampling take amortized constant time per track instead of requiring
+ * a binary search over all keyframes.
+ *
+ * The cursor is automatically reset when it is used with a clip that has a
+ * different number of tracks, but it should be reset explicitly when it is
+ * switched to a different clip with the same number of tracks.
+ */
+struct AnimationCursor {
+	/**
+	 * Index of the keyframe at or before the previously sampled time in each
+	 * track, where the translation tracks come first, followed by the
+	 * rotation tracks and then the scale tracks.
+	 */
+	std::vector<std::uint32_t> keyframes{};
+
+	/**
+	 * Forget all cached keyframe positions.
+	 */
+	void reset() noexcept {
+		keyframes.clear();
+	}
+};
+
+/**
+ * Sample the tracks of an animation clip at a specific point in time.
+ *
+ * Times before the first keyframe or after the last keyframe of a track are
+ * clamped to the value of that keyframe, so looping playback should wrap the
+ * time to the duration of the clip before calling this function.
+ *
+ * \param clip animation clip to sample.
+ * \param time time point to sample the clip at, in seconds.
+ * \param cursor cached keyframe positions of the animated instance, which are
+ *        used as a starting point for finding the keyframes to interpolate
+ *        between, and are updated to the new keyframes.
+ * \param pose local transformation of each joint, which receives the sampled
+ *        values. Components that are not animated by the clip are left
+ *        unchanged, so the pose should typically be initialized to the
+ *        Skeleton::bindPose before the first call. Tracks of joints beyond
+ *        the end of the pose are ignored.
+ *
+ * \throws std::bad_alloc on allocation failure.
+ */
+void sampleAnimation(const AnimationClip& clip, float time, AnimationCursor& cursor, std::span<JointTransform> pose);
+
+/**
+ * Interpolate between two poses, such as for cross-fading from one animation
+ * clip to another.
+ *
+ * \param from pose to interpolate from.
+ * \param to pose to interpolate to, with the same size as from.
+ * \param factor interpolation factor in the range [0, 1], where 0 results in
+ *        the from pose and 1 results in the to pose.
+ * \param output span to write the interpolated pose to, with the same size
+ *        as from. May be the same span as from or to.
+ */
+void blendPoses(std::span<const JointTransform> from, std::span<const JointTransform> to, float factor, std::span<JointTransform> output) noexcept;
+
+/**
+ * Compute the skinning matrices of the joints of a skeleton in a given pose,
+ * which transform vertices from the space of the mesh in its bind pose to
+ * their animated position.
+ *
+ * \param skeleton skeleton that the pose belongs to.
+ * \param pose local transformation of each joint.
+ * \param jointMatrices span to write the skinning matrix of each joint to.
+ *
+ * \warning The pose and jointMatrices must have the same size as the
+ *          Skeleton::parents, Skeleton::inverseBindMatrices and
+ *          Skeleton::bindPose of the skeleton.
+ *
+ * \sa ModelInstance::jointMatrices
+ */
+void computeJointMatrices(const Skeleton& skeleton, std::span<const JointTransform> pose, std::span<mat4> jointMatrices) noexcept;
+
+} // namespace donut::graphics
+
+#endif
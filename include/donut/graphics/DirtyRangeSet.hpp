@@ -0,0 +1,85 @@
+#ifndef DONUT_GRAPHICS_DIRTY_RANGE_SET_HPP
+#define DONUT_GRAPHICS_DIRTY_RANGE_SET_HPP
+
+#include <cstddef> // std::size_t
+#include <span>    // std::span
+#include <vector>  // std::vector
+
+namespace donut::graphics {
+
+/**
+ * Contiguous range of elements in a buffer that has been modified.
+ */
+struct DirtyRange {
+	std::size_t offset; ///< Index of the first modified element.
+	std::size_t size;   ///< Number of elements in the range.
+};
+
+/**
+ * Set of modified ranges in a buffer, which coalesces overlapping and nearby
+ * modifications into as few ranges as possible, so that they can be uploaded
+ * to the GPU using the minimum number of transfers.
+ */
+class DirtyRangeSet {
+public:
+	/**
+	 * Construct an empty set.
+	 *
+	 * \param mergeDistance maximum number of unmodified elements between two
+	 *        ranges for them to be merged into one. Uploading a few redundant
+	 *        elements is usually cheaper than the overhead of an additional
+	 *        transfer.
+	 */
+	explicit DirtyRangeSet(std::size_t mergeDistance = 0) noexcept
+		: mergeDistance(mergeDistance) {}
+
+	/**
+	 * Mark a range of elements as modified.
+	 *
+	 * \param offset index of the first modified element.
+	 * \param size number of modified elements. If 0, the set is left
+	 *        unchanged.
+	 */
+	void insert(std::size_t offset, std::size_t size);
+
+	/**
+	 * Remove all ranges from the set.
+	 */
+	void clear() noexcept {
+		ranges.clear();
+	}
+
+	/**
+	 * Check if the set has no modified ranges.
+	 *
+	 * \return true if the set is empty, false otherwise.
+	 */
+	[[nodiscard]] bool empty() const noexcept {
+		return ranges.empty();
+	}
+
+	/**
+	 * Get the modified ranges.
+	 *
+	 * \return a non-owning read-only view over the disjoint ranges in the set,
+	 *         sorted by offset.
+	 */
+	[[nodiscard]] std::span<const DirtyRange> getRanges() const noexcept {
+		return ranges;
+	}
+
+	/**
+	 * Get the total number of elements covered by the ranges in the set.
+	 *
+	 * \return the sum of the sizes of all ranges.
+	 */
+	[[nodiscard]] std::size_t getTotalSize() const noexcept;
+
+private:
+	std::vector<DirtyRange> ranges{};
+	std::size_t mergeDistance;
+};
+
+} // namespace donut::graphics
+
+#endif
@@ -0,0 +1,388 @@
+#ifndef DONUT_GRAPHICS_DYNAMIC_MESH_HPP
+#define DONUT_GRAPHICS_DYNAMIC_MESH_HPP
+
+#include <donut/graphics/DirtyRangeSet.hpp>
+#include <donut/graphics/Fence.hpp>
+#include <donut/graphics/Handle.hpp>
+#include <donut/graphics/Mesh.hpp>
+
+#include <algorithm>   // std::copy
+#include <cstddef>     // std::size_t
+#include <span>        // std::span
+#include <stdexcept>   // std::invalid_argument, std::out_of_range
+#include <type_traits> // std::conditional_t
+#include <vector>      // std::vector
+
+namespace donut::graphics {
+
+/**
+ * Configuration options for a DynamicMesh.
+ */
+struct DynamicMeshOptions {
+	/**
+	 * Number of copies of the GPU buffers to cycle between.
+	 *
+	 * With 2 or more copies, new modifications are uploaded to a copy that
+	 * the GPU is not currently reading from, so the upload does not have to
+	 * wait for the rendering commands of the previous frames to finish. Use 2
+	 * for double buffering and 3 for triple buffering. A value of 1 means that
+	 * every commit waits for the GPU to finish drawing the mesh.
+	 *
+	 * \warning Must be at least 1.
+	 */
+	std::size_t bufferCount = 3;
+
+	/**
+	 * Maximum number of unmodified elements between two modified ranges of a
+	 * buffer for the ranges to be coalesced into a single upload.
+	 *
+	 * \sa DirtyRangeSet
+	 */
+	std::size_t mergeDistance = 16;
+
+	/**
+	 * Intended access pattern of the GPU buffers, see MeshBufferUsage.
+	 */
+	MeshBufferUsage usage = MeshBufferUsage::DYNAMIC_DRAW;
+};
+
+/**
+ * Mesh whose contents are modified frequently, such as procedurally deformed
+ * geometry, which keeps a CPU-side copy of its vertices and indices and
+ * uploads only the modified ranges to the GPU.
+ *
+ * Modifications are not visible to the GPU until the next call to commit(),
+ * which coalesces all modifications made since the copy of the GPU buffers
+ * that is about to be used was last updated into the minimum number of
+ * uploads. The GPU buffers are multi-buffered according to
+ * DynamicMeshOptions::bufferCount, and each copy is protected by a Fence so
+ * that an upload never overwrites data that the GPU is still reading from.
+ *
+ * \tparam Vertex type of vertices stored in the vertex buffer. Must meet the
+ *         requirements of the donut::graphics::mesh_vertex concept.
+ * \tparam Index type of indices stored in the index buffer, or NoIndex for no
+ *         index buffer. Must meet the requirements of the
+ *         donut::graphics::mesh_index concept.
+ */
+template <typename Vertex, typename Index = NoIndex>
+class DynamicMesh {
+public:
+	/** Tells if the mesh has an index buffer or not. */
+	static constexpr bool IS_INDEXED = Mesh<Vertex, Index>::IS_INDEXED;
+
+	/**
+	 * Constructor for meshes that only have a vertex buffer.
+	 *
+	 * \param vertices initial vertices of the mesh.
+	 * \param options configuration options, see DynamicMeshOptions.
+	 *
+	 * \throws graphics::Error on failure to create the GPU buffers.
+	 * \throws std::invalid_argument if the buffer count is 0.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	explicit DynamicMesh(std::span<const Vertex> vertices, const DynamicMeshOptions& options = {}) requires(!IS_INDEXED)
+		: vertices(vertices.begin(), vertices.end())
+		, usage(options.usage) {
+		createBuffers(options);
+	}
+
+	/**
+	 * Constructor for meshes that have a vertex buffer and an index buffer.
+	 *
+	 * \param vertices initial vertices of the mesh.
+	 * \param indices initial indices of the mesh.
+	 * \param options configuration options, see DynamicMeshOptions.
+	 *
+	 * \throws graphics::Error on failure to create the GPU buffers.
+	 * \throws std::invalid_argument if the buffer count is 0.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	DynamicMesh(std::span<const Vertex> vertices, std::span<const Index> indices, const DynamicMeshOptions& options = {}) requires(IS_INDEXED)
+		: vertices(vertices.begin(), vertices.end())
+		, indices(indices.begin(), indices.end())
+		, usage(options.usage) {
+		createBuffers(options);
+	}
+
+	/**
+	 * Replace all vertices of the mesh, which may change the vertex count.
+	 *
+	 * \param newVertices new vertices of the mesh.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note Every copy of the GPU buffers is reallocated the next time it is
+	 *       committed, so this is more expensive than updateVertices() and
+	 *       should only be used when the size of the mesh changes.
+	 */
+	void setVertices(std::span<const Vertex> newVertices) requires(!IS_INDEXED) {
+		vertices.assign(newVertices.begin(), newVertices.end());
+		markForReallocation();
+	}
+
+	/**
+	 * Replace all vertices and indices of the mesh, which may change the
+	 * vertex and index counts.
+	 *
+	 * \param newVertices new vertices of the mesh.
+	 * \param newIndices new indices of the mesh.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note Every copy of the GPU buffers is reallocated the next time it is
+	 *       committed, so this is more expensive than updateVertices() and
+	 *       updateIndices() and should only be used when the size of the mesh
+	 *       changes.
+	 */
+	void setVertices(std::span<const Vertex> newVertices, std::span<const Index> newIndices) requires(IS_INDEXED) {
+		vertices.assign(newVertices.begin(), newVertices.end());
+		indices.assign(newIndices.begin(), newIndices.end());
+		markForReallocation();
+	}
+
+	/**
+	 * Overwrite a range of vertices.
+	 *
+	 * \param offset index of the first vertex to overwrite.
+	 * \param newVertices new vertex data, starting at the given offset.
+	 *
+	 * \throws std::out_of_range if the range does not fit within the current
+	 *         vertex count.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	void updateVertices(std::size_t offset, std::span<const Vertex> newVertices) {
+		const std::span<Vertex> destination = modifyVertices(offset, newVertices.size());
+		std::copy(newVertices.begin(), newVertices.end(), destination.begin());
+	}
+
+	/**
+	 * Get mutable access to a range of vertices in order to modify them in
+	 * place, and mark the range as modified.
+	 *
+	 * \param offset index of the first vertex to modify.
+	 * \param count number of vertices to modify.
+	 *
+	 * \return a non-owning view over the vertices in the range, which is
+	 *         valid until the next call to setVertices() or the destruction of
+	 *         the mesh. Vertices outside of the range must not be modified
+	 *         through this view.
+	 *
+	 * \throws std::out_of_range if the range does not fit within the current
+	 *         vertex count.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] std::span<Vertex> modifyVertices(std::size_t offset, std::size_t count) {
+		if (offset > vertices.size() || count > vertices.size() - offset) {
+			throw std::out_of_range{"Dynamic mesh vertex range is out of bounds."};
+		}
+		for (BufferedMesh& buffer : buffers) {
+			buffer.dirtyVertices.insert(offset, count);
+		}
+		return std::span{vertices}.subspan(offset, count);
+	}
+
+	/**
+	 * Overwrite a range of indices.
+	 *
+	 * \param offset index of the first index to overwrite.
+	 * \param newIndices new index data, starting at the given offset.
+	 *
+	 * \throws std::out_of_range if the range does not fit within the current
+	 *         index count.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	void updateIndices(std::size_t offset, std::span<const Index> newIndices) requires(IS_INDEXED) {
+		const std::span<Index> destination = modifyIndices(offset, newIndices.size());
+		std::copy(newIndices.begin(), newIndices.end(), destination.begin());
+	}
+
+	/**
+	 * Get mutable access to a range of indices in order to modify them in
+	 * place, and mark the range as modified.
+	 *
+	 * \param offset index of the first index to modify.
+	 * \param count number of indices to modify.
+	 *
+	 * \return a non-owning view over the indices in the range, which is valid
+	 *         until the next call to setVertices() or the destruction of the
+	 *         mesh. Indices outside of the range must not be modified through
+	 *         this view.
+	 *
+	 * \throws std::out_of_range if the range does not fit within the current
+	 *         index count.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] std::span<Index> modifyIndices(std::size_t offset, std::size_t count) requires(IS_INDEXED) {
+		if (offset > indices.size() || count > indices.size() - offset) {
+			throw std::out_of_range{"Dynamic mesh index range is out of bounds."};
+		}
+		for (BufferedMesh& buffer : buffers) {
+			buffer.dirtyIndices.insert(offset, count);
+		}
+		return std::span{indices}.subspan(offset, count);
+	}
+
+	/**
+	 * Make all modifications since the previous commit visible to subsequent
+	 * rendering commands.
+	 *
+	 * This switches to the next copy of the GPU buffers, waits until the GPU
+	 * has finished the rendering commands that read from that copy, which
+	 * have usually completed already when using 2 or more copies, and uploads
+	 * the ranges that were modified since the copy was last used.
+	 *
+	 * \throws graphics::Error on failure to synchronize with the GPU.
+	 *
+	 * \note This function should be called at most once per frame, after all
+	 *       modifications for that frame and before the mesh is drawn, since
+	 *       the synchronization point of a copy is placed at the time when the
+	 *       next copy becomes current.
+	 */
+	void commit() {
+		buffers[currentBufferIndex].fence.signal();
+		currentBufferIndex = (currentBufferIndex + 1) % buffers.size();
+		BufferedMesh& buffer = buffers[currentBufferIndex];
+		if (buffer.reallocate) {
+			buffer.fence.wait();
+			if constexpr (IS_INDEXED) {
+				buffer.mesh.setVertices(usage, usage, vertices, indices);
+			} else {
+				buffer.mesh.setVertices(usage, vertices);
+			}
+			buffer.reallocate = false;
+		} else {
+			if (buffer.dirtyVertices.empty() && isIndexDataClean(buffer)) {
+				return;
+			}
+			buffer.fence.wait();
+			for (const DirtyRange& range : buffer.dirtyVertices.getRanges()) {
+				buffer.mesh.updateVertices(range.offset, std::span{vertices}.subspan(range.offset, range.size));
+			}
+			if constexpr (IS_INDEXED) {
+				for (const DirtyRange& range : buffer.dirtyIndices.getRanges()) {
+					buffer.mesh.updateIndices(range.offset, std::span{indices}.subspan(range.offset, range.size));
+				}
+			}
+		}
+		buffer.dirtyVertices.clear();
+		if constexpr (IS_INDEXED) {
+			buffer.dirtyIndices.clear();
+		}
+	}
+
+	/**
+	 * Get the CPU-side copy of the vertices.
+	 *
+	 * \return a non-owning read-only view over the vertices, which is valid
+	 *         until the next call to setVertices() or the destruction of the
+	 *         mesh.
+	 */
+	[[nodiscard]] std::span<const Vertex> getVertices() const noexcept {
+		return vertices;
+	}
+
+	/**
+	 * Get the CPU-side copy of the indices.
+	 *
+	 * \return a non-owning read-only view over the indices, which is valid
+	 *         until the next call to setVertices() or the destruction of the
+	 *         mesh.
+	 */
+	[[nodiscard]] std::span<const Index> getIndices() const noexcept requires(IS_INDEXED) {
+		return indices;
+	}
+
+	/**
+	 * Get the number of copies of the GPU buffers that are cycled between.
+	 *
+	 * \return the buffer count.
+	 */
+	[[nodiscard]] std::size_t getBufferCount() const noexcept {
+		return buffers.size();
+	}
+
+	/**
+	 * Get the copy of the GPU buffers that should be used for drawing until
+	 * the next commit.
+	 *
+	 * \return a read-only reference to the current mesh.
+	 */
+	[[nodiscard]] const Mesh<Vertex, Index>& getMesh() const noexcept {
+		return buffers[currentBufferIndex].mesh;
+	}
+
+	/**
+	 * Get an opaque handle to the GPU representation of the vertex array of
+	 * the copy of the GPU buffers that should be used for drawing until the
+	 * next commit.
+	 *
+	 * \return a non-owning resource handle to the GPU representation of the
+	 *         vertex array.
+	 *
+	 * \note This function is used internally by the implementations of various
+	 *       abstractions and is not intended to be used outside of the graphics
+	 *       module. The returned handle has no meaning to application code.
+	 */
+	[[nodiscard]] Handle get() const noexcept {
+		return getMesh().get();
+	}
+
+private:
+	struct BufferedMesh {
+		Mesh<Vertex, Index> mesh;
+		Fence fence{};
+		DirtyRangeSet dirtyVertices;
+		[[no_unique_address]] std::conditional_t<IS_INDEXED, DirtyRangeSet, NoIndex> dirtyIndices;
+		bool reallocate = false;
+	};
+
+	[[nodiscard]] static bool isIndexDataClean(const BufferedMesh& buffer) noexcept {
+		if constexpr (IS_INDEXED) {
+			return buffer.dirtyIndices.empty();
+		} else {
+			return true;
+		}
+	}
+
+	void createBuffers(const DynamicMeshOptions& options) {
+		if (options.bufferCount == 0) {
+			throw std::invalid_argument{"Dynamic mesh buffer count must be at least 1."};
+		}
+		buffers.reserve(options.bufferCount);
+		for (std::size_t i = 0; i < options.bufferCount; ++i) {
+			if constexpr (IS_INDEXED) {
+				buffers.push_back(BufferedMesh{
+					.mesh{usage, usage, vertices, indices},
+					.dirtyVertices = DirtyRangeSet{options.mergeDistance},
+					.dirtyIndices = DirtyRangeSet{options.mergeDistance},
+				});
+			} else {
+				buffers.push_back(BufferedMesh{
+					.mesh{usage, vertices},
+					.dirtyVertices = DirtyRangeSet{options.mergeDistance},
+					.dirtyIndices = {},
+				});
+			}
+		}
+	}
+
+	void markForReallocation() noexcept {
+		for (BufferedMesh& buffer : buffers) {
+			buffer.dirtyVertices.clear();
+			if constexpr (IS_INDEXED) {
+				buffer.dirtyIndices.clear();
+			}
+			buffer.reallocate = true;
+		}
+	}
+
+	std::vector<Vertex> vertices;
+	[[no_unique_address]] std::conditional_t<IS_INDEXED, std::vector<Index>, NoIndex> indices{};
+	std::vector<BufferedMesh> buffers{};
+	std::size_t currentBufferIndex = 0;
+	MeshBufferUsage usage;
+};
+
+} // namespace donut::graphics
+
+#endif
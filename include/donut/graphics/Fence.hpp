@@ -0,0 +1,63 @@
+#ifndef DONUT_GRAPHICS_FENCE_HPP
+#define DONUT_GRAPHICS_FENCE_HPP
+
+#include <donut/UniqueHandle.hpp>
+
+namespace donut::graphics {
+
+/**
+ * Unique resource handle with exclusive ownership of a GPU synchronization
+ * object, which can be used to find out when the GPU has finished executing
+ * the rendering commands that were submitted before it.
+ */
+class Fence {
+public:
+	/**
+	 * Construct a fence without any pending GPU commands to wait for.
+	 */
+	Fence() noexcept = default;
+
+	/**
+	 * Insert a new synchronization point into the GPU command stream, which
+	 * replaces the old one, if any, and becomes signaled once all rendering
+	 * commands that were submitted before the call have finished executing.
+	 *
+	 * \throws graphics::Error on failure to create the synchronization object.
+	 */
+	void signal();
+
+	/**
+	 * Check if all rendering commands that were submitted before the latest
+	 * call to signal() have finished executing, without blocking.
+	 *
+	 * \return true if the GPU has passed the synchronization point, or if
+	 *         there is no synchronization point, false otherwise.
+	 */
+	[[nodiscard]] bool isComplete() const noexcept;
+
+	/**
+	 * Block until all rendering commands that were submitted before the latest
+	 * call to signal() have finished executing, and then remove the
+	 * synchronization point.
+	 *
+	 * \throws graphics::Error on failure to wait for the synchronization
+	 *         object.
+	 *
+	 * \note On platforms that don't support blocking on the GPU, such as
+	 *       WebGL, this function returns immediately, since the
+	 *       implementation is then responsible for keeping buffer updates from
+	 *       affecting in-flight rendering commands on its own.
+	 */
+	void wait();
+
+private:
+	struct FenceDeleter {
+		void operator()(void* handle) const noexcept;
+	};
+
+	UniqueHandle<void*, FenceDeleter> fence{};
+};
+
+} // namespace donut::graphics
+
+#endif
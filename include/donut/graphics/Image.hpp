@@ -5,9 +5,10 @@
 #include <donut/UniqueHandle.hpp>
 
 #include <cassert>  // assert
-#include <cstddef>  // std::size_t
+#include <cstddef>  // std::size_t, std::byte
 #include <cstdint>  // std::uint32_t
 #include <optional> // std::optional
+#include <vector>   // std::vector
 
 namespace donut::graphics {
 
@@ -31,6 +32,39 @@ enum class PixelComponentType : std::uint32_t {
 	F32 = 0x1406, ///< Each pixel component is a 32-bit floating-point number. \hideinitializer
 };
 
+/**
+ * Get the number of channels of a pixel format.
+ *
+ * \param pixelFormat the pixel format.
+ *
+ * \return the number of components per pixel.
+ */
+[[nodiscard]] constexpr std::size_t getChannelCount(PixelFormat pixelFormat) noexcept {
+	switch (pixelFormat) {
+		case PixelFormat::R: return 1;
+		case PixelFormat::RG: return 2;
+		case PixelFormat::RGB: return 3;
+		case PixelFormat::RGBA: return 4;
+	}
+	return 0;
+}
+
+/**
+ * Get the size in bytes of a pixel component type.
+ *
+ * \param pixelComponentType the pixel component type.
+ *
+ * \return the size of a single pixel component.
+ */
+[[nodiscard]] constexpr std::size_t getPixelComponentSize(PixelComponentType pixelComponentType) noexcept {
+	switch (pixelComponentType) {
+		case PixelComponentType::U8: return 1;
+		case PixelComponentType::F16: return 2;
+		case PixelComponentType::F32: return 4;
+	}
+	return 0;
+}
+
 /**
  * Read-only non-owning view over a 2D image.
  *
@@ -168,15 +202,7 @@ public:
 	 * \sa getPixelStride()
 	 */
 	[[nodiscard]] constexpr std::size_t getChannelCount() const noexcept {
-		if (pixels) {
-			switch (pixelFormat) {
-				case PixelFormat::R: return 1;
-				case PixelFormat::RG: return 2;
-				case PixelFormat::RGB: return 3;
-				case PixelFormat::RGBA: return 4;
-			}
-		}
-		return 0;
+		return (pixels) ? graphics::getChannelCount(pixelFormat) : 0;
 	}
 
 	/**
@@ -190,14 +216,7 @@ public:
 	 * \sa getPixelStride()
 	 */
 	[[nodiscard]] constexpr std::size_t getPixelComponentSize() const noexcept {
-		if (pixels) {
-			switch (pixelComponentType) {
-				case PixelComponentType::U8: return 1;
-				case PixelComponentType::F16: return 2;
-				case PixelComponentType::F32: return 4;
-			}
-		}
-		return 0;
+		return (pixels) ? graphics::getPixelComponentSize(pixelComponentType) : 0;
 	}
 
 	/**
@@ -487,6 +506,21 @@ public:
 	 */
 	Image(std::size_t width, std::size_t height, PixelFormat pixelFormat, PixelComponentType pixelComponentType, const void* pixels);
 
+	/**
+	 * Construct an image with uninitialized pixel data of a given size.
+	 *
+	 * \param width width of the image, in pixels.
+	 * \param height height of the image, in pixels.
+	 * \param pixelFormat pixel format of the image.
+	 * \param pixelComponentType pixel component data type of the image.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note The pixel data must be written through getPixels() before it is
+	 *       read.
+	 */
+	Image(std::size_t width, std::size_t height, PixelFormat pixelFormat, PixelComponentType pixelComponentType);
+
 	/**
 	 * Construct an image copied from an image view.
 	 *
@@ -717,6 +751,161 @@ private:
 	PixelComponentType pixelComponentType = PixelComponentType::U8;
 };
 
+/**
+ * Options for loading a raw image.
+ */
+struct RawImageOptions {
+	/**
+	 * Flip the loaded image vertically.
+	 */
+	bool flipVertically = false;
+};
+
+/**
+ * Container for a 2D image whose pixels are stored uncompressed in a file, and
+ * which are referenced directly inside of the buffer that the file was read
+ * into, rather than being decoded into a separate allocation like in Image.
+ *
+ * This roughly halves the peak memory usage when loading large uncompressed
+ * textures, and avoids the overhead of reading the file in small chunks.
+ *
+ * \sa Image
+ * \sa ImageView
+ */
+class RawImage {
+public:
+	/**
+	 * Construct an empty image without a value.
+	 */
+	RawImage() noexcept = default;
+
+	/**
+	 * Load an uncompressed TGA image from a virtual file.
+	 *
+	 * Supported files are uncompressed true-color images with 24 or 32 bits
+	 * per pixel, and uncompressed grayscale images with 8 bits per pixel. The
+	 * resulting pixel format is PixelFormat::RGB, PixelFormat::RGBA or
+	 * PixelFormat::R respectively, and the pixel component type is always
+	 * PixelComponentType::U8.
+	 *
+	 * Any conversion that is needed to match the pixel layout of ImageView,
+	 * such as swapping the blue and red channels or flipping the row order, is
+	 * done in place inside of the file buffer.
+	 *
+	 * \param filesystem virtual filesystem to load the file from.
+	 * \param filepath virtual filepath of the image file to load.
+	 * \param options image options, see RawImageOptions.
+	 *
+	 * \throws File::Error on failure to open or read the file.
+	 * \throws graphics::Error if the file is not an uncompressed TGA image of
+	 *         one of the supported formats.
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note Use Image to load compressed or otherwise unsupported TGA files.
+	 */
+	RawImage(const Filesystem& filesystem, const char* filepath, const RawImageOptions& options = {});
+
+	/**
+	 * Load a headerless image from a virtual file that contains only tightly
+	 * packed pixel data in the layout described by ImageView::getPixels().
+	 *
+	 * \param filesystem virtual filesystem to load the file from.
+	 * \param filepath virtual filepath of the image file to load.
+	 * \param width width of the image, in pixels.
+	 * \param height height of the image, in pixels.
+	 * \param pixelFormat pixel format of the image.
+	 * \param pixelComponentType pixel component type of the image.
+	 * \param options image options, see RawImageOptions.
+	 *
+	 * \throws File::Error on failure to open or read the file.
+	 * \throws graphics::Error if the size of the file does not match the given
+	 *         dimensions and format.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	RawImage(const Filesystem& filesystem, const char* filepath, std::size_t width, std::size_t height, PixelFormat pixelFormat, PixelComponentType pixelComponentType,
+		const RawImageOptions& options = {});
+
+	/**
+	 * Check if the image has a value.
+	 *
+	 * \return true if the image has a value, false otherwise.
+	 */
+	explicit operator bool() const noexcept {
+		return !buffer.empty();
+	}
+
+	/**
+	 * Get a view over this image.
+	 *
+	 * \return if the image has a value, returns a read-only non-owning view
+	 *         over it. Otherwise, returns a view that doesn't reference an
+	 *         image.
+	 */
+	operator ImageView() const noexcept {
+		return ImageView{width, height, pixelFormat, pixelComponentType, getPixels()};
+	}
+
+	/**
+	 * Get the width of the image.
+	 *
+	 * \return the width of the image, in pixels, or 0 if the image does not
+	 *         have a value.
+	 */
+	[[nodiscard]] std::size_t getWidth() const noexcept {
+		return width;
+	}
+
+	/**
+	 * Get the height of the image.
+	 *
+	 * \return the height of the image, in pixels, or 0 if the image does not
+	 *         have a value.
+	 */
+	[[nodiscard]] std::size_t getHeight() const noexcept {
+		return height;
+	}
+
+	/**
+	 * Get the pixel format of the image.
+	 *
+	 * \return the pixel format, or PixelFormat::R if the image does not have a
+	 *         value.
+	 */
+	[[nodiscard]] PixelFormat getPixelFormat() const noexcept {
+		return pixelFormat;
+	}
+
+	/**
+	 * Get the pixel component type of the image.
+	 *
+	 * \return the pixel component type, or PixelComponentType::U8 if the image
+	 *         does not have a value.
+	 */
+	[[nodiscard]] PixelComponentType getPixelComponentType() const noexcept {
+		return pixelComponentType;
+	}
+
+	/**
+	 * Get the pixel data of this image.
+	 *
+	 * \return a read-only non-owning pointer to the pixel data inside of the
+	 *         file buffer, or nullptr if the image does not have a value.
+	 *
+	 * \sa ImageView::getPixels()
+	 */
+	[[nodiscard]] const void* getPixels() const noexcept {
+		return (buffer.empty()) ? nullptr : buffer.data() + pixelsOffset;
+	}
+
+private:
+	std::vector<std::byte> buffer{};
+	std::size_t pixelsOffset = 0;
+	std::size_t width = 0;
+	std::size_t height = 0;
+	PixelFormat pixelFormat = PixelFormat::R;
+	PixelComponentType pixelComponentType = PixelComponentType::U8;
+};
+
 } // namespace donut::graphics
 
 #endif
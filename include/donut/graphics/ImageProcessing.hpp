@@ -0,0 +1,181 @@
+#ifndef DONUT_GRAPHICS_IMAGE_PROCESSING_HPP
+#define DONUT_GRAPHICS_IMAGE_PROCESSING_HPP
+
+#include <donut/graphics/Image.hpp>
+
+#include <cstdint> // std::uint8_t
+#include <vector>  // std::vector
+
+namespace donut::graphics {
+
+/**
+ * Resampling filter to use when generating the levels of a mipmap.
+ *
+ * The filter radii are measured in texels of the level being generated, so the
+ * kernel of a filter with radius r covers r * scale source texels on each side
+ * of a destination texel, where scale is the ratio between the source and
+ * destination sizes, i.e. 2 when halving the image.
+ */
+enum class MipmapFilter : std::uint8_t {
+	BOX,     ///< 2x2 box filter. Fastest, but blurs and aliases more than the other filters.
+	KAISER,  ///< Kaiser-windowed sinc filter with a radius of 3 destination texels (6 source texels when halving). Sharp, with little ringing.
+	LANCZOS, ///< Lanczos filter with a radius of 3 destination texels (6 source texels when halving). Sharpest, but may cause slight ringing around hard edges.
+};
+
+/**
+ * Configuration options for generating a mipmap using generateMipmap().
+ */
+struct MipmapOptions {
+	/**
+	 * Resampling filter to use for generating each level.
+	 */
+	MipmapFilter filter = MipmapFilter::KAISER;
+
+	/**
+	 * Treat the color channels of the image as sRGB-encoded.
+	 *
+	 * When enabled, the color channels are converted to linear color before
+	 * filtering and back to sRGB afterwards, so that the average brightness of
+	 * the image is preserved across levels. The alpha channel of an image with
+	 * pixel format PixelFormat::RGBA is always filtered as linear.
+	 */
+	bool sRGB = false;
+};
+
+/**
+ * Create a copy of an image converted to a different pixel format and/or pixel
+ * component type.
+ *
+ * Channels that are added by the conversion are filled in the same way as when
+ * uploading an image to a texture with more channels than the image has, i.e.
+ * missing color channels are set to 0 and a missing alpha channel is set to 1.
+ * Channels that are removed by the conversion are discarded.
+ *
+ * When converting from PixelComponentType::U8 to PixelComponentType::F32, the
+ * components are normalized to the 0-1 range. When converting the other way
+ * around, the components are clamped to the 0-1 range and rounded to the
+ * nearest 8-bit value.
+ *
+ * \param image view over the image to convert.
+ * \param newPixelFormat pixel format of the converted image.
+ * \param newPixelComponentType pixel component type of the converted image.
+ *
+ * \return the converted image, or an empty image without a value if the view
+ *         does not reference an image.
+ *
+ * \throws graphics::Error if the source or destination pixel component type is
+ *         PixelComponentType::F16, which is not supported.
+ * \throws std::bad_alloc on allocation failure.
+ */
+[[nodiscard]] Image convertImage(const ImageView& image, PixelFormat newPixelFormat, PixelComponentType newPixelComponentType);
+
+/**
+ * Convert the color channels of an image from sRGB to linear color in place.
+ *
+ * The alpha channel of an image with pixel format PixelFormat::RGBA is left
+ * unchanged.
+ *
+ * \param image image to convert.
+ *
+ * \throws graphics::Error if the pixel component type of the image is
+ *         PixelComponentType::F16, which is not supported.
+ *
+ * \note Linear color stored as PixelComponentType::U8 loses a significant
+ *       amount of precision in the dark range. Consider converting the image
+ *       to PixelComponentType::F32 first using convertImage().
+ *
+ * \sa convertImageLinearToSRGB()
+ */
+void convertImageSRGBToLinear(Image& image);
+
+/**
+ * Convert the color channels of an image from linear color to sRGB in place.
+ *
+ * The alpha channel of an image with pixel format PixelFormat::RGBA is left
+ * unchanged.
+ *
+ * \param image image to convert.
+ *
+ * \throws graphics::Error if the pixel component type of the image is
+ *         PixelComponentType::F16, which is not supported.
+ *
+ * \sa convertImageSRGBToLinear()
+ */
+void convertImageLinearToSRGB(Image& image);
+
+/**
+ * Multiply the color channels of an image with pixel format PixelFormat::RGBA
+ * by its alpha channel in place.
+ *
+ * \param image image to premultiply. Images with a pixel format other than
+ *        PixelFormat::RGBA are left unchanged.
+ *
+ * \throws graphics::Error if the pixel component type of the image is
+ *         PixelComponentType::F16, which is not supported.
+ *
+ * \note The color channels are expected to be in linear color for the result
+ *       to be correct when blending.
+ */
+void premultiplyImageAlpha(Image& image);
+
+/**
+ * Flip an image vertically in place.
+ *
+ * \param image image to flip.
+ */
+void flipImageVertically(Image& image) noexcept;
+
+/**
+ * Create a copy of an image that is downsampled to half the width and height
+ * using a 2x2 box filter, such as for generating the next level of a mipmap.
+ *
+ * If the width or height of the image is odd, the last column or row of the
+ * source image is included in the last column or row of the result.
+ *
+ * \param image view over the image to downsample.
+ *
+ * \return the downsampled image, which has the same pixel format and component
+ *         type as the original, and a width and height of half the original,
+ *         rounded down, but no less than 1. If the view does not reference an
+ *         image, an empty image without a value is returned.
+ *
+ * \throws graphics::Error if the pixel component type of the image is
+ *         PixelComponentType::F16, which is not supported.
+ * \throws std::bad_alloc on allocation failure.
+ *
+ * \note The filter is applied to the stored values as-is. To downsample an sRGB
+ *       image correctly, convert it to linear color first.
+ */
+[[nodiscard]] Image downsampleImage(const ImageView& image);
+
+/**
+ * Generate the full chain of mipmap levels for an image on the CPU.
+ *
+ * Each level has half the width and height of the previous one, rounded down,
+ * but no less than 1, and the chain ends with a 1x1 level. Filtering is done
+ * in 32-bit floating-point precision regardless of the pixel component type of
+ * the image, and the result is deterministic, unlike mipmaps generated by the
+ * graphics driver.
+ *
+ * Since this function does not touch any graphics state, it may be called from
+ * any thread, such as a worker thread that loads assets asynchronously. The
+ * resulting levels can then be uploaded using the Texture(const ImageView&, std::span<const Image>, const TextureOptions&)
+ * constructor or Texture::setMipmapLevel2D().
+ *
+ * \param image view over the base level of the mipmap.
+ * \param options mipmap generation options, see MipmapOptions.
+ *
+ * \return the mipmap levels after the base level, in order of decreasing size,
+ *         each with the same pixel format and component type as the image. If
+ *         the image is 1x1, or if the view does not reference an image, the
+ *         result is empty.
+ *
+ * \throws graphics::Error if the pixel component type of the image is
+ *         PixelComponentType::F16, which is not supported.
+ * \throws std::bad_alloc on allocation failure.
+ */
+[[nodiscard]] std::vector<Image> generateMipmap(const ImageView& image, const MipmapOptions& options = {});
+
+} // namespace donut::graphics
+
+#endif
@@ -4,6 +4,7 @@
 #include <donut/graphics/Buffer.hpp>
 #include <donut/graphics/Handle.hpp>
 #include <donut/graphics/VertexArray.hpp>
+#include <donut/graphics/VertexPacking.hpp>
 #include <donut/math.hpp>
 #include <donut/reflection.hpp>
 
@@ -17,21 +18,48 @@
 
 namespace donut::graphics {
 
+namespace detail {
+
+template <typename T>
+struct is_normalized_vertex_attribute : std::false_type {};
+
+template <length_t L, typename T>
+struct is_normalized_vertex_attribute<Normalized<vec<L, T>>>
+	: std::bool_constant<(L >= 2 && L <= 4) && (std::is_same_v<T, i8> || std::is_same_v<T, u8> || std::is_same_v<T, i16> || std::is_same_v<T, u16>)> {};
+
+template <typename T>
+inline constexpr bool is_normalized_vertex_attribute_v = is_normalized_vertex_attribute<T>::value;
+
+template <typename T>
+struct is_integer_vertex_attribute : std::false_type {};
+
+template <length_t L, typename T>
+struct is_integer_vertex_attribute<vec<L, T>> : std::bool_constant<(L >= 2 && L <= 4) && (std::is_same_v<T, u8> || std::is_same_v<T, u16> || std::is_same_v<T, u32>)> {};
+
+template <typename T>
+inline constexpr bool is_integer_vertex_attribute_v = is_integer_vertex_attribute<T>::value;
+
+} // namespace detail
+
 /**
  * Concept that checks if a type is a valid vertex attribute.
  *
  * \tparam T the type to check.
  */
 template <typename T>
-concept vertex_attribute =      //
-	std::is_same_v<T, u32> ||   //
-	std::is_same_v<T, float> || //
-	std::is_same_v<T, vec2> ||  //
-	std::is_same_v<T, vec3> ||  //
-	std::is_same_v<T, vec4> ||  //
-	std::is_same_v<T, mat2> ||  //
-	std::is_same_v<T, mat3> ||  //
-	std::is_same_v<T, mat4>;
+concept vertex_attribute =                         //
+	std::is_same_v<T, u32> ||                      //
+	std::is_same_v<T, float> ||                    //
+	std::is_same_v<T, vec2> ||                     //
+	std::is_same_v<T, vec3> ||                     //
+	std::is_same_v<T, vec4> ||                     //
+	std::is_same_v<T, mat2> ||                     //
+	std::is_same_v<T, mat3> ||                     //
+	std::is_same_v<T, mat4> ||                     //
+	std::is_same_v<T, PackedHalf2x16> ||           //
+	std::is_same_v<T, PackedSnorm3x10_1x2> ||      //
+	detail::is_normalized_vertex_attribute_v<T> || //
+	detail::is_integer_vertex_attribute_v<T>;
 
 /**
  * Hint to the graphics driver implementation regarding the intended access
@@ -78,6 +106,31 @@ enum class MeshIndexType : std::uint32_t {
 
 namespace detail {
 
+enum class VertexAttributeComponentType : std::uint32_t {
+	I8 = 0x1400,
+	U8 = 0x1401,
+	I16 = 0x1402,
+	U16 = 0x1403,
+	U32 = 0x1405,
+	F16 = 0x140B,
+	PACKED_I10_I10_I10_I2 = 0x8D9F,
+};
+
+template <typename T>
+[[nodiscard]] constexpr VertexAttributeComponentType getVertexAttributeComponentType() noexcept {
+	if constexpr (std::is_same_v<T, i8>) {
+		return VertexAttributeComponentType::I8;
+	} else if constexpr (std::is_same_v<T, u8>) {
+		return VertexAttributeComponentType::U8;
+	} else if constexpr (std::is_same_v<T, i16>) {
+		return VertexAttributeComponentType::I16;
+	} else if constexpr (std::is_same_v<T, u16>) {
+		return VertexAttributeComponentType::U16;
+	} else {
+		return VertexAttributeComponentType::U32;
+	}
+}
+
 class MeshStatePreserver {
 public:
 	[[nodiscard]] MeshStatePreserver() noexcept;
@@ -100,8 +153,12 @@ void enableVertexAttribArray(std::uint32_t index);
 void vertexAttribDivisor(std::uint32_t index, std::uint32_t divisor);
 void vertexAttribPointerUint(std::uint32_t index, std::size_t count, std::size_t stride, std::uintptr_t offset);
 void vertexAttribPointerFloat(std::uint32_t index, std::size_t count, std::size_t stride, std::uintptr_t offset);
+void vertexAttribPointerPacked(std::uint32_t index, std::size_t count, VertexAttributeComponentType type, bool normalized, std::size_t stride, std::uintptr_t offset);
+void vertexAttribPointerInteger(std::uint32_t index, std::size_t count, VertexAttributeComponentType type, std::size_t stride, std::uintptr_t offset);
 void bufferArrayBufferData(std::size_t size, const void* data, MeshBufferUsage usage);
 void bufferElementArrayBufferData(std::size_t size, const void* data, MeshBufferUsage usage);
+void bufferArrayBufferSubData(std::size_t offset, std::size_t size, const void* data);
+void bufferElementArrayBufferSubData(std::size_t offset, std::size_t size, const void* data);
 
 template <bool IsInstance>
 inline void enableVertexAttribute(std::uint32_t index) {
@@ -149,6 +206,19 @@ template <bool IsInstance, typename T>
 		vertexAttribPointerFloat(index++, 4, stride, offset + sizeof(float) * 8);
 		enableVertexAttribute<IsInstance>(index);
 		vertexAttribPointerFloat(index++, 4, stride, offset + sizeof(float) * 12);
+	} else if constexpr (std::is_same_v<T, PackedHalf2x16>) {
+		enableVertexAttribute<IsInstance>(index);
+		vertexAttribPointerPacked(index++, 2, VertexAttributeComponentType::F16, false, stride, offset);
+	} else if constexpr (std::is_same_v<T, PackedSnorm3x10_1x2>) {
+		enableVertexAttribute<IsInstance>(index);
+		vertexAttribPointerPacked(index++, 4, VertexAttributeComponentType::PACKED_I10_I10_I10_I2, true, stride, offset);
+	} else if constexpr (is_normalized_vertex_attribute_v<T>) {
+		using Vector = decltype(T::value);
+		enableVertexAttribute<IsInstance>(index);
+		vertexAttribPointerPacked(index++, static_cast<std::size_t>(Vector::length()), getVertexAttributeComponentType<typename Vector::value_type>(), true, stride, offset);
+	} else if constexpr (is_integer_vertex_attribute_v<T>) {
+		enableVertexAttribute<IsInstance>(index);
+		vertexAttribPointerInteger(index++, static_cast<std::size_t>(T::length()), getVertexAttributeComponentType<typename T::value_type>(), stride, offset);
 	} else {
 		throw std::invalid_argument{"Invalid vertex attribute type!"};
 	}
@@ -342,6 +412,85 @@ public:
 		detail::bufferElementArrayBufferData(sizeof(Index) * indices.size(), indices.data(), indicesUsage);
 	}
 
+	/**
+	 * Overwrite a range of the vertex buffer without reallocating it.
+	 *
+	 * \param offset index of the first vertex to overwrite.
+	 * \param vertices new data to copy into the vertex buffer, starting at
+	 *        the given offset.
+	 *
+	 * \warning The range must fit within the current size of the vertex
+	 *          buffer, as specified in the latest call to the constructor or
+	 *          setVertices().
+	 *
+	 * \note The GPU may have to wait for in-flight rendering commands that
+	 *       read from the buffer to finish before the update can take place.
+	 *       See DynamicMesh for an abstraction that avoids such stalls.
+	 */
+	void updateVertices(std::size_t offset, std::span<const Vertex> vertices) noexcept {
+		const detail::MeshStatePreserver preserver{};
+		detail::bindArrayBuffer(vbo.get());
+		detail::bufferArrayBufferSubData(sizeof(Vertex) * offset, sizeof(Vertex) * vertices.size(), vertices.data());
+	}
+
+	/**
+	 * Overwrite a range of the index buffer without reallocating it.
+	 *
+	 * \param offset index of the first index to overwrite.
+	 * \param indices new data to copy into the index buffer, starting at the
+	 *        given offset.
+	 *
+	 * \warning The range must fit within the current size of the index
+	 *          buffer, as specified in the latest call to the constructor or
+	 *          setVertices().
+	 *
+	 * \note The GPU may have to wait for in-flight rendering commands that
+	 *       read from the buffer to finish before the update can take place.
+	 *       See DynamicMesh for an abstraction that avoids such stalls.
+	 */
+	void updateIndices(std::size_t offset, std::span<const Index> indices) noexcept requires(IS_INDEXED) {
+		const detail::MeshStatePreserver preserver{};
+		detail::bindVertexArray(vao.get());
+		detail::bindElementArrayBuffer(ebo.get());
+		detail::bufferElementArrayBufferSubData(sizeof(Index) * offset, sizeof(Index) * indices.size(), indices.data());
+	}
+
+	/**
+	 * Create a new vertex array that reads its vertices and indices from the
+	 * buffers of this mesh, but reads its instances from a different buffer.
+	 *
+	 * This allows the same mesh to be drawn with several sets of instance data
+	 * that are kept on the GPU, without having to upload them to the instance
+	 * buffer of the mesh before each draw.
+	 *
+	 * \param instanceBuffer handle to a buffer object that contains an array of
+	 *        instances of the same type as the instance buffer of the mesh.
+	 *
+	 * \return the new vertex array.
+	 *
+	 * \throws graphics::Error on failure to create the vertex array object.
+	 *
+	 * \warning The returned vertex array refers to the buffers of this mesh
+	 *          and the given instance buffer, so they must outlive it.
+	 *
+	 * \note This function is used internally by the implementations of various
+	 *       abstractions and is not intended to be used outside of the graphics
+	 *       module.
+	 */
+	[[nodiscard]] VertexArray createVertexArrayWithInstanceBuffer(Handle instanceBuffer) const requires(IS_INSTANCED) {
+		const detail::MeshStatePreserver preserver{};
+		VertexArray result{};
+		detail::bindVertexArray(result.get());
+		detail::bindArrayBuffer(vbo.get());
+		const std::uint32_t attributeOffset = setupVertexAttributes<false, Vertex>(0);
+		if constexpr (IS_INDEXED) {
+			detail::bindElementArrayBuffer(ebo.get());
+		}
+		detail::bindArrayBuffer(instanceBuffer);
+		setupVertexAttributes<true, Instance>(attributeOffset);
+		return result;
+	}
+
 	/**
 	 * Get an opaque handle to the GPU representation of the vertex buffer.
 	 *
@@ -404,13 +553,7 @@ private:
 		static_assert(std::is_standard_layout_v<Vertex>, "Vertex type must have standard layout!");
 		detail::bindArrayBuffer(vbo.get());
 		detail::bufferArrayBufferData(sizeof(Vertex) * vertices.size(), vertices.data(), usage);
-		Vertex dummyVertex{};
-		reflection::forEach(reflection::fields(dummyVertex), [&dummyVertex, &attributeOffset]<typename T>(T& dummyField) {
-			const std::byte* const basePointer = reinterpret_cast<const std::byte*>(std::addressof(dummyVertex));
-			const std::byte* const attributePointer = reinterpret_cast<const std::byte*>(std::addressof(dummyField));
-			const std::uintptr_t offset = static_cast<std::uintptr_t>(attributePointer - basePointer);
-			attributeOffset = detail::setupVertexAttribute<false, T>(attributeOffset, sizeof(Vertex), offset);
-		});
+		setupVertexAttributes<false, Vertex>(attributeOffset);
 	}
 
 	void bufferIndexData(MeshBufferUsage usage, std::span<const Index> indices) requires(IS_INDEXED) {
@@ -423,13 +566,19 @@ private:
 		static_assert(std::is_standard_layout_v<Instance>, "Instance type must have standard layout!");
 		detail::bindArrayBuffer(ibo.get());
 		detail::bufferArrayBufferData(sizeof(Instance) * instances.size(), instances.data(), usage);
-		Instance dummyInstance{};
-		reflection::forEach(reflection::fields(dummyInstance), [&dummyInstance, &attributeOffset]<typename T>(T& dummyField) {
-			const std::byte* const basePointer = reinterpret_cast<const std::byte*>(std::addressof(dummyInstance));
+		setupVertexAttributes<true, Instance>(attributeOffset);
+	}
+
+	template <bool IsInstance, typename T>
+	static std::uint32_t setupVertexAttributes(std::uint32_t attributeOffset) {
+		T dummy{};
+		reflection::forEach(reflection::fields(dummy), [&dummy, &attributeOffset]<typename U>(U& dummyField) {
+			const std::byte* const basePointer = reinterpret_cast<const std::byte*>(std::addressof(dummy));
 			const std::byte* const attributePointer = reinterpret_cast<const std::byte*>(std::addressof(dummyField));
 			const std::uintptr_t offset = static_cast<std::uintptr_t>(attributePointer - basePointer);
-			attributeOffset = detail::setupVertexAttribute<true, T>(attributeOffset, sizeof(Instance), offset);
+			attributeOffset = detail::setupVertexAttribute<IsInstance, U>(attributeOffset, sizeof(T), offset);
 		});
+		return attributeOffset;
 	}
 
 	VertexArray vao{};
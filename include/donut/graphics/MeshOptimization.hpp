@@ -0,0 +1,229 @@
+#ifndef DONUT_GRAPHICS_MESH_OPTIMIZATION_HPP
+#define DONUT_GRAPHICS_MESH_OPTIMIZATION_HPP
+
+#include <donut/math.hpp>
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <limits>  // std::numeric_limits
+#include <span>    // std::span
+#include <vector>  // std::vector
+
+namespace donut::graphics {
+
+/**
+ * Size, in vertices, of the simulated FIFO post-transform vertex cache used by
+ * default when analyzing an index buffer using analyzeVertexCache().
+ */
+inline constexpr std::size_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+/**
+ * Default maximum ratio by which optimizeOverdraw() is allowed to degrade the
+ * average cache miss ratio of an index buffer.
+ */
+inline constexpr float DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+/**
+ * Efficiency statistics of an indexed triangle list with respect to the
+ * post-transform vertex cache of the GPU, as computed by analyzeVertexCache().
+ */
+struct VertexCacheStatistics {
+	/**
+	 * Average cache miss ratio (ACMR), i.e. the average number of vertex
+	 * shader invocations per triangle.
+	 *
+	 * This ranges from 3 in the worst case, where no vertex is ever reused,
+	 * down to approximately 0.5 for a large, perfectly ordered regular grid.
+	 */
+	float averageCacheMissRatio = 0.0f;
+
+	/**
+	 * Average transform to vertex ratio (ATVR), i.e. the average number of
+	 * vertex shader invocations per referenced vertex.
+	 *
+	 * Unlike the average cache miss ratio, this does not depend on the
+	 * topology of the mesh, and the optimal value is always 1.
+	 */
+	float averageTransformToVertexRatio = 0.0f;
+};
+
+/**
+ * Simulate rendering an indexed triangle list through a FIFO post-transform
+ * vertex cache and compute its cache efficiency.
+ *
+ * \param indices index buffer of the triangle list, where each consecutive
+ *        triplet of indices defines a triangle. Any trailing indices that do
+ *        not form a full triangle are ignored.
+ * \param vertexCount number of vertices in the vertex buffer. All indices must
+ *        be less than this value.
+ * \param cacheSize number of vertices that fit in the simulated cache.
+ *
+ * \return the cache statistics of the index buffer, or zero-initialized
+ *         statistics if it does not contain any triangles.
+ *
+ * \throws std::bad_alloc on allocation failure.
+ */
+[[nodiscard]] VertexCacheStatistics analyzeVertexCache(std::span<const std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * Reorder the triangles of an indexed triangle list in-place to improve the
+ * hit rate of the post-transform vertex cache of the GPU.
+ *
+ * This uses the linear-speed vertex cache optimization algorithm by Tom
+ * Forsyth, which greedily emits the triangle whose vertices are scored highest
+ * according to their position in a simulated LRU cache and their number of
+ * remaining triangles. The result is not tuned for any specific cache size and
+ * performs well on a wide range of hardware.
+ *
+ * The winding order of each triangle is preserved.
+ *
+ * \param indices index buffer of the triangle list to reorder, where each
+ *        consecutive triplet of indices defines a triangle. Any trailing
+ *        indices that do not form a full triangle are left untouched.
+ * \param vertexCount number of vertices in the vertex buffer. All indices must
+ *        be less than this value.
+ *
+ * \throws std::bad_alloc on allocation failure.
+ */
+void optimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount);
+
+/**
+ * Reorder clusters of triangles of an indexed triangle list in-place to reduce
+ * the amount of overdraw when the mesh is rendered with depth testing.
+ *
+ * The triangle list is split into clusters at points where the simulated
+ * vertex cache would be flushed anyway, as well as at additional points where
+ * the average cache miss ratio of the cluster so far is within the given
+ * threshold of that of the whole run it belongs to, in the manner of the
+ * Tipsify algorithm by Sander, Nehab and Barczak. The clusters are then sorted
+ * so that those on the outside of the mesh that face away from its center are
+ * drawn first, since these are the most likely to occlude the rest of the mesh
+ * from any viewpoint.
+ *
+ * \param indices index buffer of the triangle list to reorder, where each
+ *        consecutive triplet of indices defines a triangle. This should
+ *        already have been optimized using optimizeVertexCache(). Any trailing
+ *        indices that do not form a full triangle are left untouched.
+ * \param positions vertex positions of the mesh, indexed by the index buffer.
+ * \param threshold maximum ratio by which the average cache miss ratio of the
+ *        triangle list is allowed to get worse in exchange for finer clusters,
+ *        and thereby a more effective sort. A value of 1 only splits the mesh
+ *        where it is free with respect to the vertex cache.
+ *
+ * \throws std::bad_alloc on allocation failure.
+ */
+void optimizeOverdraw(std::span<std::uint32_t> indices, std::span<const vec3> positions, float threshold = DEFAULT_OVERDRAW_THRESHOLD);
+
+/**
+ * Configuration options for simplifying a mesh using simplifyMesh().
+ */
+struct MeshSimplificationOptions {
+	/**
+	 * Number of indices to reduce the mesh to.
+	 *
+	 * Simplification stops as soon as the number of indices in the result is
+	 * less than or equal to this value, but may stop earlier if the mesh
+	 * cannot be simplified further without exceeding maxError.
+	 */
+	std::size_t targetIndexCount = 0;
+
+	/**
+	 * Maximum allowed geometric error of the simplified mesh, as an
+	 * approximate distance from the original surface in the same units as the
+	 * vertex positions.
+	 */
+	float maxError = std::numeric_limits<float>::infinity();
+};
+
+/**
+ * Result of simplifying a mesh using simplifyMesh().
+ */
+struct MeshSimplificationResult {
+	/**
+	 * Index buffer of the simplified triangle list, which references a subset
+	 * of the original vertices.
+	 */
+	std::vector<std::uint32_t> indices;
+
+	/**
+	 * Approximate geometric error of the simplified mesh, as the largest
+	 * distance from the original surface of any collapsed vertex, in the same
+	 * units as the vertex positions.
+	 */
+	float error;
+};
+
+/**
+ * Generate a simplified version of an indexed triangle list with fewer
+ * triangles, for use as a lower level of detail.
+ *
+ * This uses quadric error metric edge collapse, as described in "Surface
+ * Simplification Using Quadric Error Metrics" (Garland and Heckbert 1997). Each
+ * collapse merges a vertex into one of its neighbors, so no new vertices are
+ * created and the result can share the vertex buffer of the original mesh.
+ * Collapses are performed in order of increasing error, and collapses that
+ * would flip the orientation of a triangle are rejected.
+ *
+ * Vertices on open borders of the mesh and vertices that share their position
+ * with another vertex, such as those on texture or normal seams, are never
+ * removed, so that the simplified mesh does not develop cracks along them.
+ *
+ * \param indices index buffer of the triangle list to simplify, where each
+ *        consecutive triplet of indices defines a triangle. Any trailing
+ *        indices that do not form a full triangle are ignored.
+ * \param positions vertex positions of the mesh, indexed by the index buffer.
+ * \param options simplification options, see MeshSimplificationOptions.
+ *
+ * \return the simplified triangle list and its error, see
+ *         MeshSimplificationResult.
+ *
+ * \throws std::bad_alloc on allocation failure.
+ */
+[[nodiscard]] MeshSimplificationResult simplifyMesh(std::span<const std::uint32_t> indices, std::span<const vec3> positions, const MeshSimplificationOptions& options);
+
+/**
+ * Remap the indices of an index buffer so that the vertices are numbered in
+ * order of first use, to improve the memory locality of vertex fetches.
+ *
+ * Vertices that are not referenced by the index buffer are numbered after all
+ * of the referenced vertices, in their original order.
+ *
+ * \param indices index buffer to remap in-place.
+ * \param vertexCount number of vertices in the vertex buffer. All indices must
+ *        be less than this value.
+ *
+ * \return a list of vertexCount elements that maps each original vertex index
+ *         to its new index, which should be used to reorder the vertex buffer
+ *         accordingly.
+ *
+ * \throws std::bad_alloc on allocation failure.
+ *
+ * \sa optimizeVertexFetch()
+ */
+[[nodiscard]] std::vector<std::uint32_t> optimizeVertexFetchRemap(std::span<std::uint32_t> indices, std::size_t vertexCount);
+
+/**
+ * Reorder the vertices of an indexed mesh in-place in order of first use by
+ * the index buffer, and remap the indices accordingly, to improve the memory
+ * locality of vertex fetches.
+ *
+ * \param vertices vertex buffer to reorder.
+ * \param indices index buffer to remap. All indices must be less than the
+ *        number of vertices.
+ *
+ * \throws std::bad_alloc on allocation failure.
+ *
+ * \sa optimizeVertexFetchRemap()
+ */
+template <typename Vertex>
+void optimizeVertexFetch(std::span<Vertex> vertices, std::span<std::uint32_t> indices) {
+	const std::vector<std::uint32_t> remap = optimizeVertexFetchRemap(indices, vertices.size());
+	const std::vector<Vertex> originalVertices(vertices.begin(), vertices.end());
+	for (std::size_t i = 0; i < originalVertices.size(); ++i) {
+		vertices[remap[i]] = originalVertices[i];
+	}
+}
+
+} // namespace donut::graphics
+
+#endif
@@ -3,16 +3,147 @@
 
 #include <donut/Filesystem.hpp>
 #include <donut/graphics/Mesh.hpp>
+#include <donut/graphics/MeshOptimization.hpp>
 #include <donut/graphics/Texture.hpp>
+#include <donut/graphics/VertexPacking.hpp>
 #include <donut/math.hpp>
+#include <donut/shapes.hpp>
 
 #include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <variant> // std::variant, std::get_if
 #include <vector>  // std::vector
 
 namespace donut::graphics {
 
 class Renderer; // Forward declaration, to avoid a circular include of Renderer.hpp.
 
+/**
+ * Vertex cache statistics of a single object of a Model, before and after it
+ * was optimized during loading.
+ *
+ * \sa ModelOptions::optimizationStatistics
+ */
+struct ModelOptimizationStatistics {
+	VertexCacheStatistics before; ///< Statistics of the index buffer in the order given by the model file.
+	VertexCacheStatistics after;  ///< Statistics of the index buffer after optimization.
+};
+
+/**
+ * Layout of the vertices of the objects of a Model in GPU memory.
+ *
+ * The compact layouts reduce the memory footprint and vertex fetch bandwidth
+ * of the model at the cost of precision. They are decoded by the GPU before
+ * the vertex shader runs, so the same shaders can be used to render models
+ * with any vertex format.
+ *
+ * \sa ModelOptions::vertexFormat
+ */
+enum class ModelVertexFormat : std::uint32_t {
+	STANDARD,  ///< Full precision, see Model::Object::Vertex. \hideinitializer
+	COMPACT,   ///< Full precision positions with packed directions and texture coordinates, see Model::Object::CompactVertex. \hideinitializer
+	QUANTIZED, ///< Like COMPACT, but with positions quantized within the bounding box of each object, see Model::Object::QuantizedVertex. \hideinitializer
+};
+
+/**
+ * Configuration options for loading or compiling a Model.
+ */
+struct ModelOptions {
+	/**
+	 * Reorder the triangles of each object to improve the hit rate of the
+	 * post-transform vertex cache of the GPU, and then reorder its vertices in
+	 * order of first use to improve the memory locality of vertex fetches.
+	 *
+	 * \sa optimizeVertexCache()
+	 * \sa optimizeVertexFetch()
+	 */
+	bool optimizeVertexCache = false;
+
+	/**
+	 * Additionally reorder clusters of triangles of each object to reduce
+	 * overdraw, at the cost of a slightly worse vertex cache hit rate, as
+	 * determined by the overdrawThreshold.
+	 *
+	 * Has no effect unless optimizeVertexCache is also enabled.
+	 *
+	 * \sa optimizeOverdraw()
+	 */
+	bool optimizeOverdraw = false;
+
+	/**
+	 * Maximum ratio by which the overdraw optimization is allowed to degrade
+	 * the average cache miss ratio of each object.
+	 */
+	float overdrawThreshold = DEFAULT_OVERDRAW_THRESHOLD;
+
+	/**
+	 * Optional pointer to a list that receives the vertex cache statistics of
+	 * each optimized object, in the same order as Model::objects, or nullptr
+	 * to not report any statistics.
+	 *
+	 * The list is cleared before loading, and is left empty when the
+	 * optimization is disabled or when loading a compiled model, whose objects
+	 * have already been optimized by compile().
+	 */
+	std::vector<ModelOptimizationStatistics>* optimizationStatistics = nullptr;
+
+	/**
+	 * Total number of levels of detail to provide for each object, including
+	 * the original full-detail mesh.
+	 *
+	 * Each additional level is generated by simplifying the previous one
+	 * using simplifyMesh(), and is stored in the same index buffer as the
+	 * original, referencing the same vertices. The default value of 1
+	 * disables level of detail generation.
+	 *
+	 * \sa Model::Object::levelsOfDetail
+	 */
+	std::size_t levelOfDetailCount = 1;
+
+	/**
+	 * Target ratio of the number of triangles in each generated level of
+	 * detail relative to the previous level.
+	 */
+	float levelOfDetailReduction = 0.5f;
+
+	/**
+	 * Maximum geometric error of any generated level of detail, as a fraction
+	 * of the diagonal of the bounding box of the object.
+	 *
+	 * Objects that cannot be simplified further without exceeding this error
+	 * get fewer levels than requested, and the renderer uses their lowest
+	 * available level of detail instead.
+	 */
+	float levelOfDetailMaxError = 0.05f;
+
+	/**
+	 * Projected size of the bounding sphere of the model on screen, as a
+	 * fraction of the viewport height, below which the first simplified level
+	 * of detail is used.
+	 *
+	 * Each subsequent level is used below this size multiplied by the square
+	 * root of the levelOfDetailReduction once more, which keeps the number of
+	 * triangles per pixel roughly constant between levels.
+	 *
+	 * \sa Model::levelOfDetailScreenSizes
+	 */
+	float levelOfDetailScreenSize = 0.25f;
+
+	/**
+	 * Layout to store the vertices of each object in, see ModelVertexFormat.
+	 *
+	 * Compact formats store texture coordinates with half precision, so they
+	 * should not be used for models whose texture coordinates are far outside
+	 * of the range [-1, 1], such as heavily tiled surfaces. Quantized
+	 * positions have a resolution of 1/65535 of the size of the bounding box
+	 * of each object, which may leave small cracks between adjacent objects.
+	 *
+	 * When loading a compiled model, this option is ignored in favor of the
+	 * vertex format that the model was compiled with.
+	 */
+	ModelVertexFormat vertexFormat = ModelVertexFormat::STANDARD;
+};
+
 /**
  * Container for a set of 3D triangle meshes stored on the GPU, combined with
  * associated materials.
@@ -39,6 +170,68 @@ struct Model {
 			vec2 textureCoordinates; ///< Texture UV coordinates that map to this vertex.
 		};
 
+		/**
+		 * Compact data layout for the attributes of a single vertex of the
+		 * mesh, used by the ModelVertexFormat::COMPACT format.
+		 *
+		 * This takes up 28 bytes instead of the 56 bytes of a Vertex, and the
+		 * attributes are read by the vertex shader with the same types and at
+		 * the same locations.
+		 *
+		 * \note Meets the requirements of the donut::graphics::mesh_vertex
+		 *       concept.
+		 */
+		struct CompactVertex {
+			vec3 position;                     ///< Position relative to the model origin.
+			PackedSnorm3x10_1x2 normal;        ///< Unit vector pointing away from the vertex surface.
+			PackedSnorm3x10_1x2 tangent;       ///< Unit vector pointing in some direction along the vertex surface.
+			PackedSnorm3x10_1x2 bitangent;     ///< Unit vector that is the cross product of the normal and the tangent.
+			PackedHalf2x16 textureCoordinates; ///< Texture UV coordinates that map to this vertex.
+		};
+
+		/**
+		 * Quantized data layout for the attributes of a single vertex of the
+		 * mesh, used by the ModelVertexFormat::QUANTIZED format.
+		 *
+		 * This takes up 24 bytes instead of the 56 bytes of a Vertex. The
+		 * position is stored relative to the bounding box of the object, and
+		 * is mapped back to the model space by the vertex shader, see
+		 * Shader3D::vertexPositionOffset and Shader3D::vertexPositionScale.
+		 *
+		 * \note Meets the requirements of the donut::graphics::mesh_vertex
+		 *       concept.
+		 */
+		struct QuantizedVertex {
+			Normalized<u16vec4> position;      ///< Position within the bounding box of the object, mapped to the range [0, 1] on each axis. The w component is unused.
+			PackedSnorm3x10_1x2 normal;        ///< Unit vector pointing away from the vertex surface.
+			PackedSnorm3x10_1x2 tangent;       ///< Unit vector pointing in some direction along the vertex surface.
+			PackedSnorm3x10_1x2 bitangent;     ///< Unit vector that is the cross product of the normal and the tangent.
+			PackedHalf2x16 textureCoordinates; ///< Texture UV coordinates that map to this vertex.
+		};
+
+		/**
+		 * Data layout for the attributes of a single vertex of a skinned mesh,
+		 * which is deformed by the joints of a Skeleton when rendered.
+		 *
+		 * Skinned meshes are not loaded from model files, but can be created
+		 * by the application and rendered with a shader that uses
+		 * Shader3D::VERTEX_SHADER_SOURCE_CODE_SKINNED_MODEL, such as
+		 * Shader3D::BLINN_PHONG_SKINNED, by supplying the
+		 * ModelInstance::jointMatrices of each instance.
+		 *
+		 * \note Meets the requirements of the donut::graphics::mesh_vertex
+		 *       concept.
+		 */
+		struct SkinnedVertex {
+			vec3 position;              ///< Position relative to the model origin, in the bind pose.
+			vec3 normal;                ///< Unit vector pointing away from the vertex surface, in the bind pose.
+			vec3 tangent;               ///< Unit vector pointing in some direction along the vertex surface, in the bind pose.
+			vec3 bitangent;             ///< Unit vector that is the cross product of the normal and the tangent, in the bind pose.
+			vec2 textureCoordinates;    ///< Texture UV coordinates that map to this vertex.
+			u8vec4 joints;              ///< Indices of the up to 4 joints of the skeleton that influence this vertex.
+			Normalized<u8vec4> weights; ///< Influence of each of the joints, which should sum up to 1. Unused joints should have a weight of 0.
+		};
+
 		/**
 		 * Data type used in the index buffer of the mesh.
 		 *
@@ -62,6 +255,24 @@ struct Model {
 			vec3 emissiveFactor;        ///< Emissive factor to use when rendering.
 		};
 
+		/**
+		 * Data layout for the attributes of a single instance of a skinned
+		 * mesh.
+		 *
+		 * The model transformation of each instance is combined with its joint
+		 * matrices by the renderer, so it is not part of the instance data.
+		 *
+		 * \note Meets the requirements of the donut::graphics::mesh_instance
+		 *       concept.
+		 */
+		struct SkinnedInstance {
+			vec4 textureOffsetAndScale; ///< Texture offset (xy) and texture scale (zw) to apply to the texture coordinates before sampling the texture.
+			vec4 tintColor;             ///< Tint color to use when rendering.
+			vec3 specularFactor;        ///< Specular factor to use when rendering.
+			vec3 emissiveFactor;        ///< Emissive factor to use when rendering.
+			u32 jointMatrixOffset;      ///< Index of the first joint matrix of the instance in the joint matrix texture.
+		};
+
 		/**
 		 * Material attributes of the mesh.
 		 */
@@ -94,16 +305,56 @@ struct Model {
 		/** Index type of the mesh indices. */
 		static constexpr MeshIndexType INDEX_TYPE = MeshIndexType::U32;
 
-		static constexpr std::int32_t TEXTURE_UNIT_DIFFUSE = 0;  ///< Texture unit index to use for the Material::diffuseMap.
-		static constexpr std::int32_t TEXTURE_UNIT_SPECULAR = 1; ///< Texture unit index to use for the Material::specularMap.
-		static constexpr std::int32_t TEXTURE_UNIT_NORMAL = 2;   ///< Texture unit index to use for the Material::normalMap.
-		static constexpr std::int32_t TEXTURE_UNIT_EMISSIVE = 3; ///< Texture unit index to use for the Material::emissiveMap.
-		static constexpr std::int32_t TEXTURE_UNIT_COUNT = 4;    ///< Total number of texture units required to render an object.
+		static constexpr std::int32_t TEXTURE_UNIT_DIFFUSE = 0;        ///< Texture unit index to use for the Material::diffuseMap.
+		static constexpr std::int32_t TEXTURE_UNIT_SPECULAR = 1;       ///< Texture unit index to use for the Material::specularMap.
+		static constexpr std::int32_t TEXTURE_UNIT_NORMAL = 2;         ///< Texture unit index to use for the Material::normalMap.
+		static constexpr std::int32_t TEXTURE_UNIT_EMISSIVE = 3;       ///< Texture unit index to use for the Material::emissiveMap.
+		static constexpr std::int32_t TEXTURE_UNIT_JOINT_MATRICES = 4; ///< Texture unit index to use for the joint matrices of skinned meshes.
+		static constexpr std::int32_t TEXTURE_UNIT_COUNT = 5;          ///< Total number of texture units required to render an object.
+
+		/**
+		 * Range of the index buffer of the mesh that makes up a single level
+		 * of detail.
+		 */
+		struct LevelOfDetail {
+			std::size_t indexOffset; ///< Index of the first index of the level in the index buffer.
+			std::size_t indexCount;  ///< Number of indices in the level.
+		};
+
+		/**
+		 * Mesh data stored on the GPU, where the index of the active
+		 * alternative is the underlying value of the ModelVertexFormat of the
+		 * vertices, except for the last alternative, which holds a skinned
+		 * mesh, see SkinnedVertex.
+		 *
+		 * \warning Either all or none of the objects of a model must be
+		 *          skinned, since every object of a model is rendered with the
+		 *          same shader.
+		 */
+		std::variant<Mesh<Vertex, Index, Instance>, Mesh<CompactVertex, Index, Instance>, Mesh<QuantizedVertex, Index, Instance>, Mesh<SkinnedVertex, Index, SkinnedInstance>>
+			mesh;
+
+		/**
+		 * Get the mesh of the object, if its vertices use the
+		 * ModelVertexFormat::STANDARD format.
+		 *
+		 * \return a pointer to the mesh, or nullptr if the object uses a
+		 *         different vertex format or is skinned.
+		 */
+		[[nodiscard]] Mesh<Vertex, Index, Instance>* getStandardMesh() noexcept {
+			return std::get_if<Mesh<Vertex, Index, Instance>>(&mesh);
+		}
 
 		/**
-		 * Mesh data stored on the GPU.
+		 * Get the mesh of the object, if its vertices use the
+		 * ModelVertexFormat::STANDARD format.
+		 *
+		 * \return a read-only pointer to the mesh, or nullptr if the object
+		 *         uses a different vertex format or is skinned.
 		 */
-		Mesh<Vertex, Index, Instance> mesh;
+		[[nodiscard]] const Mesh<Vertex, Index, Instance>* getStandardMesh() const noexcept {
+			return std::get_if<Mesh<Vertex, Index, Instance>>(&mesh);
+		}
 
 		/**
 		 * Material attributes.
@@ -111,9 +362,31 @@ struct Model {
 		Material material;
 
 		/**
-		 * Number of indices stored in the index buffer of the mesh.
+		 * Number of indices in the full-detail level of the index buffer of
+		 * the mesh, which starts at the beginning of the buffer.
 		 */
 		std::size_t indexCount;
+
+		/**
+		 * Axis-aligned bounding box of the vertex positions of the mesh,
+		 * relative to the model origin.
+		 *
+		 * For the ModelVertexFormat::QUANTIZED format, this is also the range
+		 * that the quantized vertex positions are mapped to.
+		 */
+		Box<3, float> bounds;
+
+		/**
+		 * Ranges of the index buffer of the mesh that make up each level of
+		 * detail, in order of decreasing detail, starting with the full-detail
+		 * level.
+		 *
+		 * When empty, the object only has a single level of detail, made up of
+		 * the first indexCount indices.
+		 *
+		 * \sa ModelOptions::levelOfDetailCount
+		 */
+		std::vector<LevelOfDetail> levelsOfDetail{};
 	};
 
 	/**
@@ -142,14 +415,50 @@ struct Model {
 	explicit Model(std::vector<Object> objects) noexcept
 		: objects(std::move(objects)) {}
 
+	/**
+	 * Convert a model file to the compiled binary model format.
+	 *
+	 * A compiled model stores the final vertex and index arrays of each object,
+	 * along with its material attributes and bounding box, so that it can be
+	 * loaded by the Model(const Filesystem&, const char*, const ModelOptions&)
+	 * constructor with a single read and without any parsing or mesh
+	 * processing. The referenced texture image files are not embedded; their
+	 * filepaths are stored relative to the directory of the model file, so the
+	 * compiled model should be placed next to the original.
+	 *
+	 * This function does not use the GPU, so it may be called without an
+	 * active graphics context, such as from a command-line tool at build time.
+	 *
+	 * \param filesystem virtual filesystem to load the input files from and
+	 *        write the output file to.
+	 * \param inputFilepath virtual filepath of the model file to convert. See
+	 *        Model(const Filesystem&, const char*, const ModelOptions&) for
+	 *        the supported formats.
+	 * \param outputFilepath virtual filepath of the compiled model file to
+	 *        write, relative to the output directory of the filesystem.
+	 * \param options model options, see ModelOptions. Any optimizations are
+	 *        baked into the compiled model.
+	 *
+	 * \throws File::Error on failure to open, create or write a file.
+	 * \throws graphics::Error on failure to load a model from the input file.
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note The compiled format uses the native memory layout of the vertex
+	 *       type selected by ModelOptions::vertexFormat and of Object::Index,
+	 *       and is only supported on little-endian platforms.
+	 */
+	static void compile(Filesystem& filesystem, const char* inputFilepath, const char* outputFilepath, const ModelOptions& options = {});
+
 	/**
 	 * Load a model from a virtual file.
 	 *
 	 * The supported file formats are:
 	 * - Wavefront OBJ (.obj)
+	 * - Compiled binary model, see compile()
 	 *
 	 * \param filesystem virtual filepath to load the files from.
 	 * \param filepath virtual filepath of the model file to load.
+	 * \param options model options, see ModelOptions.
 	 *
 	 * \throws File::Error on failure to open the file.
 	 * \throws graphics::Error on failure to load a model from the file.
@@ -160,14 +469,30 @@ struct Model {
 	 * \note Any material libraries and texture image files required by the
 	 *       model are also loaded as needed. See the documentation of Image for
 	 *       a description of the supported image file formats.
+	 * \note Large OBJ files are parsed in parallel using all hardware threads,
+	 *       see obj::ParseOptions.
 	 */
-	Model(const Filesystem& filesystem, const char* filepath);
+	Model(const Filesystem& filesystem, const char* filepath, const ModelOptions& options = {});
 
 	/**
 	 * List of objects defined by the loaded model.
 	 */
 	std::vector<Object> objects;
 
+	/**
+	 * Projected sizes of the bounding sphere of the model on screen, as a
+	 * fraction of the viewport height, below which each level of detail after
+	 * the first is used when rendering, in decreasing order.
+	 *
+	 * Element i is the size below which level i + 1 of
+	 * Object::levelsOfDetail is used. Objects with fewer levels use their
+	 * last level instead. When empty, every instance is rendered at full
+	 * detail.
+	 *
+	 * \sa ModelOptions::levelOfDetailScreenSize
+	 */
+	std::vector<float> levelOfDetailScreenSizes{};
+
 private:
 	friend Renderer;
 
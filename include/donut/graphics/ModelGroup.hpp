@@ -0,0 +1,226 @@
+#ifndef DONUT_GRAPHICS_MODEL_GROUP_HPP
+#define DONUT_GRAPHICS_MODEL_GROUP_HPP
+
+#include <donut/Color.hpp>
+#include <donut/graphics/Buffer.hpp>
+#include <donut/graphics/DirtyRangeSet.hpp>
+#include <donut/graphics/Handle.hpp>
+#include <donut/graphics/Mesh.hpp>
+#include <donut/graphics/Model.hpp>
+#include <donut/graphics/VertexArray.hpp>
+#include <donut/math.hpp>
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+namespace donut::graphics {
+
+/**
+ * Configuration options for a ModelGroup.
+ */
+struct ModelGroupOptions {
+	/**
+	 * Maximum number of unmodified members between two modified ranges of the
+	 * group for the ranges to be coalesced into a single upload.
+	 *
+	 * \sa DirtyRangeSet
+	 */
+	std::size_t mergeDistance = 16;
+
+	/**
+	 * Intended access pattern of the GPU instance buffer, see
+	 * MeshBufferUsage.
+	 */
+	MeshBufferUsage usage = MeshBufferUsage::STATIC_DRAW;
+};
+
+/**
+ * Persistent set of instances of a single Model whose per-instance data is
+ * kept on the GPU between frames, so that the whole set can be drawn with a
+ * single RenderPass command.
+ *
+ * This is meant for large numbers of instances that rarely change, such as
+ * static props in a scene. Unlike individual ModelInstance draws, which copy
+ * and upload the data of every instance every frame, the members of a group
+ * are only uploaded when they are modified, and then only the modified
+ * ranges.
+ *
+ * Modifications are not visible to the GPU until the next call to commit(),
+ * which must be made after modifying the group and before rendering a
+ * RenderPass that draws it.
+ *
+ * \note Since the members are not processed individually when the group is
+ *       drawn, they are not sorted by level of detail. Instead, the whole group
+ *       is drawn at a fixed level, see ModelGroupInstance::levelOfDetail.
+ *
+ * \sa ModelGroupInstance
+ */
+class ModelGroup {
+public:
+	/**
+	 * Attributes of a single member of the group.
+	 */
+	struct Member {
+		mat4 transformation = identity<mat4>(); ///< Transformation matrix to apply to every vertex position of the model, in world space.
+		vec2 textureOffset{0.0f, 0.0f};         ///< Offset to apply to the texture coordinates after scaling them by the textureScale.
+		vec2 textureScale{1.0f, 1.0f};          ///< Coefficients to scale the texture coordinates by.
+		Color tintColor = Color::WHITE;         ///< Tint color to use in the shader.
+		vec3 specularFactor{1.0f, 1.0f, 1.0f};  ///< Specular factor to use in the shader.
+		vec3 emissiveFactor{1.0f, 1.0f, 1.0f};  ///< Emissive factor to use in the shader.
+	};
+
+	/**
+	 * Create an empty group of instances of a model.
+	 *
+	 * \param model model to draw the members of the group as.
+	 * \param options configuration options for the group, see
+	 *        ModelGroupOptions.
+	 *
+	 * \throws graphics::Error on failure to create the GPU buffers or vertex
+	 *         arrays.
+	 * \throws std::invalid_argument if the model has skinned objects, see
+	 *         Model::Object::SkinnedVertex.
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \warning The model must outlive the group, and the meshes of its objects
+	 *          must not be replaced while the group exists, since the group
+	 *          reads the vertices and indices directly from the mesh buffers.
+	 */
+	explicit ModelGroup(const Model& model, const ModelGroupOptions& options = {});
+
+	/**
+	 * Add a new member to the end of the group.
+	 *
+	 * \param member attributes of the new member.
+	 *
+	 * \return the index of the new member.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	std::size_t add(const Member& member);
+
+	/**
+	 * Replace the attributes of a member of the group.
+	 *
+	 * \param index index of the member to modify.
+	 * \param member new attributes of the member.
+	 *
+	 * \throws std::out_of_range if the index is out of range.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	void set(std::size_t index, const Member& member);
+
+	/**
+	 * Change the transformation of a member of the group, such as when it
+	 * moves, while keeping its other attributes.
+	 *
+	 * \param index index of the member to modify.
+	 * \param transformation new transformation matrix of the member.
+	 *
+	 * \throws std::out_of_range if the index is out of range.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	void setTransformation(std::size_t index, const mat4& transformation);
+
+	/**
+	 * Remove a member from the group by moving the last member into its place.
+	 *
+	 * \param index index of the member to remove.
+	 *
+	 * \throws std::out_of_range if the index is out of range.
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note The index of the last member changes to the given index, unless
+	 *       the removed member was the last one.
+	 */
+	void remove(std::size_t index);
+
+	/**
+	 * Remove all members from the group.
+	 */
+	void clear() noexcept;
+
+	/**
+	 * Upload all modifications since the previous commit to the GPU.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note The GPU may have to wait for in-flight rendering commands that
+	 *       read from the group to finish before the upload can take place.
+	 *       This is rarely an issue since groups are meant to be modified
+	 *       infrequently. Use individual ModelInstance draws for instances
+	 *       that change every frame.
+	 *
+	 * \sa isCommitted()
+	 */
+	void commit();
+
+	/**
+	 * Check if all modifications of the group have been uploaded to the GPU.
+	 *
+	 * \return true if the group has not been modified since the previous call
+	 *         to commit(), false otherwise.
+	 *
+	 * \sa commit()
+	 */
+	[[nodiscard]] bool isCommitted() const noexcept {
+		return dirtyInstances.empty();
+	}
+
+	/**
+	 * Get the number of members in the group.
+	 *
+	 * \return the number of members.
+	 */
+	[[nodiscard]] std::size_t size() const noexcept {
+		return instances.size();
+	}
+
+	/**
+	 * Check if the group has no members.
+	 *
+	 * \return true if the group is empty, false otherwise.
+	 */
+	[[nodiscard]] bool empty() const noexcept {
+		return instances.empty();
+	}
+
+	/**
+	 * Get the model that the members of the group are drawn as.
+	 *
+	 * \return a reference to the model that was supplied in the constructor.
+	 */
+	[[nodiscard]] const Model& getModel() const noexcept {
+		return *model;
+	}
+
+	/**
+	 * Get an opaque handle to the GPU representation of the vertex array that
+	 * draws the members of the group as a specific object of the model.
+	 *
+	 * \param objectIndex index of the object in Model::objects.
+	 *
+	 * \return a non-owning resource handle to the GPU representation of the
+	 *         vertex array.
+	 *
+	 * \note This function is used internally by the implementations of various
+	 *       abstractions and is not intended to be used outside of the graphics
+	 *       module. The returned handle has no meaning to application code.
+	 */
+	[[nodiscard]] Handle getVertexArray(std::size_t objectIndex) const noexcept {
+		return vertexArrays[objectIndex].get();
+	}
+
+private:
+	const Model* model;
+	MeshBufferUsage usage;
+	std::vector<Model::Object::Instance> instances{};
+	DirtyRangeSet dirtyInstances;
+	Buffer instanceBuffer{};
+	std::vector<VertexArray> vertexArrays{};
+	std::size_t capacity = 0;
+};
+
+} // namespace donut::graphics
+
+#endif
@@ -5,6 +5,7 @@
 #include <donut/LinearAllocator.hpp>
 #include <donut/LinearBuffer.hpp>
 #include <donut/graphics/Model.hpp>
+#include <donut/graphics/ModelGroup.hpp>
 #include <donut/graphics/Shader2D.hpp>
 #include <donut/graphics/Shader3D.hpp>
 #include <donut/graphics/SpriteAtlas.hpp>
@@ -13,7 +14,7 @@
 #include <donut/graphics/TexturedQuad.hpp>
 #include <donut/math.hpp>
 
-#include <cstddef>     // std::byte
+#include <cstddef>     // std::byte, std::size_t
 #include <span>        // std::span
 #include <string_view> // std::string_view, std::u8string_view
 #include <vector>      // std::vector
@@ -28,6 +29,10 @@ namespace donut::graphics {
  *
  * \note Consecutive 3D instances with the same shader and model will be batched
  *       and rendered together.
+ * \note If the model has multiple levels of detail, each instance is rendered
+ *       at the level selected from the projected size of the model on screen,
+ *       see Model::levelOfDetailScreenSizes. Batched instances are grouped by
+ *       their selected level.
  */
 struct ModelInstance {
 	/**
@@ -133,6 +138,98 @@ struct ModelInstance {
 	 *       to the original emissive map color.
 	 */
 	vec3 emissiveFactor{1.0f, 1.0f, 1.0f};
+
+	/**
+	 * Skinning matrix of each joint of the skeleton that the model is bound
+	 * to, relative to the model space, such as computed by
+	 * computeJointMatrices(). Only used for models with skinned objects, see
+	 * Model::Object::SkinnedVertex.
+	 *
+	 * The matrices are copied into the render pass, so the span only needs to
+	 * remain valid for the duration of the call to RenderPass::draw().
+	 *
+	 * \warning When the model has skinned objects, this span must contain a
+	 *          matrix for every joint that the vertices of the model refer to,
+	 *          and the shader must be one that supports skinning, such as
+	 *          Shader3D::BLINN_PHONG_SKINNED.
+	 */
+	std::span<const mat4> jointMatrices{};
+};
+
+/**
+ * Configuration of a ModelGroup, for drawing all of its members as part of a
+ * RenderPass with a single command.
+ *
+ * Required fields:
+ * - ModelGroupInstance::group
+ *
+ * \note The members of the group are rendered in a single batch per object
+ *       of the model, regardless of any ModelInstance draws of the same model
+ *       around it.
+ */
+struct ModelGroupInstance {
+	/**
+	 * Non-owning pointer the shader to use when rendering the group.
+	 *
+	 * \warning The pointed-to shader must remain valid for the duration of its
+	 *          use in the RenderPass, and must not be nullptr.
+	 */
+	Shader3D* shader = Shader3D::BLINN_PHONG;
+
+	/**
+	 * Non-owning read-only pointer to the group to be drawn.
+	 *
+	 * \warning The pointed-to group must remain valid for the duration of its
+	 *          use in the RenderPass, and must not be nullptr.
+	 * \warning All modifications of the group must have been committed, see
+	 *          ModelGroup::commit(), by the time the RenderPass is rendered.
+	 */
+	const ModelGroup* group;
+
+	/**
+	 * Non-owning pointer to the texture to use for the base color, or nullptr
+	 * to use the original textures specified by the model.
+	 *
+	 * \warning When not nullptr, the pointed-to texture must remain valid for
+	 *          the duration of its use in the RenderPass.
+	 */
+	const Texture* diffuseMapOverride = nullptr;
+
+	/**
+	 * Non-owning pointer to the texture to use for specular highlights, or
+	 * nullptr to use the original textures specified by the model.
+	 *
+	 * \warning When not nullptr, the pointed-to texture must remain valid for
+	 *          the duration of its use in the RenderPass.
+	 */
+	const Texture* specularMapOverride = nullptr;
+
+	/**
+	 * Non-owning pointer to the texture to use for normal mapping, or nullptr
+	 * to use the original textures specified by the model.
+	 *
+	 * \warning When not nullptr, the pointed-to texture must remain valid for
+	 *          the duration of its use in the RenderPass.
+	 */
+	const Texture* normalMapOverride = nullptr;
+
+	/**
+	 * Non-owning pointer to the texture to use for emissive mapping, or nullptr
+	 * to use the original textures specified by the model.
+	 *
+	 * \warning When not nullptr, the pointed-to texture must remain valid for
+	 *          the duration of its use in the RenderPass.
+	 */
+	const Texture* emissiveMapOverride = nullptr;
+
+	/**
+	 * Level of detail to render every member of the group at, where 0 is the
+	 * full detail of the model. Levels beyond the last level of an object
+	 * use its last level.
+	 *
+	 * \sa Model::levelOfDetailScreenSizes
+	 */
+	std::size_t levelOfDetail = 0;
 };
 
 /**
@@ -745,6 +842,18 @@ public:
 	 */
 	RenderPass& draw(const ModelInstance& model);
 
+	/**
+	 * Enqueue a ModelGroupInstance to be drawn when the render pass is
+	 * rendered.
+	 *
+	 * \return `*this`, for chaining.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \sa ModelGroupInstance
+	 */
+	RenderPass& draw(const ModelGroupInstance& group);
+
 	/**
 	 * Enqueue a QuadInstance to be drawn when the render pass is rendered.
 	 *
@@ -873,6 +982,16 @@ private:
 		vec2 textureScale;
 		vec3 specularFactor;
 		vec3 emissiveFactor;
+		std::span<const mat4> jointMatrices;
+	};
+
+	struct CommandDrawModelGroupInstance {
+		const ModelGroup* group;
+		const Texture* diffuseMapOverride;
+		const Texture* specularMapOverride;
+		const Texture* normalMapOverride;
+		const Texture* emissiveMapOverride;
+		std::size_t levelOfDetail;
 	};
 
 	struct CommandDrawQuadInstance {
@@ -941,6 +1060,7 @@ private:
 		CommandUseSpriteAtlas,         //
 		CommandUseFont,                //
 		CommandDrawModelInstance,      //
+		CommandDrawModelGroupInstance, //
 		CommandDrawQuadInstance,       //
 		CommandDrawTextureInstance,    //
 		CommandDrawRectangleInstance,  //
@@ -949,6 +1069,7 @@ private:
 		CommandDrawTextCopyInstance,   //
 		CommandDrawTextStringInstance, //
 		Text::ShapedGlyph[],           //
+		mat4[],                        //
 		char[]>
 		commandBuffer{&memoryResource, memoryResource.getRemainingCapacity()};
 	std::vector<Font*, LinearAllocator<Font*>> fonts{&memoryResource};
@@ -11,9 +11,11 @@
 #include <donut/graphics/Texture.hpp>
 #include <donut/graphics/TexturedQuad.hpp>
 #include <donut/graphics/Viewport.hpp>
+#include <donut/math.hpp>
 #include <donut/shapes.hpp>
 
 #include <optional> // std::optional
+#include <span>     // std::span
 #include <vector>   // std::vector
 
 namespace donut::graphics {
@@ -108,6 +110,10 @@ public:
 	 * \param scissor if set, specifies a rectangular region of the framebuffer
 	 *        outside of which any attempts to render a pixel will be discarded.
 	 *
+	 * \throws graphics::Error on failure to compile a built-in skinned shader,
+	 *         such as Shader3D::BLINN_PHONG_SKINNED, the first time it is used.
+	 * \throws std::bad_alloc on allocation failure.
+	 *
 	 * \note This function should typically be called at least once every frame
 	 *       during the application::Application::display() callback.
 	 */
@@ -115,7 +121,11 @@ public:
 
 private:
 	TexturedQuad texturedQuad{};
-	std::vector<Model::Object::Instance> modelInstances{};
+	std::vector<std::vector<Model::Object::Instance>> modelInstancesPerLevelOfDetail{};
+	std::vector<std::vector<std::span<const mat4>>> modelInstanceJointMatricesPerLevelOfDetail{};
+	std::vector<Model::Object::SkinnedInstance> skinnedModelInstances{};
+	std::vector<mat4> jointMatrixPalette{};
+	Texture jointMatrixTexture{};
 	std::vector<TexturedQuad::Instance> texturedQuadInstances{};
 	Text text{};
 };
@@ -27,9 +27,30 @@ public:
 	/**
 	 * Pointer to a statically allocated string containing the GLSL source code
 	 * for a plain vertex shader.
+	 *
+	 * The vertex positions are mapped to the model space through
+	 * vertexPositionOffset and vertexPositionScale before the instance
+	 * transformation is applied, which custom vertex shaders must also do in
+	 * order to support models with ModelVertexFormat::QUANTIZED vertices.
 	 */
 	static const char* const VERTEX_SHADER_SOURCE_CODE_INSTANCED_MODEL;
 
+	/**
+	 * Pointer to a statically allocated string containing the GLSL source code
+	 * for a vertex shader that deforms skinned meshes, see
+	 * Model::Object::SkinnedVertex.
+	 *
+	 * The joint matrices of all instances in a batch are read from a
+	 * floating-point texture, where each matrix occupies 4 consecutive texels
+	 * of a row, one per column.
+	 *
+	 * \note The normals are transformed by the upper 3x3 part of the blended
+	 *       joint matrix rather than its inverse transpose, which is only
+	 *       correct for joint and model transformations without non-uniform
+	 *       scaling.
+	 */
+	static const char* const VERTEX_SHADER_SOURCE_CODE_SKINNED_MODEL;
+
 	/**
 	 * Pointer to a statically allocated string containing the GLSL source code
 	 * for a fragment shader that uses a fullbright shading model with no
@@ -73,6 +94,32 @@ public:
 	 */
 	static Shader3D* const BLINN_PHONG;
 
+	/**
+	 * Pointer to the statically allocated storage for the built-in unlit
+	 * shader for skinned meshes.
+	 *
+	 * The shader is compiled by the Renderer the first time it is used in a
+	 * render pass, rather than when the renderer is created.
+	 *
+	 * \warning This pointer must not be dereferenced in application code. It is
+	 *          not guaranteed that the underlying shader will be present at all
+	 *          times.
+	 */
+	static Shader3D* const UNLIT_SKINNED;
+
+	/**
+	 * Pointer to the statically allocated storage for the built-in blinn-phong
+	 * shader for skinned meshes.
+	 *
+	 * The shader is compiled by the Renderer the first time it is used in a
+	 * render pass, rather than when the renderer is created.
+	 *
+	 * \warning This pointer must not be dereferenced in application code. It is
+	 *          not guaranteed that the underlying shader will be present at all
+	 *          times.
+	 */
+	static Shader3D* const BLINN_PHONG_SKINNED;
+
 	/**
 	 * Shader configuration that was supplied in the constructor.
 	 */
@@ -165,6 +212,25 @@ public:
 	 */
 	ShaderParameter occlusionFactor{program, "occlusionFactor"};
 
+	/**
+	 * Identifier for the uniform shader variable for the texture unit of the
+	 * joint matrices of skinned meshes.
+	 */
+	ShaderParameter jointMatrices{program, "jointMatrices"};
+
+	/**
+	 * Identifier for the uniform shader variable for the offset to add to the
+	 * scaled vertex positions of the active object, see vertexPositionScale.
+	 */
+	ShaderParameter vertexPositionOffset{program, "vertexPositionOffset"};
+
+	/**
+	 * Identifier for the uniform shader variable for the scale to apply to the
+	 * vertex positions of the active object, which is the size of its bounding
+	 * box for Model::Object::QuantizedVertex and 1 otherwise.
+	 */
+	ShaderParameter vertexPositionScale{program, "vertexPositionScale"};
+
 	/**
 	 * Compile and link a 3D shader program.
 	 *
@@ -185,6 +251,7 @@ private:
 	friend Renderer;
 
 	static void createSharedShaders();
+	static void createSharedShaderOnFirstUse(Shader3D* shader);
 	static void destroySharedShaders() noexcept;
 };
 
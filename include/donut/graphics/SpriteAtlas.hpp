@@ -3,14 +3,19 @@
 
 #include <donut/AtlasPacker.hpp>
 #include <donut/Color.hpp>
+#include <donut/Filesystem.hpp>
 #include <donut/graphics/Image.hpp>
 #include <donut/graphics/Texture.hpp>
 #include <donut/math.hpp>
 
-#include <cassert> // assert
-#include <cstddef> // std::size_t
-#include <cstdint> // std::uint8_t
-#include <vector>  // std::vector
+#include <algorithm>   // std::lower_bound
+#include <cassert>     // assert
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint64_t
+#include <optional>    // std::optional
+#include <span>        // std::span
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
 
 namespace donut::graphics {
 
@@ -69,6 +74,55 @@ public:
 		Flip flip = NO_FLIP; ///< Flags that describe how the sprite should be flipped when rendered.
 	};
 
+	/**
+	 * Description of an image to pack into a baked sprite atlas using bake().
+	 */
+	struct BakeEntry {
+		std::string_view name; ///< Unique name of the sprite, which can be used to look it up using findSprite() after loading the baked atlas.
+		ImageView image;       ///< Non-owning view over the image to copy into the spritesheet. Must have pixel component type PixelComponentType::U8.
+		Flip flip = NO_FLIP;   ///< Flags that describe how the sprite should be flipped when rendered.
+	};
+
+	/**
+	 * Compute the hash of a sprite name, as stored in the sprite table of a
+	 * baked sprite atlas.
+	 *
+	 * \param name name of the sprite.
+	 *
+	 * \return the 64-bit FNV-1a hash of the name.
+	 */
+	[[nodiscard]] static constexpr std::uint64_t hashSpriteName(std::string_view name) noexcept {
+		std::uint64_t hash = 0xCBF29CE484222325ull;
+		for (const char ch : name) {
+			hash ^= static_cast<std::uint8_t>(ch);
+			hash *= 0x100000001B3ull;
+		}
+		return hash;
+	}
+
+	/**
+	 * Pack a set of images into a single atlas image and save it to a PNG file
+	 * together with a binary sprite table, so that the result can be loaded at
+	 * a later time using SpriteAtlas(const Filesystem&, const char*, const char*, const SpriteAtlasOptions&).
+	 *
+	 * This is intended to be run offline, as part of an asset build step, to
+	 * avoid having to decode and pack every individual image at startup.
+	 *
+	 * \param filesystem virtual filesystem to save the files to.
+	 * \param imageFilepath virtual filepath at which to save the atlas image.
+	 * \param spriteTableFilepath virtual filepath at which to save the sprite
+	 *        table.
+	 * \param entries images to pack into the atlas, see BakeEntry. The sprite
+	 *        identifiers of the loaded atlas are assigned in the same order.
+	 *
+	 * \throws File::Error on failure to create or write one of the files.
+	 * \throws graphics::Error if an image does not have pixel component type
+	 *         PixelComponentType::U8, if two entries have the same name hash,
+	 *         or on failure to save the atlas image.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	static void bake(Filesystem& filesystem, const char* imageFilepath, const char* spriteTableFilepath, std::span<const BakeEntry> entries);
+
 	/**
 	 * Construct an empty sprite atlas.
 	 */
@@ -82,6 +136,26 @@ public:
 	explicit SpriteAtlas(const SpriteAtlasOptions& options)
 		: options(options) {}
 
+	/**
+	 * Load a sprite atlas that was baked using bake().
+	 *
+	 * The atlas image is uploaded to the texture atlas in one go, and the
+	 * sprite table is read using a single file read. More sprites can be added
+	 * to the loaded atlas using insert() as usual.
+	 *
+	 * \param filesystem virtual filesystem to load the files from.
+	 * \param imageFilepath virtual filepath of the baked atlas image.
+	 * \param spriteTableFilepath virtual filepath of the baked sprite table.
+	 * \param options sprite atlas options, see SpriteAtlasOptions.
+	 *
+	 * \throws File::Error on failure to open or read one of the files.
+	 * \throws graphics::Error on failure to load the atlas image or to create
+	 *         the texture atlas, or if the sprite table is invalid or does not
+	 *         match the atlas image.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	SpriteAtlas(const Filesystem& filesystem, const char* imageFilepath, const char* spriteTableFilepath, const SpriteAtlasOptions& options = {});
+
 	/**
 	 * Add a new image to the spritesheet, possibly expanding the texture atlas
 	 * in order to make space for it.
@@ -102,7 +176,7 @@ public:
 	 */
 	[[nodiscard]] SpriteId insert(Renderer& renderer, const ImageView& image, Flip flip = NO_FLIP) {
 		const auto [x, y, resized] = atlasPacker.insertRectangle(image.getWidth(), image.getHeight());
-		prepareAtlasTexture(renderer, resized);
+		prepareAtlasTexture(renderer);
 
 		atlasTexture.pasteImage2D(image, x, y);
 
@@ -176,6 +250,28 @@ public:
 		return sprites[id.index];
 	}
 
+	/**
+	 * Look up a sprite that was loaded from a baked sprite atlas by its name.
+	 *
+	 * \param name name of the sprite, as given in BakeEntry::name when the
+	 *        atlas was baked.
+	 *
+	 * \return an identifier for the sprite if it was found, or an empty
+	 *         optional otherwise.
+	 *
+	 * \sa hashSpriteName()
+	 */
+	[[nodiscard]] std::optional<SpriteId> findSprite(std::string_view name) const noexcept {
+		const std::uint64_t nameHash = hashSpriteName(name);
+		if (const auto it = std::lower_bound(sortedSpriteNameHashes.begin(), sortedSpriteNameHashes.end(), nameHash);
+			it != sortedSpriteNameHashes.end() && *it == nameHash) {
+			const std::size_t hashIndex = static_cast<std::size_t>(it - sortedSpriteNameHashes.begin());
+			assert(hashIndex < spriteIndicesSortedByNameHash.size());
+			return SpriteId{spriteIndicesSortedByNameHash[hashIndex]};
+		}
+		return {};
+	}
+
 	/**
 	 * Get a reference to the internal texture atlas.
 	 *
@@ -191,9 +287,9 @@ private:
 	static constexpr std::size_t INITIAL_RESOLUTION = 128;
 	static constexpr std::size_t PADDING = 6;
 
-	void prepareAtlasTexture(Renderer& renderer, bool resized) {
+	void prepareAtlasTexture(Renderer& renderer) {
 		if (atlasTexture) {
-			if (resized) {
+			if (atlasTexture.getWidth() != atlasPacker.getResolution()) {
 				atlasTexture.grow2D(renderer, atlasPacker.getResolution(), atlasPacker.getResolution(), Color::INVISIBLE);
 			}
 		} else {
@@ -210,6 +306,8 @@ private:
 	AtlasPacker<INITIAL_RESOLUTION, PADDING> atlasPacker{};
 	Texture atlasTexture{};
 	std::vector<Sprite> sprites{};
+	std::vector<std::uint64_t> sortedSpriteNameHashes{};
+	std::vector<std::size_t> spriteIndicesSortedByNameHash{};
 	SpriteAtlasOptions options{};
 };
 
@@ -10,6 +10,7 @@
 #include <cstddef>  // std::size_t
 #include <cstdint>  // std::int32_t
 #include <optional> // std::optional
+#include <span>     // std::span
 
 namespace donut::graphics {
 
@@ -286,6 +287,34 @@ public:
 	 */
 	Texture(const ImageView& image, const TextureOptions& options = {});
 
+	/**
+	 * Create a new texture object and allocate GPU memory for storing 2D image
+	 * data loaded from an image, along with a mipmap that was generated in
+	 * advance.
+	 *
+	 * \param image non-owning read-only view over the image to copy into the
+	 *        base level of the new texture data storage. The allocated storage
+	 *        will be sized to fit the image.
+	 * \param mipmap the remaining levels of the mipmap, in order of decreasing
+	 *        size, such as those returned by generateMipmap(). Each level must
+	 *        have the same pixel format and component type as the image.
+	 * \param options texture/sampler options, see TextureOptions. The useMipmap
+	 *        option is ignored, since the mipmap is taken from the mipmap
+	 *        parameter instead of being generated by the graphics driver. It
+	 *        is reported as enabled by getOptions() if the mipmap is not
+	 *        empty.
+	 *
+	 * \throws graphics::Error on failure to create the texture object, or on
+	 *         failure to choose an appropriate internal texel format for the
+	 *         given image.
+	 * \throws std::bad_alloc on allocation failure. Note: this pertains only to
+	 *         CPU memory allocations. Failure to allocate GPU memory for the
+	 *         texture data might not be reported directly.
+	 *
+	 * \sa setMipmapLevel2D()
+	 */
+	Texture(const ImageView& image, std::span<const Image> mipmap, const TextureOptions& options = {});
+
 	/**
 	 * Check if the texture has a value.
 	 *
@@ -363,6 +392,34 @@ public:
 	 */
 	void pasteImage2D(const ImageView& image, std::size_t x, std::size_t y);
 
+	/**
+	 * Allocate GPU memory for a level of the mipmap of the 2D texture and copy
+	 * a 2D image into it.
+	 *
+	 * After this call, the texture is sampled using levels 0 through the given
+	 * level, which allows a mipmap that was generated in advance to be
+	 * uploaded one level at a time, in order, without stalling on a single
+	 * large upload. The texture remains complete after each call.
+	 *
+	 * \param level index of the mipmap level to set, where 1 is the first level
+	 *        after the base level. Must be at most one greater than the
+	 *        highest level that has already been set.
+	 * \param image non-owning read-only view over the image to copy into the
+	 *        mipmap level. Its width and height must be half of those of the
+	 *        previous level, rounded down, but no less than 1.
+	 *
+	 * \warning This function must only be called on textures that are set up to
+	 *          store 2D image data.
+	 *
+	 * \note This enables the useMipmap option of the texture. Calling
+	 *       setOptions2D() afterwards keeps the levels that were set using this
+	 *       function rather than generating a new mipmap, unless the useMipmap
+	 *       option is disabled, which only stops the levels from being sampled.
+	 *
+	 * \sa generateMipmap()
+	 */
+	void setMipmapLevel2D(std::size_t level, const ImageView& image);
+
 	/**
 	 * Copy an array of layers of 2D image data into the 2D array texture at a
 	 * specific position.
@@ -602,6 +659,7 @@ private:
 	std::size_t height = 0;
 	TextureFormat internalFormat = TextureFormat::R8_UNORM;
 	TextureOptions options{};
+	std::size_t mipmapLevelCount = 0;
 };
 
 } // namespace donut::graphics
@@ -0,0 +1,126 @@
+#ifndef DONUT_GRAPHICS_VERTEX_PACKING_HPP
+#define DONUT_GRAPHICS_VERTEX_PACKING_HPP
+
+#include <donut/math.hpp>
+
+#include <algorithm>   // std::clamp, std::max
+#include <cmath>       // std::round
+#include <cstdint>     // std::uint32_t
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::is_signed_v
+
+namespace donut::graphics {
+
+/**
+ * Vertex attribute type that stores a vector of small integers, which the GPU
+ * converts to floating-point values in the range [0, 1] for unsigned component
+ * types or [-1, 1] for signed component types before they are passed to the
+ * vertex shader.
+ *
+ * \tparam T vector type of the stored integers, which must have 2, 3 or 4
+ *         components of type i8, u8, i16 or u16.
+ */
+template <typename T>
+struct Normalized {
+	/**
+	 * Convert a floating-point vector to normalized integers.
+	 *
+	 * \param value vector to convert. Each component is clamped to the range
+	 *        that can be represented before it is rounded to the nearest
+	 *        integer step.
+	 *
+	 * \return the normalized vector.
+	 */
+	[[nodiscard]] static Normalized pack(const vec<T::length(), float>& value) noexcept {
+		Normalized result{};
+		for (length_t i = 0; i < T::length(); ++i) {
+			result.value[i] = static_cast<typename T::value_type>(std::round(std::clamp(value[i], MIN, 1.0f) * MAX));
+		}
+		return result;
+	}
+
+	/**
+	 * Convert the normalized integers back to a floating-point vector, in the
+	 * same way as the GPU does.
+	 *
+	 * \return the floating-point vector.
+	 */
+	[[nodiscard]] vec<T::length(), float> unpack() const noexcept {
+		vec<T::length(), float> result{};
+		for (length_t i = 0; i < T::length(); ++i) {
+			result[i] = std::max(static_cast<float>(value[i]) / MAX, MIN);
+		}
+		return result;
+	}
+
+	T value; ///< Stored integer components.
+
+private:
+	static constexpr float MIN = (std::is_signed_v<typename T::value_type>) ? -1.0f : 0.0f;
+	static constexpr float MAX = static_cast<float>(std::numeric_limits<typename T::value_type>::max());
+};
+
+/**
+ * Vertex attribute type that stores two half-precision floating-point values
+ * packed into 32 bits, which are passed to the vertex shader as a vec2.
+ *
+ * Half-precision values have an 11-bit significand, so they only accurately
+ * represent values close to the range [-1, 1], such as typical texture
+ * coordinates.
+ */
+struct PackedHalf2x16 {
+	/**
+	 * Convert a vector to half precision, rounding to the nearest
+	 * representable values.
+	 *
+	 * \param value vector to convert. Components whose magnitude is too large
+	 *        to be represented are converted to infinity.
+	 *
+	 * \return the packed vector.
+	 */
+	[[nodiscard]] static PackedHalf2x16 pack(vec2 value) noexcept;
+
+	/**
+	 * Convert the packed half-precision values back to a full-precision
+	 * vector.
+	 *
+	 * \return the unpacked vector.
+	 */
+	[[nodiscard]] vec2 unpack() const noexcept;
+
+	std::uint32_t value; ///< Packed bits, where x is stored in the 16 least significant bits.
+};
+
+/**
+ * Vertex attribute type that stores a signed normalized 4D vector packed into
+ * 32 bits, with 10 bits for each of x, y and z and 2 bits for w, which is
+ * passed to the vertex shader as a vec4.
+ *
+ * This has enough precision for unit direction vectors such as normals and
+ * tangents, while the w component can only represent the values -1, 0 and 1.
+ */
+struct PackedSnorm3x10_1x2 {
+	/**
+	 * Convert a vector to packed signed normalized integers.
+	 *
+	 * \param value vector to convert. Each component is clamped to the range
+	 *        [-1, 1] before it is rounded to the nearest integer step.
+	 *
+	 * \return the packed vector.
+	 */
+	[[nodiscard]] static PackedSnorm3x10_1x2 pack(vec4 value) noexcept;
+
+	/**
+	 * Convert the packed integers back to a floating-point vector, in the same
+	 * way as the GPU does.
+	 *
+	 * \return the unpacked vector.
+	 */
+	[[nodiscard]] vec4 unpack() const noexcept;
+
+	std::uint32_t value; ///< Packed bits, where x is stored in the 10 least significant bits and w in the 2 most significant bits.
+};
+
+} // namespace donut::graphics
+
+#endif
@@ -1,38 +1,47 @@
 #ifndef DONUT_JSON_HPP
 #define DONUT_JSON_HPP
 
+#include <donut/LinearAllocator.hpp>
 #include <donut/Variant.hpp>
 #include <donut/reflection.hpp>
 #include <donut/unicode.hpp>
 
-#include <algorithm>        // std::sort, std::equal_range, std::lower_bound, std::upper_bound
+#include <algorithm>        // std::stable_sort, std::inplace_merge, std::binary_search, std::equal_range, std::lower_bound, std::upper_bound, std::rotate, std::unique, std::find_if, std::count_if, std::max
 #include <array>            // std::array
-#include <charconv>         // std::from_chars_result, std::from_chars
-#include <cmath>            // std::isnan, std::isinf, std::signbit
+#include <bit>              // std::countr_zero, std::bit_cast, std::bit_ceil
+#include <charconv>         // std::from_chars_result, std::from_chars, std::to_chars_result, std::to_chars
+#include <cmath>            // std::isnan, std::isinf, std::isfinite, std::signbit, std::abs, std::ldexp
 #include <compare>          // std::partial_ordering, std::compare_partial_order_fallback
-#include <cstddef>          // std::size_t, std::nullptr_t
-#include <cstdint>          // std::uint8_t, std::uint32_t
+#include <cstddef>          // std::size_t, std::ptrdiff_t, std::nullptr_t, std::byte
+#include <cstdint>          // std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t, std::int64_t
 #include <cstdlib>          // std::strtoull, std::strtod
 #include <cstring>          // std::memcpy
-#include <fmt/format.h>     // fmt::format_to
 #include <initializer_list> // std::initializer_list
 #include <istream>          // std::istream
-#include <iterator>         // std::begin, std::end, std::istreambuf_iterator, std::ostreambuf_iterator
+#include <iterator>         // std::begin, std::end, std::size, std::prev, std::next, std::make_move_iterator, std::istreambuf_iterator
 #include <limits>           // std::numeric_limits
+#include <memory>           // std::uninitialized_copy
 #include <numeric>          // std::accumulate
 #include <optional>         // std::optional
-#include <ostream>          // std::ostream
+#include <ostream>          // std::ostream, std::streamsize
 #include <span>             // std::span, std::as_bytes
-#include <sstream>          // std::istringstream, std::ostringstream
-#include <stdexcept>        // std::runtime_error, std::out_of_range
+#include <stdexcept>        // std::runtime_error, std::out_of_range, std::invalid_argument
 #include <string>           // std::...string
 #include <string_view>      // std::...string_view
 #include <system_error>     // std::errc
-#include <tuple>            // std::forward_as_tuple
+#include <tuple>            // std::forward_as_tuple, std::get
 #include <type_traits>      // std::is_same_v, std::is_arithmetic_v, std::is_pointer_v, std::is_aggregate_v, std::is_constructible_v, std::remove_cvref_t
-#include <utility>          // std::pair, std::move, std::forward, std::piecewise_construct
+#include <utility>          // std::pair, std::move, std::forward, std::piecewise_construct, std::in_place_type, std::index_sequence, std::make_index_sequence
 #include <vector>           // std::vector, std::erase(std::vector), std::erase_if(std::vector)
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DONUT_JSON_SSE2
+#include <emmintrin.h> // __m128i, _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8, _mm_or_si128, _mm_movemask_epi8
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define DONUT_JSON_NEON
+#include <arm_neon.h> // uint8x16_t, vld1q_u8, vdupq_n_u8, vceqq_u8, vcgeq_u8, vorrq_u8, vmaxvq_u8, vminvq_u8
+#endif
+
 namespace donut::json {
 
 namespace detail {
@@ -95,6 +104,35 @@ struct Error : std::runtime_error {
 		, source(source) {}
 };
 
+/**
+ * Encoding of serialized JSON values.
+ */
+enum class Format : std::uint8_t {
+	/**
+	 * Human-readable JSON text. Input may use any JSON5 features.
+	 */
+	JSON,
+
+	/**
+	 * Concise Binary Object Representation, as specified by RFC 8949.
+	 *
+	 * The encoded data model is the same as that of JSON, so any value that
+	 * can be serialized to or deserialized from JSON text can also be
+	 * serialized to or deserialized from CBOR, using the same Serializer and
+	 * Deserializer implementations. The result is typically considerably
+	 * smaller and faster to read and write than the equivalent JSON text.
+	 *
+	 * Numbers that are exact integers are encoded as CBOR integers, and all
+	 * other numbers are encoded as single-precision floats when that is
+	 * lossless, and as double-precision floats otherwise. Input may use any
+	 * CBOR features, except that tags are ignored, and that byte strings and
+	 * undefined values are read as strings and null values respectively.
+	 *
+	 * \sa CBORParser
+	 */
+	CBOR,
+};
+
 /**
  * Options for JSON serialization.
  */
@@ -163,12 +201,24 @@ struct SerializationOptions {
 	 * \warning Must not be set to nullptr.
 	 */
 	const char* newlineString = "\r\n";
+
+	/**
+	 * Encoding to write the output in.
+	 *
+	 * \note All other options only apply to the JSON format.
+	 */
+	Format format = Format::JSON;
 };
 
 /**
  * Options for JSON deserialization.
  */
-struct DeserializationOptions {};
+struct DeserializationOptions {
+	/**
+	 * Encoding to read the input as.
+	 */
+	Format format = Format::JSON;
+};
 
 // Forward declaration of the definition below, so that Object and Array can contain objects of type Value through indirection, despite Value being defined in terms of them.
 class Value;
@@ -247,7 +297,10 @@ public:
 	[[nodiscard]] bool empty() const noexcept;
 	[[nodiscard]] size_type size() const noexcept;
 	[[nodiscard]] size_type max_size() const noexcept;
+	[[nodiscard]] size_type capacity() const noexcept;
 
+	void reserve(size_type newCap);
+	void shrink_to_fit();
 	void clear() noexcept;
 
 	template <typename P>
@@ -670,6 +723,184 @@ public:
 	return codePoint == '\n' || codePoint == '\r' || codePoint == 0x2028 || codePoint == 0x2029;
 }
 
+namespace detail {
+
+// Broadcast a byte to every byte of a 64-bit word, and check if any byte of a word is zero, for scanning 8 code units at a time without SIMD.
+[[nodiscard]] constexpr std::uint64_t broadcastByte(std::uint8_t byte) noexcept {
+	return std::uint64_t{0x0101010101010101} * byte;
+}
+
+[[nodiscard]] constexpr bool hasZeroByte(std::uint64_t word) noexcept {
+	return ((word - broadcastByte(0x01)) & ~word & broadcastByte(0x80)) != 0;
+}
+
+// Find the end of a run of code units that can be copied verbatim into a string token, i.e. the first occurrence of the quote character, a
+// backslash, a line feed, a carriage return or the first code unit of a multi-byte code point, or the end of the input if there is none.
+[[nodiscard]] inline const char8_t* findEndOfPlainStringRun(const char8_t* first, const char8_t* last, char8_t quoteCharacter) noexcept {
+#if defined(DONUT_JSON_SSE2)
+	const __m128i quotes = _mm_set1_epi8(static_cast<char>(quoteCharacter));
+	const __m128i backslashes = _mm_set1_epi8('\\');
+	const __m128i lineFeeds = _mm_set1_epi8('\n');
+	const __m128i carriageReturns = _mm_set1_epi8('\r');
+	while (last - first >= 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		const __m128i specialCharacters = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quotes), _mm_cmpeq_epi8(block, backslashes)),
+			_mm_or_si128(_mm_cmpeq_epi8(block, lineFeeds), _mm_cmpeq_epi8(block, carriageReturns)));
+		// The high bit of each byte is set for special characters as well as for non-ASCII code units, so both are found by the same mask.
+		if (const int mask = _mm_movemask_epi8(_mm_or_si128(specialCharacters, block)); mask != 0) {
+			return first + std::countr_zero(static_cast<unsigned>(mask));
+		}
+		first += 16;
+	}
+#elif defined(DONUT_JSON_NEON)
+	const uint8x16_t quotes = vdupq_n_u8(quoteCharacter);
+	const uint8x16_t backslashes = vdupq_n_u8('\\');
+	const uint8x16_t lineFeeds = vdupq_n_u8('\n');
+	const uint8x16_t carriageReturns = vdupq_n_u8('\r');
+	const uint8x16_t nonASCII = vdupq_n_u8(0x80);
+	while (last - first >= 16) {
+		const uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(first));
+		const uint8x16_t specialCharacters = vorrq_u8(vorrq_u8(vceqq_u8(block, quotes), vceqq_u8(block, backslashes)),
+			vorrq_u8(vorrq_u8(vceqq_u8(block, lineFeeds), vceqq_u8(block, carriageReturns)), vcgeq_u8(block, nonASCII)));
+		if (vmaxvq_u8(specialCharacters) != 0) {
+			break;
+		}
+		first += 16;
+	}
+#else
+	while (last - first >= 8) {
+		std::uint64_t word{};
+		std::memcpy(&word, first, sizeof(word));
+		if (hasZeroByte(word ^ broadcastByte(quoteCharacter)) || hasZeroByte(word ^ broadcastByte('\\')) || hasZeroByte(word ^ broadcastByte('\n')) ||
+			hasZeroByte(word ^ broadcastByte('\r')) || (word & broadcastByte(0x80)) != 0) {
+			break;
+		}
+		first += 8;
+	}
+#endif
+	while (first != last && *first < 0x80 && *first != quoteCharacter && *first != '\\' && *first != '\n' && *first != '\r') {
+		++first;
+	}
+	return first;
+}
+
+// Find the end of a run of spaces and tabs, which make up the indentation of pretty-printed JSON.
+[[nodiscard]] inline const char8_t* findEndOfSpaceRun(const char8_t* first, const char8_t* last) noexcept {
+#if defined(DONUT_JSON_SSE2)
+	const __m128i spaces = _mm_set1_epi8(' ');
+	const __m128i tabs = _mm_set1_epi8('\t');
+	while (last - first >= 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		if (const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, spaces), _mm_cmpeq_epi8(block, tabs))); mask != 0xFFFF) {
+			return first + std::countr_zero(static_cast<unsigned>(~mask));
+		}
+		first += 16;
+	}
+#elif defined(DONUT_JSON_NEON)
+	const uint8x16_t spaces = vdupq_n_u8(' ');
+	const uint8x16_t tabs = vdupq_n_u8('\t');
+	while (last - first >= 16) {
+		const uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(first));
+		if (vminvq_u8(vorrq_u8(vceqq_u8(block, spaces), vceqq_u8(block, tabs))) == 0) {
+			break;
+		}
+		first += 16;
+	}
+#endif
+	while (first != last && (*first == ' ' || *first == '\t')) {
+		++first;
+	}
+	return first;
+}
+
+// Find the next code unit that matters when skipping over the raw contents of an array or object, i.e. a bracket, a quote character, a slash,
+// a line feed, a carriage return or the first code unit of a multi-byte code point, or the end of the input if there is none.
+[[nodiscard]] inline const char8_t* findNextStructuralCharacter(const char8_t* first, const char8_t* last) noexcept {
+#if defined(DONUT_JSON_SSE2)
+	const __m128i caseBits = _mm_set1_epi8(0x20);
+	const __m128i openBrackets = _mm_set1_epi8('{');
+	const __m128i closeBrackets = _mm_set1_epi8('}');
+	const __m128i doubleQuotes = _mm_set1_epi8('\"');
+	const __m128i singleQuotes = _mm_set1_epi8('\'');
+	const __m128i slashes = _mm_set1_epi8('/');
+	const __m128i lineFeeds = _mm_set1_epi8('\n');
+	const __m128i carriageReturns = _mm_set1_epi8('\r');
+	while (last - first >= 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		// Square brackets only differ from curly braces by a single bit, so both kinds are found by the same comparison.
+		const __m128i foldedBlock = _mm_or_si128(block, caseBits);
+		const __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(foldedBlock, openBrackets), _mm_cmpeq_epi8(foldedBlock, closeBrackets));
+		const __m128i quotes = _mm_or_si128(_mm_cmpeq_epi8(block, doubleQuotes), _mm_cmpeq_epi8(block, singleQuotes));
+		const __m128i lineTerminators = _mm_or_si128(_mm_cmpeq_epi8(block, lineFeeds), _mm_cmpeq_epi8(block, carriageReturns));
+		const __m128i specialCharacters = _mm_or_si128(_mm_or_si128(brackets, quotes), _mm_or_si128(_mm_cmpeq_epi8(block, slashes), lineTerminators));
+		if (const int mask = _mm_movemask_epi8(_mm_or_si128(specialCharacters, block)); mask != 0) {
+			return first + std::countr_zero(static_cast<unsigned>(mask));
+		}
+		first += 16;
+	}
+#elif defined(DONUT_JSON_NEON)
+	const uint8x16_t caseBits = vdupq_n_u8(0x20);
+	const uint8x16_t openBrackets = vdupq_n_u8('{');
+	const uint8x16_t closeBrackets = vdupq_n_u8('}');
+	const uint8x16_t doubleQuotes = vdupq_n_u8('\"');
+	const uint8x16_t singleQuotes = vdupq_n_u8('\'');
+	const uint8x16_t slashes = vdupq_n_u8('/');
+	const uint8x16_t lineFeeds = vdupq_n_u8('\n');
+	const uint8x16_t carriageReturns = vdupq_n_u8('\r');
+	const uint8x16_t nonASCII = vdupq_n_u8(0x80);
+	while (last - first >= 16) {
+		const uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(first));
+		const uint8x16_t foldedBlock = vorrq_u8(block, caseBits);
+		const uint8x16_t brackets = vorrq_u8(vceqq_u8(foldedBlock, openBrackets), vceqq_u8(foldedBlock, closeBrackets));
+		const uint8x16_t quotes = vorrq_u8(vceqq_u8(block, doubleQuotes), vceqq_u8(block, singleQuotes));
+		const uint8x16_t lineTerminators = vorrq_u8(vceqq_u8(block, lineFeeds), vceqq_u8(block, carriageReturns));
+		const uint8x16_t specialCharacters = vorrq_u8(vorrq_u8(brackets, quotes), vorrq_u8(vorrq_u8(vceqq_u8(block, slashes), lineTerminators), vcgeq_u8(block, nonASCII)));
+		if (vmaxvq_u8(specialCharacters) != 0) {
+			break;
+		}
+		first += 16;
+	}
+#else
+	while (last - first >= 8) {
+		std::uint64_t word{};
+		std::memcpy(&word, first, sizeof(word));
+		const std::uint64_t foldedWord = word | broadcastByte(0x20);
+		if (hasZeroByte(foldedWord ^ broadcastByte('{')) || hasZeroByte(foldedWord ^ broadcastByte('}')) || hasZeroByte(word ^ broadcastByte('\"')) ||
+			hasZeroByte(word ^ broadcastByte('\'')) || hasZeroByte(word ^ broadcastByte('/')) || hasZeroByte(word ^ broadcastByte('\n')) ||
+			hasZeroByte(word ^ broadcastByte('\r')) || (word & broadcastByte(0x80)) != 0) {
+			break;
+		}
+		first += 8;
+	}
+#endif
+	while (first != last && *first < 0x80 && (*first | 0x20) != '{' && (*first | 0x20) != '}' && *first != '\"' && *first != '\'' && *first != '/' && *first != '\n' &&
+		   *first != '\r') {
+		++first;
+	}
+	return first;
+}
+
+// Major types and additional information values of CBOR data items, see RFC 8949.
+inline constexpr std::uint8_t CBOR_UNSIGNED_INTEGER = 0;
+inline constexpr std::uint8_t CBOR_NEGATIVE_INTEGER = 1;
+inline constexpr std::uint8_t CBOR_BYTE_STRING = 2;
+inline constexpr std::uint8_t CBOR_TEXT_STRING = 3;
+inline constexpr std::uint8_t CBOR_ARRAY = 4;
+inline constexpr std::uint8_t CBOR_MAP = 5;
+inline constexpr std::uint8_t CBOR_TAG = 6;
+inline constexpr std::uint8_t CBOR_SIMPLE = 7;
+inline constexpr std::uint8_t CBOR_FALSE = 20;
+inline constexpr std::uint8_t CBOR_TRUE = 21;
+inline constexpr std::uint8_t CBOR_NULL = 22;
+inline constexpr std::uint8_t CBOR_UNDEFINED = 23;
+inline constexpr std::uint8_t CBOR_HALF_PRECISION_FLOAT = 25;
+inline constexpr std::uint8_t CBOR_SINGLE_PRECISION_FLOAT = 26;
+inline constexpr std::uint8_t CBOR_DOUBLE_PRECISION_FLOAT = 27;
+inline constexpr std::uint8_t CBOR_INDEFINITE = 31;
+inline constexpr std::uint8_t CBOR_BREAK = 0xFF;
+
+} // namespace detail
+
 /**
  * Type of a scanned JSON5 token.
  */
@@ -700,9 +931,10 @@ enum class TokenType : std::uint8_t {
  * Token data scanned from JSON.
  */
 struct Token {
-	String string;         ///< Scanned string.
-	SourceLocation source; ///< Location of the scanned string in the JSON source string.
-	TokenType type;        ///< Scanned token type.
+	String string;                     ///< Scanned string.
+	SourceLocation source;             ///< Location of the scanned string in the JSON source string.
+	TokenType type;                    ///< Scanned token type.
+	std::string_view borrowedString{}; ///< Scanned string as a view over the JSON source string, if borrowed. See Lexer::setStringBorrowing().
 };
 
 /**
@@ -729,6 +961,72 @@ public:
 		, end(end)
 		, source(source) {}
 
+	/**
+	 * Enable or disable borrowing of strings from the contiguous input.
+	 *
+	 * When enabled, scanned string literals that don't contain any escape
+	 * sequences are not copied. Instead, they are returned as a view over the
+	 * input through Token::borrowedString, and Token::string is left empty.
+	 *
+	 * \param enabled true to borrow strings, false to copy them.
+	 *
+	 * \warning Parser functions that return strings, such as
+	 *          Parser::parseString(), expect strings to be copied. This option
+	 *          is meant for consumers that read the tokens directly.
+	 */
+	void setStringBorrowing(bool enabled) noexcept requires(std::is_same_v<It, const char8_t*>) {
+		borrowStrings = enabled;
+	}
+
+	/**
+	 * Skip the rest of an array or object whose opening bracket was the last
+	 * scanned token, up to and including its matching closing bracket,
+	 * without scanning the tokens in between.
+	 *
+	 * This is much faster than scanning every token of the skipped value,
+	 * since the input only has to be searched for brackets, strings and
+	 * comments. However, the skipped contents are not validated beyond that.
+	 *
+	 * \throws json::Error if the input ends before the matching closing
+	 *         bracket.
+	 */
+	void skipContainerContents() requires(std::is_same_v<It, const char8_t*>) {
+		const char8_t* position = it.base();
+		const char8_t* const inputEnd = it.baseEnd();
+		std::size_t depth = 1;
+		while (true) {
+			const char8_t* const runEnd = detail::findNextStructuralCharacter(position, inputEnd);
+			source.columnNumber += static_cast<std::size_t>(runEnd - position);
+			position = runEnd;
+			if (position == inputEnd) {
+				break;
+			}
+			switch (*position) {
+				case '[': [[fallthrough]];
+				case '{':
+					++depth;
+					++source.columnNumber;
+					++position;
+					break;
+				case ']': [[fallthrough]];
+				case '}':
+					++source.columnNumber;
+					++position;
+					if (--depth == 0) {
+						seek(position);
+						return;
+					}
+					break;
+				case '\"': [[fallthrough]];
+				case '\'': position = skipRawString(position, inputEnd); break;
+				case '/': position = skipRawComment(position, inputEnd); break;
+				default: position = skipRawCodePoint(position, inputEnd); break;
+			}
+		}
+		seek(position);
+		throw Error{"Missing end of array or object.", source};
+	}
+
 	/**
 	 * Scan and consume the next token from the input.
 	 *
@@ -772,8 +1070,18 @@ public:
 	}
 
 private:
+	// Contiguous input can be scanned directly through the underlying pointer, which allows runs of plain ASCII characters to be consumed in bulk
+	// rather than being decoded one code point at a time.
+	static constexpr bool CONTIGUOUS = std::is_same_v<It, const char8_t*>;
+
 	void skipWhitespace() {
 		while (!hasReachedEnd()) {
+			if constexpr (CONTIGUOUS) {
+				skipASCIIWhitespaceRun();
+				if (hasReachedEnd()) {
+					break;
+				}
+			}
 			if (isWhitespaceCharacter(peek())) {
 				if (isLineTerminatorCharacter(peek())) {
 					skipLineTerminatorSequence();
@@ -832,32 +1140,188 @@ private:
 	}
 
 	void advance() {
-		if (!currentCodePoint) {
+		if constexpr (CONTIGUOUS) {
 			++it;
+		} else {
+			if (!currentCodePoint) {
+				++it;
+			}
+			currentCodePoint.reset();
 		}
-		currentCodePoint.reset();
 		++source.columnNumber;
 	}
 
 	[[nodiscard]] bool hasReachedEnd() const noexcept {
-		return it == end && !currentCodePoint;
+		if constexpr (CONTIGUOUS) {
+			return it == end;
+		} else {
+			return it == end && !currentCodePoint;
+		}
 	}
 
 	[[nodiscard]] char32_t peek() const {
-		if (!currentCodePoint) {
-			currentCodePoint = *it++;
+		if constexpr (CONTIGUOUS) {
+			return *it;
+		} else {
+			if (!currentCodePoint) {
+				currentCodePoint = *it++;
+			}
+			return *currentCodePoint;
 		}
-		return *currentCodePoint;
 	}
 
 	[[nodiscard]] std::optional<char32_t> lookahead() const {
-		if (!currentCodePoint) {
-			currentCodePoint = *it++;
+		if constexpr (CONTIGUOUS) {
+			if (unicode::UTF8Iterator<It> next = it; ++next != end) {
+				return *next;
+			}
+			return {};
+		} else {
+			if (!currentCodePoint) {
+				currentCodePoint = *it++;
+			}
+			if (it != end) {
+				return *it;
+			}
+			return {};
 		}
-		if (it != end) {
-			return *it;
+	}
+
+	void seek(const char8_t* position) requires(CONTIGUOUS) {
+		it = unicode::UTF8Iterator<It>{position, it.baseEnd()};
+	}
+
+	// Skip a run of ASCII whitespace, which covers the indentation and line breaks of practically all JSON documents.
+	void skipASCIIWhitespaceRun() requires(CONTIGUOUS) {
+		const char8_t* const runBegin = it.base();
+		const char8_t* const runEnd = it.baseEnd();
+		const char8_t* position = runBegin;
+		while (position != runEnd) {
+			if (*position == ' ' || *position == '\t') {
+				const char8_t* const spaceRunEnd = detail::findEndOfSpaceRun(position, runEnd);
+				source.columnNumber += static_cast<std::size_t>(spaceRunEnd - position);
+				position = spaceRunEnd;
+			} else if (*position == '\v' || *position == '\f') {
+				++source.columnNumber;
+				++position;
+			} else if (*position == '\n' || *position == '\r') {
+				if (*position == '\r' && position + 1 != runEnd && position[1] == '\n') {
+					++position;
+				}
+				++position;
+				++source.lineNumber;
+				source.columnNumber = 1;
+			} else {
+				break;
+			}
+		}
+		if (position != runBegin) {
+			seek(position);
+		}
+	}
+
+	// Append a run of plain ASCII string contents in one go, stopping at anything that needs special treatment, i.e. the closing quote, escape
+	// sequences, line terminators and multi-byte code points. The run is found with SIMD instructions where available.
+	void appendPlainStringRun(String& output, char32_t quoteCharacter) requires(CONTIGUOUS) {
+		const char8_t* const runBegin = it.base();
+		const char8_t* const position = detail::findEndOfPlainStringRun(runBegin, it.baseEnd(), static_cast<char8_t>(quoteCharacter));
+		if (position != runBegin) {
+			const auto length = static_cast<std::size_t>(position - runBegin);
+			output.append(reinterpret_cast<const char*>(runBegin), length);
+			source.columnNumber += length;
+			seek(position);
+		}
+	}
+
+	void appendDecimalDigitRun(String& output) requires(CONTIGUOUS) {
+		const char8_t* const runBegin = it.base();
+		const char8_t* const runEnd = it.baseEnd();
+		const char8_t* position = runBegin;
+		while (position != runEnd && *position >= '0' && *position <= '9') {
+			++position;
+		}
+		if (position != runBegin) {
+			const auto length = static_cast<std::size_t>(position - runBegin);
+			output.append(reinterpret_cast<const char*>(runBegin), length);
+			source.columnNumber += length;
+			seek(position);
+		}
+	}
+
+	// Skip a single code point of raw input without decoding it, while keeping track of line terminators for the source location.
+	[[nodiscard]] const char8_t* skipRawCodePoint(const char8_t* position, const char8_t* inputEnd) noexcept requires(CONTIGUOUS) {
+		if (*position == '\n' || *position == '\r') {
+			if (*position == '\r' && position + 1 != inputEnd && position[1] == '\n') {
+				++position;
+			}
+			++source.lineNumber;
+			source.columnNumber = 1;
+			return position + 1;
+		}
+		if (*position == 0xE2 && inputEnd - position >= 3 && position[1] == 0x80 && (position[2] == 0xA8 || position[2] == 0xA9)) {
+			++source.lineNumber;
+			source.columnNumber = 1;
+			return position + 3;
+		}
+		++source.columnNumber;
+		do {
+			++position;
+		} while (position != inputEnd && (*position & 0xC0) == 0x80);
+		return position;
+	}
+
+	[[nodiscard]] const char8_t* skipRawString(const char8_t* position, const char8_t* inputEnd) requires(CONTIGUOUS) {
+		const char8_t quoteCharacter = *position;
+		++source.columnNumber;
+		++position;
+		while (true) {
+			const char8_t* const runEnd = detail::findEndOfPlainStringRun(position, inputEnd, quoteCharacter);
+			source.columnNumber += static_cast<std::size_t>(runEnd - position);
+			position = runEnd;
+			if (position == inputEnd) {
+				throw Error{"Missing end of string quote character.", source};
+			}
+			if (*position == quoteCharacter) {
+				++source.columnNumber;
+				return position + 1;
+			}
+			if (*position == '\n' || *position == '\r') {
+				throw Error{"Unexpected line terminator in string.", source};
+			}
+			if (*position == '\\') {
+				++source.columnNumber;
+				++position;
+				if (position == inputEnd) {
+					throw Error{"Empty escape sequence.", source};
+				}
+			}
+			position = skipRawCodePoint(position, inputEnd);
+		}
+	}
+
+	[[nodiscard]] const char8_t* skipRawComment(const char8_t* position, const char8_t* inputEnd) requires(CONTIGUOUS) {
+		if (inputEnd - position < 2 || (position[1] != '/' && position[1] != '*')) {
+			throw Error{"Invalid token.", source};
+		}
+		const bool lineComment = position[1] == '/';
+		source.columnNumber += 2;
+		position += 2;
+		while (position != inputEnd) {
+			if (lineComment) {
+				const std::size_t lineNumber = source.lineNumber;
+				position = skipRawCodePoint(position, inputEnd);
+				if (source.lineNumber != lineNumber) {
+					break;
+				}
+			} else if (*position == '*' && position + 1 != inputEnd && position[1] == '/') {
+				source.columnNumber += 2;
+				position += 2;
+				break;
+			} else {
+				position = skipRawCodePoint(position, inputEnd);
+			}
 		}
-		return {};
+		return position;
 	}
 
 	[[nodiscard]] Token scanPunctuator() {
@@ -882,7 +1346,30 @@ private:
 		String string{};
 		const SourceLocation stringSource = source;
 		advance();
+		if constexpr (CONTIGUOUS) {
+			if (borrowStrings) {
+				const char8_t* const runBegin = it.base();
+				const char8_t* const runEnd = detail::findEndOfPlainStringRun(runBegin, it.baseEnd(), static_cast<char8_t>(quoteCharacter));
+				if (runEnd != it.baseEnd() && *runEnd == quoteCharacter) {
+					const auto length = static_cast<std::size_t>(runEnd - runBegin);
+					source.columnNumber += length + 1;
+					seek(runEnd + 1);
+					return {
+						.string{},
+						.source = stringSource,
+						.type = TokenType::STRING,
+						.borrowedString{reinterpret_cast<const char*>(runBegin), length},
+					};
+				}
+			}
+		}
 		while (!hasReachedEnd()) {
+			if constexpr (CONTIGUOUS) {
+				appendPlainStringRun(string, quoteCharacter);
+				if (hasReachedEnd()) {
+					break;
+				}
+			}
 			if (!unicode::isValidCodePoint(peek())) {
 				throw Error{"Invalid UTF-8.", source};
 			}
@@ -928,16 +1415,19 @@ private:
 				case '8': [[fallthrough]];
 				case '9': scanNumericEscapeSequence(string, 1, 3, 8, [](char32_t codePoint) noexcept -> bool { return (codePoint >= '0' && codePoint <= '7'); }); continue;
 				case 'x':
+					advance();
 					scanNumericEscapeSequence(string, 2, 2, 16, [](char32_t codePoint) noexcept -> bool {
 						return (codePoint >= '0' && codePoint <= '9') || (codePoint >= 'a' && codePoint <= 'f') || (codePoint >= 'A' && codePoint <= 'F');
 					});
 					continue;
 				case 'u':
+					advance();
 					scanNumericEscapeSequence(string, 4, 4, 16, [](char32_t codePoint) noexcept -> bool {
 						return (codePoint >= '0' && codePoint <= '9') || (codePoint >= 'a' && codePoint <= 'f') || (codePoint >= 'A' && codePoint <= 'F');
 					});
 					continue;
 				case 'U':
+					advance();
 					scanNumericEscapeSequence(string, 8, 8, 16, [](char32_t codePoint) noexcept -> bool {
 						return (codePoint >= '0' && codePoint <= '9') || (codePoint >= 'a' && codePoint <= 'f') || (codePoint >= 'A' && codePoint <= 'F');
 					});
@@ -998,6 +1488,14 @@ private:
 		bool eNotation = false;
 		bool fraction = false;
 		while (!hasReachedEnd()) {
+			if constexpr (CONTIGUOUS) {
+				if (type == TokenType::NUMBER_DECIMAL) {
+					appendDecimalDigitRun(string);
+					if (hasReachedEnd()) {
+						break;
+					}
+				}
+			}
 			if (peek() == '.') {
 				if (lookahead() == '.') {
 					break;
@@ -1119,6 +1617,7 @@ private:
 	unicode::UTF8Sentinel end;
 	SourceLocation source;
 	mutable std::optional<char32_t> currentCodePoint{};
+	bool borrowStrings = false;
 };
 
 /**
@@ -1355,7 +1854,7 @@ public:
 		void visitString(const SourceLocation& source, String&& value) override { (void)source; (void)std::move(value); }
 		void visitNumber(const SourceLocation& source, Number value) override { (void)source; (void)value; }
 		void visitObject(const SourceLocation& source, Parser& parser) override { (void)source; parser.parseObject(SkipPropertyVisitor{}); }
-		void visitArray(const SourceLocation& source, Parser& parser) override { (void)source; parser.parseValue(SkipValueVisitor{}); }
+		void visitArray(const SourceLocation& source, Parser& parser) override { (void)source; parser.parseArray(SkipValueVisitor{}); }
 		// clang-format on
 	};
 
@@ -1889,17 +2388,20 @@ public:
 		switch (token.type) {
 			case TokenType::PUNCTUATOR_OPEN_CURLY_BRACE: {
 				struct Visitor final : PropertyVisitor {
-					Object& result;
+					std::vector<Object::value_type>& members;
 
-					explicit Visitor(Object& result) noexcept
-						: result(result) {}
+					explicit Visitor(std::vector<Object::value_type>& members) noexcept
+						: members(members) {}
 
 					void visitProperty(const SourceLocation&, String&& key, Parser& parser) override {
-						result.emplace(std::move(key), std::move(parser.parseValue()));
+						members.emplace_back(std::move(key), parser.parseValue());
 					}
 				};
+				// Build the object in bulk once all of its members are known, since inserting them one by one would take quadratic time.
+				std::vector<Object::value_type> members{};
+				parseObject(Visitor{members});
 				Object result{};
-				parseObject(Visitor{result});
+				result.insert(std::make_move_iterator(members.begin()), std::make_move_iterator(members.end()));
 				return result;
 			}
 			default: break;
@@ -2010,11 +2512,19 @@ private:
 		char* const numberStringEnd = token.string.data() + token.string.size();
 		char* endPointer = numberStringEnd;
 		if (radix == 10) {
-			const double number_value = std::strtod(numberStringBegin, &endPointer);
+			// Numbers whose magnitude is out of range are left to strtod, which rounds them to infinity or zero rather than failing.
+			Number numberValue{};
+			if (const std::from_chars_result parseResult = std::from_chars(numberStringBegin, numberStringEnd, numberValue); parseResult.ec != std::errc::result_out_of_range) {
+				if (parseResult.ec != std::errc{} || parseResult.ptr != numberStringEnd) {
+					throw Error{"Invalid number.", token.source};
+				}
+				return numberValue;
+			}
+			numberValue = std::strtod(numberStringBegin, &endPointer);
 			if (endPointer != numberStringEnd) {
 				throw Error{"Invalid number.", token.source};
 			}
-			return Number{number_value};
+			return numberValue;
 		}
 		bool negative = false;
 		if (!token.string.empty() && token.string.front() == '-') {
@@ -2043,81 +2553,1118 @@ using StringParser = Parser<const char8_t*>;
  */
 using StreamParser = Parser<std::istreambuf_iterator<char>>;
 
-namespace detail {
+// Forward declarations of the definitions below, so that DocumentObject and DocumentArray can refer to values of type DocumentValue.
+class DocumentValue;
+struct DocumentMember;
 
-template <typename T, typename ObjectPropertyFilter = detail::AlwaysTrue, typename ArrayItemFilter = detail::AlwaysTrue>
-[[nodiscard]] std::size_t getRecursiveSize(const T& value, ObjectPropertyFilter objectPropertyFilter, ArrayItemFilter arrayItemFilter);
+/**
+ * Read-only view over the members of a JSON object in a Document, sorted by
+ * name.
+ *
+ * Like Object, only the first of any members with duplicate names in the
+ * source is kept.
+ */
+class DocumentObject {
+public:
+	using value_type = DocumentMember;
+	using size_type = std::size_t;
+	using const_iterator = const DocumentMember*;
+	using iterator = const_iterator;
 
-} // namespace detail
+	DocumentObject() noexcept = default;
+
+	DocumentObject(const DocumentMember* members, size_type memberCount) noexcept
+		: members(members)
+		, memberCount(memberCount) {}
+
+	[[nodiscard]] const DocumentValue& at(std::string_view name) const;
+	[[nodiscard]] const_iterator begin() const noexcept;
+	[[nodiscard]] const_iterator end() const noexcept;
+	[[nodiscard]] bool empty() const noexcept;
+	[[nodiscard]] size_type size() const noexcept;
+	[[nodiscard]] bool contains(std::string_view name) const noexcept;
+	[[nodiscard]] const_iterator find(std::string_view name) const noexcept;
+
+private:
+	const DocumentMember* members = nullptr;
+	size_type memberCount = 0;
+};
 
 /**
- * Base template to specialize in order to implement JSON serialization for a
- * specific type.
- *
- * The specialization should have a member function with one of the following
- * signatures:
- * ```
- * void serialize(Writer& writer, const T& value)
- * void serialize(Writer& writer, T value)
- * ```
- * where T is the specialized template type parameter.
- *
- * The implementation should write the output using the provided Writer.
- *
- * \tparam T the type that this serializer serializes.
+ * Read-only view over the items of a JSON array in a Document.
  */
-template <typename T>
-struct Serializer;
+class DocumentArray {
+public:
+	using value_type = DocumentValue;
+	using size_type = std::size_t;
+	using const_iterator = const DocumentValue*;
+	using iterator = const_iterator;
+
+	DocumentArray() noexcept = default;
+
+	DocumentArray(const DocumentValue* items, size_type itemCount) noexcept
+		: items(items)
+		, itemCount(itemCount) {}
+
+	[[nodiscard]] const DocumentValue& at(size_type pos) const;
+	[[nodiscard]] const DocumentValue& operator[](size_type pos) const;
+	[[nodiscard]] const_iterator begin() const noexcept;
+	[[nodiscard]] const_iterator end() const noexcept;
+	[[nodiscard]] bool empty() const noexcept;
+	[[nodiscard]] size_type size() const noexcept;
+
+private:
+	const DocumentValue* items = nullptr;
+	size_type itemCount = 0;
+};
 
 /**
- * Base template to specialize in order to implement JSON deserialization for a
- * specific type.
+ * Read-only JSON value in a Document.
  *
- * The specialization should have a member function with the following
- * signature:
- * ```
- * void deserialize(Reader& reader, T& value)
- * ```
- * where T is the specialized template type parameter.
- *
- * The implementation should read the input using the provided Reader.
+ * Unlike Value, it doesn't own any of its contents. Strings and containers
+ * instead refer to memory owned by the document, or to the JSON source string
+ * that the document was parsed from, which makes the value trivially copyable
+ * and destructible.
  *
- * \tparam T the type that this deserializer deserializes.
+ * The value has one of the following types:
+ * - Null
+ * - Boolean
+ * - std::string_view
+ * - Number
+ * - DocumentObject
+ * - DocumentArray
  */
-template <typename T>
-struct Deserializer;
+class DocumentValue : public Variant<Null, Boolean, std::string_view, Number, DocumentObject, DocumentArray> {
+public:
+	using Variant::Variant;
+
+	/**
+	 * Make an owning copy of the value and all of its contents.
+	 *
+	 * \return the copied value.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] Value toValue() const;
+};
 
 /**
- * Serialize a value of any JSON-serializable type to an output stream.
- *
- * \param stream stream to write the output to.
- * \param value value to serialize.
- * \param options serialization options, see SerializationOptions.
- *
- * \throws Error on failure to serialize the value.
- * \throws std::ios_base::failure if thrown by the output stream.
- * \throws std::bad_alloc on allocation failure.
- * \throws any exception thrown by a user-defined implementation of Serializer,
- *         if one is used in the serialization of the given value type.
- *
- * \note Serialization of user-defined types can be defined by implementing a
- *       specialization of the Serializer template.
+ * Member of a DocumentObject.
  */
-template <typename T>
-void serialize(std::ostream& stream, const T& value, const SerializationOptions& options = {});
+struct DocumentMember {
+	std::string_view name; ///< Name of the member.
+	DocumentValue value;   ///< Value of the member.
+};
 
 /**
- * Deserialize a value of any JSON-serializable type from an input stream.
+ * Read-only JSON document, as an alternative to Value for large documents
+ * that only need to be read.
  *
- * \param stream stream to read the input from.
- * \param value value to deserialize to.
- * \param options deserialization options, see DeserializationOptions.
+ * Rather than making a separate heap allocation for every string, object and
+ * array, the document allocates all of its contents from a single linear
+ * memory arena, which is then released all at once when the document is
+ * destroyed. Strings that don't contain any escape sequences are not copied
+ * at all, but instead refer directly to the JSON source string.
  *
- * \throws Error on failure to parse the value from the stream.
- * \throws std::ios_base::failure if thrown by the input stream.
- * \throws std::bad_alloc on allocation failure.
- * \throws any exception thrown by a user-defined implementation of
- *         Deserializer, if one is used in the deserialization of the given
+ * \warning The JSON source string must outlive the document.
+ */
+class Document {
+public:
+	/**
+	 * Parse a document from a UTF-8 JSON string.
+	 *
+	 * The parser supports JSON5 features such as comments, unquoted identifiers
+	 * and trailing commas.
+	 *
+	 * \param jsonString read-only view over the JSON string to parse the
+	 *        document from. Must outlive the document.
+	 * \param initialMemory memory for the arena to use before it starts
+	 *        allocating from the heap, such as a buffer that is reused for
+	 *        every document that is parsed in a frame, or an empty span to
+	 *        always allocate from the heap. Must outlive the document.
+	 *
+	 * \throws Error on failure to parse a JSON value.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	explicit Document(std::u8string_view jsonString, std::span<std::byte> initialMemory = {})
+		: memoryResource(initialMemory) {
+		parse(jsonString);
+	}
+
+	/**
+	 * Parse a document from a JSON string of bytes, interpreted as UTF-8.
+	 *
+	 * The parser supports JSON5 features such as comments, unquoted identifiers
+	 * and trailing commas.
+	 *
+	 * \param jsonString read-only view over the JSON string to parse the
+	 *        document from. Must outlive the document.
+	 * \param initialMemory memory for the arena to use before it starts
+	 *        allocating from the heap, such as a buffer that is reused for
+	 *        every document that is parsed in a frame, or an empty span to
+	 *        always allocate from the heap. Must outlive the document.
+	 *
+	 * \throws Error on failure to parse a JSON value.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	explicit Document(std::string_view jsonString, std::span<std::byte> initialMemory = {})
+		: Document(std::u8string_view{reinterpret_cast<const char8_t*>(jsonString.data()), jsonString.size()}, initialMemory) {}
+
+	/**
+	 * Get the top-level value of the document.
+	 *
+	 * \return a read-only reference to the root value, which is valid for the
+	 *         lifetime of the document.
+	 */
+	[[nodiscard]] const DocumentValue& getRoot() const noexcept {
+		return root;
+	}
+
+private:
+	struct Scratch {
+		std::vector<DocumentValue> items{};
+		std::vector<DocumentMember> members{};
+	};
+
+	void parse(std::u8string_view jsonString);
+	[[nodiscard]] DocumentValue parseValue(StringParser& parser, Scratch& scratch);
+	[[nodiscard]] DocumentObject parseObject(StringParser& parser, Scratch& scratch);
+	[[nodiscard]] DocumentArray parseArray(StringParser& parser, Scratch& scratch);
+	[[nodiscard]] std::string_view makeString(Token&& token);
+
+	template <typename T>
+	[[nodiscard]] const T* copyToArena(std::span<const T> values) {
+		T* const result = LinearAllocator<T>{&memoryResource}.allocate(values.size());
+		std::uninitialized_copy(values.begin(), values.end(), result);
+		return result;
+	}
+
+	LinearMemoryResource memoryResource;
+	DocumentValue root{};
+};
+
+/**
+ * Read-only cursor for navigating a contiguous JSON string on demand, without
+ * parsing the parts of it that aren't needed.
+ *
+ * A cursor refers to a single value in the JSON string, starting with the
+ * top-level value. Navigating to a member of an object or an item of an array
+ * produces a new cursor, which is found by scanning the tokens of the
+ * enclosing object or array up to the requested value, while the contents of
+ * all nested objects and arrays along the way are skipped using a fast
+ * bracket-matching search. The value itself is only parsed when it is
+ * requested through get().
+ *
+ * This is much faster than parsing a whole Value when only a few values from
+ * a large document are needed, such as:
+ * \code
+ * const json::Cursor root{jsonString};
+ * const double number = root["a"]["b"][3].get<json::Number>();
+ * \endcode
+ *
+ * Cursors are cheap to copy and don't modify each other, so any number of
+ * values can be read from the same cursor. However, every navigation scans
+ * the input from the position of the cursor that it is performed on, so
+ * reading many members of an object is more efficiently done with
+ * forEachMember() than with repeated calls to at().
+ *
+ * \note Since the input is only parsed on demand, syntax errors are only
+ *       reported when they are encountered while navigating to or reading a
+ *       value, and errors within skipped objects and arrays are not detected
+ *       beyond mismatched brackets, strings and comments.
+ *
+ * \warning The JSON source string must outlive the cursor and all cursors
+ *          derived from it.
+ */
+class Cursor {
+public:
+	/**
+	 * Create a cursor at the top-level value of a UTF-8 JSON string.
+	 *
+	 * \param jsonString read-only view over the JSON string to navigate. Must
+	 *        outlive the cursor.
+	 */
+	explicit Cursor(std::u8string_view jsonString)
+		: Cursor(Lexer<const char8_t*>{unicode::UTF8View{jsonString}.begin(), unicode::UTF8Sentinel{}, SourceLocation{.lineNumber = 1, .columnNumber = 1}}) {}
+
+	/**
+	 * Create a cursor at the top-level value of a JSON string of bytes,
+	 * interpreted as UTF-8.
+	 *
+	 * \param jsonString read-only view over the JSON string to navigate. Must
+	 *        outlive the cursor.
+	 */
+	explicit Cursor(std::string_view jsonString)
+		: Cursor(std::u8string_view{reinterpret_cast<const char8_t*>(jsonString.data()), jsonString.size()}) {}
+
+	/**
+	 * Navigate to a member of the object at the cursor.
+	 *
+	 * \param name name of the member to find. If the object has multiple
+	 *        members with the same name, the first one is used.
+	 *
+	 * \return a cursor at the value of the member, if found, otherwise an
+	 *         empty optional.
+	 *
+	 * \throws json::Error if the value at the cursor is not an object, or on
+	 *         invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] std::optional<Cursor> find(std::string_view name) const;
+
+	/**
+	 * Navigate to a member of the object at the cursor.
+	 *
+	 * \param name name of the member to find. If the object has multiple
+	 *        members with the same name, the first one is used.
+	 *
+	 * \return a cursor at the value of the member.
+	 *
+	 * \throws json::Error if the value at the cursor is not an object, or on
+	 *         invalid input.
+	 * \throws std::out_of_range if the object has no member with the given
+	 *         name.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] Cursor at(std::string_view name) const;
+
+	/**
+	 * Navigate to an item of the array at the cursor.
+	 *
+	 * \param index index of the item to find.
+	 *
+	 * \return a cursor at the item, if the index is in range, otherwise an
+	 *         empty optional.
+	 *
+	 * \throws json::Error if the value at the cursor is not an array, or on
+	 *         invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] std::optional<Cursor> find(std::size_t index) const;
+
+	/**
+	 * Navigate to an item of the array at the cursor.
+	 *
+	 * \param index index of the item to find.
+	 *
+	 * \return a cursor at the item.
+	 *
+	 * \throws json::Error if the value at the cursor is not an array, or on
+	 *         invalid input.
+	 * \throws std::out_of_range if the index is out of range.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] Cursor at(std::size_t index) const;
+
+	/**
+	 * Navigate to a member of the object at the cursor.
+	 *
+	 * \sa at(std::string_view) const
+	 */
+	[[nodiscard]] Cursor operator[](std::string_view name) const {
+		return at(name);
+	}
+
+	/**
+	 * Navigate to an item of the array at the cursor.
+	 *
+	 * \sa at(std::size_t) const
+	 */
+	[[nodiscard]] Cursor operator[](std::size_t index) const {
+		return at(index);
+	}
+
+	/**
+	 * Check the type of the value at the cursor.
+	 *
+	 * \tparam T the type to check for. Must be one of Null, Boolean, String,
+	 *         Number, Object or Array.
+	 *
+	 * \return true if the value has type T, false otherwise.
+	 *
+	 * \throws json::Error on invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	template <typename T>
+	[[nodiscard]] bool is() const {
+		const TokenType type = scanToken().type;
+		if constexpr (std::is_same_v<T, Null>) {
+			return type == TokenType::IDENTIFIER_NULL;
+		} else if constexpr (std::is_same_v<T, Boolean>) {
+			return type == TokenType::IDENTIFIER_FALSE || type == TokenType::IDENTIFIER_TRUE;
+		} else if constexpr (std::is_same_v<T, String>) {
+			return type == TokenType::STRING;
+		} else if constexpr (std::is_same_v<T, Number>) {
+			return type >= TokenType::NUMBER_BINARY && type <= TokenType::NUMBER_NEGATIVE_NAN;
+		} else if constexpr (std::is_same_v<T, Object>) {
+			return type == TokenType::PUNCTUATOR_OPEN_CURLY_BRACE;
+		} else {
+			static_assert(std::is_same_v<T, Array>, "Unsupported JSON value type.");
+			return type == TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET;
+		}
+	}
+
+	/**
+	 * Parse the value at the cursor.
+	 *
+	 * \tparam T the type of value to parse. Must be one of Null, Boolean,
+	 *         String, Number, Object, Array or Value. Objects, arrays and
+	 *         values are parsed in full, including all of their contents.
+	 *
+	 * \return the parsed value.
+	 *
+	 * \throws json::Error if the value doesn't have type T, or on invalid
+	 *         input.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	template <typename T>
+	[[nodiscard]] T get() const {
+		StringParser parser{lexer};
+		if constexpr (std::is_same_v<T, Null>) {
+			return parser.parseNull();
+		} else if constexpr (std::is_same_v<T, Boolean>) {
+			return parser.parseBoolean();
+		} else if constexpr (std::is_same_v<T, String>) {
+			return parser.parseString();
+		} else if constexpr (std::is_same_v<T, Number>) {
+			return parser.parseNumber();
+		} else if constexpr (std::is_same_v<T, Object>) {
+			return parser.parseObject();
+		} else if constexpr (std::is_same_v<T, Array>) {
+			return parser.parseArray();
+		} else {
+			static_assert(std::is_same_v<T, Value>, "Unsupported JSON value type.");
+			return parser.parseValue();
+		}
+	}
+
+	/**
+	 * Visit each member of the object at the cursor, in order of appearance.
+	 *
+	 * \param callback function to call with the name of each member, as a
+	 *        std::string_view that is valid for the duration of the call, and
+	 *        a cursor at its value.
+	 *
+	 * \throws json::Error if the value at the cursor is not an object, or on
+	 *         invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws any exception thrown by the callback.
+	 */
+	template <typename Callback>
+	void forEachMember(Callback callback) const {
+		Lexer<const char8_t*> memberLexer = makeNavigationLexer();
+		if (const Token token = memberLexer.scan(); token.type != TokenType::PUNCTUATOR_OPEN_CURLY_BRACE) {
+			throw Error{"Expected an object.", token.source};
+		}
+		while (true) {
+			const Token name = scanPropertyName(memberLexer);
+			if (name.type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+				break;
+			}
+			callback(std::string_view{(name.string.empty()) ? name.borrowedString : std::string_view{name.string}}, Cursor{memberLexer});
+			skipValue(memberLexer, memberLexer.scan());
+			if (!scanSeparator(memberLexer, TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE)) {
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Visit each item of the array at the cursor, in order.
+	 *
+	 * \param callback function to call with a cursor at each item.
+	 *
+	 * \throws json::Error if the value at the cursor is not an array, or on
+	 *         invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws any exception thrown by the callback.
+	 */
+	template <typename Callback>
+	void forEachItem(Callback callback) const {
+		Lexer<const char8_t*> itemLexer = makeNavigationLexer();
+		if (const Token token = itemLexer.scan(); token.type != TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
+			throw Error{"Expected an array.", token.source};
+		}
+		while (true) {
+			const Lexer<const char8_t*> itemStart = itemLexer;
+			const Token token = itemLexer.scan();
+			if (token.type == TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+				break;
+			}
+			callback(Cursor{itemStart});
+			skipValue(itemLexer, token);
+			if (!scanSeparator(itemLexer, TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET)) {
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Get the location of the value at the cursor in the JSON source string.
+	 *
+	 * \return the source location of the first token of the value.
+	 *
+	 * \throws json::Error on invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] SourceLocation getSourceLocation() const {
+		return scanToken().source;
+	}
+
+private:
+	explicit Cursor(Lexer<const char8_t*> lexer) noexcept
+		: lexer(std::move(lexer)) {
+		this->lexer.setStringBorrowing(false);
+	}
+
+	[[nodiscard]] Lexer<const char8_t*> makeNavigationLexer() const noexcept {
+		Lexer<const char8_t*> result = lexer;
+		result.setStringBorrowing(true);
+		return result;
+	}
+
+	[[nodiscard]] Token scanToken() const {
+		Lexer<const char8_t*> tokenLexer = makeNavigationLexer();
+		return tokenLexer.scan();
+	}
+
+	// Scan the name of the next member of an object as well as the colon after it, or the closing brace at the end of the object.
+	[[nodiscard]] static Token scanPropertyName(Lexer<const char8_t*>& lexer);
+
+	// Scan the comma after a member or item, and return false instead if the container ends with the given closing bracket.
+	[[nodiscard]] static bool scanSeparator(Lexer<const char8_t*>& lexer, TokenType closingBracket);
+
+	// Skip the rest of a value whose first token has already been scanned.
+	static void skipValue(Lexer<const char8_t*>& lexer, const Token& token);
+
+	Lexer<const char8_t*> lexer;
+};
+
+/**
+ * Configuration options for an IncrementalParser.
+ */
+struct IncrementalParserOptions {
+	/**
+	 * Accept any number of consecutive top-level values, such as the lines of
+	 * a newline-delimited JSON log, instead of exactly one.
+	 */
+	bool multipleTopLevelValues = false;
+};
+
+/**
+ * Push-style parser for JSON5 input that arrives in chunks, such as from a
+ * network socket or a decompression stream.
+ *
+ * Unlike Parser, which pulls its input from an iterator and therefore has to
+ * block until more input is available, an incremental parser is given each
+ * chunk of input as it arrives, and reports the parsed values as a sequence of
+ * events to an EventVisitor. Chunks may be split anywhere, including in the
+ * middle of a token or a multi-byte character, in which case parsing of the
+ * incomplete token is suspended until the rest of it arrives:
+ * \code
+ * json::IncrementalParser parser{visitor};
+ * while (const std::size_t size = socket.receive(buffer)) {
+ *     parser.parse(std::string_view{buffer.data(), size});
+ * }
+ * parser.finish();
+ * \endcode
+ *
+ * Only the incomplete token at the end of the latest chunk and the kinds of
+ * the enclosing objects and arrays are kept between chunks, so the memory
+ * usage does not depend on the total size of the input.
+ *
+ * \note If any exception is thrown, the parser is left in an unspecified
+ *       state, and must not be used for any further parsing.
+ */
+class IncrementalParser {
+public:
+	/**
+	 * Polymorphic interface for the parsing events of an IncrementalParser.
+	 *
+	 * Values of type Null, Boolean, String and Number are reported through the
+	 * callbacks inherited from StringParser::ValueVisitor, which throw an
+	 * error by default. The inherited callbacks for objects and arrays are
+	 * never called. Instead, each object or array is reported as a begin
+	 * event, followed by the events of each of its property names and values
+	 * or items, followed by an end event.
+	 */
+	class EventVisitor : public StringParser::ValueVisitor {
+	public:
+		/**
+		 * Callback for the beginning of an object.
+		 *
+		 * \param source location of the opening curly brace.
+		 *
+		 * \throws json::Error on invalid input.
+		 * \throws any exception thrown by the concrete implementation.
+		 */
+		virtual void visitObjectBegin(const SourceLocation& source) {
+			throw Error{"Unexpected object.", source};
+		}
+
+		/**
+		 * Callback for the name of a property of the current object, which is
+		 * followed by the events of its value. Does nothing by default.
+		 *
+		 * \param source location of the property name.
+		 * \param name parsed property name.
+		 *
+		 * \throws json::Error on invalid input.
+		 * \throws any exception thrown by the concrete implementation.
+		 */
+		virtual void visitPropertyName(const SourceLocation& source, String&& name) {
+			(void)source;
+			(void)std::move(name);
+		}
+
+		/**
+		 * Callback for the end of the current object. Does nothing by default.
+		 *
+		 * \param source location of the closing curly brace.
+		 *
+		 * \throws json::Error on invalid input.
+		 * \throws any exception thrown by the concrete implementation.
+		 */
+		virtual void visitObjectEnd(const SourceLocation& source) {
+			(void)source;
+		}
+
+		/**
+		 * Callback for the beginning of an array.
+		 *
+		 * \param source location of the opening square bracket.
+		 *
+		 * \throws json::Error on invalid input.
+		 * \throws any exception thrown by the concrete implementation.
+		 */
+		virtual void visitArrayBegin(const SourceLocation& source) {
+			throw Error{"Unexpected array.", source};
+		}
+
+		/**
+		 * Callback for the end of the current array. Does nothing by default.
+		 *
+		 * \param source location of the closing square bracket.
+		 *
+		 * \throws json::Error on invalid input.
+		 * \throws any exception thrown by the concrete implementation.
+		 */
+		virtual void visitArrayEnd(const SourceLocation& source) {
+			(void)source;
+		}
+
+	protected:
+		~EventVisitor() = default;
+	};
+
+	/**
+	 * Create a parser at the beginning of a new input.
+	 *
+	 * \param visitor visitor to report the parsing events to. Must outlive
+	 *        the parser.
+	 * \param options configuration options for the parser, see
+	 *        IncrementalParserOptions.
+	 */
+	explicit IncrementalParser(EventVisitor& visitor, const IncrementalParserOptions& options = {}) noexcept
+		: visitor(&visitor)
+		, options(options) {}
+
+	/**
+	 * Parse the next chunk of UTF-8 input and report the events of all tokens
+	 * that are completed by it.
+	 *
+	 * \param chunk read-only view over the next part of the input. Only needs
+	 *        to stay valid for the duration of the call.
+	 *
+	 * \throws json::Error on invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws any exception thrown by the visitor.
+	 */
+	void parse(std::u8string_view chunk) {
+		buffer.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+		parseBufferedTokens(scanTokenBoundaries());
+	}
+
+	/**
+	 * Parse the next chunk of input bytes, interpreted as UTF-8, and report the
+	 * events of all tokens that are completed by it.
+	 *
+	 * \param chunk read-only view over the next part of the input. Only needs
+	 *        to stay valid for the duration of the call.
+	 *
+	 * \throws json::Error on invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws any exception thrown by the visitor.
+	 */
+	void parse(std::string_view chunk) {
+		buffer.append(chunk);
+		parseBufferedTokens(scanTokenBoundaries());
+	}
+
+	/**
+	 * Signal the end of the input, report the events of any remaining tokens,
+	 * and make sure that the input was complete.
+	 *
+	 * Afterwards, the parser is reset to the beginning of a new input.
+	 *
+	 * \throws json::Error on invalid or incomplete input.
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws any exception thrown by the visitor.
+	 */
+	void finish();
+
+	/**
+	 * Get the location in the input up to which all tokens have been parsed.
+	 *
+	 * \return the source location after the last parsed token.
+	 */
+	[[nodiscard]] const SourceLocation& getSourceLocation() const noexcept {
+		return source;
+	}
+
+private:
+	enum class State : std::uint8_t {
+		VALUE,
+		END,
+		OBJECT_PROPERTY_NAME_OR_END,
+		OBJECT_COLON,
+		OBJECT_VALUE,
+		OBJECT_COMMA_OR_END,
+		ARRAY_ITEM_OR_END,
+		ARRAY_COMMA_OR_END,
+	};
+
+	enum class ScanState : std::uint8_t {
+		NEUTRAL,
+		WORD,
+		STRING,
+		STRING_ESCAPE,
+		SLASH,
+		LINE_COMMENT,
+		BLOCK_COMMENT,
+		BLOCK_COMMENT_STAR,
+	};
+
+	// Continue scanning the buffered input for the boundaries between tokens, and return the length of the longest prefix of the buffer that
+	// ends on a boundary, which is everything up to the last token that might still be continued by the next chunk.
+	[[nodiscard]] std::size_t scanTokenBoundaries() noexcept;
+
+	// Parse the tokens of a prefix of the buffered input that ends on a token boundary, and remove it from the buffer.
+	void parseBufferedTokens(std::size_t size);
+
+	void parseToken(StringParser& parser);
+	void parseValueToken(StringParser& parser);
+	void parseContainerEnd(StringParser& parser);
+	void completeValue() noexcept;
+
+	EventVisitor* visitor;
+	IncrementalParserOptions options;
+	String buffer{};
+	std::size_t scanOffset = 0;
+	std::size_t boundary = 0;
+	SourceLocation source{.lineNumber = 1, .columnNumber = 1};
+	std::vector<TokenType> closingBrackets{};
+	State state = State::VALUE;
+	ScanState scanState = ScanState::NEUTRAL;
+	char quote = '\0';
+};
+
+/**
+ * Configuration options for evaluating a Query over a batch of documents.
+ */
+struct QueryBatchOptions {
+	/**
+	 * Maximum number of threads to evaluate the query with, including the
+	 * calling thread, or 0 to use the number of concurrent threads supported
+	 * by the hardware.
+	 *
+	 * When more than one thread is used, the documents are split into
+	 * contiguous ranges of roughly equal size, which are evaluated in
+	 * parallel.
+	 */
+	std::size_t threadCount = 1;
+};
+
+/**
+ * Precompiled path to a set of values within JSON documents, for extracting
+ * the same values from many documents with the same structure.
+ *
+ * The path is given either as a JSON Pointer, as specified by RFC 6901, or as
+ * a simpler sequence of member names and array indices separated by dots:
+ * \code
+ * const json::Query kills{"players.*.stats.kills"};
+ * for (const json::Value& document : documents) {
+ *     kills.forEachMatch(document, [&](const json::Value& value) { total += value.get<json::Number>(); });
+ * }
+ * \endcode
+ *
+ * Each step of the path selects a member of an object by name or an item of
+ * an array by index. A step that consists of only a single asterisk (*) is a
+ * wildcard, which selects every member of an object or every item of an
+ * array. Steps that select nothing, such as a member name that doesn't exist
+ * or a step into a value that is not an object or array, don't produce any
+ * matches, rather than being treated as errors.
+ *
+ * The path is split and unescaped only once, when the query is constructed,
+ * and every step that is a valid array index is converted to an integer up
+ * front, so that evaluating the query only has to look up each step.
+ *
+ * \note Since a single asterisk is always a wildcard, members whose name is
+ *       exactly "*" can only be selected through a wildcard.
+ */
+class Query {
+public:
+	/**
+	 * Compile a query from a path string.
+	 *
+	 * \param path JSON Pointer, which must be empty or begin with a slash (/),
+	 *        or a dot-separated path, which must not begin with a slash. An
+	 *        empty string selects the top-level value itself.
+	 *
+	 * \throws std::invalid_argument if the path is a JSON Pointer with an
+	 *         invalid escape sequence.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	explicit Query(std::string_view path);
+
+	/**
+	 * Visit every value that matches the query in a value tree, in order of
+	 * the members and items that lead to it.
+	 *
+	 * \param root top-level value to evaluate the query on.
+	 * \param callback function to call with a read-only reference to each
+	 *        matching value.
+	 *
+	 * \throws any exception thrown by the callback.
+	 */
+	template <typename Callback>
+	void forEachMatch(const Value& root, Callback callback) const {
+		forEachMatch(root, 0, callback);
+	}
+
+	/**
+	 * Visit every value that matches the query in a contiguous JSON string,
+	 * without parsing the parts of it that aren't needed.
+	 *
+	 * \param root cursor at the top-level value to evaluate the query on.
+	 * \param callback function to call with a cursor at each matching value.
+	 *
+	 * \throws json::Error on invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws any exception thrown by the callback.
+	 *
+	 * \sa Cursor
+	 */
+	template <typename Callback>
+	void forEachMatch(const Cursor& root, Callback callback) const {
+		forEachMatch(root, 0, callback);
+	}
+
+	/**
+	 * Find the first value that matches the query in a value tree.
+	 *
+	 * \param root top-level value to evaluate the query on.
+	 *
+	 * \return a read-only pointer to the first matching value, or nullptr if
+	 *         there is no match.
+	 */
+	[[nodiscard]] const Value* find(const Value& root) const noexcept;
+
+	/**
+	 * Find all values that match the query in a value tree.
+	 *
+	 * \param root top-level value to evaluate the query on.
+	 *
+	 * \return read-only pointers to the matching values, in the order of
+	 *         forEachMatch().
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] std::vector<const Value*> findAll(const Value& root) const;
+
+	/**
+	 * Find all values that match the query in a contiguous JSON string.
+	 *
+	 * \param root cursor at the top-level value to evaluate the query on.
+	 *
+	 * \return cursors at the matching values, in the order of forEachMatch().
+	 *
+	 * \throws json::Error on invalid input.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] std::vector<Cursor> findAll(const Cursor& root) const;
+
+	/**
+	 * Find all values that match the query in each of a batch of value trees,
+	 * optionally using multiple threads.
+	 *
+	 * \param documents top-level values to evaluate the query on. Must not be
+	 *        modified until the function returns.
+	 * \param options configuration options for the evaluation, see
+	 *        QueryBatchOptions.
+	 *
+	 * \return the result of findAll() for each document, in the same order as
+	 *         the documents.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws std::system_error on failure to start a thread.
+	 */
+	[[nodiscard]] std::vector<std::vector<const Value*>> findAllInBatch(std::span<const Value> documents, const QueryBatchOptions& options = {}) const;
+
+	/**
+	 * Find all values that match the query in each of a batch of contiguous
+	 * JSON strings, optionally using multiple threads.
+	 *
+	 * \param documents cursors at the top-level values to evaluate the query
+	 *        on.
+	 * \param options configuration options for the evaluation, see
+	 *        QueryBatchOptions.
+	 *
+	 * \return the result of findAll() for each document, in the same order as
+	 *         the documents.
+	 *
+	 * \throws json::Error on invalid input in any of the documents.
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws std::system_error on failure to start a thread.
+	 */
+	[[nodiscard]] std::vector<std::vector<Cursor>> findAllInBatch(std::span<const Cursor> documents, const QueryBatchOptions& options = {}) const;
+
+private:
+	static constexpr std::size_t NO_INDEX = std::numeric_limits<std::size_t>::max();
+
+	struct Step {
+		String name{};
+		std::size_t index = NO_INDEX;
+		bool wildcard = false;
+	};
+
+	// Add a step for a single segment of the path, whose escape sequences, if any, have already been replaced.
+	void addStep(String&& name);
+
+	template <typename Callback>
+	void forEachMatch(const Value& value, std::size_t stepIndex, Callback& callback) const {
+		if (stepIndex == steps.size()) {
+			callback(value);
+			return;
+		}
+		const Step& step = steps[stepIndex];
+		if (value.is<Object>()) {
+			const Object& object = value.as<Object>();
+			if (step.wildcard) {
+				for (const auto& [name, member] : object) {
+					forEachMatch(member, stepIndex + 1, callback);
+				}
+			} else if (const Object::const_iterator it = object.find(step.name); it != object.end()) {
+				forEachMatch(it->second, stepIndex + 1, callback);
+			}
+		} else if (value.is<Array>()) {
+			const Array& array = value.as<Array>();
+			if (step.wildcard) {
+				for (const Value& item : array) {
+					forEachMatch(item, stepIndex + 1, callback);
+				}
+			} else if (step.index < array.size()) {
+				forEachMatch(array[step.index], stepIndex + 1, callback);
+			}
+		}
+	}
+
+	template <typename Callback>
+	void forEachMatch(const Cursor& cursor, std::size_t stepIndex, Callback& callback) const {
+		if (stepIndex == steps.size()) {
+			callback(cursor);
+			return;
+		}
+		const Step& step = steps[stepIndex];
+		if (cursor.is<Object>()) {
+			if (step.wildcard) {
+				cursor.forEachMember([&](std::string_view, const Cursor& member) -> void { forEachMatch(member, stepIndex + 1, callback); });
+			} else if (const std::optional<Cursor> member = cursor.find(step.name)) {
+				forEachMatch(*member, stepIndex + 1, callback);
+			}
+		} else if (cursor.is<Array>()) {
+			if (step.wildcard) {
+				cursor.forEachItem([&](const Cursor& item) -> void { forEachMatch(item, stepIndex + 1, callback); });
+			} else if (step.index != NO_INDEX) {
+				if (const std::optional<Cursor> item = cursor.find(step.index)) {
+					forEachMatch(*item, stepIndex + 1, callback);
+				}
+			}
+		}
+	}
+
+	std::vector<Step> steps{};
+};
+
+namespace detail {
+
+template <typename T, typename ObjectPropertyFilter = detail::AlwaysTrue, typename ArrayItemFilter = detail::AlwaysTrue>
+[[nodiscard]] std::size_t getRecursiveSize(const T& value, ObjectPropertyFilter objectPropertyFilter, ArrayItemFilter arrayItemFilter);
+
+} // namespace detail
+
+/**
+ * Base template to specialize in order to implement JSON serialization for a
+ * specific type.
+ *
+ * The specialization should have a member function with one of the following
+ * signatures:
+ * ```
+ * void serialize(Writer& writer, const T& value)
+ * void serialize(Writer& writer, T value)
+ * ```
+ * where T is the specialized template type parameter.
+ *
+ * The implementation should write the output using the provided Writer.
+ *
+ * \tparam T the type that this serializer serializes.
+ */
+template <typename T>
+struct Serializer;
+
+/**
+ * Base template to specialize in order to implement JSON deserialization for a
+ * specific type.
+ *
+ * The specialization should have a member function with the following
+ * signature:
+ * ```
+ * void deserialize(Reader& reader, T& value)
+ * ```
+ * where T is the specialized template type parameter.
+ *
+ * The implementation should read the input using the provided Reader.
+ *
+ * \tparam T the type that this deserializer deserializes.
+ */
+template <typename T>
+struct Deserializer;
+
+/**
+ * Base template to specialize in order to give names to the fields of a
+ * specific aggregate type.
+ *
+ * By default, aggregates are serialized as JSON arrays of their field values in
+ * declaration order. Aggregates with named fields are instead serialized as
+ * JSON objects where each property name corresponds to a field, and when they
+ * are deserialized, properties may appear in any order, and properties that
+ * don't correspond to any field are ignored.
+ *
+ * The specialization should have a static constexpr member `NAMES` that is an
+ * array of the names of the fields, in declaration order:
+ * ```
+ * template <>
+ * struct json::AggregateFieldNames<Player> {
+ *     static constexpr std::array<std::string_view, 3> NAMES{"name", "health", "position"};
+ * };
+ * ```
+ * where Player is an aggregate type with three fields.
+ *
+ * The names are hashed at compile time into a perfect hash table, which means
+ * that each property name that is read can be mapped to its field in constant
+ * time, regardless of the number of fields.
+ *
+ * \tparam T the aggregate type whose fields to name.
+ */
+template <typename T>
+struct AggregateFieldNames {};
+
+namespace detail {
+
+template <typename T>
+concept named_aggregate = std::is_aggregate_v<T> && requires { AggregateFieldNames<T>::NAMES; };
+
+// Perfect hash table over the field names of a named aggregate, generated at compile time so that a property name can be mapped to its field
+// using a single hash and a single string comparison.
+template <std::size_t N>
+class FieldNameTable {
+public:
+	consteval explicit FieldNameTable(const auto& fieldNames) {
+		static_assert(N < 255);
+		for (std::size_t i = 0; i < N; ++i) {
+			names[i] = std::string_view{fieldNames[i]};
+			for (std::size_t j = 0; j < i; ++j) {
+				if (names[j] == names[i]) {
+					throw std::invalid_argument{"Duplicate field name."};
+				}
+			}
+		}
+		for (seed = 0; seed < MAX_SEED; ++seed) {
+			slots.fill(0);
+			bool collision = false;
+			for (std::size_t i = 0; i < N && !collision; ++i) {
+				std::uint8_t& slot = slots[getSlotIndex(names[i], seed)];
+				collision = slot != 0;
+				slot = static_cast<std::uint8_t>(i + 1);
+			}
+			if (!collision) {
+				return;
+			}
+		}
+		throw std::invalid_argument{"Failed to generate a perfect hash of the field names."};
+	}
+
+	[[nodiscard]] constexpr std::optional<std::size_t> find(std::string_view name) const noexcept {
+		const std::size_t slot = slots[getSlotIndex(name, seed)];
+		if (slot == 0 || names[slot - 1] != name) {
+			return {};
+		}
+		return slot - 1;
+	}
+
+private:
+	// Having several slots per name makes a collision-free seed quick to find, while the table stays small since each slot is a single byte.
+	static constexpr std::size_t SLOT_COUNT = std::bit_ceil(std::max(N, std::size_t{1}) * 4);
+	static constexpr std::uint32_t MAX_SEED = 65536;
+
+	// 32-bit FNV-1a with the seed mixed into the offset basis.
+	[[nodiscard]] static constexpr std::size_t getSlotIndex(std::string_view name, std::uint32_t seed) noexcept {
+		std::uint32_t hash = 2166136261u ^ seed;
+		for (const char ch : name) {
+			hash ^= static_cast<std::uint8_t>(ch);
+			hash *= 16777619u;
+		}
+		return (hash ^ (hash >> 16)) & (SLOT_COUNT - 1);
+	}
+
+	std::array<std::string_view, N> names{};
+	std::array<std::uint8_t, SLOT_COUNT> slots{};
+	std::uint32_t seed = 0;
+};
+
+} // namespace detail
+
+/**
+ * Serialize a value of any JSON-serializable type to an output stream.
+ *
+ * \param stream stream to write the output to.
+ * \param value value to serialize.
+ * \param options serialization options, see SerializationOptions.
+ *
+ * \throws Error on failure to serialize the value.
+ * \throws std::ios_base::failure if thrown by the output stream.
+ * \throws std::bad_alloc on allocation failure.
+ * \throws any exception thrown by a user-defined implementation of Serializer,
+ *         if one is used in the serialization of the given value type.
+ *
+ * \note Serialization of user-defined types can be defined by implementing a
+ *       specialization of the Serializer template.
+ */
+template <typename T>
+void serialize(std::ostream& stream, const T& value, const SerializationOptions& options = {});
+
+/**
+ * Deserialize a value of any JSON-serializable type from an input stream.
+ *
+ * \param stream stream to read the input from.
+ * \param value value to deserialize to.
+ * \param options deserialization options, see DeserializationOptions.
+ *
+ * \throws Error on failure to parse the value from the stream.
+ * \throws std::ios_base::failure if thrown by the input stream.
+ * \throws std::bad_alloc on allocation failure.
+ * \throws any exception thrown by a user-defined implementation of
+ *         Deserializer, if one is used in the deserialization of the given
  *         value type.
  *
  * \note Deserialization of user-defined types can be defined by implementing a
@@ -2126,6 +3673,53 @@ void serialize(std::ostream& stream, const T& value, const SerializationOptions&
 template <typename T>
 void deserialize(std::istream& stream, T& value, const DeserializationOptions& options = {});
 
+/**
+ * Deserialize a value of any JSON-serializable type from a UTF-8 JSON string.
+ *
+ * This is considerably faster than deserializing from an input stream, since
+ * contiguous input can be scanned directly instead of through a stream buffer.
+ *
+ * \param jsonString read-only view over the JSON string to read the input
+ *        from.
+ * \param value value to deserialize to.
+ * \param options deserialization options, see DeserializationOptions.
+ *
+ * \throws Error on failure to parse the value from the string.
+ * \throws std::bad_alloc on allocation failure.
+ * \throws any exception thrown by a user-defined implementation of
+ *         Deserializer, if one is used in the deserialization of the given
+ *         value type.
+ *
+ * \note Deserialization of user-defined types can be defined by implementing a
+ *       specialization of the Deserializer template.
+ */
+template <typename T>
+void deserialize(std::u8string_view jsonString, T& value, const DeserializationOptions& options = {});
+
+/**
+ * Deserialize a value of any JSON-serializable type from a JSON string of
+ * bytes, interpreted as UTF-8.
+ *
+ * This is considerably faster than deserializing from an input stream, since
+ * contiguous input can be scanned directly instead of through a stream buffer.
+ *
+ * \param jsonString read-only view over the JSON string to read the input
+ *        from.
+ * \param value value to deserialize to.
+ * \param options deserialization options, see DeserializationOptions.
+ *
+ * \throws Error on failure to parse the value from the string.
+ * \throws std::bad_alloc on allocation failure.
+ * \throws any exception thrown by a user-defined implementation of
+ *         Deserializer, if one is used in the deserialization of the given
+ *         value type.
+ *
+ * \note Deserialization of user-defined types can be defined by implementing a
+ *       specialization of the Deserializer template.
+ */
+template <typename T>
+void deserialize(std::string_view jsonString, T& value, const DeserializationOptions& options = {});
+
 /**
  * Write a JSON value to an output stream using the default serialization
  * options.
@@ -2170,27 +3764,172 @@ inline std::istream& operator>>(std::istream& stream, Value& value) {
 }
 
 /**
- * Stateful wrapper object of an output stream for JSON serialization.
+ * Stateful wrapper object of an output stream or string for JSON
+ * serialization.
+ *
+ * Output to a stream is collected in an internal buffer and written to the
+ * stream in large chunks, rather than one character at a time, which makes
+ * the throughput independent of the formatting overhead of the stream. This
+ * also applies to user-defined sinks, which can be written to by wrapping
+ * them in a custom std::streambuf. Output to a string is appended to it
+ * directly.
+ *
+ * The output is written as JSON text or as CBOR depending on the format
+ * specified in the SerializationOptions. Binary output is written to strings
+ * as raw bytes.
  */
 struct Writer {
 private:
-	std::ostream& stream;
+	// Number of buffered bytes at which the buffer is written to the output stream.
+	static constexpr std::size_t FLUSH_THRESHOLD = 65536;
+
+	std::ostream* stream;
+	String buffer{};
+	String* output;
+
+	void commit() {
+		if (stream && buffer.size() >= FLUSH_THRESHOLD) {
+			flush();
+		}
+	}
+
+	// Write the initial byte of a CBOR data item followed by its argument, using the shortest encoding that can represent the argument.
+	void writeBinaryHeader(std::uint8_t majorType, std::uint64_t argument) {
+		const auto initialByte = static_cast<std::uint8_t>(majorType << 5);
+		if (argument < 24) {
+			output->push_back(static_cast<char>(initialByte | argument));
+		} else if (argument <= 0xFF) {
+			writeBinaryArgument(initialByte | 24, argument, 1);
+		} else if (argument <= 0xFFFF) {
+			writeBinaryArgument(initialByte | 25, argument, 2);
+		} else if (argument <= 0xFFFFFFFF) {
+			writeBinaryArgument(initialByte | 26, argument, 4);
+		} else {
+			writeBinaryArgument(initialByte | 27, argument, 8);
+		}
+		commit();
+	}
+
+	// Write an initial byte followed by the lowest bytes of an argument in big-endian order.
+	void writeBinaryArgument(unsigned initialByte, std::uint64_t argument, std::size_t size) {
+		output->push_back(static_cast<char>(initialByte));
+		for (std::size_t i = size; i-- > 0;) {
+			output->push_back(static_cast<char>((argument >> (i * 8)) & 0xFF));
+		}
+	}
+
+	template <typename T>
+	void writeNamedAggregate(const T& value) {
+		constexpr std::size_t FIELD_COUNT = reflection::aggregate_size_v<T>;
+		static_assert(std::size(AggregateFieldNames<T>::NAMES) == FIELD_COUNT, "The number of field names must match the number of fields.");
+		const auto fields = reflection::fields(value);
+		if (options.format == Format::CBOR) {
+			writeBinaryHeader(detail::CBOR_MAP, FIELD_COUNT);
+			reflection::forEachIndex<FIELD_COUNT>([&](auto i) -> void {
+				writeString(std::string_view{AggregateFieldNames<T>::NAMES[i]});
+				serialize(std::get<i>(fields));
+			});
+		} else if (FIELD_COUNT == 0) {
+			write("{}");
+		} else if (options.prettyPrint && detail::getRecursiveSize(value, {}, {}) - 1 > options.prettyPrintMaxSingleLineObjectPropertyCount) {
+			write('{');
+			writeNewline();
+			options.indentation += options.relativeIndentation;
+			reflection::forEachIndex<FIELD_COUNT>([&](auto i) -> void {
+				if (i != 0) {
+					write(',');
+					writeNewline();
+				}
+				writeIndentation();
+				writeString(std::string_view{AggregateFieldNames<T>::NAMES[i]});
+				write(": ");
+				serialize(std::get<i>(fields));
+			});
+			writeNewline();
+			options.indentation -= options.relativeIndentation;
+			writeIndentation();
+			write('}');
+		} else {
+			write((options.prettyPrint) ? "{ " : "{");
+			reflection::forEachIndex<FIELD_COUNT>([&](auto i) -> void {
+				if (i != 0) {
+					write((options.prettyPrint) ? ", " : ",");
+				}
+				writeString(std::string_view{AggregateFieldNames<T>::NAMES[i]});
+				write((options.prettyPrint) ? ": " : ":");
+				serialize(std::get<i>(fields));
+			});
+			write((options.prettyPrint) ? " }" : "}");
+		}
+	}
+
+public:
+	/**
+	 * The current options of the serialization process.
+	 */
+	SerializationOptions options;
+
+	/**
+	 * Construct a writer with an output stream as output.
+	 *
+	 * \param stream output stream to write to.
+	 * \param options output options, see SerializationOptions.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \note The output is buffered, and is not written to the stream until
+	 *       the buffer fills up, flush() is called or the writer is destroyed.
+	 */
+	explicit Writer(std::ostream& stream, const SerializationOptions& options = {})
+		: stream(&stream)
+		, output(&buffer)
+		, options(options) {
+		buffer.reserve(FLUSH_THRESHOLD + 64);
+	}
+
+	/**
+	 * Construct a writer with a string as output.
+	 *
+	 * \param output string to append the output to.
+	 * \param options output options, see SerializationOptions.
+	 */
+	explicit Writer(String& output, const SerializationOptions& options = {})
+		: stream(nullptr)
+		, output(&output)
+		, options(options) {}
 
-public:
 	/**
-	 * The current options of the serialization process.
+	 * Flush any remaining buffered output to the output stream.
+	 *
+	 * Any exception thrown by the stream during this final flush is
+	 * suppressed. Call flush() before destroying the writer in order to handle
+	 * such errors.
 	 */
-	SerializationOptions options;
+	~Writer() {
+		try {
+			flush();
+		} catch (...) { // NOLINT(bugprone-empty-catch)
+		}
+	}
+
+	Writer(const Writer&) = delete;
+	Writer(Writer&&) = delete;
+	Writer& operator=(const Writer&) = delete;
+	Writer& operator=(Writer&&) = delete;
 
 	/**
-	 * Construct a writer with an output stream as output.
+	 * Write all buffered output to the output stream.
 	 *
-	 * \param stream output stream to write to.
-	 * \param options output options, see SerializationOptions.
+	 * Does nothing when the output is a string.
+	 *
+	 * \throws any exception thrown by the underlying output stream.
 	 */
-	explicit Writer(std::ostream& stream, const SerializationOptions& options = {})
-		: stream(stream)
-		, options(options) {}
+	void flush() {
+		if (stream && !buffer.empty()) {
+			stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	}
 
 	/**
 	 * Write a single raw byte to the output without any extra formatting.
@@ -2200,7 +3939,8 @@ public:
 	 * \throws any exception thrown by the underlying output stream.
 	 */
 	void write(char byte) {
-		stream << byte;
+		output->push_back(byte);
+		commit();
 	}
 
 	/**
@@ -2211,7 +3951,8 @@ public:
 	 * \throws any exception thrown by the underlying output stream.
 	 */
 	void write(std::string_view bytes) {
-		stream << bytes;
+		output->append(bytes);
+		commit();
 	}
 
 	/**
@@ -2226,9 +3967,11 @@ public:
 	 * \sa SerializationOptions::indentationCharacter
 	 */
 	void writeIndentation() {
-		for (std::size_t i = 0; i < options.indentation; ++i) {
-			write(options.indentationCharacter);
+		if (options.format != Format::JSON) {
+			return;
 		}
+		output->append(options.indentation, options.indentationCharacter);
+		commit();
 	}
 
 	/**
@@ -2237,7 +3980,10 @@ public:
 	 * \throws any exception thrown by the underlying output stream.
 	 */
 	void writeNewline() {
-		stream << options.newlineString;
+		if (options.format != Format::JSON) {
+			return;
+		}
+		write(std::string_view{options.newlineString});
 	}
 
 	/**
@@ -2246,6 +3992,10 @@ public:
 	 * \throws any exception thrown by the underlying output stream.
 	 */
 	void writeNull() {
+		if (options.format == Format::CBOR) {
+			writeBinaryHeader(detail::CBOR_SIMPLE, detail::CBOR_NULL);
+			return;
+		}
 		write("null");
 	}
 
@@ -2257,6 +4007,10 @@ public:
 	 * \throws any exception thrown by the underlying output stream.
 	 */
 	void writeBoolean(Boolean value) {
+		if (options.format == Format::CBOR) {
+			writeBinaryHeader(detail::CBOR_SIMPLE, (value) ? detail::CBOR_TRUE : detail::CBOR_FALSE);
+			return;
+		}
 		write((value) ? "true" : "false");
 	}
 
@@ -2269,29 +4023,39 @@ public:
 	 * \throws any exception thrown by the underlying output stream.
 	 */
 	void writeString(std::string_view bytes) {
+		if (options.format == Format::CBOR) {
+			writeBinaryHeader(detail::CBOR_TEXT_STRING, bytes.size());
+			write(bytes);
+			return;
+		}
 		constexpr std::array<char, 16> HEXADECIMAL_DIGITS{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
 		write('\"');
-		for (const char byte : bytes) {
-			if (byte >= ' ' && byte <= '~' && byte != '\"' && byte != '\\') {
-				write(byte);
-			} else {
-				write('\\');
-				switch (byte) {
-					case '\"': write('\"'); break;
-					case '\\': write('\\'); break;
-					case '\b': write('b'); break;
-					case '\f': write('f'); break;
-					case '\n': write('n'); break;
-					case '\r': write('r'); break;
-					case '\t': write('t'); break;
-					case '\v': write('v'); break;
-					case '\0': write('0'); break;
-					default:
-						write('x');
-						write(HEXADECIMAL_DIGITS[(byte >> 4) & 0x0F]);
-						write(HEXADECIMAL_DIGITS[(byte & 0x0F)]);
-						break;
-				}
+		auto it = bytes.begin();
+		while (it != bytes.end()) {
+			// Characters that don't need to be escaped are written in runs rather than one at a time.
+			const auto runEnd = std::find_if(it, bytes.end(), [](char byte) -> bool { return byte < ' ' || byte > '~' || byte == '\"' || byte == '\\'; });
+			if (runEnd != it) {
+				write(std::string_view{it, runEnd});
+				it = runEnd;
+				continue;
+			}
+			const char byte = *it++;
+			write('\\');
+			switch (byte) {
+				case '\"': write('\"'); break;
+				case '\\': write('\\'); break;
+				case '\b': write('b'); break;
+				case '\f': write('f'); break;
+				case '\n': write('n'); break;
+				case '\r': write('r'); break;
+				case '\t': write('t'); break;
+				case '\v': write('v'); break;
+				case '\0': write('0'); break;
+				default:
+					write('x');
+					write(HEXADECIMAL_DIGITS[(byte >> 4) & 0x0F]);
+					write(HEXADECIMAL_DIGITS[(byte & 0x0F)]);
+					break;
 			}
 		}
 		write('\"');
@@ -2333,9 +4097,9 @@ public:
 		} else if constexpr (requires { std::wstring_view{value}; }) {
 			writeString(std::wstring_view{value});
 		} else {
-			std::ostringstream stringStream{};
-			json::serialize(stringStream, value, {.prettyPrint = false});
-			writeString(std::move(stringStream).str());
+			String string{};
+			Writer{string, {.prettyPrint = false}}.serialize(value);
+			writeString(string);
 		}
 	}
 
@@ -2347,20 +4111,41 @@ public:
 	 * \throws any exception thrown by the underlying output stream.
 	 */
 	void writeNumber(Number value) {
-		if (std::isnan(value)) {
-			if (std::signbit(value)) {
-				stream << "-NaN";
+		// Integers are by far the most common numbers in practice, and are much cheaper to encode as such than through the shortest
+		// round-trip floating-point representation, which results in the same digits. Negative zero has to keep its sign, however.
+		constexpr Number MAX_EXACT_INTEGER = 9007199254740992.0;
+		const bool integer =
+			value >= -MAX_EXACT_INTEGER && value <= MAX_EXACT_INTEGER && value == static_cast<Number>(static_cast<std::int64_t>(value)) && (value != 0.0 || !std::signbit(value));
+		if (options.format == Format::CBOR) {
+			if (integer) {
+				const auto integerValue = static_cast<std::int64_t>(value);
+				if (integerValue >= 0) {
+					writeBinaryHeader(detail::CBOR_UNSIGNED_INTEGER, static_cast<std::uint64_t>(integerValue));
+				} else {
+					writeBinaryHeader(detail::CBOR_NEGATIVE_INTEGER, static_cast<std::uint64_t>(-1 - integerValue));
+				}
+			} else if (!std::isfinite(value) || (std::abs(value) <= std::numeric_limits<float>::max() && static_cast<Number>(static_cast<float>(value)) == value)) {
+				writeBinaryArgument((detail::CBOR_SIMPLE << 5) | detail::CBOR_SINGLE_PRECISION_FLOAT, std::bit_cast<std::uint32_t>(static_cast<float>(value)), 4);
+				commit();
 			} else {
-				stream << "NaN";
+				writeBinaryArgument((detail::CBOR_SIMPLE << 5) | detail::CBOR_DOUBLE_PRECISION_FLOAT, std::bit_cast<std::uint64_t>(value), 8);
+				commit();
 			}
+			return;
+		}
+		if (std::isnan(value)) {
+			write((std::signbit(value)) ? "-NaN" : "NaN");
 		} else if (std::isinf(value)) {
-			if (std::signbit(value)) {
-				stream << "-Infinity";
+			write((std::signbit(value)) ? "-Infinity" : "Infinity");
+		} else {
+			std::array<char, 32> characters{};
+			std::to_chars_result result{};
+			if (integer) {
+				result = std::to_chars(characters.data(), characters.data() + characters.size(), static_cast<std::int64_t>(value));
 			} else {
-				stream << "Infinity";
+				result = std::to_chars(characters.data(), characters.data() + characters.size(), value);
 			}
-		} else {
-			[[likely]] fmt::format_to(std::ostreambuf_iterator{stream}, "{}", value);
+			write(std::string_view{characters.data(), static_cast<std::size_t>(result.ptr - characters.data())});
 		}
 	}
 
@@ -2388,7 +4173,15 @@ public:
 		while (it != end && !propertyFilter(*it)) {
 			++it;
 		}
-		if (options.prettyPrint) {
+		if (options.format == Format::CBOR) {
+			writeBinaryHeader(detail::CBOR_MAP, static_cast<std::uint64_t>(std::count_if(it, end, propertyFilter)));
+			for (; it != end; ++it) {
+				if (propertyFilter(*it)) {
+					writeString(getKey(*it));
+					serialize(getValue(*it));
+				}
+			}
+		} else if (options.prettyPrint) {
 			if (it == end) {
 				write("{}");
 			} else if (detail::getRecursiveSize(value, propertyFilter, {}) - 1 <= options.prettyPrintMaxSingleLineObjectPropertyCount) {
@@ -2468,7 +4261,14 @@ public:
 		while (it != end && !itemFilter(*it)) {
 			++it;
 		}
-		if (options.prettyPrint) {
+		if (options.format == Format::CBOR) {
+			writeBinaryHeader(detail::CBOR_ARRAY, static_cast<std::uint64_t>(std::count_if(it, end, itemFilter)));
+			for (; it != end; ++it) {
+				if (itemFilter(*it)) {
+					serialize(getValue(*it));
+				}
+			}
+		} else if (options.prettyPrint) {
 			if (it == end) {
 				write("[]");
 			} else if (detail::getRecursiveSize(value, {}, itemFilter) - 1 <= options.prettyPrintMaxSingleLineArrayItemCount) {
@@ -2539,6 +4339,9 @@ public:
 	/**
 	 * Write a single JSON value to the output from any value of aggregate type.
 	 *
+	 * The aggregate is written as an array of its field values, or as an
+	 * object if its fields are named, see AggregateFieldNames.
+	 *
 	 * \param value aggregate whose fields to write.
 	 *
 	 * \throws any exception thrown by the underlying output stream.
@@ -2547,11 +4350,20 @@ public:
 	 */
 	template <typename T>
 	void writeAggregate(const T& value) {
-		if constexpr (reflection::aggregate_size_v<T> == 0) {
-			write("[]");
+		if constexpr (detail::named_aggregate<T>) {
+			writeNamedAggregate(value);
+		} else if constexpr (reflection::aggregate_size_v<T> == 0) {
+			if (options.format == Format::CBOR) {
+				writeBinaryHeader(detail::CBOR_ARRAY, 0);
+			} else {
+				write("[]");
+			}
 		} else if constexpr (reflection::aggregate_size_v<T> == 1) {
 			const auto& [v] = value;
 			serialize(v);
+		} else if (options.format == Format::CBOR) {
+			writeBinaryHeader(detail::CBOR_ARRAY, reflection::aggregate_size_v<T>);
+			reflection::forEach(reflection::fields(value), [&](const auto& v) { serialize(v); });
 		} else if (options.prettyPrint) {
 			if (detail::getRecursiveSize(value, {}, {}) - 1 <= options.prettyPrintMaxSingleLineArrayItemCount) {
 				write('[');
@@ -2613,13 +4425,452 @@ public:
 };
 
 /**
- * Stateful wrapper object of an input stream for JSON deserialization.
+ * Parser for reading JSON values from CBOR-encoded input.
+ *
+ * The parser produces the same sequence of tokens as Parser does for the
+ * equivalent JSON text, including the punctuators between the members of
+ * objects and the items of arrays, so that a Reader and any Deserializer
+ * implementation can read from either format.
+ *
+ * Since CBOR has no notion of lines, the source locations of the tokens have a
+ * line number of 0 and a column number corresponding to the 1-based byte
+ * offset of the encoded item in the input.
+ *
+ * \sa Format::CBOR
+ */
+class CBORParser {
+public:
+	/**
+	 * Construct a parser with a contiguous sequence of bytes as input.
+	 *
+	 * \param input non-owning read-only view over the CBOR input to parse.
+	 *
+	 * \warning The input must outlive the parser.
+	 */
+	explicit CBORParser(std::span<const std::byte> input) noexcept
+		: inputBegin(reinterpret_cast<const std::uint8_t*>(input.data()))
+		, inputEnd(inputBegin + input.size())
+		, position(inputBegin) {}
+
+	/**
+	 * Construct a parser with an input stream as input.
+	 *
+	 * The rest of the stream is read into an internal buffer right away.
+	 *
+	 * \param stream input stream to parse.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 * \throws any exception thrown by the input stream.
+	 */
+	explicit CBORParser(std::istream& stream)
+		: ownedInput(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{})
+		, inputBegin(reinterpret_cast<const std::uint8_t*>(ownedInput.data()))
+		, inputEnd(inputBegin + ownedInput.size())
+		, position(inputBegin) {}
+
+	CBORParser(const CBORParser&) = delete;
+	CBORParser(CBORParser&&) noexcept = default;
+	CBORParser& operator=(const CBORParser&) = delete;
+	CBORParser& operator=(CBORParser&&) noexcept = default;
+	~CBORParser() = default;
+
+	/**
+	 * \sa Parser::parseValue()
+	 */
+	Value parseValue() {
+		switch (const Token& token = peek(); token.type) {
+			case TokenType::END_OF_FILE: throw Error{"Expected a value.", token.source};
+			case TokenType::IDENTIFIER_NULL: advance(); return Null{};
+			case TokenType::IDENTIFIER_FALSE: advance(); return Boolean{false};
+			case TokenType::IDENTIFIER_TRUE: advance(); return Boolean{true};
+			case TokenType::STRING: return std::move(eat().string);
+			case TokenType::NUMBER_DECIMAL: return parseNumber();
+			case TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET: return parseArray();
+			case TokenType::PUNCTUATOR_OPEN_CURLY_BRACE: return parseObject();
+			default: break;
+		}
+		throw Error{"Unexpected token.", peek().source};
+	}
+
+	/**
+	 * \sa Parser::skipValue()
+	 */
+	void skipValue() {
+		(void)parseValue();
+	}
+
+	/**
+	 * \sa Parser::parseNull()
+	 */
+	Null parseNull() {
+		if (const Token token = eat(); token.type != TokenType::IDENTIFIER_NULL) {
+			throw Error{"Expected a null.", token.source};
+		}
+		return Null{};
+	}
+
+	/**
+	 * \sa Parser::parseBoolean()
+	 */
+	Boolean parseBoolean() {
+		const Token token = eat();
+		switch (token.type) {
+			case TokenType::IDENTIFIER_FALSE: return Boolean{false};
+			case TokenType::IDENTIFIER_TRUE: return Boolean{true};
+			default: break;
+		}
+		throw Error{"Expected a boolean.", token.source};
+	}
+
+	/**
+	 * \sa Parser::parseString()
+	 */
+	String parseString() {
+		Token token = eat();
+		if (token.type != TokenType::STRING) {
+			throw Error{"Expected a string.", token.source};
+		}
+		return std::move(token.string);
+	}
+
+	/**
+	 * \sa Parser::parseNumber()
+	 */
+	Number parseNumber() {
+		if (const Token token = eat(); token.type != TokenType::NUMBER_DECIMAL) {
+			throw Error{"Expected a number.", token.source};
+		}
+		return currentNumber;
+	}
+
+	/**
+	 * \sa Parser::parseObject()
+	 */
+	Object parseObject() {
+		if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_OPEN_CURLY_BRACE) {
+			throw Error{"Expected an object.", token.source};
+		}
+		Object result{};
+		while (peek().type != TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+			String key = parseString();
+			advance(); // Colon.
+			Value value = parseValue();
+			result.emplace(std::move(key), std::move(value));
+			if (peek().type == TokenType::PUNCTUATOR_COMMA) {
+				advance();
+			}
+		}
+		advance();
+		return result;
+	}
+
+	/**
+	 * \sa Parser::parseArray()
+	 */
+	Array parseArray() {
+		if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
+			throw Error{"Expected an array.", token.source};
+		}
+		Array result{};
+		while (peek().type != TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+			result.push_back(parseValue());
+			if (peek().type == TokenType::PUNCTUATOR_COMMA) {
+				advance();
+			}
+		}
+		advance();
+		return result;
+	}
+
+	/**
+	 * \sa Parser::peek()
+	 */
+	[[nodiscard]] const Token& peek() const {
+		if (!currentToken) {
+			currentToken = scan();
+		}
+		return *currentToken;
+	}
+
+	/**
+	 * \sa Parser::advance()
+	 */
+	void advance() {
+		if (!currentToken) {
+			(void)scan();
+		}
+		currentToken.reset();
+	}
+
+	/**
+	 * \sa Parser::eat()
+	 */
+	[[nodiscard]] Token eat() {
+		if (!currentToken) {
+			currentToken = scan();
+		}
+		Token result = std::move(*currentToken);
+		currentToken.reset();
+		return result;
+	}
+
+private:
+	struct Container {
+		std::size_t itemCount; // Number of items, where the key and value of each map entry count as separate items.
+		std::size_t itemIndex;
+		bool indefinite;
+		bool object;
+	};
+
+	struct Header {
+		std::uint8_t majorType;
+		std::uint8_t additionalInformation;
+		std::uint64_t argument;
+	};
+
+	[[nodiscard]] SourceLocation getSourceLocation() const noexcept {
+		return SourceLocation{.lineNumber = 0, .columnNumber = static_cast<std::size_t>(position - inputBegin) + 1};
+	}
+
+	[[nodiscard]] Token scan() const {
+		const SourceLocation source = getSourceLocation();
+		if (!containers.empty()) {
+			if (separatorPending) {
+				separatorPending = false;
+				const Container& container = containers.back();
+				const bool colon = container.object && container.itemIndex % 2 == 1;
+				return {.string{}, .source = source, .type = (colon) ? TokenType::PUNCTUATOR_COLON : TokenType::PUNCTUATOR_COMMA};
+			}
+			if (hasReachedEndOfContainer()) {
+				const bool object = containers.back().object;
+				if (containers.back().indefinite) {
+					++position;
+				}
+				containers.pop_back();
+				completeItem();
+				return {.string{}, .source = source, .type = (object) ? TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE : TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET};
+			}
+		}
+		if (position == inputEnd) {
+			if (!containers.empty()) {
+				throw Error{"Unexpected end of input.", source};
+			}
+			return {.string{}, .source = source, .type = TokenType::END_OF_FILE};
+		}
+		Header header = scanHeader();
+		while (header.majorType == detail::CBOR_TAG) {
+			header = scanHeader();
+		}
+		const bool indefinite = header.additionalInformation == detail::CBOR_INDEFINITE;
+		Token token{.string{}, .source = source, .type = TokenType::NUMBER_DECIMAL};
+		switch (header.majorType) {
+			case detail::CBOR_UNSIGNED_INTEGER: currentNumber = static_cast<Number>(header.argument); break;
+			case detail::CBOR_NEGATIVE_INTEGER: currentNumber = -1.0 - static_cast<Number>(header.argument); break;
+			case detail::CBOR_BYTE_STRING: [[fallthrough]];
+			case detail::CBOR_TEXT_STRING:
+				token.type = TokenType::STRING;
+				if (indefinite) {
+					while (true) {
+						if (position == inputEnd) {
+							throw Error{"Unexpected end of input.", getSourceLocation()};
+						}
+						if (*position == detail::CBOR_BREAK) {
+							++position;
+							break;
+						}
+						const SourceLocation chunkSource = getSourceLocation();
+						const Header chunkHeader = scanHeader();
+						if (chunkHeader.majorType != header.majorType || chunkHeader.additionalInformation == detail::CBOR_INDEFINITE) {
+							throw Error{"Invalid string chunk.", chunkSource};
+						}
+						appendStringContents(token.string, chunkHeader.argument);
+					}
+				} else {
+					appendStringContents(token.string, header.argument);
+				}
+				break;
+			case detail::CBOR_ARRAY: [[fallthrough]];
+			case detail::CBOR_MAP: {
+				const bool object = header.majorType == detail::CBOR_MAP;
+				std::size_t itemCount = 0;
+				if (!indefinite) {
+					// Every item takes up at least one byte, which puts an upper bound on the number of items that a well-formed input can have.
+					if (header.argument > static_cast<std::uint64_t>(inputEnd - position) / ((object) ? 2 : 1)) {
+						throw Error{"Invalid container size.", source};
+					}
+					itemCount = static_cast<std::size_t>(header.argument) * ((object) ? 2 : 1);
+				}
+				containers.push_back(Container{.itemCount = itemCount, .itemIndex = 0, .indefinite = indefinite, .object = object});
+				token.type = (object) ? TokenType::PUNCTUATOR_OPEN_CURLY_BRACE : TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET;
+				return token;
+			}
+			default:
+				switch (header.additionalInformation) {
+					case detail::CBOR_FALSE: token.type = TokenType::IDENTIFIER_FALSE; break;
+					case detail::CBOR_TRUE: token.type = TokenType::IDENTIFIER_TRUE; break;
+					case detail::CBOR_NULL: [[fallthrough]];
+					case detail::CBOR_UNDEFINED: token.type = TokenType::IDENTIFIER_NULL; break;
+					case detail::CBOR_HALF_PRECISION_FLOAT: currentNumber = decodeHalfPrecisionFloat(static_cast<std::uint16_t>(header.argument)); break;
+					case detail::CBOR_SINGLE_PRECISION_FLOAT: currentNumber = static_cast<Number>(std::bit_cast<float>(static_cast<std::uint32_t>(header.argument))); break;
+					case detail::CBOR_DOUBLE_PRECISION_FLOAT: currentNumber = std::bit_cast<double>(header.argument); break;
+					case detail::CBOR_INDEFINITE: throw Error{"Unexpected break.", source};
+					default: throw Error{"Unsupported simple value.", source};
+				}
+				break;
+		}
+		completeItem();
+		return token;
+	}
+
+	[[nodiscard]] Header scanHeader() const {
+		const SourceLocation source = getSourceLocation();
+		if (position == inputEnd) {
+			throw Error{"Unexpected end of input.", source};
+		}
+		const std::uint8_t initialByte = *position++;
+		Header header{.majorType = static_cast<std::uint8_t>(initialByte >> 5), .additionalInformation = static_cast<std::uint8_t>(initialByte & 0x1F), .argument = 0};
+		if (header.additionalInformation < 24) {
+			header.argument = header.additionalInformation;
+		} else if (header.additionalInformation < 28) {
+			const std::size_t argumentSize = std::size_t{1} << (header.additionalInformation - 24);
+			if (static_cast<std::size_t>(inputEnd - position) < argumentSize) {
+				throw Error{"Unexpected end of input.", source};
+			}
+			for (std::size_t i = 0; i < argumentSize; ++i) {
+				header.argument = (header.argument << 8) | *position++;
+			}
+		} else if (header.additionalInformation != detail::CBOR_INDEFINITE ||
+				   (header.majorType != detail::CBOR_BYTE_STRING && header.majorType != detail::CBOR_TEXT_STRING && header.majorType != detail::CBOR_ARRAY &&
+					   header.majorType != detail::CBOR_MAP && header.majorType != detail::CBOR_SIMPLE)) {
+			throw Error{"Invalid CBOR item.", source};
+		}
+		return header;
+	}
+
+	void appendStringContents(String& output, std::uint64_t size) const {
+		if (size > static_cast<std::uint64_t>(inputEnd - position)) {
+			throw Error{"Unexpected end of input.", getSourceLocation()};
+		}
+		output.append(reinterpret_cast<const char*>(position), static_cast<std::size_t>(size));
+		position += static_cast<std::size_t>(size);
+	}
+
+	[[nodiscard]] bool hasReachedEndOfContainer() const {
+		const Container& container = containers.back();
+		if (!container.indefinite) {
+			return container.itemIndex == container.itemCount;
+		}
+		if (position == inputEnd) {
+			throw Error{"Unexpected end of input.", getSourceLocation()};
+		}
+		return *position == detail::CBOR_BREAK && (!container.object || container.itemIndex % 2 == 0);
+	}
+
+	// Count a finished item towards its container, and determine if it has to be followed by a colon or comma token.
+	void completeItem() const {
+		if (!containers.empty()) {
+			Container& container = containers.back();
+			++container.itemIndex;
+			separatorPending = (container.object && container.itemIndex % 2 == 1) || !hasReachedEndOfContainer();
+		}
+	}
+
+	[[nodiscard]] static Number decodeHalfPrecisionFloat(std::uint16_t bits) noexcept {
+		const int exponent = (bits >> 10) & 0x1F;
+		const int mantissa = bits & 0x3FF;
+		Number result{};
+		if (exponent == 0) {
+			result = std::ldexp(static_cast<Number>(mantissa), -24);
+		} else if (exponent == 0x1F) {
+			result = (mantissa == 0) ? std::numeric_limits<Number>::infinity() : std::numeric_limits<Number>::quiet_NaN();
+		} else {
+			result = std::ldexp(static_cast<Number>(mantissa + 0x400), exponent - 25);
+		}
+		return ((bits & 0x8000) != 0) ? -result : result;
+	}
+
+	std::vector<char> ownedInput{};
+	const std::uint8_t* inputBegin;
+	const std::uint8_t* inputEnd;
+	mutable const std::uint8_t* position;
+	mutable std::vector<Container> containers{};
+	mutable std::optional<Token> currentToken{};
+	mutable Number currentNumber = 0.0;
+	mutable bool separatorPending = false;
+};
+
+/**
+ * Stateful wrapper object of an input stream or string for JSON
+ * deserialization.
+ *
+ * The input is read as JSON5 text or as CBOR depending on the format
+ * specified in the DeserializationOptions.
  */
 struct Reader {
 private:
-	using It = std::istreambuf_iterator<char>;
+	// Contiguous strings get their own parser, since their lexer can scan the input directly through a pointer instead of through a stream buffer.
+	Variant<StreamParser, StringParser, CBORParser> parser;
+
+	[[nodiscard]] const Token& peek() const {
+		return match(parser)([](const auto& p) -> const Token& { return p.peek(); });
+	}
+
+	[[nodiscard]] Token eat() {
+		return match(parser)([](auto& p) -> Token { return p.eat(); });
+	}
+
+	void advance() {
+		match(parser)([](auto& p) -> void { p.advance(); });
+	}
+
+	void skipValue() {
+		match(parser)([](auto& p) -> void { p.skipValue(); });
+	}
 
-	Parser<It> parser;
+	template <typename T>
+	void readNamedAggregate(T& value) {
+		constexpr std::size_t FIELD_COUNT = reflection::aggregate_size_v<T>;
+		static_assert(std::size(AggregateFieldNames<T>::NAMES) == FIELD_COUNT, "The number of field names must match the number of fields.");
+		static constexpr detail::FieldNameTable<FIELD_COUNT> FIELD_NAME_TABLE{AggregateFieldNames<T>::NAMES};
+
+		// Once the field index of a property is known, the field is read through a jump table rather than by comparing the index to each field.
+		using FieldReader = void (*)(Reader&, T&);
+		static constexpr std::array<FieldReader, FIELD_COUNT> FIELD_READERS = []<std::size_t... Indices>(std::index_sequence<Indices...>) {
+			return std::array<FieldReader, FIELD_COUNT>{[](Reader& reader, T& aggregate) -> void { reader.deserialize(std::get<Indices>(reflection::fields(aggregate))); }...};
+		}(std::make_index_sequence<FIELD_COUNT>{});
+
+		if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_OPEN_CURLY_BRACE) {
+			throw Error{"Expected an object.", token.source};
+		}
+		if (peek().type != TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+			while (true) {
+				const Token propertyKey = eat();
+				if (propertyKey.type != TokenType::STRING && propertyKey.type != TokenType::IDENTIFIER_NAME) {
+					throw Error{"Expected a property name.", propertyKey.source};
+				}
+				if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_COLON) {
+					throw Error{"Expected a colon.", token.source};
+				}
+				if (const std::optional<std::size_t> fieldIndex = FIELD_NAME_TABLE.find(propertyKey.string)) {
+					FIELD_READERS[*fieldIndex](*this, value);
+				} else {
+					skipValue();
+				}
+				const Token token = eat();
+				if (token.type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+					break;
+				}
+				if (token.type == TokenType::PUNCTUATOR_COMMA) {
+					if (peek().type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+						advance();
+						break;
+					}
+				} else {
+					throw Error{"Expected a comma or closing brace.", token.source};
+				}
+			}
+		}
+	}
 
 public:
 	/**
@@ -2630,11 +4881,40 @@ public:
 	/**
 	 * Construct a reader with an input stream as input.
 	 *
-	 * \param stream input stream to write to.
+	 * \param stream input stream to read from.
 	 * \param options input options, see DeserializationOptions.
 	 */
 	explicit Reader(std::istream& stream, const DeserializationOptions& options = {})
-		: parser(stream)
+		: parser((options.format == Format::CBOR) ? decltype(parser){std::in_place_type<CBORParser>, stream} : decltype(parser){std::in_place_type<StreamParser>, stream})
+		, options(options) {}
+
+	/**
+	 * Construct a reader with a contiguous UTF-8 string as input.
+	 *
+	 * \param jsonString non-owning read-only view over the UTF-8 string to read
+	 *        from.
+	 * \param options input options, see DeserializationOptions.
+	 *
+	 * \warning The string must outlive the reader.
+	 */
+	explicit Reader(std::u8string_view jsonString, const DeserializationOptions& options = {})
+		: parser((options.format == Format::CBOR) ? decltype(parser){std::in_place_type<CBORParser>, std::as_bytes(std::span{jsonString})}
+												  : decltype(parser){std::in_place_type<StringParser>, jsonString})
+		, options(options) {}
+
+	/**
+	 * Construct a reader with a contiguous string of bytes, interpreted as
+	 * UTF-8, as input.
+	 *
+	 * \param jsonString non-owning read-only view over the byte string to read
+	 *        from.
+	 * \param options input options, see DeserializationOptions.
+	 *
+	 * \warning The string must outlive the reader.
+	 */
+	explicit Reader(std::string_view jsonString, const DeserializationOptions& options = {})
+		: parser((options.format == Format::CBOR) ? decltype(parser){std::in_place_type<CBORParser>, std::as_bytes(std::span{jsonString})}
+												  : decltype(parser){std::in_place_type<StringParser>, jsonString})
 		, options(options) {}
 
 	/**
@@ -2650,8 +4930,8 @@ public:
 	 * \sa readValue()
 	 */
 	SourceLocation readNull() {
-		const SourceLocation source = parser.peek().source;
-		parser.parseNull();
+		const SourceLocation source = peek().source;
+		match(parser)([](auto& p) -> void { p.parseNull(); });
 		return source;
 	}
 
@@ -2671,8 +4951,8 @@ public:
 	 * \sa Parser::parseBoolean()
 	 */
 	SourceLocation readBoolean(Boolean& value) {
-		const SourceLocation source = parser.peek().source;
-		value = parser.parseBoolean();
+		const SourceLocation source = peek().source;
+		match(parser)([&](auto& p) -> void { value = p.parseBoolean(); });
 		return source;
 	}
 
@@ -2692,8 +4972,8 @@ public:
 	 * \sa Parser::parseString()
 	 */
 	SourceLocation readString(String& value) {
-		const SourceLocation source = parser.peek().source;
-		value = parser.parseString();
+		const SourceLocation source = peek().source;
+		match(parser)([&](auto& p) -> void { value = p.parseString(); });
 		return source;
 	}
 
@@ -2742,8 +5022,7 @@ public:
 			std::memcpy(temporaryString.data(), string.data(), string.size());
 			value = std::move(temporaryString);
 		} else {
-			std::istringstream stringStream{std::move(string)}; // NOLINT(performance-move-const-arg)
-			json::deserialize(stringStream, value);
+			json::deserialize(std::string_view{string}, value);
 		}
 		return source;
 	}
@@ -2764,8 +5043,8 @@ public:
 	 * \sa Parser::parseNumber()
 	 */
 	SourceLocation readNumber(Number& value) {
-		const SourceLocation source = parser.peek().source;
-		value = parser.parseNumber();
+		const SourceLocation source = peek().source;
+		match(parser)([&](auto& p) -> void { value = p.parseNumber(); });
 		return source;
 	}
 
@@ -2807,8 +5086,8 @@ public:
 	 * \sa Parser::parseObject()
 	 */
 	SourceLocation readObject(Object& value) {
-		const SourceLocation source = parser.peek().source;
-		value = parser.parseObject();
+		const SourceLocation source = peek().source;
+		match(parser)([&](auto& p) -> void { value = p.parseObject(); });
 		return source;
 	}
 
@@ -2838,28 +5117,28 @@ public:
 	 *          are not removed automatically if a later operation fails.
 	 */
 	SourceLocation readObject(auto& value) {
-		const SourceLocation source = parser.peek().source;
-		if (const Token token = parser.eat(); token.type != TokenType::PUNCTUATOR_OPEN_CURLY_BRACE) {
+		const SourceLocation source = peek().source;
+		if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_OPEN_CURLY_BRACE) {
 			throw Error{"Expected an object.", token.source};
 		}
 		value.clear();
-		if (parser.peek().type != TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+		if (peek().type != TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
 			while (true) {
 				std::remove_cvref_t<decltype(std::begin(value)->first)> propertyKey{};
 				std::remove_cvref_t<decltype(std::begin(value)->second)> propertyValue{};
 				readString(propertyKey);
-				if (const Token token = parser.eat(); token.type != TokenType::PUNCTUATOR_COLON) {
+				if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_COLON) {
 					throw Error{"Expected a colon.", token.source};
 				}
 				deserialize(propertyValue);
 				value.emplace(std::move(propertyKey), std::move(propertyValue));
-				const Token token = parser.eat();
+				const Token token = eat();
 				if (token.type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
 					break;
 				}
 				if (token.type == TokenType::PUNCTUATOR_COMMA) {
-					if (parser.peek().type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
-						parser.advance();
+					if (peek().type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+						advance();
 						break;
 					}
 				} else {
@@ -2886,8 +5165,8 @@ public:
 	 * \sa Parser::parseArray()
 	 */
 	SourceLocation readArray(Array& value) {
-		const SourceLocation source = parser.peek().source;
-		value = parser.parseArray();
+		const SourceLocation source = peek().source;
+		match(parser)([&](auto& p) -> void { value = p.parseArray(); });
 		return source;
 	}
 
@@ -2915,23 +5194,23 @@ public:
 	 *          not removed automatically if a later operation fails.
 	 */
 	SourceLocation readArray(auto& value) {
-		const SourceLocation source = parser.peek().source;
-		if (const Token token = parser.eat(); token.type != TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
+		const SourceLocation source = peek().source;
+		if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
 			throw Error{"Expected an array.", token.source};
 		}
 		value.clear();
-		if (parser.peek().type != TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+		if (peek().type != TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
 			while (true) {
 				std::remove_cvref_t<decltype(*std::begin(value))> item{};
 				deserialize(item);
 				value.push_back(std::move(item));
-				const Token token = parser.eat();
+				const Token token = eat();
 				if (token.type == TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
 					break;
 				}
 				if (token.type == TokenType::PUNCTUATOR_COMMA) {
-					if (parser.peek().type == TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
-						parser.advance();
+					if (peek().type == TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+						advance();
 						break;
 					}
 				} else {
@@ -2958,8 +5237,8 @@ public:
 	 * \sa Parser::parseValue()
 	 */
 	SourceLocation readValue(Value& value) {
-		const SourceLocation source = parser.peek().source;
-		value = parser.parseValue();
+		const SourceLocation source = peek().source;
+		match(parser)([&](auto& p) -> void { value = p.parseValue(); });
 		return source;
 	}
 
@@ -2988,9 +5267,9 @@ public:
 	 */
 	template <typename T>
 	SourceLocation readOptional(T& value) {
-		const SourceLocation source = parser.peek().source;
-		if (parser.peek().type == TokenType::IDENTIFIER_NULL) {
-			parser.advance();
+		const SourceLocation source = peek().source;
+		if (peek().type == TokenType::IDENTIFIER_NULL) {
+			advance();
 			value = T{};
 		} else {
 			std::remove_cvref_t<decltype(*value)> result{};
@@ -3004,6 +5283,10 @@ public:
 	 * Read a single JSON value from the input into any value of aggregate type
 	 * whose fields are deserializable from JSON.
 	 *
+	 * The aggregate is read from an array of its field values, or from an
+	 * object if its fields are named, see AggregateFieldNames. Fields that are
+	 * missing from the object are left unmodified.
+	 *
 	 * \param value reference to the output value whose fields to write the
 	 *        parsed results into.
 	 *
@@ -3021,27 +5304,29 @@ public:
 	 */
 	template <typename T>
 	SourceLocation readAggregate(T& value) {
-		const SourceLocation source = parser.peek().source;
-		if constexpr (reflection::aggregate_size_v<T> == 1) {
+		const SourceLocation source = peek().source;
+		if constexpr (detail::named_aggregate<T>) {
+			readNamedAggregate(value);
+		} else if constexpr (reflection::aggregate_size_v<T> == 1) {
 			auto& [v] = value;
 			deserialize(v);
 		} else {
-			if (const Token token = parser.eat(); token.type != TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
+			if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
 				throw Error{"Expected an array.", token.source};
 			}
 			bool successor = false;
 			reflection::forEach(reflection::fields(value), [&](auto& v) -> void {
 				if (successor) {
-					if (const Token token = parser.eat(); token.type != TokenType::PUNCTUATOR_COMMA) {
+					if (const Token token = eat(); token.type != TokenType::PUNCTUATOR_COMMA) {
 						throw Error{"Expected a comma.", token.source};
 					}
 				}
 				successor = true;
 				deserialize(v);
 			});
-			Token token = parser.eat();
+			Token token = eat();
 			if (token.type == TokenType::PUNCTUATOR_COMMA) {
-				token = parser.eat();
+				token = eat();
 			}
 			if (token.type != TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
 				throw Error{"Missing end of array.", token.source};
@@ -3080,7 +5365,9 @@ public:
  */
 template <typename T>
 inline void serialize(std::ostream& stream, const T& value, const SerializationOptions& options) {
-	Writer{stream, options}.serialize(value);
+	Writer writer{stream, options};
+	writer.serialize(value);
+	writer.flush();
 }
 
 /**
@@ -3101,6 +5388,42 @@ inline void deserialize(std::istream& stream, T& value, const DeserializationOpt
 	Reader{stream, options}.deserialize(value);
 }
 
+/**
+ * Read a JSON value from a UTF-8 JSON string into any value that is
+ * deserializable from JSON using its corresponding implementation of
+ * Deserializer.
+ *
+ * \param jsonString read-only view over the JSON string to read from.
+ * \param value reference to the output value to write the parsed result to.
+ * \param options input options, see DeserializationOptions.
+ *
+ * \throws any exception thrown by the Deserializer implementation of T.
+ *
+ * \sa Reader
+ */
+template <typename T>
+inline void deserialize(std::u8string_view jsonString, T& value, const DeserializationOptions& options) {
+	Reader{jsonString, options}.deserialize(value);
+}
+
+/**
+ * Read a JSON value from a JSON string of bytes, interpreted as UTF-8, into any
+ * value that is deserializable from JSON using its corresponding implementation
+ * of Deserializer.
+ *
+ * \param jsonString read-only view over the JSON string to read from.
+ * \param value reference to the output value to write the parsed result to.
+ * \param options input options, see DeserializationOptions.
+ *
+ * \throws any exception thrown by the Deserializer implementation of T.
+ *
+ * \sa Reader
+ */
+template <typename T>
+inline void deserialize(std::string_view jsonString, T& value, const DeserializationOptions& options) {
+	Reader{jsonString, options}.deserialize(value);
+}
+
 namespace detail {
 
 struct NoVisitor {};
@@ -3797,7 +6120,7 @@ inline Object& Object::operator=(Object&& other) noexcept = default;
 template <typename InputIt>
 inline Object::Object(InputIt first, InputIt last)
 	: membersSortedByName(first, last) {
-	std::sort(membersSortedByName.begin(), membersSortedByName.end(), Compare{});
+	std::stable_sort(membersSortedByName.begin(), membersSortedByName.end(), Compare{});
 }
 
 inline Object::Object(std::initializer_list<value_type> ilist)
@@ -3805,7 +6128,7 @@ inline Object::Object(std::initializer_list<value_type> ilist)
 
 inline Object& Object::operator=(std::initializer_list<value_type> ilist) {
 	membersSortedByName = ilist;
-	std::sort(membersSortedByName.begin(), membersSortedByName.end(), Compare{});
+	std::stable_sort(membersSortedByName.begin(), membersSortedByName.end(), Compare{});
 	return *this;
 }
 
@@ -3891,6 +6214,18 @@ inline Object::size_type Object::max_size() const noexcept {
 	return membersSortedByName.max_size();
 }
 
+inline Object::size_type Object::capacity() const noexcept {
+	return membersSortedByName.capacity();
+}
+
+inline void Object::reserve(size_type newCap) {
+	membersSortedByName.reserve(newCap);
+}
+
+inline void Object::shrink_to_fit() {
+	membersSortedByName.shrink_to_fit();
+}
+
 inline void Object::clear() noexcept {
 	membersSortedByName.clear();
 }
@@ -3907,9 +6242,26 @@ inline Object::iterator Object::insert(const_iterator pos, P&& value) {
 
 template <typename InputIt>
 inline void Object::insert(InputIt first, InputIt last) {
-	while (first != last) {
-		insert(*first++);
+	// Inserting the members one by one would take quadratic time, since every insertion shifts the members after it, so the new members are instead
+	// appended and sorted on their own, and then merged with the existing members in a single pass.
+	const auto oldSize = static_cast<difference_type>(membersSortedByName.size());
+	membersSortedByName.insert(membersSortedByName.end(), first, last);
+	const iterator middle = membersSortedByName.begin() + oldSize;
+	std::stable_sort(middle, membersSortedByName.end(), Compare{});
+
+	// Like emplace(), skip members whose names are already present, keeping only the first of any duplicates among the new members.
+	iterator output = middle;
+	for (iterator it = middle; it != membersSortedByName.end(); ++it) {
+		if ((output != middle && std::prev(output)->first == it->first) || std::binary_search(membersSortedByName.begin(), middle, std::string_view{it->first}, Compare{})) {
+			continue;
+		}
+		if (output != it) {
+			*output = std::move(*it);
+		}
+		++output;
 	}
+	membersSortedByName.erase(output, membersSortedByName.end());
+	std::inplace_merge(membersSortedByName.begin(), middle, membersSortedByName.end(), Compare{});
 }
 
 inline void Object::insert(std::initializer_list<Object::value_type> ilist) {
@@ -4297,9 +6649,649 @@ inline Value Value::parse(std::string_view jsonString) {
 }
 
 inline std::string Value::toString(const SerializationOptions& options) const {
-	std::ostringstream stream{};
-	json::serialize(stream, *this, options);
-	return std::move(stream).str();
+	std::string result{};
+	Writer{result, options}.serialize(*this);
+	return result;
+}
+
+inline const DocumentValue& DocumentObject::at(std::string_view name) const {
+	if (const const_iterator it = find(name); it != end()) {
+		return it->value;
+	}
+	throw std::out_of_range{"JSON object does not contain a member with the given name."};
+}
+
+inline DocumentObject::const_iterator DocumentObject::begin() const noexcept {
+	return members;
+}
+
+inline DocumentObject::const_iterator DocumentObject::end() const noexcept {
+	return members + memberCount;
+}
+
+inline bool DocumentObject::empty() const noexcept {
+	return memberCount == 0;
+}
+
+inline DocumentObject::size_type DocumentObject::size() const noexcept {
+	return memberCount;
+}
+
+inline bool DocumentObject::contains(std::string_view name) const noexcept {
+	return find(name) != end();
+}
+
+inline DocumentObject::const_iterator DocumentObject::find(std::string_view name) const noexcept {
+	const const_iterator it = std::lower_bound(begin(), end(), name, [](const DocumentMember& member, std::string_view name) -> bool { return member.name < name; });
+	return (it != end() && it->name == name) ? it : end();
+}
+
+inline const DocumentValue& DocumentArray::at(size_type pos) const {
+	if (pos >= itemCount) {
+		throw std::out_of_range{"JSON array index out of range."};
+	}
+	return items[pos];
+}
+
+inline const DocumentValue& DocumentArray::operator[](size_type pos) const {
+	return items[pos];
+}
+
+inline DocumentArray::const_iterator DocumentArray::begin() const noexcept {
+	return items;
+}
+
+inline DocumentArray::const_iterator DocumentArray::end() const noexcept {
+	return items + itemCount;
+}
+
+inline bool DocumentArray::empty() const noexcept {
+	return itemCount == 0;
+}
+
+inline DocumentArray::size_type DocumentArray::size() const noexcept {
+	return itemCount;
+}
+
+inline Value DocumentValue::toValue() const {
+	return match(*this)(
+		[](const DocumentObject& value) -> Value {
+			Object result{};
+			result.reserve(value.size());
+			for (const DocumentMember& member : value) {
+				result.emplace(String{member.name}, member.value.toValue());
+			}
+			return result;
+		},
+		[](const DocumentArray& value) -> Value {
+			Array result{};
+			result.reserve(value.size());
+			for (const DocumentValue& item : value) {
+				result.push_back(item.toValue());
+			}
+			return result;
+		},
+		[](const auto& value) -> Value { return value; });
+}
+
+inline void Document::parse(std::u8string_view jsonString) {
+	const unicode::UTF8View codePoints{jsonString};
+	Lexer<const char8_t*> lexer{codePoints.begin(), codePoints.end(), SourceLocation{.lineNumber = 1, .columnNumber = 1}};
+	lexer.setStringBorrowing(true);
+	StringParser parser{std::move(lexer)};
+	Scratch scratch{};
+	root = parseValue(parser, scratch);
+	if (const Token& token = parser.peek(); token.type != TokenType::END_OF_FILE) {
+		throw Error{"Multiple top-level values.", token.source};
+	}
+}
+
+inline DocumentValue Document::parseValue(StringParser& parser, Scratch& scratch) {
+	switch (parser.peek().type) {
+		case TokenType::IDENTIFIER_NULL: parser.advance(); return Null{};
+		case TokenType::IDENTIFIER_FALSE: parser.advance(); return Boolean{false};
+		case TokenType::IDENTIFIER_TRUE: parser.advance(); return Boolean{true};
+		case TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET: return parseArray(parser, scratch);
+		case TokenType::PUNCTUATOR_OPEN_CURLY_BRACE: return parseObject(parser, scratch);
+		case TokenType::STRING: return makeString(parser.eat());
+		case TokenType::NUMBER_BINARY: [[fallthrough]];
+		case TokenType::NUMBER_OCTAL: [[fallthrough]];
+		case TokenType::NUMBER_DECIMAL: [[fallthrough]];
+		case TokenType::NUMBER_HEXADECIMAL: [[fallthrough]];
+		case TokenType::NUMBER_POSITIVE_INFINITY: [[fallthrough]];
+		case TokenType::NUMBER_NEGATIVE_INFINITY: [[fallthrough]];
+		case TokenType::NUMBER_POSITIVE_NAN: [[fallthrough]];
+		case TokenType::NUMBER_NEGATIVE_NAN: return parser.parseNumber();
+		default: break;
+	}
+	// Any other token is invalid, which the parser reports in the same way as it would for a Value.
+	parser.skipValue();
+	return Null{};
+}
+
+inline DocumentObject Document::parseObject(StringParser& parser, Scratch& scratch) {
+	parser.advance();
+	const std::size_t firstMemberIndex = scratch.members.size();
+	while (true) {
+		Token token = parser.eat();
+		if (token.type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+			break;
+		}
+		if (token.type != TokenType::STRING && token.type != TokenType::IDENTIFIER_NAME) {
+			throw Error{"Expected a property name.", token.source};
+		}
+		const std::string_view name = makeString(std::move(token));
+		if (const Token colon = parser.eat(); colon.type != TokenType::PUNCTUATOR_COLON) {
+			throw Error{"Expected a colon.", colon.source};
+		}
+		const DocumentValue value = parseValue(parser, scratch);
+		scratch.members.push_back(DocumentMember{.name = name, .value = value});
+		if (const Token& separator = parser.peek(); separator.type == TokenType::PUNCTUATOR_COMMA) {
+			parser.advance();
+		} else if (separator.type != TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+			throw Error{"Expected a comma or closing brace.", separator.source};
+		}
+	}
+	const auto first = scratch.members.begin() + static_cast<std::ptrdiff_t>(firstMemberIndex);
+	const auto last = scratch.members.end();
+	if (first == last) {
+		return DocumentObject{};
+	}
+
+	// Sort the members by name while keeping duplicates in their original order. Insertion sort is used for small objects, which are the most
+	// common, since std::stable_sort would allocate a temporary buffer for every single one of them.
+	const auto compare = [](const DocumentMember& a, const DocumentMember& b) -> bool { return a.name < b.name; };
+	constexpr std::ptrdiff_t MAX_INSERTION_SORT_SIZE = 32;
+	if (last - first <= MAX_INSERTION_SORT_SIZE) {
+		for (auto it = first; it != last; ++it) {
+			std::rotate(std::upper_bound(first, it, *it, compare), it, std::next(it));
+		}
+	} else {
+		std::stable_sort(first, last, compare);
+	}
+	const auto uniqueLast = std::unique(first, last, [](const DocumentMember& a, const DocumentMember& b) -> bool { return a.name == b.name; });
+	const std::span<const DocumentMember> members{first, uniqueLast};
+	const DocumentObject result{copyToArena(members), members.size()};
+	scratch.members.erase(first, last);
+	return result;
+}
+
+inline DocumentArray Document::parseArray(StringParser& parser, Scratch& scratch) {
+	parser.advance();
+	const std::size_t firstItemIndex = scratch.items.size();
+	while (parser.peek().type != TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+		const DocumentValue item = parseValue(parser, scratch);
+		scratch.items.push_back(item);
+		if (const Token& separator = parser.peek(); separator.type == TokenType::PUNCTUATOR_COMMA) {
+			parser.advance();
+		} else if (separator.type != TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+			throw Error{"Expected a comma or closing bracket.", separator.source};
+		}
+	}
+	parser.advance();
+	const auto first = scratch.items.begin() + static_cast<std::ptrdiff_t>(firstItemIndex);
+	if (first == scratch.items.end()) {
+		return DocumentArray{};
+	}
+	const std::span<const DocumentValue> items{first, scratch.items.end()};
+	const DocumentArray result{copyToArena(items), items.size()};
+	scratch.items.erase(first, scratch.items.end());
+	return result;
+}
+
+inline std::string_view Document::makeString(Token&& token) {
+	if (token.string.empty()) {
+		return token.borrowedString;
+	}
+	char* const data = LinearAllocator<char>{&memoryResource}.allocate(token.string.size());
+	std::memcpy(data, token.string.data(), token.string.size());
+	return std::string_view{data, token.string.size()};
+}
+
+inline std::optional<Cursor> Cursor::find(std::string_view name) const {
+	Lexer<const char8_t*> memberLexer = makeNavigationLexer();
+	if (const Token token = memberLexer.scan(); token.type != TokenType::PUNCTUATOR_OPEN_CURLY_BRACE) {
+		throw Error{"Expected an object.", token.source};
+	}
+	while (true) {
+		const Token memberName = scanPropertyName(memberLexer);
+		if (memberName.type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+			break;
+		}
+		if (((memberName.string.empty()) ? memberName.borrowedString : std::string_view{memberName.string}) == name) {
+			return Cursor{memberLexer};
+		}
+		skipValue(memberLexer, memberLexer.scan());
+		if (!scanSeparator(memberLexer, TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE)) {
+			break;
+		}
+	}
+	return std::nullopt;
+}
+
+inline Cursor Cursor::at(std::string_view name) const {
+	if (std::optional<Cursor> member = find(name)) {
+		return *std::move(member);
+	}
+	throw std::out_of_range{"JSON object does not contain a member with the given name."};
+}
+
+inline std::optional<Cursor> Cursor::find(std::size_t index) const {
+	Lexer<const char8_t*> itemLexer = makeNavigationLexer();
+	if (const Token token = itemLexer.scan(); token.type != TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
+		throw Error{"Expected an array.", token.source};
+	}
+	for (std::size_t i = 0;; ++i) {
+		const Lexer<const char8_t*> itemStart = itemLexer;
+		const Token token = itemLexer.scan();
+		if (token.type == TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+			break;
+		}
+		if (i == index) {
+			return Cursor{itemStart};
+		}
+		skipValue(itemLexer, token);
+		if (!scanSeparator(itemLexer, TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET)) {
+			break;
+		}
+	}
+	return std::nullopt;
+}
+
+inline Cursor Cursor::at(std::size_t index) const {
+	if (std::optional<Cursor> item = find(index)) {
+		return *std::move(item);
+	}
+	throw std::out_of_range{"JSON array index out of range."};
+}
+
+inline Token Cursor::scanPropertyName(Lexer<const char8_t*>& lexer) {
+	Token token = lexer.scan();
+	switch (token.type) {
+		case TokenType::END_OF_FILE: throw Error{"Missing end of object.", token.source};
+		case TokenType::IDENTIFIER_NULL: throw Error{"Unexpected null.", token.source};
+		case TokenType::IDENTIFIER_FALSE: throw Error{"Unexpected false.", token.source};
+		case TokenType::IDENTIFIER_TRUE: throw Error{"Unexpected true.", token.source};
+		case TokenType::IDENTIFIER_NAME: [[fallthrough]];
+		case TokenType::STRING: break;
+		case TokenType::PUNCTUATOR_COMMA: [[fallthrough]];
+		case TokenType::PUNCTUATOR_COLON: [[fallthrough]];
+		case TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET: [[fallthrough]];
+		case TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET: [[fallthrough]];
+		case TokenType::PUNCTUATOR_OPEN_CURLY_BRACE: throw Error{"Unexpected punctuator.", token.source};
+		case TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE: return token;
+		case TokenType::NUMBER_BINARY: [[fallthrough]];
+		case TokenType::NUMBER_OCTAL: [[fallthrough]];
+		case TokenType::NUMBER_DECIMAL: [[fallthrough]];
+		case TokenType::NUMBER_HEXADECIMAL: [[fallthrough]];
+		case TokenType::NUMBER_POSITIVE_INFINITY: [[fallthrough]];
+		case TokenType::NUMBER_NEGATIVE_INFINITY: [[fallthrough]];
+		case TokenType::NUMBER_POSITIVE_NAN: [[fallthrough]];
+		case TokenType::NUMBER_NEGATIVE_NAN: throw Error{"Unexpected number.", token.source};
+	}
+	if (const Token colon = lexer.scan(); colon.type != TokenType::PUNCTUATOR_COLON) {
+		throw Error{"Expected a colon.", colon.source};
+	}
+	return token;
+}
+
+inline bool Cursor::scanSeparator(Lexer<const char8_t*>& lexer, TokenType closingBracket) {
+	const Token token = lexer.scan();
+	if (token.type == TokenType::PUNCTUATOR_COMMA) {
+		return true;
+	}
+	if (token.type != closingBracket) {
+		throw Error{(closingBracket == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) ? "Expected a comma or closing brace." : "Expected a comma or closing bracket.", token.source};
+	}
+	return false;
+}
+
+inline void Cursor::skipValue(Lexer<const char8_t*>& lexer, const Token& token) {
+	switch (token.type) {
+		case TokenType::END_OF_FILE: throw Error{"Expected a value.", token.source};
+		case TokenType::IDENTIFIER_NULL: [[fallthrough]];
+		case TokenType::IDENTIFIER_FALSE: [[fallthrough]];
+		case TokenType::IDENTIFIER_TRUE: break;
+		case TokenType::IDENTIFIER_NAME: throw Error{"Unexpected name identifier.", token.source};
+		case TokenType::PUNCTUATOR_COMMA: throw Error{"Unexpected comma.", token.source};
+		case TokenType::PUNCTUATOR_COLON: throw Error{"Unexpected colon.", token.source};
+		case TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET: lexer.skipContainerContents(); break;
+		case TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET: throw Error{"Unexpected closing bracket.", token.source};
+		case TokenType::PUNCTUATOR_OPEN_CURLY_BRACE: lexer.skipContainerContents(); break;
+		case TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE: throw Error{"Unexpected closing brace.", token.source};
+		case TokenType::STRING: [[fallthrough]];
+		case TokenType::NUMBER_BINARY: [[fallthrough]];
+		case TokenType::NUMBER_OCTAL: [[fallthrough]];
+		case TokenType::NUMBER_DECIMAL: [[fallthrough]];
+		case TokenType::NUMBER_HEXADECIMAL: [[fallthrough]];
+		case TokenType::NUMBER_POSITIVE_INFINITY: [[fallthrough]];
+		case TokenType::NUMBER_NEGATIVE_INFINITY: [[fallthrough]];
+		case TokenType::NUMBER_POSITIVE_NAN: [[fallthrough]];
+		case TokenType::NUMBER_NEGATIVE_NAN: break;
+	}
+}
+
+inline void IncrementalParser::finish() {
+	parseBufferedTokens(buffer.size());
+	if (!closingBrackets.empty()) {
+		throw Error{(closingBrackets.back() == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) ? "Missing end of object." : "Missing end of array.", source};
+	}
+	if (state == State::VALUE && !options.multipleTopLevelValues) {
+		throw Error{"Expected a value.", source};
+	}
+	*this = IncrementalParser{*visitor, options};
+}
+
+inline std::size_t IncrementalParser::scanTokenBoundaries() noexcept {
+	const auto isDelimiter = [](char ch) -> bool {
+		switch (ch) {
+			case ' ': [[fallthrough]];
+			case '\t': [[fallthrough]];
+			case '\n': [[fallthrough]];
+			case '\v': [[fallthrough]];
+			case '\f': [[fallthrough]];
+			case '\r': [[fallthrough]];
+			case ',': [[fallthrough]];
+			case ':': [[fallthrough]];
+			case '[': [[fallthrough]];
+			case ']': [[fallthrough]];
+			case '{': [[fallthrough]];
+			case '}': [[fallthrough]];
+			case '\"': [[fallthrough]];
+			case '\'': [[fallthrough]];
+			case '/': return true;
+			default: break;
+		}
+		return false;
+	};
+	std::size_t i = scanOffset;
+	while (i < buffer.size()) {
+		const char ch = buffer[i];
+		switch (scanState) {
+			case ScanState::NEUTRAL:
+				// A line feed that follows a carriage return belongs to the same line terminator, which must not be split.
+				if (ch != '\n' || i == 0 || buffer[i - 1] != '\r') {
+					boundary = i;
+				}
+				switch (ch) {
+					case ' ': [[fallthrough]];
+					case '\t': [[fallthrough]];
+					case '\n': [[fallthrough]];
+					case '\v': [[fallthrough]];
+					case '\f': [[fallthrough]];
+					case '\r': break;
+					case ',': [[fallthrough]];
+					case ':': [[fallthrough]];
+					case '[': [[fallthrough]];
+					case ']': [[fallthrough]];
+					case '{': [[fallthrough]];
+					case '}': boundary = i + 1; break;
+					case '\"': [[fallthrough]];
+					case '\'':
+						quote = ch;
+						scanState = ScanState::STRING;
+						break;
+					case '/': scanState = ScanState::SLASH; break;
+					default: scanState = ScanState::WORD; break;
+				}
+				break;
+			case ScanState::WORD:
+				// Numbers and identifiers only end where a delimiter is found, which is then scanned as the beginning of the next token.
+				if (isDelimiter(ch)) {
+					scanState = ScanState::NEUTRAL;
+					continue;
+				}
+				break;
+			case ScanState::STRING:
+				if (ch == '\\') {
+					scanState = ScanState::STRING_ESCAPE;
+				} else if (ch == quote) {
+					scanState = ScanState::NEUTRAL;
+					boundary = i + 1;
+				}
+				break;
+			case ScanState::STRING_ESCAPE: scanState = ScanState::STRING; break;
+			case ScanState::SLASH:
+				// A slash that doesn't begin a comment is invalid, which is reported by the lexer once the following word is complete.
+				scanState = (ch == '/') ? ScanState::LINE_COMMENT : (ch == '*') ? ScanState::BLOCK_COMMENT : ScanState::WORD;
+				break;
+			case ScanState::LINE_COMMENT:
+				// Line comments also end at U+2028 and U+2029, which are encoded as E2 80 A8 and E2 80 A9.
+				if (ch == '\n' || ch == '\r') {
+					scanState = ScanState::NEUTRAL;
+					continue;
+				}
+				if ((ch == '\xA8' || ch == '\xA9') && i >= 2 && buffer[i - 2] == '\xE2' && buffer[i - 1] == '\x80') {
+					scanState = ScanState::NEUTRAL;
+					boundary = i + 1;
+				}
+				break;
+			case ScanState::BLOCK_COMMENT:
+				if (ch == '*') {
+					scanState = ScanState::BLOCK_COMMENT_STAR;
+				}
+				break;
+			case ScanState::BLOCK_COMMENT_STAR:
+				if (ch == '/') {
+					scanState = ScanState::NEUTRAL;
+					boundary = i + 1;
+				} else if (ch != '*') {
+					scanState = ScanState::BLOCK_COMMENT;
+				}
+				break;
+		}
+		++i;
+	}
+	scanOffset = i;
+	return boundary;
+}
+
+inline void IncrementalParser::parseBufferedTokens(std::size_t size) {
+	if (size == 0) {
+		return;
+	}
+	StringParser parser{Lexer<const char8_t*>{
+		unicode::UTF8View{std::u8string_view{reinterpret_cast<const char8_t*>(buffer.data()), size}}.begin(),
+		unicode::UTF8Sentinel{},
+		source,
+	}};
+	while (true) {
+		if (const Token& token = parser.peek(); token.type == TokenType::END_OF_FILE) {
+			source = token.source;
+			break;
+		}
+		parseToken(parser);
+	}
+	buffer.erase(0, size);
+	scanOffset -= size;
+	boundary -= size;
+}
+
+inline void IncrementalParser::parseToken(StringParser& parser) {
+	const Token& token = parser.peek();
+	switch (state) {
+		case State::END:
+			if (!options.multipleTopLevelValues) {
+				throw Error{"Multiple top-level values.", token.source};
+			}
+			parseValueToken(parser);
+			break;
+		case State::VALUE: [[fallthrough]];
+		case State::OBJECT_VALUE: parseValueToken(parser); break;
+		case State::OBJECT_PROPERTY_NAME_OR_END:
+			switch (token.type) {
+				case TokenType::IDENTIFIER_NULL: throw Error{"Unexpected null.", token.source};
+				case TokenType::IDENTIFIER_FALSE: throw Error{"Unexpected false.", token.source};
+				case TokenType::IDENTIFIER_TRUE: throw Error{"Unexpected true.", token.source};
+				case TokenType::IDENTIFIER_NAME: [[fallthrough]];
+				case TokenType::STRING: {
+					const SourceLocation nameSource = token.source;
+					visitor->visitPropertyName(nameSource, std::move(parser.eat().string));
+					state = State::OBJECT_COLON;
+					break;
+				}
+				case TokenType::PUNCTUATOR_COMMA: [[fallthrough]];
+				case TokenType::PUNCTUATOR_COLON: [[fallthrough]];
+				case TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET: [[fallthrough]];
+				case TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET: [[fallthrough]];
+				case TokenType::PUNCTUATOR_OPEN_CURLY_BRACE: throw Error{"Unexpected punctuator.", token.source};
+				case TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE: parseContainerEnd(parser); break;
+				default: throw Error{"Unexpected number.", token.source};
+			}
+			break;
+		case State::OBJECT_COLON:
+			if (token.type != TokenType::PUNCTUATOR_COLON) {
+				throw Error{"Expected a colon.", token.source};
+			}
+			parser.advance();
+			state = State::OBJECT_VALUE;
+			break;
+		case State::OBJECT_COMMA_OR_END:
+			if (token.type == TokenType::PUNCTUATOR_COMMA) {
+				parser.advance();
+				state = State::OBJECT_PROPERTY_NAME_OR_END;
+			} else if (token.type == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) {
+				parseContainerEnd(parser);
+			} else {
+				throw Error{"Expected a comma or closing brace.", token.source};
+			}
+			break;
+		case State::ARRAY_ITEM_OR_END:
+			if (token.type == TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+				parseContainerEnd(parser);
+			} else {
+				parseValueToken(parser);
+			}
+			break;
+		case State::ARRAY_COMMA_OR_END:
+			if (token.type == TokenType::PUNCTUATOR_COMMA) {
+				parser.advance();
+				state = State::ARRAY_ITEM_OR_END;
+			} else if (token.type == TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET) {
+				parseContainerEnd(parser);
+			} else {
+				throw Error{"Expected a comma or closing bracket.", token.source};
+			}
+			break;
+	}
+}
+
+inline void IncrementalParser::parseValueToken(StringParser& parser) {
+	const Token& token = parser.peek();
+	const SourceLocation valueSource = token.source;
+	if (token.type == TokenType::PUNCTUATOR_OPEN_CURLY_BRACE) {
+		parser.advance();
+		closingBrackets.push_back(TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE);
+		state = State::OBJECT_PROPERTY_NAME_OR_END;
+		visitor->visitObjectBegin(valueSource);
+	} else if (token.type == TokenType::PUNCTUATOR_OPEN_SQUARE_BRACKET) {
+		parser.advance();
+		closingBrackets.push_back(TokenType::PUNCTUATOR_CLOSE_SQUARE_BRACKET);
+		state = State::ARRAY_ITEM_OR_END;
+		visitor->visitArrayBegin(valueSource);
+	} else {
+		// Every other value is a single token at this point, which the regular parser can report to the visitor directly.
+		parser.parseValue(static_cast<StringParser::ValueVisitor&>(*visitor));
+		completeValue();
+	}
+}
+
+inline void IncrementalParser::parseContainerEnd(StringParser& parser) {
+	const SourceLocation endSource = parser.peek().source;
+	parser.advance();
+	const bool object = closingBrackets.back() == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE;
+	closingBrackets.pop_back();
+	completeValue();
+	if (object) {
+		visitor->visitObjectEnd(endSource);
+	} else {
+		visitor->visitArrayEnd(endSource);
+	}
+}
+
+inline void IncrementalParser::completeValue() noexcept {
+	if (closingBrackets.empty()) {
+		state = State::END;
+	} else {
+		state = (closingBrackets.back() == TokenType::PUNCTUATOR_CLOSE_CURLY_BRACE) ? State::OBJECT_COMMA_OR_END : State::ARRAY_COMMA_OR_END;
+	}
+}
+
+inline Query::Query(std::string_view path) {
+	if (path.empty()) {
+		return;
+	}
+	if (path.front() != '/') {
+		while (true) {
+			const std::size_t separator = path.find('.');
+			addStep(String{path.substr(0, separator)});
+			if (separator == std::string_view::npos) {
+				break;
+			}
+			path.remove_prefix(separator + 1);
+		}
+		return;
+	}
+	do {
+		path.remove_prefix(1);
+		const std::size_t separator = path.find('/');
+		const std::string_view segment = path.substr(0, separator);
+		String name{};
+		name.reserve(segment.size());
+		for (std::size_t i = 0; i < segment.size(); ++i) {
+			if (segment[i] != '~') {
+				name.push_back(segment[i]);
+			} else if (i + 1 < segment.size() && segment[i + 1] == '0') {
+				name.push_back('~');
+				++i;
+			} else if (i + 1 < segment.size() && segment[i + 1] == '1') {
+				name.push_back('/');
+				++i;
+			} else {
+				throw std::invalid_argument{"Invalid escape sequence in JSON pointer."};
+			}
+		}
+		addStep(std::move(name));
+		path.remove_prefix(segment.size());
+	} while (!path.empty());
+}
+
+inline const Value* Query::find(const Value& root) const noexcept {
+	const Value* result = nullptr;
+	forEachMatch(root, [&](const Value& value) -> void {
+		if (!result) {
+			result = &value;
+		}
+	});
+	return result;
+}
+
+inline std::vector<const Value*> Query::findAll(const Value& root) const {
+	std::vector<const Value*> result{};
+	forEachMatch(root, [&](const Value& value) -> void { result.push_back(&value); });
+	return result;
+}
+
+inline std::vector<Cursor> Query::findAll(const Cursor& root) const {
+	std::vector<Cursor> result{};
+	forEachMatch(root, [&](const Cursor& value) -> void { result.push_back(value); });
+	return result;
+}
+
+inline void Query::addStep(String&& name) {
+	Step& step = steps.emplace_back();
+	if (name == "*") {
+		step.wildcard = true;
+		return;
+	}
+	// Array indices must not have leading zeros, so that every index has exactly one spelling.
+	if (!name.empty() && (name.front() != '0' || name.size() == 1)) {
+		std::size_t index = 0;
+		if (const auto [ptr, ec] = std::from_chars(name.data(), name.data() + name.size(), index); ec == std::errc{} && ptr == name.data() + name.size()) {
+			step.index = index;
+		}
+	}
+	step.name = std::move(name);
 }
 
 } // namespace donut::json
@@ -6,12 +6,24 @@
 
 namespace donut::graphics {
 
+struct JointTransform;
+struct Skeleton;
+template <typename T>
+struct AnimationTrack;
+struct AnimationClip;
+struct AnimationCursor;
+
 class Buffer;
 
 class Camera;
 
+struct DirtyRange;
+class DirtyRangeSet;
+
 struct Error;
 
+class Fence;
+
 struct FontOptions;
 class Font;
 
@@ -29,6 +41,11 @@ struct ImageSaveJPGOptions;
 struct ImageSaveHDROptions;
 struct ImageOptions;
 class Image;
+struct RawImageOptions;
+class RawImage;
+
+enum class MipmapFilter : std::uint8_t;
+struct MipmapOptions;
 
 enum class MeshBufferUsage : std::uint32_t;
 enum class MeshPrimitiveType : std::uint32_t;
@@ -38,12 +55,27 @@ struct NoInstance;
 template <typename Vertex, typename Index, typename Instance>
 class Mesh;
 
+struct DynamicMeshOptions;
+template <typename Vertex, typename Index>
+class DynamicMesh;
+
+struct VertexCacheStatistics;
+struct MeshSimplificationOptions;
+struct MeshSimplificationResult;
+
+enum class ModelVertexFormat : std::uint32_t;
+struct ModelOptimizationStatistics;
+struct ModelOptions;
 struct Model;
 
+struct ModelGroupOptions;
+class ModelGroup;
+
 struct RendererOptions;
 class Renderer;
 
 struct ModelInstance;
+struct ModelGroupInstance;
 struct TextureInstance;
 struct RectangleInstance;
 struct QuadInstance;
@@ -81,6 +113,11 @@ struct TexturedQuad;
 
 class VertexArray;
 
+template <typename T>
+struct Normalized;
+struct PackedHalf2x16;
+struct PackedSnorm3x10_1x2;
+
 struct Viewport;
 
 struct WindowOptions;
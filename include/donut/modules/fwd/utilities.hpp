@@ -7,7 +7,41 @@
 
 namespace donut {
 
-template <std::size_t InitialResolution, std::size_t Padding>
+/**
+ * Algorithm used by an AtlasPacker to find space for new rectangles.
+ */
+enum class AtlasPackingStrategy : std::uint8_t {
+	/**
+	 * Place rectangles left-to-right in horizontal rows, opening a new row at
+	 * the top when no existing row of a similar height has enough space left.
+	 *
+	 * This is the fastest strategy, but it wastes the space above rectangles
+	 * that are shorter than the row they were placed in.
+	 */
+	SHELF,
+
+	/**
+	 * Track the top contour of the packed rectangles as a list of horizontal
+	 * segments, and place each new rectangle at the position that leaves its
+	 * top edge as low as possible.
+	 *
+	 * Packs tighter than SHELF at a small additional cost per insertion.
+	 */
+	SKYLINE_BOTTOM_LEFT,
+
+	/**
+	 * Track a list of maximal free rectangles, and place each new rectangle in
+	 * the free rectangle that leaves the smallest leftover distance along its
+	 * shorter side.
+	 *
+	 * Produces the tightest packing, but the cost per insertion grows with the
+	 * number of free rectangles, which makes it best suited for atlases that
+	 * are built once, for example using insertRectangles().
+	 */
+	MAX_RECTS_BEST_SHORT_SIDE_FIT,
+};
+
+template <std::size_t InitialResolution, std::size_t Padding, AtlasPackingStrategy Strategy = AtlasPackingStrategy::SHELF>
 class AtlasPacker;
 
 namespace base64 {}
@@ -36,10 +70,24 @@ template <typename T>
 struct Serializer;
 template <typename T>
 struct Deserializer;
+template <typename T>
+struct AggregateFieldNames;
+enum class Format : std::uint8_t;
 struct SerializationOptions;
 struct DeserializationOptions;
 struct SerializationState;
 struct DeserializationState;
+class DocumentObject;
+class DocumentArray;
+class DocumentValue;
+struct DocumentMember;
+class Document;
+class Cursor;
+struct IncrementalParserOptions;
+class IncrementalParser;
+struct QueryBatchOptions;
+class Query;
+class CBORParser;
 
 } // namespace json
 
@@ -119,6 +167,12 @@ struct Face;
 struct Group;
 struct Object;
 struct Scene;
+struct StringRange;
+struct FlatGroup;
+struct FlatObject;
+struct ParseOptions;
+struct FlatScene;
+class FlatSceneParser;
 
 namespace mtl {
 
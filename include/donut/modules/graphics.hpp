@@ -1,15 +1,22 @@
 #ifndef DONUT_MODULES_GRAPHICS_HPP
 #define DONUT_MODULES_GRAPHICS_HPP
 
+#include <donut/graphics/Animation.hpp>
 #include <donut/graphics/Buffer.hpp>
 #include <donut/graphics/Camera.hpp>
+#include <donut/graphics/DirtyRangeSet.hpp>
+#include <donut/graphics/DynamicMesh.hpp>
 #include <donut/graphics/Error.hpp>
+#include <donut/graphics/Fence.hpp>
 #include <donut/graphics/Font.hpp>
 #include <donut/graphics/Framebuffer.hpp>
 #include <donut/graphics/Handle.hpp>
 #include <donut/graphics/Image.hpp>
+#include <donut/graphics/ImageProcessing.hpp>
 #include <donut/graphics/Mesh.hpp>
+#include <donut/graphics/MeshOptimization.hpp>
 #include <donut/graphics/Model.hpp>
+#include <donut/graphics/ModelGroup.hpp>
 #include <donut/graphics/RenderPass.hpp>
 #include <donut/graphics/Renderer.hpp>
 #include <donut/graphics/Shader2D.hpp>
@@ -23,6 +30,7 @@
 #include <donut/graphics/Texture.hpp>
 #include <donut/graphics/TexturedQuad.hpp>
 #include <donut/graphics/VertexArray.hpp>
+#include <donut/graphics/VertexPacking.hpp>
 #include <donut/graphics/Viewport.hpp>
 #include <donut/graphics/Window.hpp>
 #include <donut/graphics/opengl.hpp>
@@ -5,11 +5,18 @@
 
 #include <cstddef>     // std::size_t
 #include <cstdint>     // std::uint8_t, std::uint32_t
+#include <span>        // std::span
 #include <stdexcept>   // std::runtime_error
 #include <string>      // std::string
 #include <string_view> // std::string_view
 #include <vector>      // std::vector
 
+namespace donut {
+
+class File; // Forward declaration, to avoid including File.hpp.
+
+} // namespace donut
+
 namespace donut::obj {
 
 /**
@@ -93,6 +100,185 @@ struct Scene {
 	std::vector<Object> objects{};                       ///< List of objects belonging to this scene.
 };
 
+/**
+ * Range of characters within the string buffer of a FlatScene.
+ */
+struct StringRange {
+	std::size_t offset = 0; ///< Index of the first character of the string in FlatScene::strings.
+	std::size_t length = 0; ///< Number of characters in the string.
+};
+
+/**
+ * Group containing a contiguous range of polygonal faces within a FlatObject.
+ */
+struct FlatGroup {
+	StringRange name{};         ///< Name of the group, or empty if no name was specified.
+	StringRange materialName{}; ///< Name of the material of this group, or empty if no material was specified.
+	std::size_t facesBegin = 0; ///< Index of the first face belonging to this group.
+	std::size_t facesEnd = 0;   ///< Index one past the last face belonging to this group.
+};
+
+/**
+ * Object mesh containing a contiguous range of FlatGroup elements within a
+ * FlatScene.
+ */
+struct FlatObject {
+	StringRange name{};          ///< Name of the object, or empty if no name was specified.
+	std::size_t groupsBegin = 0; ///< Index of the first group belonging to this object.
+	std::size_t groupsEnd = 0;   ///< Index one past the last group belonging to this object.
+};
+
+/**
+ * Configuration options for parsing a FlatScene from an OBJ string.
+ */
+struct ParseOptions {
+	/**
+	 * Maximum number of threads to parse the string with, including the
+	 * calling thread, or 0 to use the number of concurrent threads supported
+	 * by the hardware.
+	 *
+	 * When more than one thread is used, the string is split into chunks at
+	 * line boundaries. Each chunk is parsed in parallel into its own arrays,
+	 * and the arrays are merged afterwards. Strings that are too small to
+	 * benefit from this are always parsed on the calling thread only.
+	 */
+	std::size_t threadCount = 1;
+};
+
+/**
+ * Scene of objects defined by an OBJ file, stored in flat arrays.
+ *
+ * Unlike Scene, which performs separate heap allocations for every face and
+ * every name, a flat scene stores the vertices of all faces in a single array
+ * with an offset per face, and all object, group and material names in a
+ * single character buffer. This makes it better suited for very large files.
+ */
+struct FlatScene {
+	/**
+	 * Parse a flat scene from an OBJ string.
+	 *
+	 * \param objString read-only view over the OBJ string to parse.
+	 * \param options parsing options, see ParseOptions.
+	 *
+	 * \return the parsed scene.
+	 *
+	 * \throws Error on failure to parse any element of the scene.
+	 * \throws std::system_error on failure to start a parsing thread.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	[[nodiscard]] static FlatScene parse(std::string_view objString, const ParseOptions& options = {});
+
+	/**
+	 * Parse a flat scene from the remaining contents of an open OBJ file.
+	 *
+	 * The file is read and parsed in fixed-size chunks, so the full contents
+	 * of the file never need to be held in memory at once.
+	 *
+	 * \param file file to read the OBJ data from, starting at its current
+	 *        reading position.
+	 *
+	 * \return the parsed scene.
+	 *
+	 * \throws File::Error on failure to read from the file.
+	 * \throws Error on failure to parse any element of the scene.
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \sa FlatSceneParser
+	 */
+	[[nodiscard]] static FlatScene parse(File& file);
+
+	/**
+	 * Get the number of faces in the scene.
+	 *
+	 * \return the face count.
+	 */
+	[[nodiscard]] std::size_t getFaceCount() const noexcept {
+		return faceOffsets.size() - 1;
+	}
+
+	/**
+	 * Get the vertices of a specific face.
+	 *
+	 * \param faceIndex index of the face, which must be less than
+	 *        getFaceCount().
+	 *
+	 * \return a read-only view over the vertices of the face.
+	 */
+	[[nodiscard]] std::span<const FaceVertex> getFace(std::size_t faceIndex) const noexcept {
+		return std::span<const FaceVertex>{faceVertices}.subspan(faceOffsets[faceIndex], faceOffsets[faceIndex + 1] - faceOffsets[faceIndex]);
+	}
+
+	/**
+	 * Get a string stored in the string buffer of the scene.
+	 *
+	 * \param range range of the string in the buffer.
+	 *
+	 * \return a read-only view over the string.
+	 */
+	[[nodiscard]] std::string_view getString(StringRange range) const noexcept {
+		return std::string_view{strings}.substr(range.offset, range.length);
+	}
+
+	std::vector<std::string> materialLibraryFilenames{}; ///< List of relative filepaths of the material libraries associated with this scene.
+	std::vector<vec3> vertices{};                        ///< List of vertex positions referenced by the face vertices defined in this scene.
+	std::vector<vec2> textureCoordinates{};              ///< List of texture coordinates referenced by the face vertices defined in this scene.
+	std::vector<vec3> normals{};                         ///< List of normal vectors referenced by the face vertices defined in this scene.
+	std::vector<FaceVertex> faceVertices{};              ///< Vertices of all faces in this scene, stored consecutively face by face.
+	std::vector<std::size_t> faceOffsets{0};             ///< Index of the first vertex of each face in #faceVertices, followed by the total number of face vertices.
+	std::vector<FlatGroup> groups{};                     ///< List of groups belonging to the objects of this scene.
+	std::vector<FlatObject> objects{};                   ///< List of objects belonging to this scene.
+	std::string strings{};                               ///< Character buffer referenced by the StringRange of every name in this scene.
+};
+
+/**
+ * Incremental parser that builds a FlatScene from consecutive chunks of an OBJ
+ * file.
+ *
+ * Chunks may be split at arbitrary positions, including in the middle of a
+ * line. Only the last incomplete line of each chunk is buffered internally
+ * until the rest of the line arrives with a later chunk.
+ *
+ * \note The Error::position of any error thrown by this parser refers to an
+ *       unspecified location. Use Error::lineNumber to locate the error.
+ */
+class FlatSceneParser {
+public:
+	/**
+	 * Construct a parser for a new, empty scene.
+	 *
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	FlatSceneParser();
+
+	/**
+	 * Parse the next chunk of OBJ data.
+	 *
+	 * \param chunk read-only view over the next chunk. The view only needs to
+	 *        remain valid for the duration of the call.
+	 *
+	 * \throws Error on failure to parse any element of the scene.
+	 * \throws std::bad_alloc on allocation failure.
+	 */
+	void parse(std::string_view chunk);
+
+	/**
+	 * Parse any remaining buffered data and get the resulting scene.
+	 *
+	 * \return the parsed scene.
+	 *
+	 * \throws Error on failure to parse any element of the scene.
+	 * \throws std::bad_alloc on allocation failure.
+	 *
+	 * \warning The parser must not be used again after calling this function.
+	 */
+	[[nodiscard]] FlatScene finish();
+
+private:
+	FlatScene scene{};
+	std::string incompleteLine{};
+	std::size_t lineNumber = 1;
+};
+
 namespace mtl {
 
 /**
@@ -242,6 +242,10 @@ public:
 		return it;
 	}
 
+	[[nodiscard]] constexpr Sentinel baseEnd() const {
+		return end;
+	}
+
 private:
 	It it{};
 	It next{};
@@ -0,0 +1,118 @@
+#include <donut/graphics/Animation.hpp>
+#include <donut/math.hpp>
+
+#include <algorithm> // std::upper_bound, std::min
+#include <cassert>   // assert
+#include <cstddef>   // std::size_t, std::ptrdiff_t
+#include <cstdint>   // std::uint32_t
+#include <span>      // std::span
+#include <vector>    // std::vector
+
+namespace donut::graphics {
+
+namespace {
+
+// Find the last keyframe at or before the given time, starting from the keyframe found by the previous sample. Playback usually advances by at most a
+// few keyframes between samples, so a short linear scan is tried before falling back to a binary search.
+[[nodiscard]] std::uint32_t findKeyframe(std::span<const float> times, float time, std::uint32_t previousKeyframe) noexcept {
+	constexpr std::size_t MAX_LINEAR_STEPS = 4;
+
+	std::size_t keyframe = (previousKeyframe < times.size()) ? previousKeyframe : 0;
+	auto first = times.begin();
+	auto last = times.end();
+	if (times[keyframe] <= time) {
+		for (std::size_t step = 0; step < MAX_LINEAR_STEPS; ++step) {
+			if (keyframe + 1 >= times.size() || time < times[keyframe + 1]) {
+				return static_cast<std::uint32_t>(keyframe);
+			}
+			++keyframe;
+		}
+		first += static_cast<std::ptrdiff_t>(keyframe);
+	} else {
+		last = first + static_cast<std::ptrdiff_t>(keyframe);
+	}
+	const auto next = std::upper_bound(first, last, time);
+	return (next == times.begin()) ? 0 : static_cast<std::uint32_t>(next - times.begin() - 1);
+}
+
+// Normalized linear interpolation along the shortest path, which is much cheaper than slerp and practically indistinguishable from it for the small
+// angles between consecutive keyframes.
+[[nodiscard]] quat nlerp(const quat& a, const quat& b, float t) noexcept {
+	const quat target = (dot(a, b) < 0.0f) ? -b : b;
+	return normalize(a * (1.0f - t) + target * t);
+}
+
+template <typename T, typename Interpolate>
+[[nodiscard]] T sampleTrack(const AnimationTrack<T>& track, float time, std::uint32_t& previousKeyframe, Interpolate interpolate) {
+	const std::uint32_t keyframe = findKeyframe(track.times, time, previousKeyframe);
+	previousKeyframe = keyframe;
+	if (keyframe + 1 >= track.times.size() || time <= track.times[keyframe]) {
+		return track.values[keyframe];
+	}
+	const float t = (time - track.times[keyframe]) / (track.times[keyframe + 1] - track.times[keyframe]);
+	return interpolate(track.values[keyframe], track.values[keyframe + 1], t);
+}
+
+template <typename T, typename Interpolate>
+void sampleTracks(std::span<const AnimationTrack<T>> tracks, float time, std::span<std::uint32_t> keyframes, std::span<JointTransform> pose, T JointTransform::*component,
+	Interpolate interpolate) {
+	const std::size_t jointCount = std::min(tracks.size(), pose.size());
+	for (std::size_t joint = 0; joint < jointCount; ++joint) {
+		if (!tracks[joint].times.empty()) {
+			pose[joint].*component = sampleTrack(tracks[joint], time, keyframes[joint], interpolate);
+		}
+	}
+}
+
+} // namespace
+
+void sampleAnimation(const AnimationClip& clip, float time, AnimationCursor& cursor, std::span<JointTransform> pose) {
+	const std::size_t translationTrackCount = clip.translationTracks.size();
+	const std::size_t rotationTrackCount = clip.rotationTracks.size();
+	const std::size_t scaleTrackCount = clip.scaleTracks.size();
+	if (cursor.keyframes.size() != translationTrackCount + rotationTrackCount + scaleTrackCount) {
+		cursor.keyframes.assign(translationTrackCount + rotationTrackCount + scaleTrackCount, 0);
+	}
+	const std::span<std::uint32_t> keyframes = cursor.keyframes;
+
+	const auto lerp = [](const vec3& a, const vec3& b, float t) -> vec3 { return mix(a, b, t); };
+	sampleTracks<vec3>(clip.translationTracks, time, keyframes.first(translationTrackCount), pose, &JointTransform::translation, lerp);
+	sampleTracks<quat>(clip.rotationTracks, time, keyframes.subspan(translationTrackCount, rotationTrackCount), pose, &JointTransform::rotation, nlerp);
+	sampleTracks<vec3>(clip.scaleTracks, time, keyframes.subspan(translationTrackCount + rotationTrackCount), pose, &JointTransform::scale, lerp);
+}
+
+void blendPoses(std::span<const JointTransform> from, std::span<const JointTransform> to, float factor, std::span<JointTransform> output) noexcept {
+	assert(to.size() == from.size());
+	assert(output.size() == from.size());
+	for (std::size_t joint = 0; joint < output.size(); ++joint) {
+		output[joint] = JointTransform{
+			.translation = mix(from[joint].translation, to[joint].translation, factor),
+			.rotation = nlerp(from[joint].rotation, to[joint].rotation, factor),
+			.scale = mix(from[joint].scale, to[joint].scale, factor),
+		};
+	}
+}
+
+void computeJointMatrices(const Skeleton& skeleton, std::span<const JointTransform> pose, std::span<mat4> jointMatrices) noexcept {
+	assert(pose.size() == jointMatrices.size());
+	assert(skeleton.parents.size() == jointMatrices.size());
+	assert(skeleton.inverseBindMatrices.size() == jointMatrices.size());
+
+	// Since parents precede their children, the model-space transformation of each parent is already known when its children are reached.
+	for (std::size_t joint = 0; joint < jointMatrices.size(); ++joint) {
+		const JointTransform& transform = pose[joint];
+		const mat4 localMatrix = translate(transform.translation) * mat4_cast(transform.rotation) * scale(transform.scale);
+		const std::uint32_t parent = skeleton.parents[joint];
+		if (parent == Skeleton::NO_PARENT) {
+			jointMatrices[joint] = localMatrix;
+		} else {
+			assert(parent < joint);
+			jointMatrices[joint] = jointMatrices[parent] * localMatrix;
+		}
+	}
+	for (std::size_t joint = 0; joint < jointMatrices.size(); ++joint) {
+		jointMatrices[joint] *= skeleton.inverseBindMatrices[joint];
+	}
+}
+
+} // namespace donut::graphics
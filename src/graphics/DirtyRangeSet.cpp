@@ -0,0 +1,40 @@
+#include <donut/graphics/DirtyRangeSet.hpp>
+
+#include <algorithm> // std::partition_point, std::min, std::max
+#include <cstddef>   // std::size_t
+
+namespace donut::graphics {
+
+void DirtyRangeSet::insert(std::size_t offset, std::size_t size) {
+	if (size == 0) {
+		return;
+	}
+	std::size_t end = offset + size;
+
+	// Find the first range that ends close enough to the new range to be merged with it, and every following range that starts close enough to its end.
+	const auto first = std::partition_point(ranges.begin(), ranges.end(), [&](const DirtyRange& range) { return range.offset + range.size + mergeDistance < offset; });
+	auto last = first;
+	while (last != ranges.end() && last->offset <= end + mergeDistance) {
+		offset = std::min(offset, last->offset);
+		end = std::max(end, last->offset + last->size);
+		++last;
+	}
+
+	const DirtyRange merged{.offset = offset, .size = end - offset};
+	if (first == last) {
+		ranges.insert(first, merged);
+	} else {
+		*first = merged;
+		ranges.erase(first + 1, last);
+	}
+}
+
+std::size_t DirtyRangeSet::getTotalSize() const noexcept {
+	std::size_t totalSize = 0;
+	for (const DirtyRange& range : ranges) {
+		totalSize += range.size;
+	}
+	return totalSize;
+}
+
+} // namespace donut::graphics
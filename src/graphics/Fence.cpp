@@ -0,0 +1,52 @@
+#include <donut/graphics/Error.hpp>
+#include <donut/graphics/Fence.hpp>
+#include <donut/graphics/opengl.hpp>
+
+#include <cstdint> // std::uint64_t
+
+namespace donut::graphics {
+
+void Fence::signal() {
+	GLsync handle = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	if (!handle) {
+		throw Error{"Failed to create fence sync object!"};
+	}
+	fence.reset(handle);
+}
+
+bool Fence::isComplete() const noexcept {
+	if (!fence) {
+		return true;
+	}
+	const GLenum result = glClientWaitSync(static_cast<GLsync>(fence.get()), 0, 0);
+	return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+void Fence::wait() {
+	if (!fence) {
+		return;
+	}
+#ifndef __EMSCRIPTEN__
+	constexpr std::uint64_t TIMEOUT_NANOSECONDS = 1000000000;
+
+	// The first wait flushes the command stream to make sure that the fence is eventually reached, so later waits don't need to flush again.
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	while (true) {
+		const GLenum result = glClientWaitSync(static_cast<GLsync>(fence.get()), flags, TIMEOUT_NANOSECONDS);
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+			break;
+		}
+		if (result == GL_WAIT_FAILED) {
+			throw Error{"Failed to wait for fence sync object!"};
+		}
+		flags = 0;
+	}
+#endif
+	fence.reset();
+}
+
+void Fence::FenceDeleter::operator()(void* handle) const noexcept {
+	glDeleteSync(static_cast<GLsync>(handle));
+}
+
+} // namespace donut::graphics
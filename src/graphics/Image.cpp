@@ -3,11 +3,14 @@
 #include <donut/graphics/Error.hpp>
 #include <donut/graphics/Image.hpp>
 
+#include <algorithm>         // std::swap_ranges
 #include <cstddef>           // std::size_t, std::ptrdiff_t, std::byte
+#include <cstdint>           // std::uint8_t
 #include <cstring>           // std::memcpy
 #include <fmt/format.h>      // fmt::format
 #include <new>               // std::bad_alloc
 #include <span>              // std::span, std::as_writable_bytes
+#include <utility>           // std::swap
 #include <stb_image.h>       // stbi_...
 #include <stb_image_write.h> // stbi_..., stbi_write_...
 #include <stdlib.h>          // malloc // NOLINT(modernize-deprecated-headers)
@@ -36,6 +39,19 @@ void imageFileOutputCallback(void* context, void* data, int size) {
 	file.write(std::span{reinterpret_cast<const std::byte*>(data), static_cast<std::size_t>(size)});
 }
 
+constexpr std::size_t TGA_HEADER_SIZE = 18;
+constexpr std::uint8_t TGA_IMAGE_TYPE_UNCOMPRESSED_TRUE_COLOR = 2;
+constexpr std::uint8_t TGA_IMAGE_TYPE_UNCOMPRESSED_GRAYSCALE = 3;
+constexpr std::uint8_t TGA_DESCRIPTOR_RIGHT_TO_LEFT = 0x10;
+constexpr std::uint8_t TGA_DESCRIPTOR_TOP_TO_BOTTOM = 0x20;
+
+void flipRowsInPlace(std::byte* pixels, std::size_t rowSize, std::size_t rowCount) noexcept {
+	for (std::size_t top = 0, bottom = rowCount; top + 1 < bottom; ++top) {
+		--bottom;
+		std::swap_ranges(pixels + top * rowSize, pixels + (top + 1) * rowSize, pixels + bottom * rowSize);
+	}
+}
+
 } // namespace
 
 void Image::savePNG(const ImageView& image, Filesystem& filesystem, const char* filepath, const ImageSavePNGOptions& options) {
@@ -128,16 +144,35 @@ void Image::save(const ImageView& image, Filesystem& filesystem, const char* fil
 Image::Image(std::size_t width, std::size_t height, PixelFormat pixelFormat, PixelComponentType pixelComponentType, const void* pixels)
 	: Image(ImageView{width, height, pixelFormat, pixelComponentType, pixels}) {}
 
+Image::Image(std::size_t width, std::size_t height, PixelFormat pixelFormat, PixelComponentType pixelComponentType)
+	: width(width)
+	, height(height)
+	, pixelFormat(pixelFormat)
+	, pixelComponentType(pixelComponentType) {
+	const std::size_t sizeInBytes = width * height * graphics::getChannelCount(pixelFormat) * graphics::getPixelComponentSize(pixelComponentType);
+	if (sizeInBytes == 0) {
+		return;
+	}
+	pixels.reset(malloc(sizeInBytes)); // NOLINT(cppcoreguidelines-no-malloc)
+	if (!pixels) {
+		throw std::bad_alloc{};
+	}
+}
+
 Image::Image(const ImageView& image)
-	: pixels(malloc(image.getSizeInBytes())) // NOLINT(cppcoreguidelines-no-malloc)
-	, width(image.getWidth())
+	: width(image.getWidth())
 	, height(image.getHeight())
 	, pixelFormat(image.getPixelFormat())
 	, pixelComponentType(image.getPixelComponentType()) {
+	const std::size_t sizeInBytes = image.getSizeInBytes();
+	if (sizeInBytes == 0) {
+		return;
+	}
+	pixels.reset(malloc(sizeInBytes)); // NOLINT(cppcoreguidelines-no-malloc)
 	if (!pixels) {
 		throw std::bad_alloc{};
 	}
-	std::memcpy(pixels.get(), image.getPixels(), image.getSizeInBytes());
+	std::memcpy(pixels.get(), image.getPixels(), sizeInBytes);
 }
 
 Image::Image(const Filesystem& filesystem, const char* filepath, const ImageOptions& options) {
@@ -187,4 +222,72 @@ void Image::PixelsDeleter::operator()(void* handle) const noexcept {
 	stbi_image_free(handle);
 }
 
+RawImage::RawImage(const Filesystem& filesystem, const char* filepath, const RawImageOptions& options)
+	: buffer(filesystem.openFile(filepath).readAll()) {
+	if (buffer.size() < TGA_HEADER_SIZE) {
+		throw Error{fmt::format("Invalid TGA image \"{}\".", filepath)};
+	}
+	const auto readU8 = [&](std::size_t offset) -> std::size_t {
+		return static_cast<std::size_t>(buffer[offset]);
+	};
+	const auto readU16 = [&](std::size_t offset) -> std::size_t {
+		return readU8(offset) | (readU8(offset + 1) << 8);
+	};
+	const std::size_t idLength = readU8(0);
+	const std::size_t colorMapType = readU8(1);
+	const std::size_t imageType = readU8(2);
+	const std::size_t bitsPerPixel = readU8(16);
+	const std::size_t descriptor = readU8(17);
+	if (colorMapType != 0 || (descriptor & TGA_DESCRIPTOR_RIGHT_TO_LEFT) != 0) {
+		throw Error{fmt::format("Unsupported TGA image \"{}\": only uncompressed images without a color map stored left-to-right can be loaded in place.", filepath)};
+	}
+	if (imageType == TGA_IMAGE_TYPE_UNCOMPRESSED_TRUE_COLOR && bitsPerPixel == 24) {
+		pixelFormat = PixelFormat::RGB;
+	} else if (imageType == TGA_IMAGE_TYPE_UNCOMPRESSED_TRUE_COLOR && bitsPerPixel == 32) {
+		pixelFormat = PixelFormat::RGBA;
+	} else if (imageType == TGA_IMAGE_TYPE_UNCOMPRESSED_GRAYSCALE && bitsPerPixel == 8) {
+		pixelFormat = PixelFormat::R;
+	} else {
+		throw Error{fmt::format("Unsupported TGA image \"{}\": image type {} with {} bits per pixel cannot be loaded in place.", filepath, imageType, bitsPerPixel)};
+	}
+	pixelComponentType = PixelComponentType::U8;
+	width = readU16(12);
+	height = readU16(14);
+	pixelsOffset = TGA_HEADER_SIZE + idLength;
+
+	const std::size_t pixelStride = bitsPerPixel / 8;
+	const std::size_t rowSize = width * pixelStride;
+	if (buffer.size() < pixelsOffset + rowSize * height) {
+		throw Error{fmt::format("Invalid TGA image \"{}\": unexpected end of file.", filepath)};
+	}
+
+	std::byte* const pixels = buffer.data() + pixelsOffset;
+	if (pixelStride >= 3) {
+		// TGA stores true-color pixels in BGR(A) order.
+		for (std::size_t i = 0; i < width * height; ++i) {
+			std::swap(pixels[i * pixelStride], pixels[i * pixelStride + 2]);
+		}
+	}
+	const bool isStoredTopToBottom = (descriptor & TGA_DESCRIPTOR_TOP_TO_BOTTOM) != 0;
+	if (isStoredTopToBottom != options.flipVertically) {
+		flipRowsInPlace(pixels, rowSize, height);
+	}
+}
+
+RawImage::RawImage(const Filesystem& filesystem, const char* filepath, std::size_t width, std::size_t height, PixelFormat pixelFormat,
+	PixelComponentType pixelComponentType, const RawImageOptions& options)
+	: buffer(filesystem.openFile(filepath).readAll())
+	, width(width)
+	, height(height)
+	, pixelFormat(pixelFormat)
+	, pixelComponentType(pixelComponentType) {
+	const ImageView image = *this;
+	if (buffer.size() != image.getSizeInBytes()) {
+		throw Error{fmt::format("Invalid raw image \"{}\": expected {} bytes of pixel data, but the file is {} bytes.", filepath, image.getSizeInBytes(), buffer.size())};
+	}
+	if (options.flipVertically) {
+		flipRowsInPlace(buffer.data(), width * image.getPixelStride(), height);
+	}
+}
+
 } // namespace donut::graphics
@@ -0,0 +1,410 @@
+#include <donut/graphics/Error.hpp>
+#include <donut/graphics/Image.hpp>
+#include <donut/graphics/ImageProcessing.hpp>
+
+#include <algorithm>   // std::fill, std::swap_ranges, std::clamp, std::max
+#include <array>       // std::array
+#include <cmath>       // std::pow, std::sin, std::sqrt, std::floor, std::ceil
+#include <cstddef>     // std::size_t, std::ptrdiff_t, std::byte
+#include <cstdint>     // std::uint8_t, std::uint32_t
+#include <numbers>     // std::numbers::pi_v
+#include <type_traits> // std::integral_constant, std::type_identity, std::is_same_v, std::conditional_t
+#include <utility>     // std::move
+#include <vector>      // std::vector
+
+// The kernels in this file are written as simple loops over contiguous arrays with compile-time channel counts, so that
+// the compiler can vectorize them for the target instruction set without requiring any platform-specific intrinsics.
+
+namespace donut::graphics {
+
+namespace {
+
+template <typename Function>
+void visitPixelComponentType(PixelComponentType pixelComponentType, Function&& function) {
+	switch (pixelComponentType) {
+		case PixelComponentType::U8: function(std::type_identity<std::uint8_t>{}); return;
+		case PixelComponentType::F32: function(std::type_identity<float>{}); return;
+		case PixelComponentType::F16: break;
+	}
+	throw Error{"16-bit floating-point images are not supported."};
+}
+
+template <typename Function>
+void visitChannelCount(std::size_t channelCount, Function&& function) {
+	switch (channelCount) {
+		case 1: function(std::integral_constant<std::size_t, 1>{}); break;
+		case 2: function(std::integral_constant<std::size_t, 2>{}); break;
+		case 3: function(std::integral_constant<std::size_t, 3>{}); break;
+		case 4: function(std::integral_constant<std::size_t, 4>{}); break;
+		default: break;
+	}
+}
+
+template <typename Destination, typename Source>
+[[nodiscard]] Destination convertComponent(Source value) noexcept {
+	if constexpr (std::is_same_v<Destination, Source>) {
+		return value;
+	} else if constexpr (std::is_same_v<Destination, float>) {
+		return static_cast<float>(value) * (1.0f / 255.0f);
+	} else {
+		const float clampedValue = (value > 0.0f) ? ((value < 1.0f) ? value : 1.0f) : 0.0f;
+		return static_cast<std::uint8_t>(clampedValue * 255.0f + 0.5f);
+	}
+}
+
+template <typename T>
+[[nodiscard]] constexpr T getMaxComponentValue() noexcept {
+	if constexpr (std::is_same_v<T, float>) {
+		return 1.0f;
+	} else {
+		return 255;
+	}
+}
+
+template <typename Destination, std::size_t DestinationChannelCount, typename Source, std::size_t SourceChannelCount>
+void convertPixels(Destination* destination, const Source* source, std::size_t pixelCount) noexcept {
+	for (std::size_t i = 0; i < pixelCount; ++i) {
+		for (std::size_t channel = 0; channel < DestinationChannelCount; ++channel) {
+			if (channel < SourceChannelCount) {
+				destination[i * DestinationChannelCount + channel] = convertComponent<Destination>(source[i * SourceChannelCount + channel]);
+			} else if (channel == 3) {
+				destination[i * DestinationChannelCount + channel] = getMaxComponentValue<Destination>();
+			} else {
+				destination[i * DestinationChannelCount + channel] = Destination{0};
+			}
+		}
+	}
+}
+
+[[nodiscard]] float convertSRGBToLinear(float value) noexcept {
+	return (value <= 0.04045f) ? value * (1.0f / 12.92f) : std::pow((value + 0.055f) * (1.0f / 1.055f), 2.4f);
+}
+
+[[nodiscard]] float convertLinearToSRGB(float value) noexcept {
+	return (value <= 0.0031308f) ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+template <float (*Convert)(float)>
+[[nodiscard]] const std::array<std::uint8_t, 256>& getColorSpaceConversionTable() noexcept {
+	static const std::array<std::uint8_t, 256> table = [] {
+		std::array<std::uint8_t, 256> result{};
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			result[i] = convertComponent<std::uint8_t>(Convert(static_cast<float>(i) * (1.0f / 255.0f)));
+		}
+		return result;
+	}();
+	return table;
+}
+
+template <float (*Convert)(float)>
+void convertImageColorSpace(Image& image) {
+	const std::size_t pixelCount = image.getWidth() * image.getHeight();
+	const std::size_t channelCount = image.getChannelCount();
+	const std::size_t colorChannelCount = (image.getPixelFormat() == PixelFormat::RGBA) ? 3 : channelCount;
+	visitPixelComponentType(image.getPixelComponentType(), [&]<typename T>(std::type_identity<T>) -> void {
+		T* const pixels = static_cast<T*>(image.getPixels());
+		if constexpr (std::is_same_v<T, std::uint8_t>) {
+			const std::array<std::uint8_t, 256>& table = getColorSpaceConversionTable<Convert>();
+			for (std::size_t i = 0; i < pixelCount; ++i) {
+				for (std::size_t channel = 0; channel < colorChannelCount; ++channel) {
+					pixels[i * channelCount + channel] = table[pixels[i * channelCount + channel]];
+				}
+			}
+		} else {
+			for (std::size_t i = 0; i < pixelCount; ++i) {
+				for (std::size_t channel = 0; channel < colorChannelCount; ++channel) {
+					pixels[i * channelCount + channel] = Convert(pixels[i * channelCount + channel]);
+				}
+			}
+		}
+	});
+}
+
+template <typename T, std::size_t ChannelCount>
+void downsamplePixels(T* destination, const T* source, std::size_t width, std::size_t height, std::size_t newWidth, std::size_t newHeight) {
+	using Accumulator = std::conditional_t<std::is_same_v<T, float>, float, std::uint32_t>;
+
+	std::vector<Accumulator> rowSums(width * ChannelCount);
+	for (std::size_t y = 0; y < newHeight; ++y) {
+		// Sum the source rows that map to this destination row.
+		const std::size_t firstRow = y * 2;
+		const std::size_t endRow = (y + 1 == newHeight) ? height : firstRow + 2;
+		std::fill(rowSums.begin(), rowSums.end(), Accumulator{0});
+		for (std::size_t row = firstRow; row < endRow; ++row) {
+			const T* const sourceRow = source + row * width * ChannelCount;
+			for (std::size_t i = 0; i < width * ChannelCount; ++i) {
+				rowSums[i] += static_cast<Accumulator>(sourceRow[i]);
+			}
+		}
+
+		// Sum pairs of columns and normalize.
+		T* const destinationRow = destination + y * newWidth * ChannelCount;
+		const std::size_t rowCount = endRow - firstRow;
+		for (std::size_t x = 0; x < newWidth; ++x) {
+			const std::size_t firstColumn = x * 2;
+			const std::size_t endColumn = (x + 1 == newWidth) ? width : firstColumn + 2;
+			const std::size_t sampleCount = rowCount * (endColumn - firstColumn);
+			for (std::size_t channel = 0; channel < ChannelCount; ++channel) {
+				Accumulator sum{0};
+				for (std::size_t column = firstColumn; column < endColumn; ++column) {
+					sum += rowSums[column * ChannelCount + channel];
+				}
+				if constexpr (std::is_same_v<T, float>) {
+					destinationRow[x * ChannelCount + channel] = sum / static_cast<float>(sampleCount);
+				} else {
+					destinationRow[x * ChannelCount + channel] = static_cast<T>((sum + static_cast<Accumulator>(sampleCount / 2)) / static_cast<Accumulator>(sampleCount));
+				}
+			}
+		}
+	}
+}
+
+constexpr float MIPMAP_FILTER_RADIUS = 3.0f;
+constexpr float KAISER_BETA = 4.0f;
+
+[[nodiscard]] float sinc(float x) noexcept {
+	if (x == 0.0f) {
+		return 1.0f;
+	}
+	const float angle = std::numbers::pi_v<float> * x;
+	return std::sin(angle) / angle;
+}
+
+[[nodiscard]] float besselI0(float x) noexcept {
+	// Power series, which converges quickly for the small arguments used by the Kaiser window.
+	const float quarterXSquared = x * x * 0.25f;
+	float term = 1.0f;
+	float sum = 1.0f;
+	for (int k = 1; k < 16; ++k) {
+		term *= quarterXSquared / static_cast<float>(k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+[[nodiscard]] float getMipmapFilterRadius(MipmapFilter filter) noexcept {
+	return (filter == MipmapFilter::BOX) ? 0.5f : MIPMAP_FILTER_RADIUS;
+}
+
+[[nodiscard]] float evaluateMipmapFilter(MipmapFilter filter, float x) noexcept {
+	switch (filter) {
+		case MipmapFilter::BOX: return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+		case MipmapFilter::KAISER: {
+			const float t = x * (1.0f / MIPMAP_FILTER_RADIUS);
+			return (t > -1.0f && t < 1.0f) ? sinc(x) * besselI0(KAISER_BETA * std::sqrt(1.0f - t * t)) / besselI0(KAISER_BETA) : 0.0f;
+		}
+		case MipmapFilter::LANCZOS: {
+			const float t = x * (1.0f / MIPMAP_FILTER_RADIUS);
+			return (t > -1.0f && t < 1.0f) ? sinc(x) * sinc(t) : 0.0f;
+		}
+	}
+	return 0.0f;
+}
+
+/**
+ * Precomputed filter taps for resampling one axis of an image, where the taps
+ * of destination index i are weights[offsets[i]] to weights[offsets[i + 1]],
+ * applied to consecutive source indices starting at firstSourceIndices[i].
+ */
+struct ResampleWeights {
+	std::vector<std::size_t> firstSourceIndices;
+	std::vector<std::size_t> offsets;
+	std::vector<float> weights;
+};
+
+[[nodiscard]] ResampleWeights computeResampleWeights(MipmapFilter filter, std::size_t sourceSize, std::size_t destinationSize) {
+	const float scale = static_cast<float>(sourceSize) / static_cast<float>(destinationSize);
+	const float support = getMipmapFilterRadius(filter) * scale;
+	const std::ptrdiff_t lastSourceIndex = static_cast<std::ptrdiff_t>(sourceSize) - 1;
+
+	ResampleWeights result{};
+	result.firstSourceIndices.reserve(destinationSize);
+	result.offsets.reserve(destinationSize + 1);
+	result.offsets.push_back(0);
+	for (std::size_t i = 0; i < destinationSize; ++i) {
+		const float center = (static_cast<float>(i) + 0.5f) * scale;
+		const std::ptrdiff_t begin = static_cast<std::ptrdiff_t>(std::floor(center - support));
+		const std::ptrdiff_t end = static_cast<std::ptrdiff_t>(std::ceil(center + support));
+		const std::ptrdiff_t first = std::clamp(begin, std::ptrdiff_t{0}, lastSourceIndex);
+		const std::ptrdiff_t last = std::clamp(end - 1, std::ptrdiff_t{0}, lastSourceIndex);
+
+		// Taps that fall outside of the image are folded into the nearest edge texel.
+		const std::size_t offset = result.weights.size();
+		result.weights.resize(offset + static_cast<std::size_t>(last - first + 1), 0.0f);
+		float totalWeight = 0.0f;
+		for (std::ptrdiff_t sourceIndex = begin; sourceIndex < end; ++sourceIndex) {
+			const float weight = evaluateMipmapFilter(filter, (static_cast<float>(sourceIndex) + 0.5f - center) / scale);
+			result.weights[offset + static_cast<std::size_t>(std::clamp(sourceIndex, first, last) - first)] += weight;
+			totalWeight += weight;
+		}
+		if (totalWeight != 0.0f) {
+			for (std::size_t j = offset; j < result.weights.size(); ++j) {
+				result.weights[j] /= totalWeight;
+			}
+		}
+		result.firstSourceIndices.push_back(static_cast<std::size_t>(first));
+		result.offsets.push_back(result.weights.size());
+	}
+	return result;
+}
+
+template <std::size_t ChannelCount>
+void resamplePixels(float* destination, const float* source, std::size_t width, std::size_t height, std::size_t newWidth, std::size_t newHeight, MipmapFilter filter) {
+	const ResampleWeights horizontalWeights = computeResampleWeights(filter, width, newWidth);
+	const ResampleWeights verticalWeights = computeResampleWeights(filter, height, newHeight);
+
+	// Filter each source row horizontally.
+	std::vector<float> rows(newWidth * height * ChannelCount, 0.0f);
+	for (std::size_t y = 0; y < height; ++y) {
+		const float* const sourceRow = source + y * width * ChannelCount;
+		float* const row = rows.data() + y * newWidth * ChannelCount;
+		for (std::size_t x = 0; x < newWidth; ++x) {
+			const float* const sourcePixels = sourceRow + horizontalWeights.firstSourceIndices[x] * ChannelCount;
+			for (std::size_t tap = 0, tapCount = horizontalWeights.offsets[x + 1] - horizontalWeights.offsets[x]; tap < tapCount; ++tap) {
+				const float weight = horizontalWeights.weights[horizontalWeights.offsets[x] + tap];
+				for (std::size_t channel = 0; channel < ChannelCount; ++channel) {
+					row[x * ChannelCount + channel] += sourcePixels[tap * ChannelCount + channel] * weight;
+				}
+			}
+		}
+	}
+
+	// Filter the intermediate rows vertically.
+	const std::size_t rowSize = newWidth * ChannelCount;
+	std::fill(destination, destination + newHeight * rowSize, 0.0f);
+	for (std::size_t y = 0; y < newHeight; ++y) {
+		float* const destinationRow = destination + y * rowSize;
+		for (std::size_t tap = 0, tapCount = verticalWeights.offsets[y + 1] - verticalWeights.offsets[y]; tap < tapCount; ++tap) {
+			const float weight = verticalWeights.weights[verticalWeights.offsets[y] + tap];
+			const float* const row = rows.data() + (verticalWeights.firstSourceIndices[y] + tap) * rowSize;
+			for (std::size_t i = 0; i < rowSize; ++i) {
+				destinationRow[i] += row[i] * weight;
+			}
+		}
+	}
+}
+
+} // namespace
+
+Image convertImage(const ImageView& image, PixelFormat newPixelFormat, PixelComponentType newPixelComponentType) {
+	if (!image) {
+		return Image{};
+	}
+	Image result{image.getWidth(), image.getHeight(), newPixelFormat, newPixelComponentType};
+	const std::size_t pixelCount = image.getWidth() * image.getHeight();
+	visitPixelComponentType(image.getPixelComponentType(), [&]<typename Source>(std::type_identity<Source>) -> void {
+		visitPixelComponentType(newPixelComponentType, [&]<typename Destination>(std::type_identity<Destination>) -> void {
+			visitChannelCount(image.getChannelCount(), [&]<std::size_t SourceChannelCount>(std::integral_constant<std::size_t, SourceChannelCount>) -> void {
+				visitChannelCount(result.getChannelCount(), [&]<std::size_t DestinationChannelCount>(std::integral_constant<std::size_t, DestinationChannelCount>) -> void {
+					convertPixels<Destination, DestinationChannelCount, Source, SourceChannelCount>(
+						static_cast<Destination*>(result.getPixels()), static_cast<const Source*>(image.getPixels()), pixelCount);
+				});
+			});
+		});
+	});
+	return result;
+}
+
+void convertImageSRGBToLinear(Image& image) {
+	convertImageColorSpace<convertSRGBToLinear>(image);
+}
+
+void convertImageLinearToSRGB(Image& image) {
+	convertImageColorSpace<convertLinearToSRGB>(image);
+}
+
+void premultiplyImageAlpha(Image& image) {
+	if (image.getPixelFormat() != PixelFormat::RGBA) {
+		return;
+	}
+	const std::size_t pixelCount = image.getWidth() * image.getHeight();
+	visitPixelComponentType(image.getPixelComponentType(), [&]<typename T>(std::type_identity<T>) -> void {
+		T* const pixels = static_cast<T*>(image.getPixels());
+		for (std::size_t i = 0; i < pixelCount; ++i) {
+			const T alpha = pixels[i * 4 + 3];
+			for (std::size_t channel = 0; channel < 3; ++channel) {
+				if constexpr (std::is_same_v<T, float>) {
+					pixels[i * 4 + channel] *= alpha;
+				} else {
+					// Exact rounded division by 255 without a division instruction.
+					const std::uint32_t product = std::uint32_t{pixels[i * 4 + channel]} * std::uint32_t{alpha} + 128;
+					pixels[i * 4 + channel] = static_cast<std::uint8_t>((product + (product >> 8)) >> 8);
+				}
+			}
+		}
+	});
+}
+
+void flipImageVertically(Image& image) noexcept {
+	const std::size_t rowSize = image.getWidth() * image.getPixelStride();
+	std::byte* const pixels = static_cast<std::byte*>(image.getPixels());
+	for (std::size_t top = 0, bottom = image.getHeight(); top + 1 < bottom; ++top) {
+		--bottom;
+		std::swap_ranges(pixels + top * rowSize, pixels + (top + 1) * rowSize, pixels + bottom * rowSize);
+	}
+}
+
+Image downsampleImage(const ImageView& image) {
+	if (!image) {
+		return Image{};
+	}
+	const std::size_t newWidth = (image.getWidth() > 1) ? image.getWidth() / 2 : image.getWidth();
+	const std::size_t newHeight = (image.getHeight() > 1) ? image.getHeight() / 2 : image.getHeight();
+	Image result{newWidth, newHeight, image.getPixelFormat(), image.getPixelComponentType()};
+	visitPixelComponentType(image.getPixelComponentType(), [&]<typename T>(std::type_identity<T>) -> void {
+		visitChannelCount(image.getChannelCount(), [&]<std::size_t ChannelCount>(std::integral_constant<std::size_t, ChannelCount>) -> void {
+			downsamplePixels<T, ChannelCount>(
+				static_cast<T*>(result.getPixels()), static_cast<const T*>(image.getPixels()), image.getWidth(), image.getHeight(), newWidth, newHeight);
+		});
+	});
+	return result;
+}
+
+std::vector<Image> generateMipmap(const ImageView& image, const MipmapOptions& options) {
+	std::vector<Image> levels{};
+	if (!image) {
+		return levels;
+	}
+
+	std::size_t levelCount = 0;
+	for (std::size_t size = std::max(image.getWidth(), image.getHeight()); size > 1; size /= 2) {
+		++levelCount;
+	}
+	levels.reserve(levelCount);
+
+	// The box filter can work directly on the stored values, so skip the conversion to floating-point.
+	if (options.filter == MipmapFilter::BOX && !options.sRGB && image.getPixelComponentType() != PixelComponentType::F16) {
+		ImageView previousLevel = image;
+		while (previousLevel.getWidth() > 1 || previousLevel.getHeight() > 1) {
+			previousLevel = levels.emplace_back(downsampleImage(previousLevel));
+		}
+		return levels;
+	}
+
+	Image previousLevel = convertImage(image, image.getPixelFormat(), PixelComponentType::F32);
+	if (options.sRGB) {
+		convertImageSRGBToLinear(previousLevel);
+	}
+	while (previousLevel.getWidth() > 1 || previousLevel.getHeight() > 1) {
+		const std::size_t width = previousLevel.getWidth();
+		const std::size_t height = previousLevel.getHeight();
+		const std::size_t newWidth = (width > 1) ? width / 2 : width;
+		const std::size_t newHeight = (height > 1) ? height / 2 : height;
+		Image level{newWidth, newHeight, image.getPixelFormat(), PixelComponentType::F32};
+		visitChannelCount(image.getChannelCount(), [&]<std::size_t ChannelCount>(std::integral_constant<std::size_t, ChannelCount>) -> void {
+			resamplePixels<ChannelCount>(
+				static_cast<float*>(level.getPixels()), static_cast<const float*>(previousLevel.getPixels()), width, height, newWidth, newHeight, options.filter);
+		});
+		if (options.sRGB) {
+			Image encodedLevel{ImageView{level}};
+			convertImageLinearToSRGB(encodedLevel);
+			levels.push_back(convertImage(encodedLevel, image.getPixelFormat(), image.getPixelComponentType()));
+		} else {
+			levels.push_back(convertImage(level, image.getPixelFormat(), image.getPixelComponentType()));
+		}
+		previousLevel = std::move(level);
+	}
+	return levels;
+}
+
+} // namespace donut::graphics
@@ -53,6 +53,16 @@ void vertexAttribPointerFloat(std::uint32_t index, std::size_t count, std::size_
 		reinterpret_cast<const void*>(offset)); // NOLINT(performance-no-int-to-ptr)
 }
 
+void vertexAttribPointerPacked(std::uint32_t index, std::size_t count, VertexAttributeComponentType type, bool normalized, std::size_t stride, std::uintptr_t offset) {
+	glVertexAttribPointer(static_cast<GLuint>(index), static_cast<GLint>(count), static_cast<GLenum>(type), (normalized) ? GL_TRUE : GL_FALSE, static_cast<GLsizei>(stride),
+		reinterpret_cast<const void*>(offset)); // NOLINT(performance-no-int-to-ptr)
+}
+
+void vertexAttribPointerInteger(std::uint32_t index, std::size_t count, VertexAttributeComponentType type, std::size_t stride, std::uintptr_t offset) {
+	glVertexAttribIPointer(static_cast<GLuint>(index), static_cast<GLint>(count), static_cast<GLenum>(type), static_cast<GLsizei>(stride),
+		reinterpret_cast<const void*>(offset)); // NOLINT(performance-no-int-to-ptr)
+}
+
 void bufferArrayBufferData(std::size_t size, const void* data, MeshBufferUsage usage) {
 	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), data, static_cast<GLenum>(usage));
 }
@@ -61,6 +71,14 @@ void bufferElementArrayBufferData(std::size_t size, const void* data, MeshBuffer
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), data, static_cast<GLenum>(usage));
 }
 
+void bufferArrayBufferSubData(std::size_t offset, std::size_t size, const void* data) {
+	glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+}
+
+void bufferElementArrayBufferSubData(std::size_t offset, std::size_t size, const void* data) {
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+}
+
 } // namespace detail
 
 } // namespace donut::graphics
@@ -0,0 +1,645 @@
+#include <donut/graphics/MeshOptimization.hpp>
+#include <donut/math.hpp>
+
+#include <algorithm> // std::min, std::max, std::find, std::swap, std::sort, std::stable_sort, std::copy, std::fill
+#include <array>     // std::array
+#include <bit>       // std::bit_cast
+#include <cmath>     // std::pow, std::sqrt
+#include <cstddef>   // std::size_t, std::ptrdiff_t
+#include <cstdint>   // std::uint8_t, std::uint32_t
+#include <limits>    // std::numeric_limits
+#include <span>      // std::span
+#include <utility>   // std::pair, std::move
+#include <vector>    // std::vector
+
+namespace donut::graphics {
+
+namespace {
+
+// FIFO post-transform vertex cache simulation, where each vertex is stamped with the number of cache misses at the time it was loaded. Flushing
+// the cache advances the miss counter far enough for every stamp to be out of range, which takes constant time.
+struct VertexCacheSimulator {
+	std::vector<std::size_t> timestamps;
+	std::size_t time = 0;
+	std::size_t cacheSize;
+
+	VertexCacheSimulator(std::size_t vertexCount, std::size_t cacheSize)
+		: timestamps(vertexCount, 0)
+		, cacheSize(cacheSize) {}
+
+	[[nodiscard]] bool isReferenced(std::uint32_t vertexIndex) const noexcept {
+		return timestamps[vertexIndex] != 0;
+	}
+
+	[[nodiscard]] bool access(std::uint32_t vertexIndex) noexcept {
+		if (timestamps[vertexIndex] != 0 && time - timestamps[vertexIndex] < cacheSize) {
+			return false;
+		}
+		timestamps[vertexIndex] = ++time;
+		return true;
+	}
+
+	[[nodiscard]] std::size_t accessTriangle(std::span<const std::uint32_t, 3> triangle) noexcept {
+		std::size_t missCount = 0;
+		for (const std::uint32_t vertexIndex : triangle) {
+			missCount += (access(vertexIndex)) ? 1 : 0;
+		}
+		return missCount;
+	}
+
+	void flush() noexcept {
+		time += cacheSize;
+	}
+};
+
+constexpr std::size_t FORSYTH_CACHE_SIZE = 32;
+constexpr std::size_t FORSYTH_VALENCE_TABLE_SIZE = 32;
+constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+constexpr float FORSYTH_VALENCE_BOOST_POWER = -0.5f;
+
+constexpr std::size_t NO_TRIANGLE = std::numeric_limits<std::size_t>::max();
+
+struct ForsythScoreTables {
+	std::array<float, FORSYTH_CACHE_SIZE + 1> cachePositionScores{}; // Indexed by cache position + 1, where 0 means not in the cache.
+	std::array<float, FORSYTH_VALENCE_TABLE_SIZE> valenceScores{};
+
+	ForsythScoreTables() noexcept {
+		cachePositionScores[0] = 0.0f;
+		for (std::size_t i = 0; i < FORSYTH_CACHE_SIZE; ++i) {
+			cachePositionScores[i + 1] = (i < 3) ? FORSYTH_LAST_TRIANGLE_SCORE
+			                                     : std::pow(1.0f - static_cast<float>(i - 3) / static_cast<float>(FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+		}
+		valenceScores[0] = 0.0f;
+		for (std::size_t i = 1; i < FORSYTH_VALENCE_TABLE_SIZE; ++i) {
+			valenceScores[i] = computeValenceScore(i);
+		}
+	}
+
+	[[nodiscard]] static float computeValenceScore(std::size_t valence) noexcept {
+		return FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(valence), FORSYTH_VALENCE_BOOST_POWER);
+	}
+
+	[[nodiscard]] float getVertexScore(std::size_t cachePosition, std::size_t valence) const noexcept {
+		if (valence == 0) {
+			return 0.0f;
+		}
+		const float valenceScore = (valence < FORSYTH_VALENCE_TABLE_SIZE) ? valenceScores[valence] : computeValenceScore(valence);
+		return cachePositionScores[cachePosition] + valenceScore;
+	}
+};
+
+// Split a triangle list into ranges of triangles that can be reordered with respect to each other without hurting the vertex cache efficiency
+// by more than the given threshold, as described in "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (Sander et al. 2007).
+[[nodiscard]] std::vector<std::size_t> findClusterStarts(std::span<const std::uint32_t> indices, std::size_t vertexCount, float threshold) {
+	const std::size_t triangleCount = indices.size() / 3;
+	VertexCacheSimulator cache{vertexCount, DEFAULT_VERTEX_CACHE_SIZE};
+
+	// Hard boundaries, where the cache would have been flushed regardless of the order of the preceding triangles.
+	std::vector<std::size_t> hardStarts{0};
+	for (std::size_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		if (cache.accessTriangle(indices.subspan(triangleIndex * 3).first<3>()) == 3 && triangleIndex != 0) {
+			hardStarts.push_back(triangleIndex);
+		}
+	}
+	hardStarts.push_back(triangleCount);
+
+	// Soft boundaries within each run, wherever the cluster so far is at least as cache efficient as the run as a whole.
+	std::vector<std::size_t> clusterStarts{};
+	for (std::size_t runIndex = 0; runIndex + 1 < hardStarts.size(); ++runIndex) {
+		const std::size_t runBegin = hardStarts[runIndex];
+		const std::size_t runEnd = hardStarts[runIndex + 1];
+
+		cache.flush();
+		std::size_t runMissCount = 0;
+		for (std::size_t triangleIndex = runBegin; triangleIndex < runEnd; ++triangleIndex) {
+			runMissCount += cache.accessTriangle(indices.subspan(triangleIndex * 3).first<3>());
+		}
+		const float maxClusterCacheMissRatio = threshold * static_cast<float>(runMissCount) / static_cast<float>(runEnd - runBegin);
+
+		cache.flush();
+		clusterStarts.push_back(runBegin);
+		std::size_t clusterMissCount = 0;
+		for (std::size_t triangleIndex = runBegin; triangleIndex + 1 < runEnd; ++triangleIndex) {
+			clusterMissCount += cache.accessTriangle(indices.subspan(triangleIndex * 3).first<3>());
+			const std::size_t clusterTriangleCount = triangleIndex + 1 - clusterStarts.back();
+			if (static_cast<float>(clusterMissCount) <= maxClusterCacheMissRatio * static_cast<float>(clusterTriangleCount)) {
+				clusterStarts.push_back(triangleIndex + 1);
+				clusterMissCount = 0;
+				cache.flush();
+			}
+		}
+	}
+	clusterStarts.push_back(triangleCount);
+	return clusterStarts;
+}
+
+// Symmetric 4x4 matrix of the error quadric of a vertex, accumulated from the planes of its adjacent triangles weighted by their area, such that
+// evaluating it at a point gives the weighted sum of squared distances from the point to each plane.
+struct Quadric {
+	double a00 = 0.0;
+	double a01 = 0.0;
+	double a02 = 0.0;
+	double a03 = 0.0;
+	double a11 = 0.0;
+	double a12 = 0.0;
+	double a13 = 0.0;
+	double a22 = 0.0;
+	double a23 = 0.0;
+	double a33 = 0.0;
+	double weight = 0.0;
+
+	void addPlane(vec3 normal, float distance, float area) noexcept {
+		const double x = normal.x;
+		const double y = normal.y;
+		const double z = normal.z;
+		const double d = distance;
+		const double w = area;
+		a00 += w * x * x;
+		a01 += w * x * y;
+		a02 += w * x * z;
+		a03 += w * x * d;
+		a11 += w * y * y;
+		a12 += w * y * z;
+		a13 += w * y * d;
+		a22 += w * z * z;
+		a23 += w * z * d;
+		a33 += w * d * d;
+		weight += w;
+	}
+
+	Quadric& operator+=(const Quadric& other) noexcept {
+		a00 += other.a00;
+		a01 += other.a01;
+		a02 += other.a02;
+		a03 += other.a03;
+		a11 += other.a11;
+		a12 += other.a12;
+		a13 += other.a13;
+		a22 += other.a22;
+		a23 += other.a23;
+		a33 += other.a33;
+		weight += other.weight;
+		return *this;
+	}
+
+	// Weighted average squared distance from the given point to the accumulated planes.
+	[[nodiscard]] double evaluate(vec3 point) const noexcept {
+		if (weight <= 0.0) {
+			return 0.0;
+		}
+		const double x = point.x;
+		const double y = point.y;
+		const double z = point.z;
+		const double error = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + a03 * x + a13 * y + a23 * z) + a33;
+		return std::max(error, 0.0) / weight;
+	}
+};
+
+// Map each vertex to the lowest index of any vertex with a bitwise identical position, so that vertices that were split along attribute seams
+// can be recognized as the same point on the surface.
+[[nodiscard]] std::vector<std::uint32_t> findPositionRemap(std::span<const vec3> positions) {
+	std::vector<std::uint32_t> order(positions.size());
+	for (std::size_t i = 0; i < order.size(); ++i) {
+		order[i] = static_cast<std::uint32_t>(i);
+	}
+	const auto getKey = [&](std::uint32_t vertexIndex) -> std::array<std::uint32_t, 3> {
+		const vec3 position = positions[vertexIndex];
+		return {std::bit_cast<std::uint32_t>(position.x), std::bit_cast<std::uint32_t>(position.y), std::bit_cast<std::uint32_t>(position.z)};
+	};
+	std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) -> bool {
+		const std::array<std::uint32_t, 3> keyA = getKey(a);
+		const std::array<std::uint32_t, 3> keyB = getKey(b);
+		return (keyA == keyB) ? a < b : keyA < keyB;
+	});
+
+	std::vector<std::uint32_t> remap(positions.size());
+	for (std::size_t i = 0; i < order.size();) {
+		const std::array<std::uint32_t, 3> key = getKey(order[i]);
+		std::size_t end = i + 1;
+		while (end < order.size() && getKey(order[end]) == key) {
+			++end;
+		}
+		for (std::size_t j = i; j < end; ++j) {
+			remap[order[j]] = order[i];
+		}
+		i = end;
+	}
+	return remap;
+}
+
+// Lock every vertex that shares its position with another vertex, as well as both ends of every edge that is not shared by exactly two
+// triangles, since collapsing these would tear the surface open along seams and borders.
+[[nodiscard]] std::vector<std::uint8_t> findLockedVertices(std::span<const std::uint32_t> indices, std::span<const std::uint32_t> positionRemap) {
+	std::vector<std::uint8_t> locked(positionRemap.size(), 0);
+	for (std::size_t vertexIndex = 0; vertexIndex < positionRemap.size(); ++vertexIndex) {
+		if (positionRemap[vertexIndex] != vertexIndex) {
+			locked[vertexIndex] = 1;
+			locked[positionRemap[vertexIndex]] = 1;
+		}
+	}
+
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> edges{};
+	edges.reserve(indices.size());
+	for (std::size_t i = 0; i < indices.size(); i += 3) {
+		for (std::size_t j = 0; j < 3; ++j) {
+			const std::uint32_t a = positionRemap[indices[i + j]];
+			const std::uint32_t b = positionRemap[indices[i + (j + 1) % 3]];
+			edges.emplace_back(std::min(a, b), std::max(a, b));
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+	for (std::size_t i = 0; i < edges.size();) {
+		std::size_t end = i + 1;
+		while (end < edges.size() && edges[end] == edges[i]) {
+			++end;
+		}
+		if (end - i != 2) {
+			locked[edges[i].first] = 1;
+			locked[edges[i].second] = 1;
+		}
+		i = end;
+	}
+
+	// Propagate the locks of seam vertices to every vertex at the same position.
+	for (std::size_t vertexIndex = 0; vertexIndex < positionRemap.size(); ++vertexIndex) {
+		locked[vertexIndex] = static_cast<std::uint8_t>(locked[vertexIndex] | locked[positionRemap[vertexIndex]]);
+	}
+	return locked;
+}
+
+// Check if moving a vertex to a new position would flip any of the given triangles that use it, other than those that would become degenerate.
+[[nodiscard]] bool collapseFlipsTriangles(std::span<const std::uint32_t> indices, std::span<const std::size_t> triangles, std::span<const vec3> positions,
+	std::span<const std::uint32_t> positionRemap, std::uint32_t from, std::uint32_t to) noexcept {
+	const vec3 newPosition = positions[to];
+	for (const std::size_t triangleIndex : triangles) {
+		const std::span<const std::uint32_t, 3> triangle = indices.subspan(triangleIndex * 3).first<3>();
+		if (positionRemap[triangle[0]] == positionRemap[to] || positionRemap[triangle[1]] == positionRemap[to] || positionRemap[triangle[2]] == positionRemap[to]) {
+			continue;
+		}
+		const vec3 a = positions[triangle[0]];
+		const vec3 b = positions[triangle[1]];
+		const vec3 c = positions[triangle[2]];
+		const vec3 oldNormal = cross(b - a, c - a);
+		const vec3 newA = (triangle[0] == from) ? newPosition : a;
+		const vec3 newB = (triangle[1] == from) ? newPosition : b;
+		const vec3 newC = (triangle[2] == from) ? newPosition : c;
+		const vec3 newNormal = cross(newB - newA, newC - newA);
+		if (dot(oldNormal, newNormal) <= 0.0f) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+VertexCacheStatistics analyzeVertexCache(std::span<const std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize) {
+	const std::size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return {};
+	}
+
+	VertexCacheSimulator cache{vertexCount, cacheSize};
+	std::size_t missCount = 0;
+	std::size_t referencedVertexCount = 0;
+	for (const std::uint32_t vertexIndex : indices.first(triangleCount * 3)) {
+		referencedVertexCount += (cache.isReferenced(vertexIndex)) ? 0 : 1;
+		missCount += (cache.access(vertexIndex)) ? 1 : 0;
+	}
+	return VertexCacheStatistics{
+		.averageCacheMissRatio = static_cast<float>(missCount) / static_cast<float>(triangleCount),
+		.averageTransformToVertexRatio = static_cast<float>(missCount) / static_cast<float>(referencedVertexCount),
+	};
+}
+
+void optimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount) {
+	const std::size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	const ForsythScoreTables scoreTables{};
+
+	// Number of remaining triangles that use each vertex, and the list of those triangles, stored contiguously per vertex.
+	std::vector<std::uint32_t> valences(vertexCount, 0);
+	for (const std::uint32_t vertexIndex : indices.first(triangleCount * 3)) {
+		++valences[vertexIndex];
+	}
+	std::vector<std::size_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		adjacencyOffsets[vertexIndex + 1] = adjacencyOffsets[vertexIndex] + valences[vertexIndex];
+	}
+	std::vector<std::size_t> adjacentTriangles(triangleCount * 3);
+	{
+		std::vector<std::size_t> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (std::size_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+			for (std::size_t i = 0; i < 3; ++i) {
+				adjacentTriangles[adjacencyCursors[indices[triangleIndex * 3 + i]]++] = triangleIndex;
+			}
+		}
+	}
+
+	// Cache positions are stored off by one, so that 0 means that the vertex is not in the cache.
+	std::vector<std::size_t> cachePositions(vertexCount, 0);
+	std::vector<float> vertexScores(vertexCount);
+	for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		vertexScores[vertexIndex] = scoreTables.getVertexScore(0, valences[vertexIndex]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::size_t bestTriangle = 0;
+	for (std::size_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		const std::uint32_t* const triangle = &indices[triangleIndex * 3];
+		triangleScores[triangleIndex] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+		if (triangleScores[triangleIndex] > triangleScores[bestTriangle]) {
+			bestTriangle = triangleIndex;
+		}
+	}
+
+	std::vector<std::uint8_t> emitted(triangleCount, 0);
+	std::vector<std::uint32_t> output{};
+	output.reserve(triangleCount * 3);
+
+	std::array<std::uint32_t, FORSYTH_CACHE_SIZE + 3> cache{};
+	std::array<std::uint32_t, FORSYTH_CACHE_SIZE + 3> newCache{};
+	std::size_t cacheCount = 0;
+	std::size_t inputCursor = 0;
+	for (std::size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+		if (bestTriangle == NO_TRIANGLE) {
+			// None of the triangles that use a vertex in the cache are left, so continue from the next unused triangle in input order.
+			while (emitted[inputCursor] != 0) {
+				++inputCursor;
+			}
+			bestTriangle = inputCursor;
+		}
+
+		const std::array<std::uint32_t, 3> triangle{indices[bestTriangle * 3], indices[bestTriangle * 3 + 1], indices[bestTriangle * 3 + 2]};
+		output.insert(output.end(), triangle.begin(), triangle.end());
+		emitted[bestTriangle] = 1;
+
+		std::size_t newCacheCount = 0;
+		for (const std::uint32_t vertexIndex : triangle) {
+			const auto adjacencyBegin = adjacentTriangles.begin() + static_cast<std::ptrdiff_t>(adjacencyOffsets[vertexIndex]);
+			const auto adjacencyEnd = adjacencyBegin + static_cast<std::ptrdiff_t>(valences[vertexIndex]);
+			std::swap(*std::find(adjacencyBegin, adjacencyEnd, bestTriangle), *(adjacencyEnd - 1));
+			--valences[vertexIndex];
+
+			if (std::find(newCache.begin(), newCache.begin() + static_cast<std::ptrdiff_t>(newCacheCount), vertexIndex) ==
+				newCache.begin() + static_cast<std::ptrdiff_t>(newCacheCount)) {
+				newCache[newCacheCount++] = vertexIndex;
+			}
+		}
+		for (const std::uint32_t vertexIndex : std::span{cache}.first(cacheCount)) {
+			if (std::find(triangle.begin(), triangle.end(), vertexIndex) == triangle.end()) {
+				newCache[newCacheCount++] = vertexIndex;
+			}
+		}
+
+		// Update the scores of every vertex whose cache position or valence changed, including the ones that were just evicted.
+		for (std::size_t i = 0; i < newCacheCount; ++i) {
+			const std::uint32_t vertexIndex = newCache[i];
+			cachePositions[vertexIndex] = (i < FORSYTH_CACHE_SIZE) ? i + 1 : 0;
+			const float newScore = scoreTables.getVertexScore(cachePositions[vertexIndex], valences[vertexIndex]);
+			const float scoreDifference = newScore - vertexScores[vertexIndex];
+			vertexScores[vertexIndex] = newScore;
+			const std::size_t adjacencyBegin = adjacencyOffsets[vertexIndex];
+			for (std::size_t j = adjacencyBegin; j < adjacencyBegin + valences[vertexIndex]; ++j) {
+				triangleScores[adjacentTriangles[j]] += scoreDifference;
+			}
+		}
+
+		cacheCount = std::min(newCacheCount, FORSYTH_CACHE_SIZE);
+		std::copy(newCache.begin(), newCache.begin() + static_cast<std::ptrdiff_t>(cacheCount), cache.begin());
+
+		bestTriangle = NO_TRIANGLE;
+		float bestScore = -1.0f;
+		for (const std::uint32_t vertexIndex : std::span{cache}.first(cacheCount)) {
+			const std::size_t adjacencyBegin = adjacencyOffsets[vertexIndex];
+			for (std::size_t j = adjacencyBegin; j < adjacencyBegin + valences[vertexIndex]; ++j) {
+				if (const std::size_t triangleIndex = adjacentTriangles[j]; triangleScores[triangleIndex] > bestScore) {
+					bestTriangle = triangleIndex;
+					bestScore = triangleScores[triangleIndex];
+				}
+			}
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void optimizeOverdraw(std::span<std::uint32_t> indices, std::span<const vec3> positions, float threshold) {
+	const std::size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2) {
+		return;
+	}
+
+	struct Cluster {
+		std::size_t trianglesBegin;
+		std::size_t trianglesEnd;
+		vec3 centroid;
+		vec3 normal;
+		float sortKey;
+	};
+
+	const std::vector<std::size_t> clusterStarts = findClusterStarts(indices, positions.size(), threshold);
+	std::vector<Cluster> clusters{};
+	clusters.reserve(clusterStarts.size() - 1);
+
+	vec3 meshCentroid{0.0f, 0.0f, 0.0f};
+	float meshArea = 0.0f;
+	for (std::size_t clusterIndex = 0; clusterIndex + 1 < clusterStarts.size(); ++clusterIndex) {
+		Cluster& cluster = clusters.emplace_back(Cluster{
+			.trianglesBegin = clusterStarts[clusterIndex],
+			.trianglesEnd = clusterStarts[clusterIndex + 1],
+			.centroid{0.0f, 0.0f, 0.0f},
+			.normal{0.0f, 0.0f, 0.0f},
+			.sortKey = 0.0f,
+		});
+		vec3 vertexSum{0.0f, 0.0f, 0.0f};
+		float clusterArea = 0.0f;
+		for (std::size_t triangleIndex = cluster.trianglesBegin; triangleIndex < cluster.trianglesEnd; ++triangleIndex) {
+			const vec3 a = positions[indices[triangleIndex * 3]];
+			const vec3 b = positions[indices[triangleIndex * 3 + 1]];
+			const vec3 c = positions[indices[triangleIndex * 3 + 2]];
+			const vec3 weightedNormal = cross(b - a, c - a);
+			const float area = length(weightedNormal) * 0.5f;
+			vertexSum += a + b + c;
+			cluster.centroid += (a + b + c) * (area / 3.0f);
+			cluster.normal += weightedNormal;
+			clusterArea += area;
+		}
+		meshCentroid += cluster.centroid;
+		meshArea += clusterArea;
+		const float clusterTriangleCount = static_cast<float>(cluster.trianglesEnd - cluster.trianglesBegin);
+		cluster.centroid = (clusterArea > 0.0f) ? cluster.centroid * (1.0f / clusterArea) : vertexSum * (1.0f / (clusterTriangleCount * 3.0f));
+	}
+	if (meshArea > 0.0f) {
+		meshCentroid = meshCentroid * (1.0f / meshArea);
+	}
+
+	// Clusters that lie far out along the direction they face are the most likely to occlude the rest of the mesh, so draw them first.
+	for (Cluster& cluster : clusters) {
+		const float normalLength = length(cluster.normal);
+		cluster.sortKey = (normalLength > 0.0f) ? dot(cluster.centroid - meshCentroid, cluster.normal) / normalLength : 0.0f;
+	}
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) -> bool { return a.sortKey > b.sortKey; });
+
+	std::vector<std::uint32_t> output{};
+	output.reserve(triangleCount * 3);
+	for (const Cluster& cluster : clusters) {
+		output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(cluster.trianglesBegin * 3),
+			indices.begin() + static_cast<std::ptrdiff_t>(cluster.trianglesEnd * 3));
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+MeshSimplificationResult simplifyMesh(std::span<const std::uint32_t> indices, std::span<const vec3> positions, const MeshSimplificationOptions& options) {
+	struct Collapse {
+		std::uint32_t from;
+		std::uint32_t to;
+		double error;
+	};
+
+	const std::size_t vertexCount = positions.size();
+	std::vector<std::uint32_t> result(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(indices.size() / 3 * 3));
+	const std::vector<std::uint32_t> positionRemap = findPositionRemap(positions);
+	const std::vector<std::uint8_t> locked = findLockedVertices(result, positionRemap);
+
+	// Quadrics are stored per unique position, so that the error of the vertices on either side of a seam is shared.
+	std::vector<Quadric> quadrics(vertexCount);
+	for (std::size_t i = 0; i < result.size(); i += 3) {
+		const vec3 a = positions[result[i]];
+		const vec3 b = positions[result[i + 1]];
+		const vec3 c = positions[result[i + 2]];
+		const vec3 weightedNormal = cross(b - a, c - a);
+		const float doubleArea = length(weightedNormal);
+		if (doubleArea > 0.0f) {
+			const vec3 normal = weightedNormal * (1.0f / doubleArea);
+			for (std::size_t j = 0; j < 3; ++j) {
+				quadrics[positionRemap[result[i + j]]].addPlane(normal, -dot(normal, a), doubleArea * 0.5f);
+			}
+		}
+	}
+
+	const double maxError = static_cast<double>(options.maxError) * static_cast<double>(options.maxError);
+	double resultError = 0.0;
+	std::vector<Collapse> collapses{};
+	std::vector<std::size_t> adjacencyOffsets(vertexCount + 1);
+	std::vector<std::size_t> adjacentTriangles{};
+	std::vector<std::uint32_t> remap(vertexCount);
+	std::vector<std::uint8_t> touched(vertexCount);
+	while (result.size() > options.targetIndexCount) {
+		const std::size_t triangleCount = result.size() / 3;
+
+		// Gather the candidate collapses along every edge, in both directions.
+		collapses.clear();
+		for (std::size_t i = 0; i < result.size(); i += 3) {
+			for (std::size_t j = 0; j < 3; ++j) {
+				const std::uint32_t a = result[i + j];
+				const std::uint32_t b = result[i + (j + 1) % 3];
+				for (const auto& [from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+					if (locked[from] == 0 && positionRemap[from] != positionRemap[to]) {
+						Quadric quadric = quadrics[positionRemap[from]];
+						quadric += quadrics[positionRemap[to]];
+						collapses.push_back({.from = from, .to = to, .error = quadric.evaluate(positions[to])});
+					}
+				}
+			}
+		}
+		if (collapses.empty()) {
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) -> bool { return a.error < b.error; });
+
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (const std::uint32_t vertexIndex : result) {
+			++adjacencyOffsets[vertexIndex + 1];
+		}
+		for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+			adjacencyOffsets[vertexIndex + 1] += adjacencyOffsets[vertexIndex];
+		}
+		adjacentTriangles.resize(result.size());
+		{
+			std::vector<std::size_t> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (std::size_t i = 0; i < result.size(); ++i) {
+				adjacentTriangles[adjacencyCursors[result[i]]++] = i / 3;
+			}
+		}
+
+		// Perform as many of the cheapest collapses as possible that do not affect the same triangles, up to the number needed to reach the
+		// target, given that each collapse of an interior edge removes two triangles.
+		for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+			remap[vertexIndex] = static_cast<std::uint32_t>(vertexIndex);
+		}
+		std::fill(touched.begin(), touched.end(), 0);
+		const std::size_t targetTriangleCount = options.targetIndexCount / 3;
+		const std::size_t maxCollapseCount = (triangleCount - std::min(targetTriangleCount, triangleCount) + 1) / 2;
+		std::size_t collapseCount = 0;
+		for (const Collapse& collapse : collapses) {
+			if (collapseCount >= maxCollapseCount || collapse.error > maxError) {
+				break;
+			}
+			if (touched[positionRemap[collapse.from]] != 0 || touched[positionRemap[collapse.to]] != 0) {
+				continue;
+			}
+			const std::span<const std::size_t> triangles =
+				std::span{adjacentTriangles}.subspan(adjacencyOffsets[collapse.from], adjacencyOffsets[collapse.from + 1] - adjacencyOffsets[collapse.from]);
+			if (collapseFlipsTriangles(result, triangles, positions, positionRemap, collapse.from, collapse.to)) {
+				continue;
+			}
+			remap[collapse.from] = collapse.to;
+			quadrics[positionRemap[collapse.to]] += quadrics[positionRemap[collapse.from]];
+			for (const std::size_t triangleIndex : triangles) {
+				for (std::size_t j = 0; j < 3; ++j) {
+					touched[positionRemap[result[triangleIndex * 3 + j]]] = 1;
+				}
+			}
+			resultError = std::max(resultError, collapse.error);
+			++collapseCount;
+		}
+		if (collapseCount == 0) {
+			break;
+		}
+
+		std::size_t resultSize = 0;
+		for (std::size_t i = 0; i < result.size(); i += 3) {
+			const std::uint32_t a = remap[result[i]];
+			const std::uint32_t b = remap[result[i + 1]];
+			const std::uint32_t c = remap[result[i + 2]];
+			if (positionRemap[a] != positionRemap[b] && positionRemap[b] != positionRemap[c] && positionRemap[c] != positionRemap[a]) {
+				result[resultSize++] = a;
+				result[resultSize++] = b;
+				result[resultSize++] = c;
+			}
+		}
+		result.resize(resultSize);
+	}
+
+	return MeshSimplificationResult{
+		.indices = std::move(result),
+		.error = static_cast<float>(std::sqrt(resultError)),
+	};
+}
+
+std::vector<std::uint32_t> optimizeVertexFetchRemap(std::span<std::uint32_t> indices, std::size_t vertexCount) {
+	constexpr std::uint32_t UNUSED = std::numeric_limits<std::uint32_t>::max();
+
+	std::vector<std::uint32_t> remap(vertexCount, UNUSED);
+	std::uint32_t nextVertexIndex = 0;
+	for (std::uint32_t& vertexIndex : indices) {
+		if (remap[vertexIndex] == UNUSED) {
+			remap[vertexIndex] = nextVertexIndex++;
+		}
+		vertexIndex = remap[vertexIndex];
+	}
+	for (std::uint32_t& newVertexIndex : remap) {
+		if (newVertexIndex == UNUSED) {
+			newVertexIndex = nextVertexIndex++;
+		}
+	}
+	return remap;
+}
+
+} // namespace donut::graphics
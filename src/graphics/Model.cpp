@@ -3,28 +3,54 @@
 #include <donut/graphics/Error.hpp>
 #include <donut/graphics/Image.hpp>
 #include <donut/graphics/Mesh.hpp>
+#include <donut/graphics/MeshOptimization.hpp>
 #include <donut/graphics/Model.hpp>
 #include <donut/graphics/Texture.hpp>
+#include <donut/graphics/VertexPacking.hpp>
 #include <donut/math.hpp>
 #include <donut/obj.hpp>
-
-#include <algorithm>     // std::find_if
-#include <array>         // std::array
-#include <cstddef>       // std::size_t, std::byte
-#include <exception>     // std::exception
-#include <fmt/format.h>  // fmt::format
-#include <functional>    // std::hash
-#include <numbers>       // std::numbers_pi_v
-#include <span>          // std::span
-#include <string>        // std::string
-#include <unordered_map> // std::unordered_map
-#include <utility>       // std::move
-#include <vector>        // std::vector
+#include <donut/shapes.hpp>
+
+#include "../parallel.hpp"
+
+#include <algorithm>    // std::find_if, std::equal, std::max
+#include <array>        // std::array
+#include <bit>          // std::endian, std::bit_ceil
+#include <cstddef>      // std::size_t, std::byte
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcpy
+#include <exception>    // std::exception
+#include <fmt/format.h> // fmt::format
+#include <limits>       // std::numeric_limits
+#include <numbers>      // std::numbers::pi_v
+#include <span>         // std::span, std::as_bytes
+#include <string>       // std::string
+#include <string_view>  // std::string_view
+#include <type_traits>  // std::is_same_v, std::type_identity
+#include <utility>      // std::move, std::pair, std::in_place_type
+#include <vector>       // std::vector
 
 namespace donut::graphics {
 
 namespace {
 
+// Polynomial approximation of acos(x) for x in [-1, 1], with an absolute error of at most 2e-8 (Abramowitz and Stegun, formula 4.4.46). Unlike
+// std::acos, it compiles to a short branch-free sequence of multiply-adds and a square root that is inlined into the triangle loop of
+// generateNormals(), where the three angles of a triangle can then be evaluated together.
+[[nodiscard]] float approximateAcos(float x) noexcept {
+	const float a = abs(x);
+	float polynomial = -0.0012624911f;
+	polynomial = polynomial * a + 0.0066700901f;
+	polynomial = polynomial * a - 0.0170881256f;
+	polynomial = polynomial * a + 0.0308918810f;
+	polynomial = polynomial * a - 0.0501743046f;
+	polynomial = polynomial * a + 0.0889789874f;
+	polynomial = polynomial * a - 0.2145988016f;
+	polynomial = polynomial * a + 1.5707963050f;
+	const float result = sqrt(1.0f - a) * polynomial;
+	return (x < 0.0f) ? std::numbers::pi_v<float> - result : result;
+}
+
 void generateNormals(std::span<Model::Object::Vertex> vertices, std::span<const Model::Object::Index> indices) {
 	for (Model::Object::Vertex& vertex : vertices) {
 		vertex.normal = {0.0f, 0.0f, 0.0f};
@@ -41,25 +67,17 @@ void generateNormals(std::span<Model::Object::Vertex> vertices, std::span<const
 
 		const vec3 normal = cross(ab, ac);
 
-		const float squareLengthAB = length2(ab);
-		const float squareLengthAC = length2(ac);
-		const float squareLengthBC = length2(bc);
-
-		const float lengthAB = (squareLengthAB >= 1e-6f) ? sqrt(squareLengthAB) : 1e-3f;
-		const float lengthAC = (squareLengthAC >= 1e-6f) ? sqrt(squareLengthAC) : 1e-3f;
-		const float lengthBC = (squareLengthBC >= 1e-6f) ? sqrt(squareLengthBC) : 1e-3f;
+		const float lengthAB = sqrt(max(length2(ab), 1e-6f));
+		const float lengthAC = sqrt(max(length2(ac), 1e-6f));
+		const float lengthBC = sqrt(max(length2(bc), 1e-6f));
 
 		const float influenceAB = dot(ab, ac) / (lengthAB * lengthAC);
 		const float influenceAC = -dot(ab, bc) / (lengthAB * lengthBC);
 		const float influenceBC = dot(ac, bc) / (lengthAC * lengthBC);
 
-		const float angleAB = (influenceAB >= 1.0f) ? 0.0f : (influenceAB <= -1.0f) ? std::numbers::pi_v<float> : acos(influenceAB);
-		const float angleAC = (influenceAC >= 1.0f) ? 0.0f : (influenceAC <= -1.0f) ? std::numbers::pi_v<float> : acos(influenceAC);
-		const float angleBC = (influenceBC >= 1.0f) ? 0.0f : (influenceBC <= -1.0f) ? std::numbers::pi_v<float> : acos(influenceBC);
-
-		vertices[indexA].normal += normal * angleAB;
-		vertices[indexB].normal += normal * angleAC;
-		vertices[indexC].normal += normal * angleBC;
+		vertices[indexA].normal += normal * approximateAcos(clamp(influenceAB, -1.0f, 1.0f));
+		vertices[indexB].normal += normal * approximateAcos(clamp(influenceAC, -1.0f, 1.0f));
+		vertices[indexC].normal += normal * approximateAcos(clamp(influenceBC, -1.0f, 1.0f));
 	}
 
 	for (Model::Object::Vertex& vertex : vertices) {
@@ -103,19 +121,262 @@ void generateTangentSpace(std::span<Model::Object::Vertex> vertices, std::span<c
 	}
 }
 
+// Open-addressing hash map from face vertices to the index of the corresponding mesh vertex, using linear probing over a flat array of slots.
+class FaceVertexMap {
+public:
+	explicit FaceVertexMap(std::size_t faceVertexCount)
+		: slots(std::bit_ceil(std::max(faceVertexCount / 2, MIN_CAPACITY))) {}
+
+	[[nodiscard]] std::pair<Model::Object::Index, bool> emplace(const obj::FaceVertex& faceVertex, Model::Object::Index index) {
+		if ((size + 1) * 4 > slots.size() * 3) {
+			grow();
+		}
+		Slot& slot = findSlot(faceVertex);
+		if (slot.index != EMPTY_INDEX) {
+			return {slot.index, false};
+		}
+		slot = Slot{.faceVertex = faceVertex, .index = index};
+		++size;
+		return {index, true};
+	}
+
+private:
+	static constexpr std::size_t MIN_CAPACITY = 64;
+	static constexpr Model::Object::Index EMPTY_INDEX = std::numeric_limits<Model::Object::Index>::max();
+
+	struct Slot {
+		obj::FaceVertex faceVertex{};
+		Model::Object::Index index = EMPTY_INDEX;
+	};
+
+	[[nodiscard]] static std::size_t hash(const obj::FaceVertex& faceVertex) noexcept {
+		// Mix the 96-bit key as two 64-bit words, and fold the well-mixed high bits into the low bits that are used for indexing.
+		const std::uint64_t low = std::uint64_t{faceVertex.vertexIndex} | (std::uint64_t{faceVertex.textureCoordinateIndex} << 32);
+		const std::uint64_t high = std::uint64_t{faceVertex.normalIndex};
+		std::uint64_t result = (low * 0x9E3779B97F4A7C15ull) ^ ((high + 1) * 0xC2B2AE3D27D4EB4Full);
+		result ^= result >> 32;
+		return static_cast<std::size_t>(result);
+	}
+
+	[[nodiscard]] Slot& findSlot(const obj::FaceVertex& faceVertex) noexcept {
+		const std::size_t mask = slots.size() - 1;
+		for (std::size_t i = hash(faceVertex) & mask;; i = (i + 1) & mask) {
+			Slot& slot = slots[i];
+			if (slot.index == EMPTY_INDEX || (slot.faceVertex.vertexIndex == faceVertex.vertexIndex &&
+												 slot.faceVertex.textureCoordinateIndex == faceVertex.textureCoordinateIndex &&
+												 slot.faceVertex.normalIndex == faceVertex.normalIndex)) {
+				return slot;
+			}
+		}
+	}
+
+	void grow() {
+		std::vector<Slot> oldSlots(slots.size() * 2);
+		oldSlots.swap(slots);
+		for (const Slot& oldSlot : oldSlots) {
+			if (oldSlot.index != EMPTY_INDEX) {
+				findSlot(oldSlot.faceVertex) = oldSlot;
+			}
+		}
+	}
+
+	std::vector<Slot> slots;
+	std::size_t size = 0;
+};
+
 [[nodiscard]] Texture loadTexture(const Filesystem& filesystem, const std::string& filepath) {
 	return Texture{Image{filesystem, filepath.c_str(), {.highDynamicRange = filepath.ends_with(".hdr")}}};
 }
 
-void loadObjScene(Model& output, const Filesystem& filesystem, const char* filepath) {
-	const obj::Scene scene = obj::Scene::parse(filesystem.openFile(filepath).readAllIntoString());
-
+[[nodiscard]] std::string getFilepathPrefix(const char* filepath) {
 	std::string filepathPrefix = filepath;
 	if (const std::size_t filepathLastSlashPosition = filepathPrefix.rfind('/'); filepathLastSlashPosition != std::string::npos) {
 		filepathPrefix.erase(filepathLastSlashPosition + 1, std::string::npos);
 	} else {
 		filepathPrefix.clear();
 	}
+	return filepathPrefix;
+}
+
+[[nodiscard]] Box<3, float> getBoundingBox(std::span<const Model::Object::Vertex> vertices) noexcept {
+	if (vertices.empty()) {
+		return Box<3, float>{.min{0.0f, 0.0f, 0.0f}, .max{0.0f, 0.0f, 0.0f}};
+	}
+	Box<3, float> bounds{.min = vertices.front().position, .max = vertices.front().position};
+	for (const Model::Object::Vertex& vertex : vertices) {
+		bounds.min = min(bounds.min, vertex.position);
+		bounds.max = max(bounds.max, vertex.position);
+	}
+	return bounds;
+}
+
+struct MaterialDescription {
+	std::string diffuseMapName{};
+	std::string specularMapName{};
+	std::string normalMapName{};
+	std::string emissiveMapName{};
+	vec3 diffuseColor{1.0f, 1.0f, 1.0f};
+	vec3 specularColor{1.0f, 1.0f, 1.0f};
+	vec3 normalScale{1.0f, 1.0f, 1.0f};
+	vec3 emissiveColor{0.0f, 0.0f, 0.0f};
+	float specularExponent = 1.0f;
+	float dissolveFactor = 0.0f;
+	float occlusionFactor = 1.0f;
+};
+
+struct ObjectDescription {
+	std::vector<Model::Object::Vertex> vertices{};
+	std::vector<Model::Object::Index> indices{};
+	std::vector<Model::Object::LevelOfDetail> levelsOfDetail{};
+	MaterialDescription material{};
+	ModelOptimizationStatistics optimizationStatistics{};
+};
+
+template <typename Vertex>
+[[nodiscard]] Model::Object createObject(const Filesystem& filesystem, const std::string& filepathPrefix, std::span<const Vertex> vertices,
+	std::span<const Model::Object::Index> indices, std::span<const Model::Object::LevelOfDetail> levelsOfDetail, const MaterialDescription& material,
+	const Box<3, float>& bounds) {
+	return Model::Object{
+		.mesh{std::in_place_type<Mesh<Vertex, Model::Object::Index, Model::Object::Instance>>, Model::Object::VERTICES_USAGE, Model::Object::INDICES_USAGE,
+			Model::Object::INSTANCES_USAGE, vertices, indices, std::span<const Model::Object::Instance>{}},
+		.material{
+			.diffuseMap = (material.diffuseMapName.empty()) ? Texture{} : loadTexture(filesystem, filepathPrefix + material.diffuseMapName),
+			.specularMap = (material.specularMapName.empty()) ? Texture{} : loadTexture(filesystem, filepathPrefix + material.specularMapName),
+			.normalMap = (material.normalMapName.empty()) ? Texture{} : loadTexture(filesystem, filepathPrefix + material.normalMapName),
+			.emissiveMap = (material.emissiveMapName.empty()) ? Texture{} : loadTexture(filesystem, filepathPrefix + material.emissiveMapName),
+			.diffuseColor = material.diffuseColor,
+			.specularColor = material.specularColor,
+			.normalScale = material.normalScale,
+			.emissiveColor = material.emissiveColor,
+			.specularExponent = material.specularExponent,
+			.dissolveFactor = material.dissolveFactor,
+			.occlusionFactor = material.occlusionFactor,
+		},
+		.indexCount = (levelsOfDetail.empty()) ? indices.size() : levelsOfDetail.front().indexCount,
+		.bounds = bounds,
+		.levelsOfDetail{levelsOfDetail.begin(), levelsOfDetail.end()},
+	};
+}
+
+[[nodiscard]] std::size_t getVertexSize(ModelVertexFormat vertexFormat) noexcept {
+	switch (vertexFormat) {
+		case ModelVertexFormat::STANDARD: break;
+		case ModelVertexFormat::COMPACT: return sizeof(Model::Object::CompactVertex);
+		case ModelVertexFormat::QUANTIZED: return sizeof(Model::Object::QuantizedVertex);
+	}
+	return sizeof(Model::Object::Vertex);
+}
+
+template <typename Vertex>
+[[nodiscard]] std::vector<Vertex> packVertices(std::span<const Model::Object::Vertex> vertices, const Box<3, float>& bounds) {
+	const vec3 extent = bounds.max - bounds.min;
+	const vec3 inverseExtent{
+		(extent.x > 0.0f) ? 1.0f / extent.x : 0.0f,
+		(extent.y > 0.0f) ? 1.0f / extent.y : 0.0f,
+		(extent.z > 0.0f) ? 1.0f / extent.z : 0.0f,
+	};
+	std::vector<Vertex> result{};
+	result.reserve(vertices.size());
+	for (const Model::Object::Vertex& vertex : vertices) {
+		Vertex& packedVertex = result.emplace_back();
+		if constexpr (std::is_same_v<Vertex, Model::Object::QuantizedVertex>) {
+			packedVertex.position = Normalized<u16vec4>::pack(vec4{(vertex.position - bounds.min) * inverseExtent, 0.0f});
+		} else {
+			packedVertex.position = vertex.position;
+		}
+		packedVertex.normal = PackedSnorm3x10_1x2::pack(vec4{vertex.normal, 0.0f});
+		packedVertex.tangent = PackedSnorm3x10_1x2::pack(vec4{vertex.tangent, 0.0f});
+		packedVertex.bitangent = PackedSnorm3x10_1x2::pack(vec4{vertex.bitangent, 0.0f});
+		packedVertex.textureCoordinates = PackedHalf2x16::pack(vertex.textureCoordinates);
+	}
+	return result;
+}
+
+// Invokes the callback with a span of the vertices converted to the given vertex format, which is only valid for the duration of the call.
+template <typename Callback>
+decltype(auto) visitPackedVertices(std::span<const Model::Object::Vertex> vertices, const Box<3, float>& bounds, ModelVertexFormat vertexFormat, Callback&& callback) {
+	switch (vertexFormat) {
+		case ModelVertexFormat::STANDARD: break;
+		case ModelVertexFormat::COMPACT: return callback(std::span<const Model::Object::CompactVertex>{packVertices<Model::Object::CompactVertex>(vertices, bounds)});
+		case ModelVertexFormat::QUANTIZED: return callback(std::span<const Model::Object::QuantizedVertex>{packVertices<Model::Object::QuantizedVertex>(vertices, bounds)});
+	}
+	return callback(vertices);
+}
+
+[[nodiscard]] std::vector<vec3> getPositions(std::span<const Model::Object::Vertex> vertices) {
+	std::vector<vec3> positions{};
+	positions.reserve(vertices.size());
+	for (const Model::Object::Vertex& vertex : vertices) {
+		positions.push_back(vertex.position);
+	}
+	return positions;
+}
+
+[[nodiscard]] std::span<Model::Object::Index> getLevelOfDetailIndices(ObjectDescription& object, const Model::Object::LevelOfDetail& levelOfDetail) noexcept {
+	return std::span{object.indices}.subspan(levelOfDetail.indexOffset, levelOfDetail.indexCount);
+}
+
+void generateLevelsOfDetail(ObjectDescription& object, const ModelOptions& options) {
+	object.levelsOfDetail.push_back({.indexOffset = 0, .indexCount = object.indices.size()});
+	if (options.levelOfDetailCount <= 1 || object.indices.empty()) {
+		return;
+	}
+	const std::vector<vec3> positions = getPositions(object.vertices);
+	const Box<3, float> bounds = getBoundingBox(object.vertices);
+	const float maxError = options.levelOfDetailMaxError * length(bounds.max - bounds.min);
+	while (object.levelsOfDetail.size() < options.levelOfDetailCount) {
+		const std::span<const Model::Object::Index> previousIndices = getLevelOfDetailIndices(object, object.levelsOfDetail.back());
+		const std::size_t targetTriangleCount = static_cast<std::size_t>(static_cast<float>(previousIndices.size() / 3) * options.levelOfDetailReduction);
+		const MeshSimplificationResult simplified = simplifyMesh(previousIndices, positions, {.targetIndexCount = targetTriangleCount * 3, .maxError = maxError});
+		if (simplified.indices.empty() || simplified.indices.size() >= previousIndices.size()) {
+			break;
+		}
+		object.levelsOfDetail.push_back({.indexOffset = object.indices.size(), .indexCount = simplified.indices.size()});
+		object.indices.insert(object.indices.end(), simplified.indices.begin(), simplified.indices.end());
+	}
+}
+
+[[nodiscard]] std::vector<float> getLevelOfDetailScreenSizes(std::span<const ObjectDescription> objects, const ModelOptions& options) {
+	std::size_t levelOfDetailCount = 1;
+	for (const ObjectDescription& object : objects) {
+		levelOfDetailCount = std::max(levelOfDetailCount, object.levelsOfDetail.size());
+	}
+	std::vector<float> screenSizes{};
+	screenSizes.reserve(levelOfDetailCount - 1);
+	float screenSize = options.levelOfDetailScreenSize;
+	for (std::size_t i = 1; i < levelOfDetailCount; ++i) {
+		screenSizes.push_back(screenSize);
+		screenSize *= sqrt(options.levelOfDetailReduction);
+	}
+	return screenSizes;
+}
+
+void optimizeObject(ObjectDescription& object, const ModelOptions& options) {
+	object.optimizationStatistics.before = analyzeVertexCache(getLevelOfDetailIndices(object, object.levelsOfDetail.front()), object.vertices.size());
+	const std::vector<vec3> positions = (options.optimizeOverdraw) ? getPositions(object.vertices) : std::vector<vec3>{};
+	for (const Model::Object::LevelOfDetail& levelOfDetail : object.levelsOfDetail) {
+		const std::span<Model::Object::Index> indices = getLevelOfDetailIndices(object, levelOfDetail);
+		optimizeVertexCache(indices, object.vertices.size());
+		if (options.optimizeOverdraw) {
+			optimizeOverdraw(indices, positions, options.overdrawThreshold);
+		}
+	}
+	// The vertices are ordered by their first use across all levels, which is dominated by the full-detail level at the start of the buffer.
+	optimizeVertexFetch(std::span{object.vertices}, std::span{object.indices});
+	object.optimizationStatistics.after = analyzeVertexCache(getLevelOfDetailIndices(object, object.levelsOfDetail.front()), object.vertices.size());
+}
+
+void reportOptimizationStatistics(std::span<const ObjectDescription> objects, const ModelOptions& options) {
+	if (options.optimizationStatistics && options.optimizeVertexCache) {
+		options.optimizationStatistics->reserve(objects.size());
+		for (const ObjectDescription& object : objects) {
+			options.optimizationStatistics->push_back(object.optimizationStatistics);
+		}
+	}
+}
+
+[[nodiscard]] std::vector<ObjectDescription> buildObjScene(const Filesystem& filesystem, const char* filepath, const obj::FlatScene& scene, const ModelOptions& options) {
+	const std::string filepathPrefix = getFilepathPrefix(filepath);
 
 	std::vector<obj::mtl::Library> materialLibraries{};
 	materialLibraries.reserve(scene.materialLibraryFilenames.size());
@@ -123,107 +384,275 @@ void loadObjScene(Model& output, const Filesystem& filesystem, const char* filep
 		materialLibraries.push_back(obj::mtl::Library::parse(filesystem.openFile((filepathPrefix + materialLibraryFilename).c_str()).readAllIntoString()));
 	}
 
-	struct FaceVertexHash {
-		[[nodiscard]] std::size_t operator()(const obj::FaceVertex& faceVertex) const {
-			return (std::hash<std::uint32_t>{}(faceVertex.vertexIndex) ^ (std::hash<std::uint32_t>{}(faceVertex.textureCoordinateIndex) << 1) >> 1) ^
-			       (std::hash<std::uint32_t>{}(faceVertex.normalIndex) << 1);
+	std::vector<const obj::FlatGroup*> groups{};
+	groups.reserve(scene.groups.size());
+	for (const obj::FlatObject& object : scene.objects) {
+		for (std::size_t groupIndex = object.groupsBegin; groupIndex < object.groupsEnd; ++groupIndex) {
+			groups.push_back(&scene.groups[groupIndex]);
 		}
-	};
+	}
 
-	struct FaceVertexEqual {
-		[[nodiscard]] bool operator()(const obj::FaceVertex& a, const obj::FaceVertex& b) const {
-			return a.vertexIndex == b.vertexIndex && a.textureCoordinateIndex == b.textureCoordinateIndex && a.normalIndex == b.normalIndex;
+	std::vector<ObjectDescription> output(groups.size());
+	donut::detail::runInParallel(groups.size(), donut::detail::getThreadCount(0), [&](std::size_t groupIndex) -> void {
+		const obj::FlatGroup& group = *groups[groupIndex];
+		ObjectDescription& result = output[groupIndex];
+		std::vector<Model::Object::Vertex>& vertices = result.vertices;
+		std::vector<Model::Object::Index>& indices = result.indices;
+
+		std::size_t faceVertexCount = 0;
+		std::size_t triangleCount = 0;
+		for (std::size_t faceIndex = group.facesBegin; faceIndex < group.facesEnd; ++faceIndex) {
+			const std::size_t faceSize = scene.faceOffsets[faceIndex + 1] - scene.faceOffsets[faceIndex];
+			faceVertexCount += faceSize;
+			triangleCount += (faceSize >= 3) ? faceSize - 2 : 0;
 		}
-	};
-
-	std::unordered_map<obj::FaceVertex, std::size_t, FaceVertexHash, FaceVertexEqual> vertexMap{};
-
-	output.objects.reserve(scene.objects.size());
-	for (const obj::Object& object : scene.objects) {
-		for (const obj::Group& group : object.groups) {
-			std::vector<Model::Object::Vertex> vertices{};
-			std::vector<Model::Object::Index> indices{};
-
-			vertexMap.clear();
-
-			for (const obj::Face& face : group.faces) {
-				if (face.vertices.size() >= 3) {
-					for (std::size_t i = 1; i + 1 < face.vertices.size(); ++i) {
-						for (const std::size_t faceVertexIndex : {std::size_t{0}, i, i + 1}) {
-							const obj::FaceVertex& faceVertex = face.vertices[faceVertexIndex];
-							std::size_t vertexIndex = vertices.size();
-							if (const auto [it, inserted] = vertexMap.emplace(faceVertex, vertexIndex); inserted) {
-								vertices.push_back({
-									.position = (faceVertex.vertexIndex < scene.vertices.size()) ? scene.vertices[faceVertex.vertexIndex] : vec3{0.0f, 0.0f, 0.0f},
-									.normal = (faceVertex.normalIndex < scene.normals.size()) ? scene.normals[faceVertex.normalIndex] : vec3{0.0f, 0.0f, 0.0f},
-									.tangent{},
-									.bitangent{},
-									.textureCoordinates = (faceVertex.textureCoordinateIndex < scene.textureCoordinates.size())
-								                              ? scene.textureCoordinates[faceVertex.textureCoordinateIndex]
-								                              : vec2{0.0f, 0.0f},
-								});
-							} else {
-								vertexIndex = it->second;
-							}
-							indices.push_back(static_cast<Model::Object::Index>(vertexIndex));
+		indices.reserve(triangleCount * 3);
+
+		FaceVertexMap vertexMap{faceVertexCount};
+		for (std::size_t faceIndex = group.facesBegin; faceIndex < group.facesEnd; ++faceIndex) {
+			const std::span<const obj::FaceVertex> face = scene.getFace(faceIndex);
+			if (face.size() >= 3) {
+				for (std::size_t i = 1; i + 1 < face.size(); ++i) {
+					for (const std::size_t faceVertexIndex : {std::size_t{0}, i, i + 1}) {
+						const obj::FaceVertex& faceVertex = face[faceVertexIndex];
+						const auto [vertexIndex, inserted] = vertexMap.emplace(faceVertex, static_cast<Model::Object::Index>(vertices.size()));
+						if (inserted) {
+							vertices.push_back({
+								.position = (faceVertex.vertexIndex < scene.vertices.size()) ? scene.vertices[faceVertex.vertexIndex] : vec3{0.0f, 0.0f, 0.0f},
+								.normal = (faceVertex.normalIndex < scene.normals.size()) ? scene.normals[faceVertex.normalIndex] : vec3{0.0f, 0.0f, 0.0f},
+								.tangent{},
+								.bitangent{},
+								.textureCoordinates = (faceVertex.textureCoordinateIndex < scene.textureCoordinates.size())
+							                              ? scene.textureCoordinates[faceVertex.textureCoordinateIndex]
+							                              : vec2{0.0f, 0.0f},
+							});
 						}
+						indices.push_back(vertexIndex);
 					}
 				}
 			}
+		}
 
-			if (scene.normals.size() != scene.vertices.size()) {
-				generateNormals(vertices, indices);
-			}
-			generateTangentSpace(vertices, indices);
+		if (scene.normals.size() != scene.vertices.size()) {
+			generateNormals(vertices, indices);
+		}
+		generateTangentSpace(vertices, indices);
+		generateLevelsOfDetail(result, options);
+		if (options.optimizeVertexCache) {
+			optimizeObject(result, options);
+		}
 
-			Model::Object::Material groupMaterial{
-				.diffuseMap{},
-				.specularMap{},
-				.normalMap{},
-				.emissiveMap{},
-				.diffuseColor{1.0f, 1.0f, 1.0f},
-				.specularColor{1.0f, 1.0f, 1.0f},
-				.normalScale{1.0f, 1.0f, 1.0f},
-				.emissiveColor{0.0f, 0.0f, 0.0f},
-				.specularExponent = 1.0f,
-				.dissolveFactor = 0.0f,
-				.occlusionFactor = 1.0f,
-			};
-			if (!group.materialName.empty()) {
-				for (const obj::mtl::Library& materialLibrary : materialLibraries) {
-					if (const auto it = std::find_if(materialLibrary.materials.begin(), materialLibrary.materials.end(),
-							[&](const obj::mtl::Material& material) -> bool { return material.name == group.materialName; });
-						it != materialLibrary.materials.end()) {
-						const obj::mtl::Material& material = *it;
-						if (!material.diffuseMapName.empty()) {
-							groupMaterial.diffuseMap = loadTexture(filesystem, filepathPrefix + material.diffuseMapName);
-						}
-						if (!material.specularMapName.empty()) {
-							groupMaterial.specularMap = loadTexture(filesystem, filepathPrefix + material.specularMapName);
-						}
-						if (!material.bumpMapName.empty()) {
-							groupMaterial.normalMap = loadTexture(filesystem, filepathPrefix + material.bumpMapName);
-						}
-						if (!material.emissiveMapName.empty()) {
-							groupMaterial.emissiveMap = loadTexture(filesystem, filepathPrefix + material.emissiveMapName);
-						}
-						groupMaterial.diffuseColor = material.diffuseColor;
-						groupMaterial.specularColor = material.specularColor;
-						groupMaterial.emissiveColor = material.emissiveColor;
-						groupMaterial.specularExponent = material.specularExponent;
-						groupMaterial.dissolveFactor = material.dissolveFactor;
-						groupMaterial.occlusionFactor = material.ambientColor.x * material.ambientColor.y * material.ambientColor.z;
-						break;
-					}
+		if (const std::string_view materialName = scene.getString(group.materialName); !materialName.empty()) {
+			for (const obj::mtl::Library& materialLibrary : materialLibraries) {
+				if (const auto it = std::find_if(materialLibrary.materials.begin(), materialLibrary.materials.end(),
+						[&](const obj::mtl::Material& material) -> bool { return material.name == materialName; });
+					it != materialLibrary.materials.end()) {
+					const obj::mtl::Material& material = *it;
+					result.material.diffuseMapName = material.diffuseMapName;
+					result.material.specularMapName = material.specularMapName;
+					result.material.normalMapName = material.bumpMapName;
+					result.material.emissiveMapName = material.emissiveMapName;
+					result.material.diffuseColor = material.diffuseColor;
+					result.material.specularColor = material.specularColor;
+					result.material.emissiveColor = material.emissiveColor;
+					result.material.specularExponent = material.specularExponent;
+					result.material.dissolveFactor = material.dissolveFactor;
+					result.material.occlusionFactor = material.ambientColor.x * material.ambientColor.y * material.ambientColor.z;
+					break;
 				}
 			}
+		}
+	});
+	return output;
+}
+
+void loadObjScene(Model& output, const Filesystem& filesystem, const char* filepath, const obj::FlatScene& scene, const ModelOptions& options) {
+	const std::vector<ObjectDescription> objects = buildObjScene(filesystem, filepath, scene, options);
+	reportOptimizationStatistics(objects, options);
+	const std::string filepathPrefix = getFilepathPrefix(filepath);
+	output.objects.reserve(objects.size());
+	for (const ObjectDescription& object : objects) {
+		const Box<3, float> bounds = getBoundingBox(object.vertices);
+		output.objects.push_back(visitPackedVertices(object.vertices, bounds, options.vertexFormat, [&](auto vertices) -> Model::Object {
+			return createObject(filesystem, filepathPrefix, vertices, object.indices, object.levelsOfDetail, object.material, bounds);
+		}));
+	}
+	output.levelOfDetailScreenSizes = getLevelOfDetailScreenSizes(objects, options);
+}
+
+// Compiled model format, version 3. All values are stored in little-endian
+// byte order, and every field starts at an offset that is a multiple of 4.
+//
+// Header:
+//   u8[4]   magic "DMDL"
+//   u32     version
+//   u32     vertex format, i.e. the value of the ModelVertexFormat
+//   u32     vertex size in bytes, i.e. the size of the corresponding vertex type
+//   u32     index size in bytes, i.e. sizeof(Model::Object::Index)
+//   u32     object count
+//   u32     level of detail screen size count
+//   f32[level of detail screen size count] level of detail screen sizes
+//
+// Followed by, for each object:
+//   u32     vertex count
+//   u32     index count, including every level of detail
+//   u32     level of detail count
+//   f32[6]  bounding box minimum and maximum
+//   f32[12] diffuse color, specular color, normal scale, emissive color
+//   f32[3]  specular exponent, dissolve factor, occlusion factor
+//   str[4]  diffuse, specular, normal and emissive map names, each stored as a
+//           u32 length followed by the characters, padded to a multiple of 4
+//   u32[2 * level of detail count] index offset and index count of each level
+//   Vertex[vertex count], of the type that corresponds to the vertex format
+//   Index[index count]
+constexpr std::array<std::byte, 4> COMPILED_MODEL_MAGIC{std::byte{'D'}, std::byte{'M'}, std::byte{'D'}, std::byte{'L'}};
+constexpr std::uint32_t COMPILED_MODEL_VERSION = 3;
+constexpr std::size_t COMPILED_MODEL_ALIGNMENT = 4;
+
+static_assert(sizeof(Model::Object::Vertex) % COMPILED_MODEL_ALIGNMENT == 0 && alignof(Model::Object::Vertex) <= COMPILED_MODEL_ALIGNMENT);
+static_assert(sizeof(Model::Object::CompactVertex) % COMPILED_MODEL_ALIGNMENT == 0 && alignof(Model::Object::CompactVertex) <= COMPILED_MODEL_ALIGNMENT);
+static_assert(sizeof(Model::Object::QuantizedVertex) % COMPILED_MODEL_ALIGNMENT == 0 && alignof(Model::Object::QuantizedVertex) <= COMPILED_MODEL_ALIGNMENT);
+static_assert(sizeof(Model::Object::Index) % COMPILED_MODEL_ALIGNMENT == 0 && alignof(Model::Object::Index) <= COMPILED_MODEL_ALIGNMENT);
+
+class CompiledModelWriter {
+public:
+	template <typename T>
+	void write(const T& value) {
+		writeArray(std::span{&value, 1});
+	}
 
-			output.objects.push_back({
-				.mesh{Model::Object::VERTICES_USAGE, Model::Object::INDICES_USAGE, Model::Object::INSTANCES_USAGE, vertices, indices, {}},
-				.material = std::move(groupMaterial),
-				.indexCount = indices.size(),
-			});
+	template <typename T>
+	void writeArray(std::span<const T> values) {
+		const std::span<const std::byte> bytes = std::as_bytes(values);
+		output.insert(output.end(), bytes.begin(), bytes.end());
+	}
+
+	void writeString(std::string_view string) {
+		write(static_cast<std::uint32_t>(string.size()));
+		writeArray(std::as_bytes(std::span{string.data(), string.size()}));
+		output.resize((output.size() + COMPILED_MODEL_ALIGNMENT - 1) / COMPILED_MODEL_ALIGNMENT * COMPILED_MODEL_ALIGNMENT, std::byte{0});
+	}
+
+	[[nodiscard]] std::span<const std::byte> getOutput() const noexcept {
+		return output;
+	}
+
+private:
+	std::vector<std::byte> output{};
+};
+
+class CompiledModelReader {
+public:
+	explicit CompiledModelReader(std::span<const std::byte> input) noexcept
+		: input(input) {}
+
+	template <typename T>
+	[[nodiscard]] T read() {
+		T value{};
+		const std::span<const std::byte> bytes = advance(sizeof(T));
+		std::memcpy(&value, bytes.data(), sizeof(T));
+		return value;
+	}
+
+	template <typename T>
+	[[nodiscard]] std::span<const T> readArray(std::size_t count) {
+		if (count > (input.size() - offset) / sizeof(T)) {
+			throw Error{"Unexpected end of compiled model data."};
 		}
+		// The array is used in place inside of the file buffer, which is suitably aligned since every field offset is a multiple of 4.
+		return std::span{reinterpret_cast<const T*>(advance(count * sizeof(T)).data()), count}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+	}
+
+	[[nodiscard]] std::string readString() {
+		const std::size_t length = read<std::uint32_t>();
+		const std::span<const std::byte> bytes = advance((length + COMPILED_MODEL_ALIGNMENT - 1) / COMPILED_MODEL_ALIGNMENT * COMPILED_MODEL_ALIGNMENT);
+		return std::string{reinterpret_cast<const char*>(bytes.data()), length}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+	}
+
+	[[nodiscard]] bool atEnd() const noexcept {
+		return offset == input.size();
+	}
+
+private:
+	[[nodiscard]] std::span<const std::byte> advance(std::size_t size) {
+		if (size > input.size() - offset) {
+			throw Error{"Unexpected end of compiled model data."};
+		}
+		const std::span<const std::byte> result = input.subspan(offset, size);
+		offset += size;
+		return result;
+	}
+
+	std::span<const std::byte> input;
+	std::size_t offset = 0;
+};
+
+[[nodiscard]] bool isCompiledModel(std::span<const std::byte> fileContents) noexcept {
+	return fileContents.size() >= COMPILED_MODEL_MAGIC.size() && std::equal(COMPILED_MODEL_MAGIC.begin(), COMPILED_MODEL_MAGIC.end(), fileContents.begin());
+}
+
+void loadCompiledModel(Model& output, const Filesystem& filesystem, const char* filepath, std::span<const std::byte> fileContents) {
+	if constexpr (std::endian::native != std::endian::little) {
+		throw Error{"Compiled models are only supported on little-endian platforms."};
+	}
+	CompiledModelReader reader{fileContents.subspan(COMPILED_MODEL_MAGIC.size())};
+	if (const std::uint32_t version = reader.read<std::uint32_t>(); version != COMPILED_MODEL_VERSION) {
+		throw Error{fmt::format("Unsupported compiled model version {}.", version)};
+	}
+	const std::uint32_t vertexFormatValue = reader.read<std::uint32_t>();
+	if (vertexFormatValue > static_cast<std::uint32_t>(ModelVertexFormat::QUANTIZED)) {
+		throw Error{fmt::format("Unsupported compiled model vertex format {}.", vertexFormatValue)};
+	}
+	const ModelVertexFormat vertexFormat = static_cast<ModelVertexFormat>(vertexFormatValue);
+	if (reader.read<std::uint32_t>() != getVertexSize(vertexFormat) || reader.read<std::uint32_t>() != sizeof(Model::Object::Index)) {
+		throw Error{"Compiled model vertex layout does not match."};
+	}
+	const std::size_t objectCount = reader.read<std::uint32_t>();
+	const std::span<const float> levelOfDetailScreenSizes = reader.readArray<float>(reader.read<std::uint32_t>());
+	output.levelOfDetailScreenSizes.assign(levelOfDetailScreenSizes.begin(), levelOfDetailScreenSizes.end());
+
+	const std::string filepathPrefix = getFilepathPrefix(filepath);
+	output.objects.reserve(objectCount);
+	std::vector<Model::Object::LevelOfDetail> levelsOfDetail{};
+	for (std::size_t i = 0; i < objectCount; ++i) {
+		const std::size_t vertexCount = reader.read<std::uint32_t>();
+		const std::size_t indexCount = reader.read<std::uint32_t>();
+		const std::size_t levelOfDetailCount = reader.read<std::uint32_t>();
+		const Box<3, float> bounds{.min = reader.read<vec3>(), .max = reader.read<vec3>()};
+		MaterialDescription material{};
+		material.diffuseColor = reader.read<vec3>();
+		material.specularColor = reader.read<vec3>();
+		material.normalScale = reader.read<vec3>();
+		material.emissiveColor = reader.read<vec3>();
+		material.specularExponent = reader.read<float>();
+		material.dissolveFactor = reader.read<float>();
+		material.occlusionFactor = reader.read<float>();
+		material.diffuseMapName = reader.readString();
+		material.specularMapName = reader.readString();
+		material.normalMapName = reader.readString();
+		material.emissiveMapName = reader.readString();
+		levelsOfDetail.clear();
+		for (std::size_t j = 0; j < levelOfDetailCount; ++j) {
+			const std::size_t indexOffset = reader.read<std::uint32_t>();
+			const std::size_t levelIndexCount = reader.read<std::uint32_t>();
+			if (indexOffset > indexCount || levelIndexCount > indexCount - indexOffset) {
+				throw Error{"Invalid level of detail in compiled model."};
+			}
+			levelsOfDetail.push_back({.indexOffset = indexOffset, .indexCount = levelIndexCount});
+		}
+		const auto readObject = [&]<typename Vertex>(std::type_identity<Vertex>) -> Model::Object {
+			const std::span<const Vertex> vertices = reader.readArray<Vertex>(vertexCount);
+			const std::span<const Model::Object::Index> indices = reader.readArray<Model::Object::Index>(indexCount);
+			return createObject(filesystem, filepathPrefix, vertices, indices, levelsOfDetail, material, bounds);
+		};
+		switch (vertexFormat) {
+			case ModelVertexFormat::STANDARD: output.objects.push_back(readObject(std::type_identity<Model::Object::Vertex>{})); break;
+			case ModelVertexFormat::COMPACT: output.objects.push_back(readObject(std::type_identity<Model::Object::CompactVertex>{})); break;
+			case ModelVertexFormat::QUANTIZED: output.objects.push_back(readObject(std::type_identity<Model::Object::QuantizedVertex>{})); break;
+		}
+	}
+	if (!reader.atEnd()) {
+		throw Error{"Unexpected trailing data after compiled model."};
 	}
 }
 
@@ -236,9 +665,81 @@ alignas(Model) std::array<std::byte, sizeof(Model)> sharedCubeModelStorage;
 const Model* const Model::QUAD = reinterpret_cast<Model*>(sharedQuadModelStorage.data());
 const Model* const Model::CUBE = reinterpret_cast<Model*>(sharedCubeModelStorage.data());
 
-Model::Model(const Filesystem& filesystem, const char* filepath) {
+void Model::compile(Filesystem& filesystem, const char* inputFilepath, const char* outputFilepath, const ModelOptions& options) {
+	if constexpr (std::endian::native != std::endian::little) {
+		throw Error{"Compiled models are only supported on little-endian platforms."};
+	}
+	if (options.optimizationStatistics) {
+		options.optimizationStatistics->clear();
+	}
+	std::vector<ObjectDescription> objects{};
 	try {
-		loadObjScene(*this, filesystem, filepath);
+		File file = filesystem.openFile(inputFilepath);
+		objects = buildObjScene(filesystem, inputFilepath, obj::FlatScene::parse(file), options);
+	} catch (const obj::Error& e) {
+		throw Error{fmt::format("Failed to load model \"{}\": Line {}: {}", inputFilepath, e.lineNumber, e.what())};
+	} catch (const File::Error&) {
+		throw;
+	} catch (const std::exception& e) {
+		throw Error{fmt::format("Failed to load model \"{}\": {}", inputFilepath, e.what())};
+	}
+
+	reportOptimizationStatistics(objects, options);
+
+	CompiledModelWriter writer{};
+	writer.writeArray(std::span<const std::byte>{COMPILED_MODEL_MAGIC});
+	writer.write(COMPILED_MODEL_VERSION);
+	writer.write(static_cast<std::uint32_t>(options.vertexFormat));
+	writer.write(static_cast<std::uint32_t>(getVertexSize(options.vertexFormat)));
+	writer.write(static_cast<std::uint32_t>(sizeof(Object::Index)));
+	writer.write(static_cast<std::uint32_t>(objects.size()));
+	const std::vector<float> levelOfDetailScreenSizes = getLevelOfDetailScreenSizes(objects, options);
+	writer.write(static_cast<std::uint32_t>(levelOfDetailScreenSizes.size()));
+	writer.writeArray(std::span<const float>{levelOfDetailScreenSizes});
+	for (const ObjectDescription& object : objects) {
+		const Box<3, float> bounds = getBoundingBox(object.vertices);
+		writer.write(static_cast<std::uint32_t>(object.vertices.size()));
+		writer.write(static_cast<std::uint32_t>(object.indices.size()));
+		writer.write(static_cast<std::uint32_t>(object.levelsOfDetail.size()));
+		writer.write(bounds.min);
+		writer.write(bounds.max);
+		writer.write(object.material.diffuseColor);
+		writer.write(object.material.specularColor);
+		writer.write(object.material.normalScale);
+		writer.write(object.material.emissiveColor);
+		writer.write(object.material.specularExponent);
+		writer.write(object.material.dissolveFactor);
+		writer.write(object.material.occlusionFactor);
+		writer.writeString(object.material.diffuseMapName);
+		writer.writeString(object.material.specularMapName);
+		writer.writeString(object.material.normalMapName);
+		writer.writeString(object.material.emissiveMapName);
+		for (const Model::Object::LevelOfDetail& levelOfDetail : object.levelsOfDetail) {
+			writer.write(static_cast<std::uint32_t>(levelOfDetail.indexOffset));
+			writer.write(static_cast<std::uint32_t>(levelOfDetail.indexCount));
+		}
+		visitPackedVertices(object.vertices, bounds, options.vertexFormat, [&](auto vertices) -> void { writer.writeArray(vertices); });
+		writer.writeArray(std::span<const Object::Index>{object.indices});
+	}
+
+	File file = filesystem.createFile(outputFilepath);
+	if (file.write(writer.getOutput()) != writer.getOutput().size()) {
+		throw File::Error{fmt::format("Failed to write compiled model \"{}\".", outputFilepath)};
+	}
+}
+
+Model::Model(const Filesystem& filesystem, const char* filepath, const ModelOptions& options) {
+	if (options.optimizationStatistics) {
+		options.optimizationStatistics->clear();
+	}
+	try {
+		const std::vector<std::byte> fileContents = filesystem.openFile(filepath).readAll();
+		if (isCompiledModel(fileContents)) {
+			loadCompiledModel(*this, filesystem, filepath, fileContents);
+		} else {
+			const std::string_view objString{reinterpret_cast<const char*>(fileContents.data()), fileContents.size()}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+			loadObjScene(*this, filesystem, filepath, obj::FlatScene::parse(objString, {.threadCount = 0}), options);
+		}
 	} catch (const obj::Error& e) {
 		throw Error{fmt::format("Failed to load model \"{}\": Line {}: {}", filepath, e.lineNumber, e.what())};
 	} catch (const std::exception& e) {
@@ -298,7 +799,8 @@ void Model::createSharedModels() {
 
 		std::vector<Object> quadObjects{};
 		quadObjects.push_back(Object{
-			.mesh{Object::VERTICES_USAGE, Object::INDICES_USAGE, Object::INSTANCES_USAGE, QUAD_VERTICES, QUAD_INDICES, {}},
+			.mesh{std::in_place_type<Mesh<Object::Vertex, Object::Index, Object::Instance>>, Object::VERTICES_USAGE, Object::INDICES_USAGE, Object::INSTANCES_USAGE,
+				std::span<const Object::Vertex>{QUAD_VERTICES}, std::span<const Object::Index>{QUAD_INDICES}, std::span<const Object::Instance>{}},
 			.material{
 				.diffuseMap{},
 				.specularMap{},
@@ -313,11 +815,14 @@ void Model::createSharedModels() {
 				.occlusionFactor = 1.0f,
 			},
 			.indexCount = QUAD_INDICES.size(),
+			.bounds{.min{-1.0f, -1.0f, 0.0f}, .max{1.0f, 1.0f, 0.0f}},
+			.levelsOfDetail{},
 		});
 
 		std::vector<Object> cubeObjects{};
 		cubeObjects.push_back(Object{
-			.mesh{Object::VERTICES_USAGE, Object::INDICES_USAGE, Object::INSTANCES_USAGE, CUBE_VERTICES, CUBE_INDICES, {}},
+			.mesh{std::in_place_type<Mesh<Object::Vertex, Object::Index, Object::Instance>>, Object::VERTICES_USAGE, Object::INDICES_USAGE, Object::INSTANCES_USAGE,
+				std::span<const Object::Vertex>{CUBE_VERTICES}, std::span<const Object::Index>{CUBE_INDICES}, std::span<const Object::Instance>{}},
 			.material{
 				.diffuseMap{},
 				.specularMap{},
@@ -332,6 +837,8 @@ void Model::createSharedModels() {
 				.occlusionFactor = 1.0f,
 			},
 			.indexCount = CUBE_INDICES.size(),
+			.bounds{.min{-1.0f, -1.0f, -1.0f}, .max{1.0f, 1.0f, 1.0f}},
+			.levelsOfDetail{},
 		});
 
 		std::construct_at(const_cast<Model*>(QUAD), std::move(quadObjects));
@@ -0,0 +1,107 @@
+#include <donut/graphics/DirtyRangeSet.hpp>
+#include <donut/graphics/Mesh.hpp>
+#include <donut/graphics/Model.hpp>
+#include <donut/graphics/ModelGroup.hpp>
+#include <donut/graphics/opengl.hpp>
+#include <donut/math.hpp>
+
+#include <algorithm> // std::max, std::min
+#include <cstddef>   // std::size_t
+#include <span>      // std::span
+#include <stdexcept> // std::invalid_argument, std::out_of_range
+#include <variant>   // std::holds_alternative, std::visit
+#include <vector>    // std::vector
+
+namespace donut::graphics {
+
+namespace {
+
+[[nodiscard]] Model::Object::Instance makeInstance(const ModelGroup::Member& member) noexcept {
+	return Model::Object::Instance{
+		.transformation = member.transformation,
+		.normalMatrix = inverseTranspose(mat3{member.transformation}),
+		.textureOffsetAndScale{member.textureOffset.x, member.textureOffset.y, member.textureScale.x, member.textureScale.y},
+		.tintColor = member.tintColor,
+		.specularFactor = member.specularFactor,
+		.emissiveFactor = member.emissiveFactor,
+	};
+}
+
+} // namespace
+
+ModelGroup::ModelGroup(const Model& model, const ModelGroupOptions& options)
+	: model(&model)
+	, usage(options.usage)
+	, dirtyInstances(options.mergeDistance) {
+	vertexArrays.reserve(model.objects.size());
+	for (const Model::Object& object : model.objects) {
+		if (std::holds_alternative<Mesh<Model::Object::SkinnedVertex, Model::Object::Index, Model::Object::SkinnedInstance>>(object.mesh)) {
+			throw std::invalid_argument{"Model groups do not support skinned objects!"};
+		}
+		vertexArrays.push_back(std::visit([&](const auto& mesh) -> VertexArray { return mesh.createVertexArrayWithInstanceBuffer(instanceBuffer.get()); }, object.mesh));
+	}
+}
+
+std::size_t ModelGroup::add(const Member& member) {
+	const std::size_t index = instances.size();
+	instances.push_back(makeInstance(member));
+	dirtyInstances.insert(index, 1);
+	return index;
+}
+
+void ModelGroup::set(std::size_t index, const Member& member) {
+	if (index >= instances.size()) {
+		throw std::out_of_range{"Model group member index out of range!"};
+	}
+	instances[index] = makeInstance(member);
+	dirtyInstances.insert(index, 1);
+}
+
+void ModelGroup::setTransformation(std::size_t index, const mat4& transformation) {
+	if (index >= instances.size()) {
+		throw std::out_of_range{"Model group member index out of range!"};
+	}
+	instances[index].transformation = transformation;
+	instances[index].normalMatrix = inverseTranspose(mat3{transformation});
+	dirtyInstances.insert(index, 1);
+}
+
+void ModelGroup::remove(std::size_t index) {
+	if (index >= instances.size()) {
+		throw std::out_of_range{"Model group member index out of range!"};
+	}
+	if (index + 1 != instances.size()) {
+		instances[index] = instances.back();
+		dirtyInstances.insert(index, 1);
+	}
+	instances.pop_back();
+}
+
+void ModelGroup::clear() noexcept {
+	instances.clear();
+	dirtyInstances.clear();
+}
+
+void ModelGroup::commit() {
+	const detail::MeshStatePreserver preserver{};
+	if (instances.size() > capacity) {
+		// Reallocate with room to spare, so that adding members one by one doesn't reallocate every commit.
+		capacity = std::max(instances.size(), capacity * 2);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.get());
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity * sizeof(Model::Object::Instance)), nullptr, static_cast<GLenum>(usage));
+		glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(instances.size() * sizeof(Model::Object::Instance)), instances.data());
+	} else {
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.get());
+		for (const DirtyRange& range : dirtyInstances.getRanges()) {
+			// Ranges may extend past the end after members have been removed, in which case the rest is no longer drawn anyway.
+			if (range.offset >= instances.size()) {
+				break;
+			}
+			const std::span<const Model::Object::Instance> data = std::span{instances}.subspan(range.offset, std::min(range.size, instances.size() - range.offset));
+			glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(range.offset * sizeof(Model::Object::Instance)), static_cast<GLsizeiptr>(data.size_bytes()), data.data());
+		}
+	}
+	dirtyInstances.clear();
+}
+
+} // namespace donut::graphics
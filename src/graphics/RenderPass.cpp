@@ -39,6 +39,7 @@ RenderPass& RenderPass::draw(const ModelInstance& model) {
 		});
 	}
 
+	const std::span<const mat4> jointMatricesData = (model.jointMatrices.empty()) ? std::span<const mat4>{} : commandBuffer.append(model.jointMatrices);
 	commandBuffer.push_back(CommandDrawModelInstance{
 		.transformation = model.transformation,
 		.tintColor = model.tintColor,
@@ -46,6 +47,31 @@ RenderPass& RenderPass::draw(const ModelInstance& model) {
 		.textureScale = model.textureScale,
 		.specularFactor = model.specularFactor,
 		.emissiveFactor = model.emissiveFactor,
+		.jointMatrices = jointMatricesData,
+	});
+	return *this;
+}
+
+RenderPass& RenderPass::draw(const ModelGroupInstance& group) {
+	assert(group.shader);
+	assert(group.group);
+
+	if (previousShader2D || previousShader3D != group.shader) {
+		previousShader2D = nullptr;
+		previousTexture = nullptr;
+		previousSpriteAtlas = nullptr;
+		previousFont = nullptr;
+		previousShader3D = group.shader;
+		commandBuffer.push_back(CommandUseShader3D{.shader = group.shader});
+	}
+
+	commandBuffer.push_back(CommandDrawModelGroupInstance{
+		.group = group.group,
+		.diffuseMapOverride = group.diffuseMapOverride,
+		.specularMapOverride = group.specularMapOverride,
+		.normalMapOverride = group.normalMapOverride,
+		.emissiveMapOverride = group.emissiveMapOverride,
+		.levelOfDetail = group.levelOfDetail,
 	});
 	return *this;
 }
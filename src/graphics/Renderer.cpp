@@ -3,7 +3,9 @@
 #include <donut/graphics/Font.hpp>
 #include <donut/graphics/Framebuffer.hpp>
 #include <donut/graphics/Handle.hpp>
+#include <donut/graphics/Mesh.hpp>
 #include <donut/graphics/Model.hpp>
+#include <donut/graphics/ModelGroup.hpp>
 #include <donut/graphics/RenderPass.hpp>
 #include <donut/graphics/Renderer.hpp>
 #include <donut/graphics/Shader2D.hpp>
@@ -18,9 +20,15 @@
 #include <donut/graphics/opengl.hpp>
 #include <donut/math.hpp>
 
+#include <algorithm>   // std::min, std::max
+#include <bit>         // std::bit_ceil
 #include <cassert>     // assert
+#include <cstddef>     // std::size_t
 #include <span>        // std::span
 #include <string_view> // std::string_view
+#include <utility>     // std::pair
+#include <variant>     // std::visit, std::holds_alternative
+#include <vector>      // std::vector
 
 namespace donut::graphics {
 
@@ -139,6 +147,7 @@ void useShader(Shader3D& shader) {
 	glUniform1i(shader.specularMap.getLocation(), Model::Object::TEXTURE_UNIT_SPECULAR);
 	glUniform1i(shader.normalMap.getLocation(), Model::Object::TEXTURE_UNIT_NORMAL);
 	glUniform1i(shader.emissiveMap.getLocation(), Model::Object::TEXTURE_UNIT_EMISSIVE);
+	glUniform1i(shader.jointMatrices.getLocation(), Model::Object::TEXTURE_UNIT_JOINT_MATRICES);
 	bindTextures(shader.program, Model::Object::TEXTURE_UNIT_COUNT);
 }
 
@@ -160,56 +169,179 @@ void useTexture(const Texture& texture) {
 	glBindTexture(GL_TEXTURE_2D, texture.get());
 }
 
+[[nodiscard]] Sphere<3, float> getBoundingSphere(std::span<const Model::Object> objects) noexcept {
+	if (objects.empty()) {
+		return Sphere<3, float>{.center{0.0f, 0.0f, 0.0f}, .radius = 0.0f};
+	}
+	Box<3, float> bounds = objects.front().bounds;
+	for (const Model::Object& object : objects.subspan(1)) {
+		bounds.min = min(bounds.min, object.bounds.min);
+		bounds.max = max(bounds.max, object.bounds.max);
+	}
+	return Sphere<3, float>{.center = (bounds.min + bounds.max) * 0.5f, .radius = length(bounds.max - bounds.min) * 0.5f};
+}
+
+// Select the level of detail to render a model instance at from the projected diameter of its bounding sphere relative to the viewport height,
+// which is the radius scaled by the vertical projection scale, divided by the distance along the view direction (or 1 for orthographic cameras).
+[[nodiscard]] std::size_t selectLevelOfDetail(std::span<const float> screenSizes, const Sphere<3, float>& boundingSphere, const mat4& transformation,
+	const mat4& viewProjectionMatrix, float projectionScale) noexcept {
+	if (screenSizes.empty()) {
+		return 0;
+	}
+	const float w = (viewProjectionMatrix * (transformation * vec4{boundingSphere.center, 1.0f})).w;
+	if (w <= 0.0f) {
+		return 0;
+	}
+	const float scale = sqrt(max(length2(vec3{transformation[0]}), max(length2(vec3{transformation[1]}), length2(vec3{transformation[2]}))));
+	const float screenSize = boundingSphere.radius * scale * projectionScale / w;
+	std::size_t levelOfDetail = 0;
+	while (levelOfDetail < screenSizes.size() && screenSize < screenSizes[levelOfDetail]) {
+		++levelOfDetail;
+	}
+	return levelOfDetail;
+}
+
+void useObjectMaterial(Shader3D& shader, const Texture* diffuseMapOverride, const Texture* specularMapOverride, const Texture* normalMapOverride,
+	const Texture* emissiveMapOverride, const Model::Object& object) {
+	const Handle diffuseMapTextureHandle =
+		(diffuseMapOverride)           ? diffuseMapOverride->get()
+		: (object.material.diffuseMap) ? object.material.diffuseMap.get()
+									   : Texture::WHITE->get();
+
+	const Handle specularMapTextureHandle =
+		(specularMapOverride)           ? specularMapOverride->get()
+		: (object.material.specularMap) ? object.material.specularMap.get()
+										: Texture::DEFAULT_SPECULAR->get();
+
+	const Handle normalMapTextureHandle =
+		(normalMapOverride)           ? normalMapOverride->get()
+		: (object.material.normalMap) ? object.material.normalMap.get()
+									  : Texture::DEFAULT_NORMAL->get();
+
+	const Handle emissiveMapTextureHandle =
+		(emissiveMapOverride)           ? emissiveMapOverride->get()
+		: (object.material.emissiveMap) ? object.material.emissiveMap.get()
+										: Texture::WHITE->get();
+
+	glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_DIFFUSE));
+	glBindTexture(GL_TEXTURE_2D, diffuseMapTextureHandle);
+
+	glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_SPECULAR));
+	glBindTexture(GL_TEXTURE_2D, specularMapTextureHandle);
+
+	glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_NORMAL));
+	glBindTexture(GL_TEXTURE_2D, normalMapTextureHandle);
+
+	glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_EMISSIVE));
+	glBindTexture(GL_TEXTURE_2D, emissiveMapTextureHandle);
+
+	glUniform3fv(shader.diffuseColor.getLocation(), 1, value_ptr(object.material.diffuseColor));
+	glUniform3fv(shader.specularColor.getLocation(), 1, value_ptr(object.material.specularColor));
+	glUniform3fv(shader.normalScale.getLocation(), 1, value_ptr(object.material.normalScale));
+	glUniform3fv(shader.emissiveColor.getLocation(), 1, value_ptr(object.material.emissiveColor));
+	glUniform1f(shader.specularExponent.getLocation(), object.material.specularExponent);
+	glUniform1f(shader.dissolveFactor.getLocation(), object.material.dissolveFactor);
+	glUniform1f(shader.occlusionFactor.getLocation(), object.material.occlusionFactor);
+}
+
+// Quantized vertex positions are stored relative to the bounding box of the object, which the vertex shader maps them back to, so that instance data
+// can be uploaded as is for every vertex format.
+void useObjectVertexPositionMapping(Shader3D& shader, const Model::Object& object) {
+	const bool quantized = std::holds_alternative<Mesh<Model::Object::QuantizedVertex, Model::Object::Index, Model::Object::Instance>>(object.mesh);
+	const vec3 offset = (quantized) ? object.bounds.min : vec3{0.0f};
+	const vec3 scale = (quantized) ? object.bounds.max - object.bounds.min : vec3{1.0f};
+	glUniform3fv(shader.vertexPositionOffset.getLocation(), 1, value_ptr(offset));
+	glUniform3fv(shader.vertexPositionScale.getLocation(), 1, value_ptr(scale));
+}
+
+void drawObjectInstances(const Model::Object& object, std::size_t levelOfDetail, std::size_t instanceCount) {
+	const Model::Object::LevelOfDetail range = (object.levelsOfDetail.empty())
+	                                             ? Model::Object::LevelOfDetail{.indexOffset = 0, .indexCount = object.indexCount}
+	                                             : object.levelsOfDetail[std::min(levelOfDetail, object.levelsOfDetail.size() - 1)];
+	const std::size_t indexBufferOffset = range.indexOffset * sizeof(Model::Object::Index);
+	const void* const indices = reinterpret_cast<const void*>(indexBufferOffset); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+	glDrawElementsInstanced(static_cast<GLenum>(Model::Object::PRIMITIVE_TYPE), static_cast<GLsizei>(range.indexCount), static_cast<GLenum>(Model::Object::INDEX_TYPE),
+		indices, static_cast<GLsizei>(instanceCount));
+}
+
+// Combine the joint matrices of each instance with its model transformation into one palette for the whole batch, and upload it to a floating-point
+// texture for the skinned vertex shader to fetch from. Rows have a fixed width, so that the texture only needs to be reallocated when it grows taller.
+void uploadJointMatrices(std::span<const Model::Object::Instance> instances, std::span<const std::span<const mat4>> instanceJointMatrices,
+	std::vector<Model::Object::SkinnedInstance>& skinnedInstances, std::vector<mat4>& jointMatrixPalette, Texture& jointMatrixTexture) {
+	constexpr std::size_t TEXTURE_WIDTH = 1024;
+	constexpr std::size_t MATRICES_PER_ROW = TEXTURE_WIDTH / 4;
+
+	assert(instanceJointMatrices.size() == instances.size());
+	skinnedInstances.clear();
+	jointMatrixPalette.clear();
+	for (std::size_t i = 0; i < instances.size(); ++i) {
+		const Model::Object::Instance& instance = instances[i];
+		skinnedInstances.push_back(Model::Object::SkinnedInstance{
+			.textureOffsetAndScale = instance.textureOffsetAndScale,
+			.tintColor = instance.tintColor,
+			.specularFactor = instance.specularFactor,
+			.emissiveFactor = instance.emissiveFactor,
+			.jointMatrixOffset = static_cast<u32>(jointMatrixPalette.size()),
+		});
+		for (const mat4& jointMatrix : instanceJointMatrices[i]) {
+			jointMatrixPalette.push_back(instance.transformation * jointMatrix);
+		}
+	}
+
+	const std::size_t rowCount = std::max((jointMatrixPalette.size() + MATRICES_PER_ROW - 1) / MATRICES_PER_ROW, std::size_t{1});
+	jointMatrixPalette.resize(rowCount * MATRICES_PER_ROW);
+	glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_JOINT_MATRICES));
+	if (!jointMatrixTexture || jointMatrixTexture.getHeight() < rowCount) {
+		jointMatrixTexture = Texture{TextureFormat::R32G32B32A32_FLOAT, TEXTURE_WIDTH, std::bit_ceil(rowCount), {.repeat = false, .useLinearFiltering = false, .useMipmap = false}};
+	}
+	jointMatrixTexture.pasteImage2D(TEXTURE_WIDTH, rowCount, PixelFormat::RGBA, PixelComponentType::F32, jointMatrixPalette.data(), 0, 0);
+}
+
 void renderModelInstances(Shader3D& shader, const Texture* diffuseMapOverride, const Texture* specularMapOverride, const Texture* normalMapOverride,
-	const Texture* emissiveMapOverride, std::span<const Model::Object> objects, std::span<const Model::Object::Instance> instances) {
+	const Texture* emissiveMapOverride, std::span<const Model::Object> objects, std::size_t levelOfDetail, std::span<const Model::Object::Instance> instances,
+	std::span<const std::span<const mat4>> instanceJointMatrices, std::vector<Model::Object::SkinnedInstance>& skinnedInstances,
+	std::vector<mat4>& jointMatrixPalette, Texture& jointMatrixTexture) {
+	bool jointMatricesUploaded = false;
 	for (const Model::Object& object : objects) {
-		const Handle diffuseMapTextureHandle =
-			(diffuseMapOverride)           ? diffuseMapOverride->get()
-			: (object.material.diffuseMap) ? object.material.diffuseMap.get()
-										   : Texture::WHITE->get();
-
-		const Handle specularMapTextureHandle =
-			(specularMapOverride)           ? specularMapOverride->get()
-			: (object.material.specularMap) ? object.material.specularMap.get()
-											: Texture::DEFAULT_SPECULAR->get();
-
-		const Handle normalMapTextureHandle =
-			(normalMapOverride)           ? normalMapOverride->get()
-			: (object.material.normalMap) ? object.material.normalMap.get()
-										  : Texture::DEFAULT_NORMAL->get();
-
-		const Handle emissiveMapTextureHandle =
-			(emissiveMapOverride)           ? emissiveMapOverride->get()
-			: (object.material.emissiveMap) ? object.material.emissiveMap.get()
-											: Texture::WHITE->get();
-
-		glBindVertexArray(object.mesh.get());
-		glBindBuffer(GL_ARRAY_BUFFER, object.mesh.getInstanceBuffer());
-
-		glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_DIFFUSE));
-		glBindTexture(GL_TEXTURE_2D, diffuseMapTextureHandle);
-
-		glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_SPECULAR));
-		glBindTexture(GL_TEXTURE_2D, specularMapTextureHandle);
-
-		glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_NORMAL));
-		glBindTexture(GL_TEXTURE_2D, normalMapTextureHandle);
-
-		glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_EMISSIVE));
-		glBindTexture(GL_TEXTURE_2D, emissiveMapTextureHandle);
-
-		glUniform3fv(shader.diffuseColor.getLocation(), 1, value_ptr(object.material.diffuseColor));
-		glUniform3fv(shader.specularColor.getLocation(), 1, value_ptr(object.material.specularColor));
-		glUniform3fv(shader.normalScale.getLocation(), 1, value_ptr(object.material.normalScale));
-		glUniform3fv(shader.emissiveColor.getLocation(), 1, value_ptr(object.material.emissiveColor));
-		glUniform1f(shader.specularExponent.getLocation(), object.material.specularExponent);
-		glUniform1f(shader.dissolveFactor.getLocation(), object.material.dissolveFactor);
-		glUniform1f(shader.occlusionFactor.getLocation(), object.material.occlusionFactor);
-
-		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size() * sizeof(Model::Object::Instance)), instances.data(),
-			static_cast<GLenum>(Model::Object::INSTANCES_USAGE));
-		glDrawElementsInstanced(static_cast<GLenum>(Model::Object::PRIMITIVE_TYPE), static_cast<GLsizei>(object.indexCount), static_cast<GLenum>(Model::Object::INDEX_TYPE),
-			nullptr, static_cast<GLsizei>(instances.size()));
+		const auto [vertexArrayHandle, instanceBufferHandle] =
+			std::visit([](const auto& mesh) -> std::pair<Handle, Handle> { return {mesh.get(), mesh.getInstanceBuffer()}; }, object.mesh);
+		glBindVertexArray(vertexArrayHandle);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBufferHandle);
+
+		useObjectMaterial(shader, diffuseMapOverride, specularMapOverride, normalMapOverride, emissiveMapOverride, object);
+		useObjectVertexPositionMapping(shader, object);
+
+		if (std::holds_alternative<Mesh<Model::Object::SkinnedVertex, Model::Object::Index, Model::Object::SkinnedInstance>>(object.mesh)) {
+			// The palette is shared by every skinned object of the model, so it only needs to be uploaded once per batch.
+			if (!jointMatricesUploaded) {
+				uploadJointMatrices(instances, instanceJointMatrices, skinnedInstances, jointMatrixPalette, jointMatrixTexture);
+				jointMatricesUploaded = true;
+			}
+			glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + Model::Object::TEXTURE_UNIT_JOINT_MATRICES));
+			glBindTexture(GL_TEXTURE_2D, jointMatrixTexture.get());
+			glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(skinnedInstances.size() * sizeof(Model::Object::SkinnedInstance)), skinnedInstances.data(),
+				static_cast<GLenum>(Model::Object::INSTANCES_USAGE));
+		} else {
+			glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size() * sizeof(Model::Object::Instance)), instances.data(),
+				static_cast<GLenum>(Model::Object::INSTANCES_USAGE));
+		}
+
+		drawObjectInstances(object, levelOfDetail, instances.size());
+	}
+}
+
+void renderModelGroup(Shader3D& shader, const Texture* diffuseMapOverride, const Texture* specularMapOverride, const Texture* normalMapOverride,
+	const Texture* emissiveMapOverride, const ModelGroup& group, std::size_t levelOfDetail) {
+	if (group.empty()) {
+		return;
+	}
+	const std::span<const Model::Object> objects = group.getModel().objects;
+	for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+		const Model::Object& object = objects[objectIndex];
+		glBindVertexArray(group.getVertexArray(objectIndex));
+		useObjectMaterial(shader, diffuseMapOverride, specularMapOverride, normalMapOverride, emissiveMapOverride, object);
+		useObjectVertexPositionMapping(shader, object);
+		drawObjectInstances(object, levelOfDetail, group.size());
 	}
 }
 
@@ -279,6 +411,7 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 		Shader3D* boundShader3D = nullptr;
 		Shader2D* boundShader2D = nullptr;
 		const Model* boundModel = nullptr;
+		Sphere<3, float> boundModelBoundingSphere{.center{0.0f, 0.0f, 0.0f}, .radius = 0.0f};
 		const Texture* boundDiffuseMapOverride = nullptr;
 		const Texture* boundSpecularMapOverride = nullptr;
 		const Texture* boundNormalMapOverride = nullptr;
@@ -287,8 +420,15 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 		const SpriteAtlas* boundSpriteAtlas = nullptr;
 		Font* boundFont = nullptr;
 
-		const auto pushModelInstance = [&](const mat4& transformation, vec2 textureOffset, vec2 textureScale, Color tintColor, vec3 specularFactor, vec3 emissiveFactor) -> void {
-			modelInstances.push_back(Model::Object::Instance{
+		const mat4 viewProjectionMatrix = camera.getProjectionMatrix() * camera.getViewMatrix();
+		const float projectionScale = camera.getProjectionMatrix()[1][1];
+
+		const auto pushModelInstance = [&](const mat4& transformation, vec2 textureOffset, vec2 textureScale, Color tintColor, vec3 specularFactor, vec3 emissiveFactor,
+			std::span<const mat4> jointMatrices) -> void {
+			const std::size_t levelOfDetail =
+				selectLevelOfDetail(boundModel->levelOfDetailScreenSizes, boundModelBoundingSphere, transformation, viewProjectionMatrix, projectionScale);
+			modelInstanceJointMatricesPerLevelOfDetail[levelOfDetail].push_back(jointMatrices);
+			modelInstancesPerLevelOfDetail[levelOfDetail].push_back(Model::Object::Instance{
 				.transformation = transformation,
 				.normalMatrix = inverseTranspose(mat3{transformation}),
 				.textureOffsetAndScale{textureOffset.x, textureOffset.y, textureScale.x, textureScale.y},
@@ -332,10 +472,14 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 		};
 
 		const auto render3DInstances = [&]() -> void {
-			if (!modelInstances.empty()) {
-				renderModelInstances(*boundShader3D, boundDiffuseMapOverride, boundSpecularMapOverride, boundNormalMapOverride, boundEmissiveMapOverride, boundModel->objects,
-					modelInstances);
-				modelInstances.clear();
+			for (std::size_t levelOfDetail = 0; levelOfDetail < modelInstancesPerLevelOfDetail.size(); ++levelOfDetail) {
+				if (std::vector<Model::Object::Instance>& modelInstances = modelInstancesPerLevelOfDetail[levelOfDetail]; !modelInstances.empty()) {
+					std::vector<std::span<const mat4>>& modelInstanceJointMatrices = modelInstanceJointMatricesPerLevelOfDetail[levelOfDetail];
+					renderModelInstances(*boundShader3D, boundDiffuseMapOverride, boundSpecularMapOverride, boundNormalMapOverride, boundEmissiveMapOverride,
+						boundModel->objects, levelOfDetail, modelInstances, modelInstanceJointMatrices, skinnedModelInstances, jointMatrixPalette, jointMatrixTexture);
+					modelInstances.clear();
+					modelInstanceJointMatrices.clear();
+				}
 			}
 		};
 
@@ -346,7 +490,12 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 			}
 		};
 
-		modelInstances.clear();
+		for (std::vector<Model::Object::Instance>& modelInstances : modelInstancesPerLevelOfDetail) {
+			modelInstances.clear();
+		}
+		for (std::vector<std::span<const mat4>>& modelInstanceJointMatrices : modelInstanceJointMatricesPerLevelOfDetail) {
+			modelInstanceJointMatrices.clear();
+		}
 		texturedQuadInstances.clear();
 
 		renderPass.commandBuffer.visit(Overloaded{
@@ -356,6 +505,7 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 				render2DInstances();
 				boundShader2D = nullptr;
 				boundTexture = nullptr;
+				Shader3D::createSharedShaderOnFirstUse(command.shader);
 				boundShader3D = command.shader;
 				useShader(*boundShader3D);
 				uploadCameraToShader(*boundShader3D, camera);
@@ -376,6 +526,11 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 				assert(command.model);
 				render3DInstances();
 				boundModel = command.model;
+				boundModelBoundingSphere = getBoundingSphere(boundModel->objects);
+				if (modelInstancesPerLevelOfDetail.size() <= boundModel->levelOfDetailScreenSizes.size()) {
+					modelInstancesPerLevelOfDetail.resize(boundModel->levelOfDetailScreenSizes.size() + 1);
+					modelInstanceJointMatricesPerLevelOfDetail.resize(boundModel->levelOfDetailScreenSizes.size() + 1);
+				}
 				boundDiffuseMapOverride = command.diffuseMapOverride;
 				boundSpecularMapOverride = command.specularMapOverride;
 				boundNormalMapOverride = command.normalMapOverride;
@@ -404,7 +559,16 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 			[&](const RenderPass::CommandDrawModelInstance& command) -> void {
 				assert(boundShader3D);
 				assert(boundModel);
-				pushModelInstance(command.transformation, command.textureOffset, command.textureScale, command.tintColor, command.specularFactor, command.emissiveFactor);
+				pushModelInstance(command.transformation, command.textureOffset, command.textureScale, command.tintColor, command.specularFactor, command.emissiveFactor,
+					command.jointMatrices);
+			},
+			[&](const RenderPass::CommandDrawModelGroupInstance& command) -> void {
+				assert(boundShader3D);
+				assert(command.group);
+				assert(command.group->isCommitted());
+				render3DInstances();
+				renderModelGroup(*boundShader3D, command.diffuseMapOverride, command.specularMapOverride, command.normalMapOverride, command.emissiveMapOverride,
+					*command.group, command.levelOfDetail);
 			},
 			[&](const RenderPass::CommandDrawQuadInstance& command) -> void {
 				assert(boundShader2D);
@@ -490,6 +654,7 @@ void Renderer::render(Framebuffer& framebuffer, const RenderPass& renderPass, co
 				}
 			},
 			[&](std::span<const Text::ShapedGlyph>) -> void {},
+			[&](std::span<const mat4>) -> void {},
 			[&](std::span<const char>) -> void {},
 		});
 		render3DInstances();
@@ -9,8 +9,12 @@ namespace donut::graphics {
 namespace {
 
 std::size_t sharedShaderReferenceCount = 0;
+bool sharedUnlitSkinnedShaderCreated = false;
+bool sharedBlinnPhongSkinnedShaderCreated = false;
 alignas(Shader3D) std::array<std::byte, sizeof(Shader3D)> sharedUnlitShaderStorage;
 alignas(Shader3D) std::array<std::byte, sizeof(Shader3D)> sharedBlinnPhongShaderStorage;
+alignas(Shader3D) std::array<std::byte, sizeof(Shader3D)> sharedUnlitSkinnedShaderStorage;
+alignas(Shader3D) std::array<std::byte, sizeof(Shader3D)> sharedBlinnPhongSkinnedShaderStorage;
 
 } // namespace
 
@@ -39,9 +43,12 @@ const char* const Shader3D::VERTEX_SHADER_SOURCE_CODE_INSTANCED_MODEL = R"GLSL(
     uniform mat4 projectionMatrix;
     uniform mat4 viewMatrix;
     uniform mat4 viewProjectionMatrix;
+    uniform vec3 vertexPositionOffset;
+    uniform vec3 vertexPositionScale;
 
     void main() {
-        fragmentPosition = vec3(instanceTransformation * vec4(vertexPosition, 1.0));
+        vec3 modelPosition = vertexPositionOffset + vertexPositionScale * vertexPosition;
+        fragmentPosition = vec3(instanceTransformation * vec4(modelPosition, 1.0));
         fragmentNormal = instanceNormalMatrix * vertexNormal;
         fragmentTangent = instanceNormalMatrix * vertexTangent;
         fragmentBitangent = instanceNormalMatrix * vertexBitangent;
@@ -53,6 +60,65 @@ const char* const Shader3D::VERTEX_SHADER_SOURCE_CODE_INSTANCED_MODEL = R"GLSL(
     }
 )GLSL";
 
+const char* const Shader3D::VERTEX_SHADER_SOURCE_CODE_SKINNED_MODEL = R"GLSL(
+    layout(location = 0) in vec3 vertexPosition;
+    layout(location = 1) in vec3 vertexNormal;
+    layout(location = 2) in vec3 vertexTangent;
+    layout(location = 3) in vec3 vertexBitangent;
+    layout(location = 4) in vec2 vertexTextureCoordinates;
+    layout(location = 5) in uvec4 vertexJoints;
+    layout(location = 6) in vec4 vertexWeights;
+    layout(location = 7) in vec4 instanceTextureOffsetAndScale;
+    layout(location = 8) in vec4 instanceTintColor;
+    layout(location = 9) in vec3 instanceSpecularFactor;
+    layout(location = 10) in vec3 instanceEmissiveFactor;
+    layout(location = 11) in uint instanceJointMatrixOffset;
+
+    out vec3 fragmentPosition;
+    out vec3 fragmentNormal;
+    out vec3 fragmentTangent;
+    out vec3 fragmentBitangent;
+    out vec2 fragmentTextureCoordinates;
+    out vec4 fragmentTintColor;
+    out vec3 fragmentSpecularFactor;
+    out vec3 fragmentEmissiveFactor;
+
+    uniform mat4 projectionMatrix;
+    uniform mat4 viewMatrix;
+    uniform mat4 viewProjectionMatrix;
+    uniform highp sampler2D jointMatrices;
+
+    mat4 fetchJointMatrix(uint joint, int textureWidth) {
+        int texel = int(instanceJointMatrixOffset + joint) * 4;
+        ivec2 coordinates = ivec2(texel % textureWidth, texel / textureWidth);
+        return mat4(
+            texelFetch(jointMatrices, coordinates, 0),
+            texelFetch(jointMatrices, coordinates + ivec2(1, 0), 0),
+            texelFetch(jointMatrices, coordinates + ivec2(2, 0), 0),
+            texelFetch(jointMatrices, coordinates + ivec2(3, 0), 0)
+        );
+    }
+
+    void main() {
+        int textureWidth = textureSize(jointMatrices, 0).x;
+        mat4 skinMatrix =
+            vertexWeights.x * fetchJointMatrix(vertexJoints.x, textureWidth) +
+            vertexWeights.y * fetchJointMatrix(vertexJoints.y, textureWidth) +
+            vertexWeights.z * fetchJointMatrix(vertexJoints.z, textureWidth) +
+            vertexWeights.w * fetchJointMatrix(vertexJoints.w, textureWidth);
+        mat3 normalMatrix = mat3(skinMatrix);
+        fragmentPosition = vec3(skinMatrix * vec4(vertexPosition, 1.0));
+        fragmentNormal = normalMatrix * vertexNormal;
+        fragmentTangent = normalMatrix * vertexTangent;
+        fragmentBitangent = normalMatrix * vertexBitangent;
+        fragmentTextureCoordinates = instanceTextureOffsetAndScale.xy + instanceTextureOffsetAndScale.zw * vertexTextureCoordinates;
+        fragmentTintColor = instanceTintColor;
+        fragmentSpecularFactor = instanceSpecularFactor;
+        fragmentEmissiveFactor = instanceEmissiveFactor;
+        gl_Position = viewProjectionMatrix * vec4(fragmentPosition, 1.0);
+    }
+)GLSL";
+
 const char* const Shader3D::FRAGMENT_SHADER_SOURCE_CODE_UNLIT = R"GLSL(
     in vec3 fragmentPosition;
     in vec3 fragmentNormal;
@@ -196,6 +262,8 @@ const char* const Shader3D::FRAGMENT_SHADER_SOURCE_CODE_BLINN_PHONG = R"GLSL(
 
 Shader3D* const Shader3D::UNLIT = reinterpret_cast<Shader3D*>(sharedUnlitShaderStorage.data());
 Shader3D* const Shader3D::BLINN_PHONG = reinterpret_cast<Shader3D*>(sharedBlinnPhongShaderStorage.data());
+Shader3D* const Shader3D::UNLIT_SKINNED = reinterpret_cast<Shader3D*>(sharedUnlitSkinnedShaderStorage.data());
+Shader3D* const Shader3D::BLINN_PHONG_SKINNED = reinterpret_cast<Shader3D*>(sharedBlinnPhongSkinnedShaderStorage.data());
 
 void Shader3D::createSharedShaders() {
 	if (sharedShaderReferenceCount == 0) {
@@ -220,8 +288,37 @@ void Shader3D::createSharedShaders() {
 	++sharedShaderReferenceCount;
 }
 
+void Shader3D::createSharedShaderOnFirstUse(Shader3D* shader) {
+	// The skinned shaders are only compiled once something is drawn with them, so that applications without skinned meshes don't pay for them.
+	if (shader == UNLIT_SKINNED && !sharedUnlitSkinnedShaderCreated) {
+		std::construct_at(UNLIT_SKINNED,
+			ShaderProgramOptions{
+				.vertexShaderSourceCode = VERTEX_SHADER_SOURCE_CODE_SKINNED_MODEL,
+				.fragmentShaderSourceCode = FRAGMENT_SHADER_SOURCE_CODE_UNLIT,
+			},
+			Shader3DOptions{});
+		sharedUnlitSkinnedShaderCreated = true;
+	} else if (shader == BLINN_PHONG_SKINNED && !sharedBlinnPhongSkinnedShaderCreated) {
+		std::construct_at(BLINN_PHONG_SKINNED,
+			ShaderProgramOptions{
+				.vertexShaderSourceCode = VERTEX_SHADER_SOURCE_CODE_SKINNED_MODEL,
+				.fragmentShaderSourceCode = FRAGMENT_SHADER_SOURCE_CODE_BLINN_PHONG,
+			},
+			Shader3DOptions{});
+		sharedBlinnPhongSkinnedShaderCreated = true;
+	}
+}
+
 void Shader3D::destroySharedShaders() noexcept {
 	if (sharedShaderReferenceCount-- == 1) {
+		if (sharedBlinnPhongSkinnedShaderCreated) {
+			std::destroy_at(BLINN_PHONG_SKINNED);
+			sharedBlinnPhongSkinnedShaderCreated = false;
+		}
+		if (sharedUnlitSkinnedShaderCreated) {
+			std::destroy_at(UNLIT_SKINNED);
+			sharedUnlitSkinnedShaderCreated = false;
+		}
 		std::destroy_at(BLINN_PHONG);
 		std::destroy_at(UNLIT);
 	}
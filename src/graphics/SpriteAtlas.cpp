@@ -0,0 +1,174 @@
+#include <donut/AtlasPacker.hpp>
+#include <donut/File.hpp>
+#include <donut/Filesystem.hpp>
+#include <donut/graphics/Error.hpp>
+#include <donut/graphics/Image.hpp>
+#include <donut/graphics/SpriteAtlas.hpp>
+#include <donut/graphics/Texture.hpp>
+#include <donut/math.hpp>
+
+#include <algorithm>    // std::sort, std::adjacent_find, std::equal, std::max
+#include <array>        // std::array
+#include <cstddef>      // std::size_t, std::byte
+#include <cstdint>      // std::uint8_t, std::uint32_t, std::uint64_t
+#include <fmt/format.h> // fmt::format
+#include <span>         // std::span
+#include <utility>      // std::pair
+#include <vector>       // std::vector
+
+namespace donut::graphics {
+
+namespace {
+
+constexpr std::array<std::byte, 4> SPRITE_TABLE_MAGIC{std::byte{'D'}, std::byte{'S'}, std::byte{'A'}, std::byte{'T'}};
+constexpr std::uint32_t SPRITE_TABLE_VERSION = 1;
+constexpr std::size_t SPRITE_TABLE_HEADER_SIZE = 16;
+constexpr std::size_t SPRITE_TABLE_RECORD_SIZE = 28;
+
+void writeLittleEndian(std::vector<std::byte>& output, std::uint64_t value, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		output.push_back(static_cast<std::byte>((value >> (i * 8)) & 0xFF));
+	}
+}
+
+[[nodiscard]] std::uint64_t readLittleEndian(std::span<const std::byte> input, std::size_t offset, std::size_t size) noexcept {
+	std::uint64_t value = 0;
+	for (std::size_t i = 0; i < size; ++i) {
+		value |= static_cast<std::uint64_t>(input[offset + i]) << (i * 8);
+	}
+	return value;
+}
+
+} // namespace
+
+void SpriteAtlas::bake(Filesystem& filesystem, const char* imageFilepath, const char* spriteTableFilepath, std::span<const BakeEntry> entries) {
+	using BakePacker = AtlasPacker<INITIAL_RESOLUTION, PADDING, AtlasPackingStrategy::MAX_RECTS_BEST_SHORT_SIDE_FIT>;
+
+	std::vector<std::uint64_t> nameHashes{};
+	std::vector<BakePacker::RectangleSize> sizes{};
+	nameHashes.reserve(entries.size());
+	sizes.reserve(entries.size());
+	for (const BakeEntry& entry : entries) {
+		if (entry.image && entry.image.getPixelComponentType() != PixelComponentType::U8) {
+			throw Error{fmt::format("Cannot bake sprite \"{}\" into \"{}\" since the image is not stored in 8-bit unsigned integer format.", entry.name, imageFilepath)};
+		}
+		nameHashes.push_back(hashSpriteName(entry.name));
+		sizes.push_back({.width = entry.image.getWidth(), .height = entry.image.getHeight()});
+	}
+
+	std::vector<std::uint64_t> sortedNameHashes = nameHashes;
+	std::sort(sortedNameHashes.begin(), sortedNameHashes.end());
+	if (std::adjacent_find(sortedNameHashes.begin(), sortedNameHashes.end()) != sortedNameHashes.end()) {
+		throw Error{fmt::format("Cannot bake sprite atlas \"{}\" since two sprites have the same name hash.", imageFilepath)};
+	}
+
+	BakePacker packer{};
+	const std::vector<BakePacker::InsertRectangleResult> results = packer.insertRectangles(sizes);
+	const std::size_t resolution = packer.getResolution();
+
+	// Paste every image into a single RGBA atlas image, expanding missing channels the same way OpenGL does.
+	std::vector<std::uint8_t> atlasPixels(resolution * resolution * 4, 0);
+	for (std::size_t i = 0; i < entries.size(); ++i) {
+		const ImageView& image = entries[i].image;
+		const std::size_t channelCount = image.getChannelCount();
+		const std::uint8_t* const pixels = static_cast<const std::uint8_t*>(image.getPixels());
+		for (std::size_t y = 0; y < image.getHeight(); ++y) {
+			const std::uint8_t* source = pixels + y * image.getWidth() * channelCount;
+			std::uint8_t* destination = atlasPixels.data() + ((results[i].y + y) * resolution + results[i].x) * 4;
+			for (std::size_t x = 0; x < image.getWidth(); ++x) {
+				destination[0] = source[0];
+				destination[1] = (channelCount >= 2) ? source[1] : std::uint8_t{0};
+				destination[2] = (channelCount >= 3) ? source[2] : std::uint8_t{0};
+				destination[3] = (channelCount >= 4) ? source[3] : std::uint8_t{255};
+				source += channelCount;
+				destination += 4;
+			}
+		}
+	}
+	Image::savePNG(ImageView{resolution, resolution, PixelFormat::RGBA, PixelComponentType::U8, atlasPixels.data()}, filesystem, imageFilepath);
+
+	std::vector<std::byte> spriteTable{};
+	spriteTable.reserve(SPRITE_TABLE_HEADER_SIZE + entries.size() * SPRITE_TABLE_RECORD_SIZE);
+	spriteTable.insert(spriteTable.end(), SPRITE_TABLE_MAGIC.begin(), SPRITE_TABLE_MAGIC.end());
+	writeLittleEndian(spriteTable, SPRITE_TABLE_VERSION, 4);
+	writeLittleEndian(spriteTable, resolution, 4);
+	writeLittleEndian(spriteTable, entries.size(), 4);
+	for (std::size_t i = 0; i < entries.size(); ++i) {
+		writeLittleEndian(spriteTable, nameHashes[i], 8);
+		writeLittleEndian(spriteTable, results[i].x, 4);
+		writeLittleEndian(spriteTable, results[i].y, 4);
+		writeLittleEndian(spriteTable, entries[i].image.getWidth(), 4);
+		writeLittleEndian(spriteTable, entries[i].image.getHeight(), 4);
+		writeLittleEndian(spriteTable, entries[i].flip, 4);
+	}
+	File file = filesystem.createFile(spriteTableFilepath);
+	if (file.write(spriteTable) != spriteTable.size()) {
+		throw File::Error{fmt::format("Failed to write sprite table \"{}\".", spriteTableFilepath)};
+	}
+}
+
+SpriteAtlas::SpriteAtlas(const Filesystem& filesystem, const char* imageFilepath, const char* spriteTableFilepath, const SpriteAtlasOptions& options)
+	: options(options) {
+	const std::vector<std::byte> spriteTable = filesystem.openFile(spriteTableFilepath).readAll();
+	if (spriteTable.size() < SPRITE_TABLE_HEADER_SIZE || !std::equal(SPRITE_TABLE_MAGIC.begin(), SPRITE_TABLE_MAGIC.end(), spriteTable.begin())) {
+		throw Error{fmt::format("Invalid sprite table \"{}\".", spriteTableFilepath)};
+	}
+	if (const std::uint64_t version = readLittleEndian(spriteTable, 4, 4); version != SPRITE_TABLE_VERSION) {
+		throw Error{fmt::format("Unsupported sprite table version {} in \"{}\".", version, spriteTableFilepath)};
+	}
+	const std::size_t resolution = static_cast<std::size_t>(readLittleEndian(spriteTable, 8, 4));
+	const std::size_t spriteCount = static_cast<std::size_t>(readLittleEndian(spriteTable, 12, 4));
+	if (spriteTable.size() != SPRITE_TABLE_HEADER_SIZE + spriteCount * SPRITE_TABLE_RECORD_SIZE || resolution < PADDING * std::size_t{2}) {
+		throw Error{fmt::format("Invalid sprite table \"{}\".", spriteTableFilepath)};
+	}
+
+	const Image atlasImage{filesystem, imageFilepath, {.desiredFormat = PixelFormat::RGBA}};
+	if (atlasImage.getWidth() != resolution || atlasImage.getHeight() != resolution) {
+		throw Error{fmt::format("Sprite atlas image \"{}\" does not match the resolution of sprite table \"{}\".", imageFilepath, spriteTableFilepath)};
+	}
+	atlasTexture = {
+		TextureFormat::R8G8B8A8_UNORM,
+		resolution,
+		resolution,
+		PixelFormat::RGBA,
+		PixelComponentType::U8,
+		atlasImage.getPixels(),
+		{.repeat = false, .useLinearFiltering = options.useLinearFiltering, .useMipmap = false},
+	};
+
+	std::vector<std::pair<std::uint64_t, std::size_t>> nameHashesAndIndices{};
+	std::size_t usedHeight = 0;
+	sprites.reserve(spriteCount);
+	nameHashesAndIndices.reserve(spriteCount);
+	for (std::size_t i = 0; i < spriteCount; ++i) {
+		const std::size_t offset = SPRITE_TABLE_HEADER_SIZE + i * SPRITE_TABLE_RECORD_SIZE;
+		const std::uint64_t nameHash = readLittleEndian(spriteTable, offset, 8);
+		const std::uint64_t x = readLittleEndian(spriteTable, offset + 8, 4);
+		const std::uint64_t y = readLittleEndian(spriteTable, offset + 12, 4);
+		const std::uint64_t width = readLittleEndian(spriteTable, offset + 16, 4);
+		const std::uint64_t height = readLittleEndian(spriteTable, offset + 20, 4);
+		const Flip flip = static_cast<Flip>(readLittleEndian(spriteTable, offset + 24, 4));
+		usedHeight = std::max(usedHeight, static_cast<std::size_t>(y + height) + PADDING);
+		sprites.push_back(Sprite{
+			.position{static_cast<float>(x), static_cast<float>(y)},
+			.size{static_cast<float>(width), static_cast<float>(height)},
+			.flip = flip,
+		});
+		nameHashesAndIndices.emplace_back(nameHash, i);
+	}
+	std::sort(nameHashesAndIndices.begin(), nameHashesAndIndices.end());
+	sortedSpriteNameHashes.reserve(spriteCount);
+	spriteIndicesSortedByNameHash.reserve(spriteCount);
+	for (const auto& [nameHash, index] : nameHashesAndIndices) {
+		sortedSpriteNameHashes.push_back(nameHash);
+		spriteIndicesSortedByNameHash.push_back(index);
+	}
+
+	// Resume packing above the baked sprites at the baked resolution, so that inserting more sprites only grows the texture once it is full.
+	if (usedHeight > resolution) {
+		throw Error{fmt::format("Invalid sprite table \"{}\".", spriteTableFilepath)};
+	}
+	atlasPacker = AtlasPacker<INITIAL_RESOLUTION, PADDING>{resolution, usedHeight};
+}
+
+} // namespace donut::graphics
@@ -13,6 +13,7 @@
 #include <cstddef>  // std::size_t, std::byte, std::max_align_t
 #include <memory>   // std::construct_at, std::destroy_at
 #include <optional> // std::optional
+#include <span>     // std::span
 
 namespace donut::graphics {
 
@@ -187,6 +188,13 @@ Texture::Texture(const ImageView& image, const TextureOptions& options)
 	: Texture(getInternalFormat(image.getPixelFormat(), image.getPixelComponentType()), image.getWidth(), image.getHeight(), image.getPixelFormat(), image.getPixelComponentType(),
 		  image.getPixels(), options) {}
 
+Texture::Texture(const ImageView& image, std::span<const Image> mipmap, const TextureOptions& options)
+	: Texture(image, {.repeat = options.repeat, .useLinearFiltering = options.useLinearFiltering, .useMipmap = false}) {
+	for (std::size_t i = 0; i < mipmap.size(); ++i) {
+		setMipmapLevel2D(i + 1, mipmap[i]);
+	}
+}
+
 void Texture::setOptions2D(const TextureOptions& newOptions) {
 	options = newOptions;
 
@@ -198,7 +206,12 @@ void Texture::setOptions2D(const TextureOptions& newOptions) {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (options.repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (options.repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
 	if (options.useMipmap) {
-		glGenerateMipmap(GL_TEXTURE_2D);
+		// Keep a mipmap that was uploaded level by level instead of overwriting it with a generated one.
+		if (mipmapLevelCount == 0) {
+			glGenerateMipmap(GL_TEXTURE_2D);
+		} else {
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mipmapLevelCount));
+		}
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (options.useLinearFiltering) ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (options.useLinearFiltering) ? GL_LINEAR : GL_NEAREST);
 	} else {
@@ -249,6 +262,25 @@ void Texture::pasteImage2D(const ImageView& image, std::size_t x, std::size_t y)
 	pasteImage2D(image.getWidth(), image.getHeight(), image.getPixelFormat(), image.getPixelComponentType(), image.getPixels(), x, y);
 }
 
+void Texture::setMipmapLevel2D(std::size_t level, const ImageView& image) {
+	GLint oldUnpackAlignment = 0;
+	GLint oldTextureBinding2D = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldUnpackAlignment);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTextureBinding2D);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glBindTexture(GL_TEXTURE_2D, texture.get());
+	glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLint>(internalFormat), static_cast<GLsizei>(image.getWidth()),
+		static_cast<GLsizei>(image.getHeight()), 0, static_cast<GLenum>(image.getPixelFormat()), static_cast<GLenum>(image.getPixelComponentType()), image.getPixels());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(level));
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (options.useLinearFiltering) ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
+	mipmapLevelCount = level;
+	options.useMipmap = true;
+
+	glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(oldTextureBinding2D));
+	glPixelStorei(GL_UNPACK_ALIGNMENT, oldUnpackAlignment);
+}
+
 void Texture::pasteImage2DArray(std::size_t imageWidth, std::size_t imageHeight, std::size_t arrayDepth, PixelFormat pixelFormat, PixelComponentType pixelComponentType,
 	const void* pixels, std::size_t x, std::size_t y, std::size_t z) {
 	GLint oldUnpackAlignment = 0;
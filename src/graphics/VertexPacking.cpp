@@ -0,0 +1,82 @@
+#include <donut/graphics/VertexPacking.hpp>
+#include <donut/math.hpp>
+
+#include <algorithm> // std::clamp, std::max
+#include <bit>       // std::bit_cast
+#include <cmath>     // std::round
+#include <cstdint>   // std::uint16_t, std::uint32_t, std::int32_t
+
+namespace donut::graphics {
+
+namespace {
+
+// Conversion with round-to-nearest-even that handles subnormals, infinities and NaN, based on the float_to_half_fast3_rtne function by Fabian
+// Giesen. Values in the subnormal range are rounded by letting the FPU add a magic number that aligns their significand with the result.
+[[nodiscard]] std::uint32_t floatToHalf(float value) noexcept {
+	constexpr std::uint32_t INFINITY_BITS = 0x7F800000u;
+	constexpr std::uint32_t HALF_OVERFLOW_BITS = 0x47800000u; // 2^16
+	constexpr std::uint32_t HALF_NORMAL_BITS = 0x38800000u;   // 2^-14
+	constexpr std::uint32_t SUBNORMAL_MAGIC_BITS = 0x3F000000u;
+
+	std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+	const std::uint32_t sign = (bits >> 16) & 0x8000u;
+	bits &= 0x7FFFFFFFu;
+	if (bits >= HALF_OVERFLOW_BITS) {
+		return sign | ((bits > INFINITY_BITS) ? 0x7E00u : 0x7C00u);
+	}
+	if (bits < HALF_NORMAL_BITS) {
+		return sign | (std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits) + std::bit_cast<float>(SUBNORMAL_MAGIC_BITS)) - SUBNORMAL_MAGIC_BITS);
+	}
+	const std::uint32_t significandOdd = (bits >> 13) & 1u;
+	bits -= (127u - 15u) << 23;
+	bits += 0xFFFu + significandOdd;
+	return sign | (bits >> 13);
+}
+
+[[nodiscard]] float halfToFloat(std::uint32_t half) noexcept {
+	constexpr std::uint32_t SHIFTED_EXPONENT_MASK = 0x7C00u << 13;
+	constexpr std::uint32_t SUBNORMAL_MAGIC_BITS = 113u << 23;
+
+	std::uint32_t bits = (half & 0x7FFFu) << 13;
+	const std::uint32_t exponent = bits & SHIFTED_EXPONENT_MASK;
+	bits += (127u - 15u) << 23;
+	if (exponent == SHIFTED_EXPONENT_MASK) {
+		bits += (128u - 16u) << 23;
+	} else if (exponent == 0) {
+		bits += 1u << 23;
+		bits = std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits) - std::bit_cast<float>(SUBNORMAL_MAGIC_BITS));
+	}
+	return std::bit_cast<float>(bits | ((half & 0x8000u) << 16));
+}
+
+[[nodiscard]] std::uint32_t packSnorm(float value, std::uint32_t bitCount) noexcept {
+	const float max = static_cast<float>((1 << (bitCount - 1)) - 1);
+	const std::int32_t integer = static_cast<std::int32_t>(std::round(std::clamp(value, -1.0f, 1.0f) * max));
+	return static_cast<std::uint32_t>(integer) & ((1u << bitCount) - 1u);
+}
+
+[[nodiscard]] float unpackSnorm(std::uint32_t bits, std::uint32_t bitCount) noexcept {
+	const float max = static_cast<float>((1 << (bitCount - 1)) - 1);
+	const std::int32_t integer = static_cast<std::int32_t>(bits << (32 - bitCount)) >> (32 - bitCount); // Sign extension.
+	return std::max(static_cast<float>(integer) / max, -1.0f);
+}
+
+} // namespace
+
+PackedHalf2x16 PackedHalf2x16::pack(vec2 value) noexcept {
+	return PackedHalf2x16{.value = floatToHalf(value.x) | (floatToHalf(value.y) << 16)};
+}
+
+vec2 PackedHalf2x16::unpack() const noexcept {
+	return vec2{halfToFloat(value & 0xFFFFu), halfToFloat(value >> 16)};
+}
+
+PackedSnorm3x10_1x2 PackedSnorm3x10_1x2::pack(vec4 value) noexcept {
+	return PackedSnorm3x10_1x2{.value = packSnorm(value.x, 10) | (packSnorm(value.y, 10) << 10) | (packSnorm(value.z, 10) << 20) | (packSnorm(value.w, 2) << 30)};
+}
+
+vec4 PackedSnorm3x10_1x2::unpack() const noexcept {
+	return vec4{unpackSnorm(value & 0x3FFu, 10), unpackSnorm((value >> 10) & 0x3FFu, 10), unpackSnorm((value >> 20) & 0x3FFu, 10), unpackSnorm(value >> 30, 2)};
+}
+
+} // namespace donut::graphics
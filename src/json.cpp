@@ -0,0 +1,38 @@
+#include <donut/json.hpp>
+
+#include "parallel.hpp"
+
+#include <algorithm> // std::min
+#include <cstddef>   // std::size_t
+#include <span>      // std::span
+#include <vector>    // std::vector
+
+namespace donut::json {
+
+namespace {
+
+// Split the documents into one contiguous range per thread and evaluate the query on each range in parallel.
+template <typename Document, typename Result>
+[[nodiscard]] std::vector<Result> findAllInBatch(const Query& query, std::span<const Document> documents, const QueryBatchOptions& options) {
+	std::vector<Result> results(documents.size());
+	const std::size_t taskCount = std::min(donut::detail::getThreadCount(options.threadCount), documents.size());
+	donut::detail::runInParallel(taskCount, taskCount, [&](std::size_t taskIndex) -> void {
+		const std::size_t end = documents.size() * (taskIndex + 1) / taskCount;
+		for (std::size_t i = documents.size() * taskIndex / taskCount; i < end; ++i) {
+			results[i] = query.findAll(documents[i]);
+		}
+	});
+	return results;
+}
+
+} // namespace
+
+std::vector<std::vector<const Value*>> Query::findAllInBatch(std::span<const Value> documents, const QueryBatchOptions& options) const {
+	return json::findAllInBatch<Value, std::vector<const Value*>>(*this, documents, options);
+}
+
+std::vector<std::vector<Cursor>> Query::findAllInBatch(std::span<const Cursor> documents, const QueryBatchOptions& options) const {
+	return json::findAllInBatch<Cursor, std::vector<Cursor>>(*this, documents, options);
+}
+
+} // namespace donut::json
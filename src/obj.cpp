@@ -1,15 +1,80 @@
+#include <donut/File.hpp>
 #include <donut/math.hpp>
 #include <donut/obj.hpp>
 
-#include <cstddef>     // std::size_t
-#include <cstdint>     // std::int64_t, std::uint8_t, std::uint32_t
-#include <string>      // std::string
-#include <string_view> // std::string_view
+#include "parallel.hpp"
+
+#include <algorithm>    // std::min, std::max, std::ranges::copy
+#include <charconv>     // std::from_chars, std::from_chars_result
+#include <cstddef>      // std::size_t, std::byte
+#include <cstdint>      // std::int64_t, std::uint8_t, std::uint32_t
+#include <limits>       // std::numeric_limits
+#include <memory>       // std::to_address
+#include <span>         // std::span
+#include <string>       // std::string
+#include <string_view>  // std::string_view
+#include <system_error> // std::errc
+#include <utility>      // std::move
+#include <vector>       // std::vector
 
 namespace donut::obj {
 
 namespace {
 
+constexpr std::uint8_t RELATIVE_VERTEX_INDEX = 1 << 0;
+constexpr std::uint8_t RELATIVE_TEXTURE_COORDINATE_INDEX = 1 << 1;
+constexpr std::uint8_t RELATIVE_NORMAL_INDEX = 1 << 2;
+
+enum class CommandKind : std::uint8_t {
+	MATERIAL_LIBRARY,
+	MATERIAL,
+	OBJECT,
+	GROUP,
+};
+
+struct Command {
+	CommandKind kind;
+	StringRange name;
+	std::size_t faceCount;
+};
+
+// Partial scene parsed from a range of complete lines, independently of the lines before it. Relative face indices are resolved against the local
+// attribute counts, and need to be offset by the attribute counts of the preceding chunks. Commands that depend on the current object or group are
+// recorded rather than applied, so that they can be replayed in order afterwards.
+struct FlatSceneChunk {
+	std::vector<vec3> vertices{};
+	std::vector<vec2> textureCoordinates{};
+	std::vector<vec3> normals{};
+	std::vector<FaceVertex> faceVertices{};
+	std::vector<std::uint8_t> faceVertexRelativeIndices{};
+	std::vector<std::size_t> faceOffsets{0};
+	std::vector<Command> commands{};
+	std::string strings{};
+};
+
+void useMaterial(FlatScene& output, StringRange name, std::size_t faceCount) {
+	if (output.groups.back().materialName.length != 0) {
+		output.groups.push_back(FlatGroup{.materialName = name, .facesBegin = faceCount, .facesEnd = faceCount});
+		output.objects.back().groupsEnd = output.groups.size();
+	} else {
+		output.groups.back().materialName = name;
+	}
+}
+
+void beginObject(FlatScene& output, StringRange name, std::size_t faceCount) {
+	if (output.objects.back().name.length != 0) {
+		output.groups.push_back(FlatGroup{.facesBegin = faceCount, .facesEnd = faceCount});
+		output.objects.push_back(FlatObject{.name = name, .groupsBegin = output.groups.size() - 1, .groupsEnd = output.groups.size()});
+	} else {
+		output.objects.back().name = name;
+	}
+}
+
+void beginGroup(FlatScene& output, StringRange name, std::size_t faceCount) {
+	output.groups.push_back(FlatGroup{.name = name, .facesBegin = faceCount, .facesEnd = faceCount});
+	output.objects.back().groupsEnd = output.groups.size();
+}
+
 class Parser {
 public:
 	[[nodiscard]] static constexpr bool isWhitespace(char ch) noexcept {
@@ -20,11 +85,51 @@ public:
 		return ch >= '0' && ch <= '9';
 	}
 
+	[[nodiscard]] static constexpr bool isFaceVertexStart(char ch) noexcept {
+		return isDecimalDigit(ch) || ch == '-' || ch == '+';
+	}
+
+	// Tell an out-of-range decimal number that overflowed apart from one that underflowed, by checking whether its first significant digit ends
+	// up before the decimal point once the exponent has been applied.
+	[[nodiscard]] static constexpr bool hasOverflowed(std::string_view number) noexcept {
+		std::int64_t magnitude = 0;
+		bool significant = false;
+		bool fraction = false;
+		std::size_t i = (number.starts_with('-')) ? 1 : 0;
+		for (; i < number.size() && number[i] != 'e' && number[i] != 'E'; ++i) {
+			if (number[i] == '.') {
+				fraction = true;
+			} else if (!significant && number[i] == '0') {
+				magnitude -= (fraction) ? 1 : 0;
+			} else {
+				significant = true;
+				magnitude += (fraction) ? 0 : 1;
+			}
+		}
+		if (i < number.size()) {
+			++i;
+			const bool negativeExponent = i < number.size() && number[i] == '-';
+			if (i < number.size() && (number[i] == '-' || number[i] == '+')) {
+				++i;
+			}
+			std::int64_t exponent = 0;
+			for (; i < number.size(); ++i) {
+				exponent = std::min(exponent * 10 + (number[i] - '0'), std::int64_t{1} << 32);
+			}
+			magnitude += (negativeExponent) ? -exponent : exponent;
+		}
+		return magnitude > 0;
+	}
+
 	Parser(std::string_view string, std::size_t lineNumber) noexcept
 		: it(string.begin())
 		, end(string.end())
 		, lineNumber(lineNumber) {}
 
+	[[nodiscard]] std::size_t getLineNumber() const noexcept {
+		return lineNumber;
+	}
+
 	void parseScene(Scene& output) {
 		output.objects.push_back(Object{.groups{Group{}}});
 		do {
@@ -63,6 +168,75 @@ public:
 		} while (it != end);
 	}
 
+	void parseFlatScene(FlatScene& output) {
+		do {
+			skipWhitespace();
+			if (it == end) {
+				break;
+			}
+			if (*it == '#') {
+				++it;
+			} else if (readCommand("mtllib")) {
+				output.materialLibraryFilenames.push_back(parseString());
+			} else if (readCommand("usemtl")) {
+				useMaterial(output, parseString(output.strings), output.getFaceCount());
+			} else if (readCommand("o")) {
+				beginObject(output, parseString(output.strings), output.getFaceCount());
+			} else if (readCommand("g")) {
+				beginGroup(output, parseString(output.strings), output.getFaceCount());
+			} else if (readCommand("v")) {
+				output.vertices.push_back(parseVec3());
+			} else if (readCommand("vt")) {
+				output.textureCoordinates.push_back(parseVec2());
+			} else if (readCommand("vn")) {
+				output.normals.push_back(parseVec3());
+			} else if (readCommand("f")) {
+				while (it != end && isFaceVertexStart(*it)) {
+					output.faceVertices.push_back(parseFaceVertex(output.vertices.size(), output.textureCoordinates.size(), output.normals.size()));
+					skipWhitespace();
+				}
+				output.faceOffsets.push_back(output.faceVertices.size());
+				output.groups.back().facesEnd = output.getFaceCount();
+			}
+			skipLine();
+		} while (it != end);
+	}
+
+	void parseFlatSceneChunk(FlatSceneChunk& output) {
+		do {
+			skipWhitespace();
+			if (it == end) {
+				break;
+			}
+			if (*it == '#') {
+				++it;
+			} else if (readCommand("mtllib")) {
+				output.commands.push_back(Command{.kind = CommandKind::MATERIAL_LIBRARY, .name = parseString(output.strings), .faceCount = output.faceOffsets.size() - 1});
+			} else if (readCommand("usemtl")) {
+				output.commands.push_back(Command{.kind = CommandKind::MATERIAL, .name = parseString(output.strings), .faceCount = output.faceOffsets.size() - 1});
+			} else if (readCommand("o")) {
+				output.commands.push_back(Command{.kind = CommandKind::OBJECT, .name = parseString(output.strings), .faceCount = output.faceOffsets.size() - 1});
+			} else if (readCommand("g")) {
+				output.commands.push_back(Command{.kind = CommandKind::GROUP, .name = parseString(output.strings), .faceCount = output.faceOffsets.size() - 1});
+			} else if (readCommand("v")) {
+				output.vertices.push_back(parseVec3());
+			} else if (readCommand("vt")) {
+				output.textureCoordinates.push_back(parseVec2());
+			} else if (readCommand("vn")) {
+				output.normals.push_back(parseVec3());
+			} else if (readCommand("f")) {
+				while (it != end && isFaceVertexStart(*it)) {
+					std::uint8_t relativeIndices = 0;
+					output.faceVertices.push_back(parseFaceVertex(output.vertices.size(), output.textureCoordinates.size(), output.normals.size(), relativeIndices));
+					output.faceVertexRelativeIndices.push_back(relativeIndices);
+					skipWhitespace();
+				}
+				output.faceOffsets.push_back(output.faceVertices.size());
+			}
+			skipLine();
+		} while (it != end);
+	}
+
 	void parseMtlLibrary(mtl::Library& output) {
 		output.materials.push_back(mtl::Material{});
 		do {
@@ -171,6 +345,19 @@ private:
 		return std::string{begin, it};
 	}
 
+	[[nodiscard]] StringRange parseString(std::string& output) {
+		const std::string_view::iterator begin = it;
+		while (it != end && *it != '\r' && *it != '\n') {
+			++it;
+		}
+		if (it == begin) {
+			throw Error{"Missing string.", it, lineNumber};
+		}
+		const StringRange result{.offset = output.size(), .length = static_cast<std::size_t>(it - begin)};
+		output.append(begin, it);
+		return result;
+	}
+
 	[[nodiscard]] bool parseSign() {
 		if (it == end) {
 			return false;
@@ -204,32 +391,19 @@ private:
 	}
 
 	[[nodiscard]] float parseFloat() {
-		const bool sign = parseSign();
-		float result = parseUnsignedInteger<float>();
-		if (it != end && *it == '.') {
+		if (it != end && *it == '+') {
 			++it;
-			float digitValue = 0.1f;
-			while (it != end && isDecimalDigit(*it)) {
-				result += static_cast<float>(*it++ - '0') * digitValue;
-				digitValue *= 0.1f;
-			}
 		}
-
-		if (it != end && (*it == 'e' || *it == 'E')) {
-			++it;
-			int exponent = parseSignedInteger<int>();
-			if (exponent < 0) {
-				exponent = -exponent;
-				for (int i = 0; i < exponent; ++i) {
-					result *= 0.1f;
-				}
-			} else {
-				for (int i = 0; i < exponent; ++i) {
-					result *= 10.0f;
-				}
-			}
+		float result = 0.0f;
+		const char* const first = std::to_address(it);
+		const std::from_chars_result parseResult = std::from_chars(first, std::to_address(end), result);
+		if (parseResult.ec == std::errc::result_out_of_range) {
+			// Overflow to infinity, like float arithmetic does, and only flush values that are too small to represent to zero.
+			const std::string_view number{first, static_cast<std::size_t>(parseResult.ptr - first)};
+			result = (hasOverflowed(number)) ? std::numeric_limits<float>::infinity() : 0.0f;
+			result = (number.starts_with('-')) ? -result : result;
 		}
-		result = (sign) ? -result : result;
+		it += parseResult.ptr - first;
 		return result;
 	}
 
@@ -251,29 +425,39 @@ private:
 		return result;
 	}
 
-	[[nodiscard]] FaceVertex parseFaceVertex(std::size_t vertexCount, std::size_t textureCoordinateCount, std::size_t normalCount) {
+	[[nodiscard]] std::uint32_t parseIndex(std::size_t count, std::uint8_t& relativeIndices, std::uint8_t relativeIndexFlag) {
+		const std::int64_t index = parseSignedInteger<std::int64_t>();
+		if (index < 0) {
+			relativeIndices |= relativeIndexFlag;
+			return static_cast<std::uint32_t>(static_cast<std::int64_t>(count) + index);
+		}
+		return static_cast<std::uint32_t>(index - 1);
+	}
+
+	[[nodiscard]] FaceVertex parseFaceVertex(std::size_t vertexCount, std::size_t textureCoordinateCount, std::size_t normalCount, std::uint8_t& relativeIndices) {
 		FaceVertex result{};
-		const std::int64_t vertexIndex = parseSignedInteger<std::int64_t>();
-		result.vertexIndex = static_cast<std::uint32_t>((vertexIndex < 0) ? static_cast<std::int64_t>(vertexCount) + vertexIndex : vertexIndex - 1);
+		result.vertexIndex = parseIndex(vertexCount, relativeIndices, RELATIVE_VERTEX_INDEX);
 		if (it == end || *it != '/') {
 			return result;
 		}
 		++it;
-		const std::int64_t textureCoordinateIndex = parseSignedInteger<std::int64_t>();
-		result.textureCoordinateIndex =
-			static_cast<std::uint32_t>((textureCoordinateIndex < 0) ? static_cast<std::int64_t>(textureCoordinateCount) + textureCoordinateIndex : textureCoordinateIndex - 1);
+		result.textureCoordinateIndex = parseIndex(textureCoordinateCount, relativeIndices, RELATIVE_TEXTURE_COORDINATE_INDEX);
 		if (it == end || *it != '/') {
 			return result;
 		}
 		++it;
-		const std::int64_t normalIndex = parseSignedInteger<std::int64_t>();
-		result.normalIndex = static_cast<std::uint32_t>((normalIndex < 0) ? static_cast<std::int64_t>(normalCount) + normalIndex : normalIndex - 1);
+		result.normalIndex = parseIndex(normalCount, relativeIndices, RELATIVE_NORMAL_INDEX);
 		return result;
 	}
 
+	[[nodiscard]] FaceVertex parseFaceVertex(std::size_t vertexCount, std::size_t textureCoordinateCount, std::size_t normalCount) {
+		std::uint8_t relativeIndices = 0;
+		return parseFaceVertex(vertexCount, textureCoordinateCount, normalCount, relativeIndices);
+	}
+
 	[[nodiscard]] Face parseFace(std::size_t vertexCount, std::size_t textureCoordinateCount, std::size_t normalCount) {
 		Face result{};
-		while (it != end && isDecimalDigit(*it)) {
+		while (it != end && isFaceVertexStart(*it)) {
 			result.vertices.push_back(parseFaceVertex(vertexCount, textureCoordinateCount, normalCount));
 			skipWhitespace();
 		}
@@ -293,6 +477,128 @@ private:
 	std::size_t lineNumber;
 };
 
+constexpr std::size_t FILE_CHUNK_SIZE = 256 * 1024;
+constexpr std::size_t PARALLEL_CHUNK_SIZE_MIN = 1024 * 1024;
+
+void parseFlatSceneLines(FlatScene& output, std::string_view lines, std::size_t& lineNumber) {
+	Parser parser{lines, lineNumber};
+	parser.parseFlatScene(output);
+	lineNumber = parser.getLineNumber();
+}
+
+[[nodiscard]] std::size_t countLines(std::string_view string) noexcept {
+	std::size_t result = 0;
+	for (std::size_t i = 0; i < string.size(); ++i) {
+		if (string[i] == '\n' || (string[i] == '\r' && (i + 1 == string.size() || string[i + 1] != '\n'))) {
+			++result;
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] FlatScene parseFlatSceneInParallel(std::string_view objString, std::size_t chunkCount) {
+	std::vector<std::string_view> chunkStrings{};
+	chunkStrings.reserve(chunkCount);
+	for (std::size_t chunkIndex = 1, chunkBegin = 0; chunkBegin < objString.size(); ++chunkIndex) {
+		std::size_t chunkEnd = objString.size();
+		if (chunkIndex < chunkCount) {
+			if (const std::size_t lineEnd = objString.find('\n', std::max(chunkBegin, objString.size() / chunkCount * chunkIndex)); lineEnd != std::string_view::npos) {
+				chunkEnd = lineEnd + 1;
+			}
+		}
+		chunkStrings.push_back(objString.substr(chunkBegin, chunkEnd - chunkBegin));
+		chunkBegin = chunkEnd;
+	}
+
+	std::vector<FlatSceneChunk> chunks(chunkStrings.size());
+	detail::runInParallel(chunks.size(), chunks.size(), [&](std::size_t chunkIndex) -> void {
+		try {
+			Parser{chunkStrings[chunkIndex], 1}.parseFlatSceneChunk(chunks[chunkIndex]);
+		} catch (const Error& e) {
+			const std::string_view precedingString = objString.substr(0, static_cast<std::size_t>(chunkStrings[chunkIndex].data() - objString.data()));
+			throw Error{e.what(), e.position, countLines(precedingString) + e.lineNumber};
+		}
+	});
+
+	struct ChunkOffsets {
+		std::size_t vertexCount = 0;
+		std::size_t textureCoordinateCount = 0;
+		std::size_t normalCount = 0;
+		std::size_t faceVertexCount = 0;
+		std::size_t faceCount = 0;
+		std::size_t stringsSize = 0;
+	};
+
+	std::vector<ChunkOffsets> chunkOffsets(chunks.size());
+	ChunkOffsets totals{};
+	for (std::size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex) {
+		const FlatSceneChunk& chunk = chunks[chunkIndex];
+		chunkOffsets[chunkIndex] = totals;
+		totals.vertexCount += chunk.vertices.size();
+		totals.textureCoordinateCount += chunk.textureCoordinates.size();
+		totals.normalCount += chunk.normals.size();
+		totals.faceVertexCount += chunk.faceVertices.size();
+		totals.faceCount += chunk.faceOffsets.size() - 1;
+		totals.stringsSize += chunk.strings.size();
+	}
+
+	FlatScene result{};
+	result.vertices.resize(totals.vertexCount);
+	result.textureCoordinates.resize(totals.textureCoordinateCount);
+	result.normals.resize(totals.normalCount);
+	result.faceVertices.resize(totals.faceVertexCount);
+	result.faceOffsets.resize(totals.faceCount + 1);
+	result.strings.resize(totals.stringsSize);
+	result.groups.push_back(FlatGroup{});
+	result.objects.push_back(FlatObject{.groupsBegin = 0, .groupsEnd = 1});
+	for (std::size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex) {
+		const FlatSceneChunk& chunk = chunks[chunkIndex];
+		const ChunkOffsets& offsets = chunkOffsets[chunkIndex];
+		for (const Command& command : chunk.commands) {
+			const std::size_t faceCount = offsets.faceCount + command.faceCount;
+			const StringRange name{.offset = offsets.stringsSize + command.name.offset, .length = command.name.length};
+			result.groups.back().facesEnd = faceCount;
+			switch (command.kind) {
+				case CommandKind::MATERIAL_LIBRARY: result.materialLibraryFilenames.emplace_back(chunk.strings, command.name.offset, command.name.length); break;
+				case CommandKind::MATERIAL: useMaterial(result, name, faceCount); break;
+				case CommandKind::OBJECT: beginObject(result, name, faceCount); break;
+				case CommandKind::GROUP: beginGroup(result, name, faceCount); break;
+			}
+		}
+	}
+	result.groups.back().facesEnd = totals.faceCount;
+
+	detail::runInParallel(chunks.size(), chunks.size(), [&](std::size_t chunkIndex) -> void {
+		const FlatSceneChunk& chunk = chunks[chunkIndex];
+		const ChunkOffsets& offsets = chunkOffsets[chunkIndex];
+		std::ranges::copy(chunk.vertices, std::span{result.vertices}.subspan(offsets.vertexCount).begin());
+		std::ranges::copy(chunk.textureCoordinates, std::span{result.textureCoordinates}.subspan(offsets.textureCoordinateCount).begin());
+		std::ranges::copy(chunk.normals, std::span{result.normals}.subspan(offsets.normalCount).begin());
+		std::ranges::copy(chunk.strings, std::span{result.strings}.subspan(offsets.stringsSize).begin());
+		const std::span<FaceVertex> faceVertices = std::span{result.faceVertices}.subspan(offsets.faceVertexCount, chunk.faceVertices.size());
+		for (std::size_t i = 0; i < faceVertices.size(); ++i) {
+			FaceVertex faceVertex = chunk.faceVertices[i];
+			if (const std::uint8_t relativeIndices = chunk.faceVertexRelativeIndices[i]; relativeIndices != 0) {
+				if ((relativeIndices & RELATIVE_VERTEX_INDEX) != 0) {
+					faceVertex.vertexIndex += static_cast<std::uint32_t>(offsets.vertexCount);
+				}
+				if ((relativeIndices & RELATIVE_TEXTURE_COORDINATE_INDEX) != 0) {
+					faceVertex.textureCoordinateIndex += static_cast<std::uint32_t>(offsets.textureCoordinateCount);
+				}
+				if ((relativeIndices & RELATIVE_NORMAL_INDEX) != 0) {
+					faceVertex.normalIndex += static_cast<std::uint32_t>(offsets.normalCount);
+				}
+			}
+			faceVertices[i] = faceVertex;
+		}
+		const std::span<std::size_t> faceOffsets = std::span{result.faceOffsets}.subspan(offsets.faceCount + 1, chunk.faceOffsets.size() - 1);
+		for (std::size_t i = 0; i < faceOffsets.size(); ++i) {
+			faceOffsets[i] = offsets.faceVertexCount + chunk.faceOffsets[i + 1];
+		}
+	});
+	return result;
+}
+
 } // namespace
 
 Scene Scene::parse(std::string_view objString) {
@@ -301,6 +607,52 @@ Scene Scene::parse(std::string_view objString) {
 	return result;
 }
 
+FlatScene FlatScene::parse(std::string_view objString, const ParseOptions& options) {
+	if (const std::size_t chunkCount = std::min(detail::getThreadCount(options.threadCount), objString.size() / PARALLEL_CHUNK_SIZE_MIN); chunkCount > 1) {
+		return parseFlatSceneInParallel(objString, chunkCount);
+	}
+	FlatSceneParser parser{};
+	parser.parse(objString);
+	return parser.finish();
+}
+
+FlatScene FlatScene::parse(File& file) {
+	FlatSceneParser parser{};
+	std::vector<std::byte> buffer(FILE_CHUNK_SIZE);
+	while (const std::size_t size = file.read(buffer)) {
+		parser.parse(std::string_view{reinterpret_cast<const char*>(buffer.data()), size}); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+	}
+	return parser.finish();
+}
+
+FlatSceneParser::FlatSceneParser() {
+	scene.groups.push_back(FlatGroup{});
+	scene.objects.push_back(FlatObject{.groupsBegin = 0, .groupsEnd = 1});
+}
+
+void FlatSceneParser::parse(std::string_view chunk) {
+	const std::size_t lastLineEnd = chunk.rfind('\n');
+	if (lastLineEnd == std::string_view::npos) {
+		incompleteLine.append(chunk);
+		return;
+	}
+	std::string_view completeLines = chunk.substr(0, lastLineEnd + 1);
+	if (!incompleteLine.empty()) {
+		const std::size_t firstLineEnd = chunk.find('\n');
+		incompleteLine.append(chunk.substr(0, firstLineEnd + 1));
+		parseFlatSceneLines(scene, incompleteLine, lineNumber);
+		completeLines.remove_prefix(firstLineEnd + 1);
+	}
+	parseFlatSceneLines(scene, completeLines, lineNumber);
+	incompleteLine.assign(chunk.substr(lastLineEnd + 1));
+}
+
+FlatScene FlatSceneParser::finish() {
+	parseFlatSceneLines(scene, incompleteLine, lineNumber);
+	incompleteLine.clear();
+	return std::move(scene);
+}
+
 namespace mtl {
 
 Library Library::parse(std::string_view mtlString) {
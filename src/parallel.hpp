@@ -0,0 +1,55 @@
+#ifndef DONUT_PARALLEL_HPP
+#define DONUT_PARALLEL_HPP
+
+#include <algorithm> // std::min, std::max
+#include <atomic>    // std::atomic
+#include <cstddef>   // std::size_t
+#include <exception> // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <thread>    // std::jthread, std::thread
+#include <vector>    // std::vector
+
+namespace donut::detail {
+
+// Resolve a thread count option, where 0 means one thread per hardware thread.
+[[nodiscard]] inline std::size_t getThreadCount(std::size_t requestedThreadCount) noexcept {
+	return (requestedThreadCount == 0) ? std::max(std::size_t{std::thread::hardware_concurrency()}, std::size_t{1}) : requestedThreadCount;
+}
+
+// Call function(taskIndex) for every task index in [0, taskCount) on up to threadCount threads, including the calling thread, which take tasks in
+// order until none are left. The first exception thrown by a task cancels the tasks that have not started yet and is rethrown after all threads join.
+template <typename Function>
+void runInParallel(std::size_t taskCount, std::size_t threadCount, const Function& function) {
+	threadCount = std::min(taskCount, threadCount);
+	if (threadCount == 0) {
+		return;
+	}
+	std::atomic<std::size_t> nextTaskIndex{0};
+	std::vector<std::exception_ptr> exceptions(threadCount);
+	const auto runTasks = [&](std::size_t threadIndex) -> void {
+		try {
+			for (std::size_t taskIndex = nextTaskIndex++; taskIndex < taskCount; taskIndex = nextTaskIndex++) {
+				function(taskIndex);
+			}
+		} catch (...) {
+			exceptions[threadIndex] = std::current_exception();
+			nextTaskIndex = taskCount;
+		}
+	};
+	{
+		std::vector<std::jthread> threads{};
+		threads.reserve(threadCount - 1);
+		for (std::size_t threadIndex = 1; threadIndex < threadCount; ++threadIndex) {
+			threads.emplace_back(runTasks, threadIndex);
+		}
+		runTasks(0);
+	}
+	for (const std::exception_ptr& exception : exceptions) {
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+}
+
+} // namespace donut::detail
+
+#endif
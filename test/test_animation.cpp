@@ -0,0 +1,146 @@
+#include <donut/graphics/Animation.hpp>
+#include <donut/math.hpp>
+
+#include <array>                        // std::array
+#include <catch2/catch_approx.hpp>      // Catch::Approx
+#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK, REQUIRE
+#include <cmath>                        // std::cos, std::sin, std::abs
+#include <cstddef>                      // std::size_t
+#include <vector>                       // std::vector
+
+namespace gfx = donut::graphics;
+
+namespace {
+
+[[nodiscard]] gfx::AnimationClip makeTranslationClip() {
+	gfx::AnimationClip clip{};
+	clip.translationTracks.push_back(gfx::AnimationTrack<donut::vec3>{
+		.times{0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f},
+		.values{
+			{0.0f, 0.0f, 0.0f},
+			{1.0f, 0.0f, 0.0f},
+			{2.0f, 0.0f, 0.0f},
+			{3.0f, 0.0f, 0.0f},
+			{4.0f, 0.0f, 0.0f},
+			{5.0f, 0.0f, 0.0f},
+			{6.0f, 0.0f, 0.0f},
+			{7.0f, 0.0f, 0.0f},
+			{8.0f, 0.0f, 0.0f},
+			{9.0f, 0.0f, 0.0f},
+			{10.0f, 0.0f, 0.0f},
+		},
+	});
+	clip.duration = 10.0f;
+	return clip;
+}
+
+} // namespace
+
+// NOLINTBEGIN(misc-use-anonymous-namespace)
+
+TEST_CASE("Sample animation", "[animation]") {
+	const gfx::AnimationClip clip = makeTranslationClip();
+
+	SECTION("Interpolation and clamping") {
+		gfx::AnimationCursor cursor{};
+		std::array<gfx::JointTransform, 1> pose{};
+		for (const float time : {-1.0f, 0.0f, 0.25f, 2.5f, 9.75f, 10.0f, 12.0f}) {
+			gfx::sampleAnimation(clip, time, cursor, pose);
+			const float expected = (time < 0.0f) ? 0.0f : (time > 10.0f) ? 10.0f : time;
+			CHECK(pose[0].translation.x == Catch::Approx(expected));
+		}
+	}
+
+	SECTION("Cursor matches uncached sampling in any order") {
+		gfx::AnimationCursor cursor{};
+		for (const float time : {0.5f, 1.5f, 1.75f, 7.25f, 3.5f, 3.5f, 0.0f, 9.5f, 8.0f, 8.5f, 2.0f}) {
+			std::array<gfx::JointTransform, 1> cachedPose{};
+			std::array<gfx::JointTransform, 1> uncachedPose{};
+			gfx::AnimationCursor freshCursor{};
+			gfx::sampleAnimation(clip, time, cursor, cachedPose);
+			gfx::sampleAnimation(clip, time, freshCursor, uncachedPose);
+			CHECK(cachedPose[0].translation.x == Catch::Approx(time));
+			CHECK(uncachedPose[0].translation.x == Catch::Approx(time));
+		}
+	}
+
+	SECTION("Components without tracks are left unchanged") {
+		gfx::AnimationCursor cursor{};
+		std::array<gfx::JointTransform, 2> pose{};
+		pose[0].scale = {2.0f, 2.0f, 2.0f};
+		pose[1].translation = {0.0f, 5.0f, 0.0f};
+		gfx::sampleAnimation(clip, 4.0f, cursor, pose);
+		CHECK(pose[0].translation.x == Catch::Approx(4.0f));
+		CHECK(pose[0].scale.x == 2.0f);
+		CHECK(pose[1].translation.y == 5.0f);
+	}
+
+	SECTION("Rotation takes the shortest path") {
+		gfx::AnimationClip rotationClip{};
+		const float halfAngle = 0.25f * 3.14159265f;
+		rotationClip.rotationTracks.push_back(gfx::AnimationTrack<donut::quat>{
+			.times{0.0f, 1.0f},
+			.values{donut::quat{1.0f, 0.0f, 0.0f, 0.0f}, -donut::quat{std::cos(halfAngle), 0.0f, 0.0f, std::sin(halfAngle)}},
+		});
+		gfx::AnimationCursor cursor{};
+		std::array<gfx::JointTransform, 1> pose{};
+		gfx::sampleAnimation(rotationClip, 0.5f, cursor, pose);
+		const donut::quat rotation = pose[0].rotation;
+		CHECK(dot(rotation, rotation) == Catch::Approx(1.0f));
+		CHECK(std::abs(rotation.w) == Catch::Approx(std::cos(0.5f * halfAngle)).margin(0.01f));
+		CHECK(std::abs(rotation.z) == Catch::Approx(std::sin(0.5f * halfAngle)).margin(0.01f));
+	}
+}
+
+TEST_CASE("Compute joint matrices", "[animation]") {
+	gfx::Skeleton skeleton{
+		.parents{gfx::Skeleton::NO_PARENT, 0, 1},
+		.inverseBindMatrices{
+			donut::identity<donut::mat4>(),
+			donut::translate(donut::vec3{-1.0f, 0.0f, 0.0f}),
+			donut::translate(donut::vec3{-2.0f, 0.0f, 0.0f}),
+		},
+		.bindPose{
+			gfx::JointTransform{},
+			gfx::JointTransform{.translation{1.0f, 0.0f, 0.0f}},
+			gfx::JointTransform{.translation{1.0f, 0.0f, 0.0f}},
+		},
+	};
+	std::vector<donut::mat4> jointMatrices(3);
+
+	SECTION("Bind pose yields identity") {
+		gfx::computeJointMatrices(skeleton, skeleton.bindPose, jointMatrices);
+		for (const donut::mat4& matrix : jointMatrices) {
+			for (int column = 0; column < 4; ++column) {
+				for (int row = 0; row < 4; ++row) {
+					CHECK(matrix[column][row] == Catch::Approx((column == row) ? 1.0f : 0.0f).margin(1e-6f));
+				}
+			}
+		}
+	}
+
+	SECTION("Parent transformations propagate to children") {
+		std::vector<gfx::JointTransform> pose = skeleton.bindPose;
+		pose[0].translation = {0.0f, 3.0f, 0.0f};
+		pose[1].rotation = donut::quat{std::cos(0.25f * 3.14159265f), 0.0f, 0.0f, std::sin(0.25f * 3.14159265f)}; // 90 degrees around z.
+		gfx::computeJointMatrices(skeleton, pose, jointMatrices);
+
+		// A vertex at the bind position of the last joint is rotated around the middle joint and then translated along with the root.
+		const donut::vec4 vertex = jointMatrices[2] * donut::vec4{2.0f, 0.0f, 0.0f, 1.0f};
+		CHECK(vertex.x == Catch::Approx(1.0f));
+		CHECK(vertex.y == Catch::Approx(4.0f));
+		CHECK(vertex.z == Catch::Approx(0.0f).margin(1e-6f));
+	}
+}
+
+TEST_CASE("Blend poses", "[animation]") {
+	const std::array<gfx::JointTransform, 1> from{gfx::JointTransform{.translation{0.0f, 0.0f, 0.0f}, .scale{1.0f, 1.0f, 1.0f}}};
+	const std::array<gfx::JointTransform, 1> to{gfx::JointTransform{.translation{4.0f, 0.0f, 0.0f}, .scale{3.0f, 3.0f, 3.0f}}};
+	std::array<gfx::JointTransform, 1> output{};
+	gfx::blendPoses(from, to, 0.25f, output);
+	CHECK(output[0].translation.x == Catch::Approx(1.0f));
+	CHECK(output[0].scale.y == Catch::Approx(1.5f));
+	CHECK(output[0].rotation.w == Catch::Approx(1.0f));
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
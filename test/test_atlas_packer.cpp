@@ -0,0 +1,149 @@
+#include <donut/AtlasPacker.hpp>
+#include <donut/random.hpp>
+
+#include <algorithm>                               // std::max
+#include <catch2/catch_template_test_macros.hpp> // TEMPLATE_TEST_CASE
+#include <catch2/catch_test_macros.hpp>          // TEST_CASE, SECTION, CHECK, CHECK_FALSE, REQUIRE, REQUIRE_FALSE
+#include <cstddef>                               // std::size_t
+#include <cstdint>                               // std::uint64_t
+#include <random>                                // std::uniform_int_distribution
+#include <vector>                                // std::vector
+
+namespace {
+
+using donut::AtlasPacker;
+using donut::AtlasPackingStrategy;
+
+constexpr std::size_t INITIAL_RESOLUTION = 128;
+constexpr std::size_t PADDING = 2;
+
+using ShelfPacker = AtlasPacker<INITIAL_RESOLUTION, PADDING, AtlasPackingStrategy::SHELF>;
+using SkylinePacker = AtlasPacker<INITIAL_RESOLUTION, PADDING, AtlasPackingStrategy::SKYLINE_BOTTOM_LEFT>;
+using MaxRectsPacker = AtlasPacker<INITIAL_RESOLUTION, PADDING, AtlasPackingStrategy::MAX_RECTS_BEST_SHORT_SIDE_FIT>;
+
+struct PlacedRectangle {
+	std::size_t x;
+	std::size_t y;
+	std::size_t width;
+	std::size_t height;
+};
+
+template <typename Packer>
+[[nodiscard]] std::vector<typename Packer::RectangleSize> generateSpriteSizes(std::size_t count, std::size_t minSize, std::size_t maxSize, std::uint64_t seed) {
+	donut::random::Xoroshiro128PlusPlusEngine rng{seed};
+	std::uniform_int_distribution<std::size_t> sizeDistribution{minSize, maxSize};
+	std::vector<typename Packer::RectangleSize> sizes{};
+	sizes.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		const std::size_t width = sizeDistribution(rng);
+		const std::size_t height = sizeDistribution(rng);
+		sizes.push_back({.width = width, .height = height});
+	}
+	return sizes;
+}
+
+[[nodiscard]] bool overlapsWithPadding(const PlacedRectangle& a, const PlacedRectangle& b) {
+	return a.x < b.x + b.width + PADDING && b.x < a.x + a.width + PADDING && a.y < b.y + b.height + PADDING && b.y < a.y + a.height + PADDING;
+}
+
+template <typename Packer>
+void checkPacking(const Packer& packer, const std::vector<PlacedRectangle>& placedRectangles) {
+	for (std::size_t i = 0; i < placedRectangles.size(); ++i) {
+		const PlacedRectangle& a = placedRectangles[i];
+		REQUIRE(a.x >= PADDING);
+		REQUIRE(a.y >= PADDING);
+		REQUIRE(a.x + a.width + PADDING <= packer.getResolution());
+		REQUIRE(a.y + a.height + PADDING <= packer.getResolution());
+		for (std::size_t j = i + 1; j < placedRectangles.size(); ++j) {
+			REQUIRE_FALSE(overlapsWithPadding(a, placedRectangles[j]));
+		}
+	}
+}
+
+template <typename Packer>
+[[nodiscard]] std::vector<PlacedRectangle> packOneByOne(Packer& packer, const std::vector<typename Packer::RectangleSize>& sizes) {
+	std::vector<PlacedRectangle> placedRectangles{};
+	placedRectangles.reserve(sizes.size());
+	for (const typename Packer::RectangleSize& size : sizes) {
+		const auto [x, y, resized] = packer.insertRectangle(size.width, size.height);
+		placedRectangles.push_back({x, y, size.width, size.height});
+	}
+	return placedRectangles;
+}
+
+template <typename Packer>
+[[nodiscard]] std::vector<PlacedRectangle> packBatch(Packer& packer, const std::vector<typename Packer::RectangleSize>& sizes) {
+	const std::vector<typename Packer::InsertRectangleResult> results = packer.insertRectangles(sizes);
+	std::vector<PlacedRectangle> placedRectangles{};
+	placedRectangles.reserve(sizes.size());
+	for (std::size_t i = 0; i < sizes.size(); ++i) {
+		placedRectangles.push_back({results[i].x, results[i].y, sizes[i].width, sizes[i].height});
+	}
+	return placedRectangles;
+}
+
+} // namespace
+
+// NOLINTBEGIN(misc-use-anonymous-namespace)
+
+TEMPLATE_TEST_CASE("Insert rectangles", "[atlas_packer]", ShelfPacker, SkylinePacker, MaxRectsPacker) {
+	SECTION("Single rectangle") {
+		TestType packer{};
+		const auto [x, y, resized] = packer.insertRectangle(16, 16);
+		CHECK(x == PADDING);
+		CHECK(y == PADDING);
+		CHECK_FALSE(resized);
+		CHECK(packer.getResolution() == INITIAL_RESOLUTION);
+	}
+
+	SECTION("Rectangle larger than the initial resolution") {
+		TestType packer{};
+		const auto [x, y, resized] = packer.insertRectangle(300, 20);
+		CHECK(resized);
+		CHECK(packer.getResolution() == 512);
+		checkPacking(packer, {{x, y, 300, 20}});
+	}
+
+	SECTION("One by one") {
+		TestType packer{};
+		checkPacking(packer, packOneByOne(packer, generateSpriteSizes<TestType>(300, 1, 48, 1)));
+	}
+
+	SECTION("Batch") {
+		TestType packer{};
+		checkPacking(packer, packBatch(packer, generateSpriteSizes<TestType>(300, 1, 48, 2)));
+	}
+}
+
+TEMPLATE_TEST_CASE("Resume packing an existing atlas", "[atlas_packer]", ShelfPacker, SkylinePacker, MaxRectsPacker) {
+	SECTION("Bake, load and insert") {
+		// Bake a batch offline, then restore the used height from the placed rectangles the same way as SpriteAtlas does when loading it.
+		MaxRectsPacker bakePacker{};
+		std::vector<PlacedRectangle> placedRectangles = packBatch(bakePacker, {{50, 20}, {50, 20}, {30, 40}});
+		std::size_t usedHeight = 0;
+		for (const PlacedRectangle& rectangle : placedRectangles) {
+			usedHeight = std::max(usedHeight, rectangle.y + rectangle.height + PADDING);
+		}
+
+		TestType packer{bakePacker.getResolution(), usedHeight};
+		const auto [x, y, resized] = packer.insertRectangle(16, 16);
+		CHECK_FALSE(resized);
+		CHECK(packer.getResolution() == bakePacker.getResolution());
+		CHECK(y >= usedHeight + PADDING);
+		placedRectangles.push_back({x, y, 16, 16});
+
+		const std::vector<PlacedRectangle> insertedRectangles = packOneByOne(packer, generateSpriteSizes<TestType>(100, 1, 48, 5));
+		placedRectangles.insert(placedRectangles.end(), insertedRectangles.begin(), insertedRectangles.end());
+		checkPacking(packer, placedRectangles);
+	}
+
+	SECTION("Full atlas") {
+		TestType packer{256, 256};
+		const auto [x, y, resized] = packer.insertRectangle(16, 16);
+		CHECK(resized);
+		CHECK(packer.getResolution() == 512);
+		checkPacking(packer, {{PADDING, PADDING, 256 - PADDING * 2, 256 - PADDING * 2}, {x, y, 16, 16}});
+	}
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
@@ -0,0 +1,86 @@
+#include <donut/graphics/DirtyRangeSet.hpp>
+
+#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK, REQUIRE
+#include <cstddef>                      // std::size_t
+#include <utility>                      // std::pair
+#include <vector>                       // std::vector
+
+namespace gfx = donut::graphics;
+
+namespace {
+
+[[nodiscard]] std::vector<std::pair<std::size_t, std::size_t>> getRanges(const gfx::DirtyRangeSet& set) {
+	std::vector<std::pair<std::size_t, std::size_t>> result{};
+	for (const gfx::DirtyRange& range : set.getRanges()) {
+		result.emplace_back(range.offset, range.size);
+	}
+	return result;
+}
+
+} // namespace
+
+// NOLINTBEGIN(misc-use-anonymous-namespace)
+
+TEST_CASE("Dirty range set", "[dirty_range_set]") {
+	SECTION("Empty") {
+		gfx::DirtyRangeSet set{};
+		CHECK(set.empty());
+		set.insert(5, 0);
+		CHECK(set.empty());
+		CHECK(set.getTotalSize() == 0);
+	}
+
+	SECTION("Disjoint ranges are sorted") {
+		gfx::DirtyRangeSet set{};
+		set.insert(20, 5);
+		set.insert(0, 2);
+		set.insert(10, 3);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 2}, {10, 3}, {20, 5}});
+		CHECK(set.getTotalSize() == 10);
+	}
+
+	SECTION("Overlapping and adjacent ranges are merged") {
+		gfx::DirtyRangeSet set{};
+		set.insert(10, 5);
+		set.insert(12, 10);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{10, 12}});
+		set.insert(22, 3);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{10, 15}});
+		set.insert(5, 5);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{5, 20}});
+		set.insert(11, 2);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{5, 20}});
+	}
+
+	SECTION("Range spanning several others") {
+		gfx::DirtyRangeSet set{};
+		set.insert(0, 1);
+		set.insert(4, 1);
+		set.insert(8, 1);
+		set.insert(12, 1);
+		set.insert(3, 7);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 1}, {3, 7}, {12, 1}});
+	}
+
+	SECTION("Merge distance") {
+		gfx::DirtyRangeSet set{4};
+		set.insert(0, 2);
+		set.insert(6, 2);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 8}});
+		set.insert(13, 1);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 8}, {13, 1}});
+		set.insert(9, 1);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{0, 14}});
+	}
+
+	SECTION("Clear") {
+		gfx::DirtyRangeSet set{};
+		set.insert(3, 4);
+		set.clear();
+		CHECK(set.empty());
+		set.insert(1, 1);
+		CHECK(getRanges(set) == std::vector<std::pair<std::size_t, std::size_t>>{{1, 1}});
+	}
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
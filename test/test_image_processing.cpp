@@ -0,0 +1,199 @@
+#include <donut/graphics/Image.hpp>
+#include <donut/graphics/ImageProcessing.hpp>
+
+#include <array>                        // std::array
+#include <catch2/catch_approx.hpp>      // Catch::Approx
+#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK, REQUIRE
+#include <cstddef>                      // std::size_t
+#include <cstdint>                      // std::uint8_t
+#include <cstring>                      // std::memcmp
+#include <vector>                       // std::vector
+
+namespace gfx = donut::graphics;
+
+namespace {
+
+template <typename T>
+[[nodiscard]] const T* getPixels(const gfx::Image& image) {
+	return static_cast<const T*>(image.getPixels());
+}
+
+[[nodiscard]] gfx::Image makeGradientImage(std::size_t width, std::size_t height, gfx::PixelFormat pixelFormat) {
+	gfx::Image image{width, height, pixelFormat, gfx::PixelComponentType::U8};
+	std::uint8_t* const pixels = static_cast<std::uint8_t*>(image.getPixels());
+	for (std::size_t i = 0; i < image.getSizeInBytes(); ++i) {
+		pixels[i] = static_cast<std::uint8_t>(i * 7);
+	}
+	return image;
+}
+
+} // namespace
+
+// NOLINTBEGIN(misc-use-anonymous-namespace)
+
+TEST_CASE("Convert image", "[image_processing]") {
+	SECTION("RGB to RGBA") {
+		const std::array<std::uint8_t, 6> pixels{1, 2, 3, 4, 5, 6};
+		const gfx::Image result = gfx::convertImage(gfx::ImageView{2, 1, gfx::PixelFormat::RGB, gfx::PixelComponentType::U8, pixels.data()}, gfx::PixelFormat::RGBA,
+			gfx::PixelComponentType::U8);
+		REQUIRE(result.getPixelFormat() == gfx::PixelFormat::RGBA);
+		const std::array<std::uint8_t, 8> expectedPixels{1, 2, 3, 255, 4, 5, 6, 255};
+		CHECK(std::memcmp(result.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+	}
+
+	SECTION("RGBA to RGB") {
+		const std::array<std::uint8_t, 8> pixels{1, 2, 3, 4, 5, 6, 7, 8};
+		const gfx::Image result = gfx::convertImage(gfx::ImageView{2, 1, gfx::PixelFormat::RGBA, gfx::PixelComponentType::U8, pixels.data()}, gfx::PixelFormat::RGB,
+			gfx::PixelComponentType::U8);
+		const std::array<std::uint8_t, 6> expectedPixels{1, 2, 3, 5, 6, 7};
+		CHECK(std::memcmp(result.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+	}
+
+	SECTION("R to RGBA") {
+		const std::array<std::uint8_t, 1> pixels{9};
+		const gfx::Image result = gfx::convertImage(gfx::ImageView{1, 1, gfx::PixelFormat::R, gfx::PixelComponentType::U8, pixels.data()}, gfx::PixelFormat::RGBA,
+			gfx::PixelComponentType::U8);
+		const std::array<std::uint8_t, 4> expectedPixels{9, 0, 0, 255};
+		CHECK(std::memcmp(result.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+	}
+
+	SECTION("U8 to F32 and back") {
+		const gfx::Image original = makeGradientImage(7, 5, gfx::PixelFormat::RGBA);
+		const gfx::Image floatImage = gfx::convertImage(original, gfx::PixelFormat::RGBA, gfx::PixelComponentType::F32);
+		REQUIRE(floatImage.getPixelComponentType() == gfx::PixelComponentType::F32);
+		CHECK(getPixels<float>(floatImage)[1] == Catch::Approx(7.0 / 255.0).margin(1e-6));
+		const gfx::Image roundTrip = gfx::convertImage(floatImage, gfx::PixelFormat::RGBA, gfx::PixelComponentType::U8);
+		CHECK(std::memcmp(roundTrip.getPixels(), original.getPixels(), original.getSizeInBytes()) == 0);
+	}
+
+	SECTION("F32 to U8 clamps out-of-range values") {
+		const std::array<float, 3> pixels{-1.0f, 0.5f, 2.0f};
+		const gfx::Image result = gfx::convertImage(gfx::ImageView{1, 1, gfx::PixelFormat::RGB, gfx::PixelComponentType::F32, pixels.data()}, gfx::PixelFormat::RGB,
+			gfx::PixelComponentType::U8);
+		const std::array<std::uint8_t, 3> expectedPixels{0, 128, 255};
+		CHECK(std::memcmp(result.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+	}
+}
+
+TEST_CASE("Convert image color space", "[image_processing]") {
+	SECTION("F32 round trip") {
+		const std::array<float, 4> pixels{0.0f, 0.5f, 1.0f, 0.5f};
+		gfx::Image image{gfx::ImageView{1, 1, gfx::PixelFormat::RGBA, gfx::PixelComponentType::F32, pixels.data()}};
+		gfx::convertImageSRGBToLinear(image);
+		CHECK(getPixels<float>(image)[1] == Catch::Approx(0.21404).margin(1e-4));
+		CHECK(getPixels<float>(image)[3] == 0.5f);
+		gfx::convertImageLinearToSRGB(image);
+		for (std::size_t i = 0; i < pixels.size(); ++i) {
+			CHECK(getPixels<float>(image)[i] == Catch::Approx(pixels[i]).margin(1e-5));
+		}
+	}
+
+	SECTION("U8") {
+		const std::array<std::uint8_t, 4> pixels{0, 128, 255, 128};
+		gfx::Image image{gfx::ImageView{1, 1, gfx::PixelFormat::RGBA, gfx::PixelComponentType::U8, pixels.data()}};
+		gfx::convertImageSRGBToLinear(image);
+		const std::array<std::uint8_t, 4> expectedPixels{0, 55, 255, 128};
+		CHECK(std::memcmp(image.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+	}
+}
+
+TEST_CASE("Premultiply image alpha", "[image_processing]") {
+	const std::array<std::uint8_t, 8> pixels{255, 128, 10, 128, 200, 100, 50, 0};
+	gfx::Image image{gfx::ImageView{2, 1, gfx::PixelFormat::RGBA, gfx::PixelComponentType::U8, pixels.data()}};
+	gfx::premultiplyImageAlpha(image);
+	const std::array<std::uint8_t, 8> expectedPixels{128, 64, 5, 128, 0, 0, 0, 0};
+	CHECK(std::memcmp(image.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+}
+
+TEST_CASE("Flip image vertically", "[image_processing]") {
+	const std::array<std::uint8_t, 6> pixels{1, 2, 3, 4, 5, 6};
+	gfx::Image image{gfx::ImageView{2, 3, gfx::PixelFormat::R, gfx::PixelComponentType::U8, pixels.data()}};
+	gfx::flipImageVertically(image);
+	const std::array<std::uint8_t, 6> expectedPixels{5, 6, 3, 4, 1, 2};
+	CHECK(std::memcmp(image.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+}
+
+TEST_CASE("Downsample image", "[image_processing]") {
+	SECTION("Even size") {
+		const std::array<std::uint8_t, 8> pixels{0, 10, 20, 30, 100, 110, 120, 130};
+		const gfx::Image result = gfx::downsampleImage(gfx::ImageView{4, 2, gfx::PixelFormat::R, gfx::PixelComponentType::U8, pixels.data()});
+		REQUIRE(result.getWidth() == 2);
+		REQUIRE(result.getHeight() == 1);
+		const std::array<std::uint8_t, 2> expectedPixels{55, 75};
+		CHECK(std::memcmp(result.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+	}
+
+	SECTION("Odd size") {
+		const std::array<float, 9> pixels{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+		const gfx::Image result = gfx::downsampleImage(gfx::ImageView{3, 3, gfx::PixelFormat::R, gfx::PixelComponentType::F32, pixels.data()});
+		REQUIRE(result.getWidth() == 1);
+		REQUIRE(result.getHeight() == 1);
+		CHECK(getPixels<float>(result)[0] == Catch::Approx(5.0).margin(1e-6));
+	}
+
+	SECTION("Single column") {
+		const std::array<std::uint8_t, 4> pixels{10, 20, 30, 40};
+		const gfx::Image result = gfx::downsampleImage(gfx::ImageView{1, 4, gfx::PixelFormat::R, gfx::PixelComponentType::U8, pixels.data()});
+		REQUIRE(result.getWidth() == 1);
+		REQUIRE(result.getHeight() == 2);
+		const std::array<std::uint8_t, 2> expectedPixels{15, 35};
+		CHECK(std::memcmp(result.getPixels(), expectedPixels.data(), expectedPixels.size()) == 0);
+	}
+}
+
+TEST_CASE("Generate mipmap", "[image_processing]") {
+	SECTION("Level sizes") {
+		const gfx::Image image = makeGradientImage(10, 3, gfx::PixelFormat::RGB);
+		const std::vector<gfx::Image> levels = gfx::generateMipmap(image);
+		REQUIRE(levels.size() == 3);
+		CHECK(levels[0].getWidth() == 5);
+		CHECK(levels[0].getHeight() == 1);
+		CHECK(levels[1].getWidth() == 2);
+		CHECK(levels[1].getHeight() == 1);
+		CHECK(levels[2].getWidth() == 1);
+		CHECK(levels[2].getHeight() == 1);
+		for (const gfx::Image& level : levels) {
+			CHECK(level.getPixelFormat() == gfx::PixelFormat::RGB);
+			CHECK(level.getPixelComponentType() == gfx::PixelComponentType::U8);
+		}
+	}
+
+	SECTION("Constant image stays constant") {
+		const std::array<std::uint8_t, 4> pixel{10, 100, 200, 255};
+		std::vector<std::uint8_t> pixels{};
+		for (std::size_t i = 0; i < 37 * 19; ++i) {
+			pixels.insert(pixels.end(), pixel.begin(), pixel.end());
+		}
+		const gfx::ImageView image{37, 19, gfx::PixelFormat::RGBA, gfx::PixelComponentType::U8, pixels.data()};
+		for (const gfx::MipmapFilter filter : {gfx::MipmapFilter::BOX, gfx::MipmapFilter::KAISER, gfx::MipmapFilter::LANCZOS}) {
+			for (const bool sRGB : {false, true}) {
+				const std::vector<gfx::Image> levels = gfx::generateMipmap(image, {.filter = filter, .sRGB = sRGB});
+				REQUIRE(levels.size() == 5);
+				for (const gfx::Image& level : levels) {
+					const std::uint8_t* const levelPixels = getPixels<std::uint8_t>(level);
+					for (std::size_t i = 0; i < level.getSizeInBytes(); ++i) {
+						CHECK(levelPixels[i] == pixel[i % pixel.size()]);
+					}
+				}
+			}
+		}
+	}
+
+	SECTION("sRGB averaging is gamma-correct") {
+		const std::array<std::uint8_t, 2> pixels{0, 255};
+		const gfx::ImageView image{2, 1, gfx::PixelFormat::R, gfx::PixelComponentType::U8, pixels.data()};
+		const std::vector<gfx::Image> linearLevels = gfx::generateMipmap(image, {.filter = gfx::MipmapFilter::BOX, .sRGB = false});
+		const std::vector<gfx::Image> sRGBLevels = gfx::generateMipmap(image, {.filter = gfx::MipmapFilter::BOX, .sRGB = true});
+		REQUIRE(linearLevels.size() == 1);
+		REQUIRE(sRGBLevels.size() == 1);
+		CHECK(getPixels<std::uint8_t>(linearLevels[0])[0] == 128);
+		CHECK(getPixels<std::uint8_t>(sRGBLevels[0])[0] == 188);
+	}
+
+	SECTION("1x1 image") {
+		const std::array<float, 1> pixels{1.0f};
+		CHECK(gfx::generateMipmap(gfx::ImageView{1, 1, gfx::PixelFormat::R, gfx::PixelComponentType::F32, pixels.data()}).empty());
+	}
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
@@ -1,15 +1,20 @@
 #include <donut/json.hpp>
 
-#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK
+#include <algorithm>                    // std::is_sorted
+#include <array>                        // std::array
+#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK, REQUIRE, CHECK_THROWS_AS, FAIL
 #include <cmath>                        // std::isinf, std::isnan, std::signbit
+#include <cstddef>                      // std::size_t, std::byte, std::max_align_t
 #include <fmt/format.h>                 // fmt::format
 #include <limits>                       // std::numeric_limits
 #include <optional>                     // std::optional
 #include <sstream>                      // std::istringstream, std::ostringstream
-#include <stdexcept>                    // std::runtime_error
+#include <span>                         // std::span
+#include <stdexcept>                    // std::runtime_error, std::out_of_range, std::invalid_argument
 #include <string>                       // std::string
 #include <string_view>                  // std::string_view, std::u8string_view
-#include <utility>                      // std::move
+#include <utility>                      // std::move, std::pair
+#include <vector>                       // std::vector
 
 namespace json = donut::json;
 
@@ -38,8 +43,84 @@ namespace {
 	}
 }
 
+struct EventLog final : json::IncrementalParser::EventVisitor {
+	std::string events{};
+
+	void visitNull(const json::SourceLocation& source, json::Null) override {
+		log(source, "null");
+	}
+
+	void visitBoolean(const json::SourceLocation& source, json::Boolean value) override {
+		log(source, (value) ? "true" : "false");
+	}
+
+	void visitString(const json::SourceLocation& source, json::String&& value) override {
+		log(source, fmt::format("\"{}\"", value));
+	}
+
+	void visitNumber(const json::SourceLocation& source, json::Number value) override {
+		log(source, fmt::format("{}", value));
+	}
+
+	void visitObjectBegin(const json::SourceLocation& source) override {
+		log(source, "{");
+	}
+
+	void visitPropertyName(const json::SourceLocation& source, json::String&& name) override {
+		log(source, fmt::format("{}:", name));
+	}
+
+	void visitObjectEnd(const json::SourceLocation& source) override {
+		log(source, "}");
+	}
+
+	void visitArrayBegin(const json::SourceLocation& source) override {
+		log(source, "[");
+	}
+
+	void visitArrayEnd(const json::SourceLocation& source) override {
+		log(source, "]");
+	}
+
+	void log(const json::SourceLocation& source, std::string_view event) {
+		events.append(fmt::format("{}:{} {}\n", source.lineNumber, source.columnNumber, event));
+	}
+};
+
+struct NamedPoint {
+	float x;
+	float y;
+};
+
+struct NamedPlayer {
+	std::string name;
+	int health;
+	NamedPoint position;
+	std::vector<std::string> items;
+};
+
+struct ManyNamedFields {
+	int f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19;
+};
+
 } // namespace
 
+template <>
+struct json::AggregateFieldNames<NamedPoint> {
+	static constexpr std::array<std::string_view, 2> NAMES{"x", "y"};
+};
+
+template <>
+struct json::AggregateFieldNames<NamedPlayer> {
+	static constexpr std::array<std::string_view, 4> NAMES{"name", "health", "position", "items"};
+};
+
+template <>
+struct json::AggregateFieldNames<ManyNamedFields> {
+	static constexpr std::array<std::string_view, 20> NAMES{
+		"f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9", "f10", "f11", "f12", "f13", "f14", "f15", "f16", "f17", "f18", "f19"};
+};
+
 // NOLINTBEGIN(misc-use-anonymous-namespace)
 
 TEST_CASE("Parse UTF-8 string", "[json]") {
@@ -602,6 +683,44 @@ TEST_CASE("Serialize to ASCII stream", "[json]") {
 		constexpr std::string_view EXPECTED_STRING = "123";
 		CHECK(string == EXPECTED_STRING);
 	}
+
+	SECTION("Numbers") {
+		const std::array<json::Number, 14> inputs{0.0, -0.0, 1.0, -42.0, 8675309.0, 9007199254740992.0, -9007199254740992.0, 1e20, 0.1, -2.5, 1e-7, 1.7976931348623157e308,
+			std::numeric_limits<json::Number>::infinity(), -std::numeric_limits<json::Number>::infinity()};
+		const std::array<std::string_view, 14> expected{
+			"0", "-0", "1", "-42", "8675309", "9007199254740992", "-9007199254740992", "1e+20", "0.1", "-2.5", "1e-07", "1.7976931348623157e+308", "Infinity", "-Infinity"};
+		for (std::size_t i = 0; i < inputs.size(); ++i) {
+			std::string string{};
+			json::Writer{string}.writeNumber(inputs[i]);
+			CHECK(string == expected[i]);
+			if (!std::isinf(inputs[i])) {
+				CHECK(json::Value::parse(string) == json::Value{inputs[i]});
+			}
+		}
+	}
+
+	SECTION("Buffered output") {
+		json::Array array{};
+		for (int i = 0; i < 100000; ++i) {
+			array.emplace_back((i % 3 == 0) ? json::Value{i} : (i % 3 == 1) ? json::Value{i * 0.25} : json::Value{fmt::format("item \"{}\"", i)});
+		}
+		const json::Value input{std::move(array)};
+		std::ostringstream stream{};
+		json::serialize(stream, input, {.prettyPrint = false});
+		const std::string string = std::move(stream).str();
+		CHECK(string.size() > 1000000);
+		CHECK(string == input.toString({.prettyPrint = false}));
+		CHECK(json::Value::parse(string) == input);
+	}
+
+	SECTION("Explicit flush") {
+		std::ostringstream stream{};
+		json::Writer writer{stream};
+		writer.writeString("text");
+		CHECK(stream.str().empty());
+		writer.flush();
+		CHECK(stream.str() == "\"text\"");
+	}
 }
 
 TEST_CASE("Deserialize from ASCII stream - pretty printed", "[json]") {
@@ -1104,6 +1223,612 @@ TEST_CASE("Deserialize from ASCII stream - not pretty printed", "[json]") {
 	}
 }
 
+TEST_CASE("Deserialize from UTF-8 string", "[json]") {
+	SECTION("Kitchen sink") {
+		const json::Value valueA{json::Object{
+			{"unquoted", "and you can quote me on that"},
+			{"singleQuotes", "I can use \"double quotes\" here"},
+			{"lineBreaks", "Look, Mom! No \\n's!"},
+			{"hexadecimal", 0xdecaf},
+			{"leadingDecimalPoint", .8675309},
+			{"andTrailing", 8675309.},
+			{"positiveSign", +1},
+			{"trailingComma", "in objects"},
+			{"andIn", json::Array{"arrays"}},
+			{"backwardsCompatible", "with JSON"},
+		}};
+		std::ostringstream streamA{};
+		json::serialize(streamA, valueA, {.prettyPrint = true});
+		const std::string string = std::move(streamA).str();
+		json::Value valueB{};
+		json::deserialize(string, valueB);
+		CHECK(valueA == valueB);
+	}
+
+	SECTION("Strings mixing plain runs with escapes and multi-byte code points") {
+		std::u8string valueB{};
+		json::deserialize(std::u8string_view{u8"\"abc\\tdef\\u00e5gh\u00e5\u00e4\u00f6ij\\\"kl\""}, valueB);
+		CHECK(valueB == u8"abc\tdef\u00e5gh\u00e5\u00e4\u00f6ij\"kl");
+	}
+
+	SECTION("Long strings with special characters at every offset") {
+		for (std::size_t offset = 0; offset < 40; ++offset) {
+			const std::string plainRun(offset, 'a');
+			for (const std::string_view special : {"\\\"", "\\n", "'", "\xC3\xA5", "\\u00e5"}) {
+				std::string valueB{};
+				json::deserialize(fmt::format("\"{}{}{}\"", plainRun, special, plainRun), valueB);
+				const std::string_view expectedSpecial = (special == "\\\"") ? "\"" : (special == "\\n") ? "\n" : (special == "'") ? "'" : "\xC3\xA5";
+				CHECK(valueB == fmt::format("{}{}{}", plainRun, expectedSpecial, plainRun));
+			}
+		}
+	}
+
+	SECTION("Long indentation") {
+		for (std::size_t indentation = 0; indentation < 40; ++indentation) {
+			const std::string whitespace(indentation, (indentation % 2 == 0) ? ' ' : '\t');
+			json::SourceLocation errorSource{};
+			try {
+				json::Value value{};
+				json::deserialize(fmt::format("[\n{}1,\r\n{}x]", whitespace, whitespace), value);
+			} catch (const json::Error& e) {
+				errorSource = e.source;
+			}
+			CHECK(errorSource == json::SourceLocation{.lineNumber = 3, .columnNumber = indentation + 1});
+		}
+	}
+
+	SECTION("Long numbers") {
+		double valueB{};
+		json::deserialize(std::string_view{"  -1234567890.0123456789e+2  "}, valueB);
+		CHECK(valueB == -123456789001.23456789);
+	}
+
+	struct Aggregate {
+		int x = 0;
+		double y = 0.0;
+		std::string z{};
+
+		[[nodiscard]] bool operator==(const Aggregate& other) const = default;
+	};
+
+	SECTION("Aggregate") {
+		const Aggregate valueA{.x = 123, .y = -5.3, .z = "abc"};
+		std::ostringstream streamA{};
+		json::serialize(streamA, valueA, {.prettyPrint = false});
+		const std::string string = std::move(streamA).str();
+		Aggregate valueB{};
+		json::deserialize(string, valueB);
+		CHECK(valueA == valueB);
+	}
+
+	SECTION("Error locations match stream input") {
+		constexpr std::string_view JSON_STRING = "{\r\n\t\"a\": [1, 2,\r\n\t\t\"b\\u00e5c\", \"d\",  x]\n}";
+		json::SourceLocation stringErrorSource{};
+		json::SourceLocation streamErrorSource{};
+		try {
+			json::Value value{};
+			json::deserialize(JSON_STRING, value);
+		} catch (const json::Error& e) {
+			stringErrorSource = e.source;
+		}
+		try {
+			std::istringstream stream{std::string{JSON_STRING}};
+			json::Value value{};
+			json::deserialize(stream, value);
+		} catch (const json::Error& e) {
+			streamErrorSource = e.source;
+		}
+		CHECK(stringErrorSource == json::SourceLocation{.lineNumber = 3, .columnNumber = 21});
+		CHECK(stringErrorSource == streamErrorSource);
+	}
+}
+
+TEST_CASE("Build large objects", "[json]") {
+	SECTION("Parse flat object") {
+		constexpr std::size_t MEMBER_COUNT = 50000;
+		std::string jsonString = "{";
+		for (std::size_t i = MEMBER_COUNT; i-- > 0;) {
+			jsonString.append(fmt::format("\"key{}\": {},", i, i));
+		}
+		jsonString.append("}");
+		const json::Value value = json::Value::parse(jsonString);
+		REQUIRE(value.is<json::Object>());
+		const json::Object& object = value.as<json::Object>();
+		CHECK(object.size() == MEMBER_COUNT);
+		CHECK(std::is_sorted(object.begin(), object.end(), [](const auto& a, const auto& b) -> bool { return a.first < b.first; }));
+		CHECK(object.at("key0") == json::Value{0});
+		CHECK(object.at("key12345") == json::Value{12345});
+		CHECK(object.at("key49999") == json::Value{49999});
+	}
+
+	SECTION("Parse duplicate keys") {
+		const json::Value value = json::Value::parse(std::string_view{R"({"b": 1, "a": 2, "b": 3, "c": 4, "a": 5})"});
+		CHECK(value == json::Value{json::Object{{"a", 2}, {"b", 1}, {"c", 4}}});
+	}
+
+	SECTION("Insert range into existing object") {
+		json::Object object{{"b", 1}, {"d", 2}};
+		object.reserve(8);
+		CHECK(object.capacity() >= 8);
+		const std::array<json::Object::value_type, 5> members{{{"e", 3}, {"d", 4}, {"a", 5}, {"c", 6}, {"a", 7}}};
+		object.insert(members.begin(), members.end());
+		CHECK(object == json::Object{{"a", 5}, {"b", 1}, {"c", 6}, {"d", 2}, {"e", 3}});
+	}
+}
+
+TEST_CASE("Parse document", "[json]") {
+	SECTION("Values") {
+		const std::string_view jsonString = R"({"b": [1, 2.5, -3], "a": "text", "c": {"x": null, "y": true, "z": false}, "d": [], "e": {}})";
+		const json::Document document{jsonString};
+		const json::DocumentValue& root = document.getRoot();
+		REQUIRE(root.is<json::DocumentObject>());
+		const json::DocumentObject& object = root.as<json::DocumentObject>();
+		REQUIRE(object.size() == 5);
+		CHECK(std::is_sorted(object.begin(), object.end(), [](const auto& a, const auto& b) -> bool { return a.name < b.name; }));
+		REQUIRE(object.at("b").is<json::DocumentArray>());
+		const json::DocumentArray& array = object.at("b").as<json::DocumentArray>();
+		REQUIRE(array.size() == 3);
+		CHECK(array[0].as<json::Number>() == 1.0);
+		CHECK(array[1].as<json::Number>() == 2.5);
+		CHECK(array.at(2).as<json::Number>() == -3.0);
+		CHECK_THROWS_AS(array.at(3), std::out_of_range);
+		CHECK(object.at("a").as<std::string_view>() == "text");
+		const json::DocumentObject& nested = object.at("c").as<json::DocumentObject>();
+		CHECK(nested.at("x").is<json::Null>());
+		CHECK(nested.at("y").as<json::Boolean>() == true);
+		CHECK(nested.at("z").as<json::Boolean>() == false);
+		CHECK(object.at("d").as<json::DocumentArray>().empty());
+		CHECK(object.at("e").as<json::DocumentObject>().empty());
+		CHECK(!object.contains("f"));
+		CHECK_THROWS_AS(object.at("f"), std::out_of_range);
+		CHECK(root.toValue() == json::Value::parse(jsonString));
+	}
+
+	SECTION("Strings without escape sequences are borrowed from the source") {
+		const std::string_view jsonString = R"(["plain", "esc\naped", {unquoted: 1}])";
+		const json::Document document{jsonString};
+		const json::DocumentArray& array = document.getRoot().as<json::DocumentArray>();
+		const std::string_view plain = array[0].as<std::string_view>();
+		const std::string_view escaped = array[1].as<std::string_view>();
+		CHECK(plain == "plain");
+		CHECK(plain.data() >= jsonString.data());
+		CHECK(plain.data() < jsonString.data() + jsonString.size());
+		CHECK(escaped == "esc\naped");
+		CHECK((escaped.data() < jsonString.data() || escaped.data() >= jsonString.data() + jsonString.size()));
+		CHECK(array[2].as<json::DocumentObject>().at("unquoted").as<json::Number>() == 1.0);
+	}
+
+	SECTION("Duplicate keys") {
+		const json::Document document{std::string_view{R"({"b": 1, "a": 2, "b": 3, "c": 4, "a": 5})"}};
+		CHECK(document.getRoot().toValue() == json::Value{json::Object{{"a", 2}, {"b", 1}, {"c", 4}}});
+	}
+
+	SECTION("Large object") {
+		constexpr std::size_t MEMBER_COUNT = 1000;
+		std::string jsonString = "{";
+		for (std::size_t i = MEMBER_COUNT; i-- > 0;) {
+			jsonString.append(fmt::format("\"key{}\": [{}, \"\\u0041{}\"],", i, i, i));
+		}
+		jsonString.append("}");
+		const json::Document document{jsonString};
+		const json::DocumentObject& object = document.getRoot().as<json::DocumentObject>();
+		CHECK(object.size() == MEMBER_COUNT);
+		CHECK(object.at("key123").as<json::DocumentArray>()[1].as<std::string_view>() == "A123");
+		CHECK(document.getRoot().toValue() == json::Value::parse(jsonString));
+	}
+
+	SECTION("Initial memory") {
+		alignas(std::max_align_t) std::array<std::byte, 4096> memory{};
+		const std::string_view jsonString = R"({"a": [1, 2, 3], "b": {"c": "d\te"}})";
+		const json::Document document{jsonString, memory};
+		const json::DocumentArray& array = document.getRoot().as<json::DocumentObject>().at("a").as<json::DocumentArray>();
+		CHECK(reinterpret_cast<const std::byte*>(array.begin()) >= memory.data());
+		CHECK(reinterpret_cast<const std::byte*>(array.begin()) < memory.data() + memory.size());
+		CHECK(document.getRoot().toValue() == json::Value::parse(jsonString));
+	}
+
+	SECTION("Errors") {
+		CHECK_THROWS_AS(json::Document{std::string_view{"[1, 2"}}, json::Error);
+		CHECK_THROWS_AS(json::Document{std::string_view{"{\"a\" 1}"}}, json::Error);
+		CHECK_THROWS_AS(json::Document{std::string_view{"{\"a\": 1 \"b\": 2}"}}, json::Error);
+		CHECK_THROWS_AS(json::Document{std::string_view{"1 2"}}, json::Error);
+		CHECK_THROWS_AS(json::Document{std::string_view{"]"}}, json::Error);
+		CHECK_THROWS_AS(json::Document{std::string_view{""}}, json::Error);
+	}
+}
+
+TEST_CASE("Navigate with cursor", "[json]") {
+	const std::string_view jsonString =
+		"{\n"
+		"  // Nested containers, strings with brackets and comments are skipped without being parsed.\n"
+		"  skipped: {\"x\": [1, 2, {\"]\": \"}\"}], // ]\n"
+		"    'y': \"\\\"[\", /* ] */ z: [[], {}]},\n"
+		"  \"a\": {\n"
+		"    \"list\": [10, [20, 21], {\"b\": 30, \"\xC3\xA5\xC3\xA5\": 0}, \"\xC3\xA5 string\", null, true],\n"
+		"    \"b\": {\"c\": [0, 1, 2, 3.5]},\n"
+		"  },\n"
+		"  \"a\": \"duplicate\",\n"
+		"}";
+	const json::Cursor root{jsonString};
+
+	SECTION("Scalars") {
+		CHECK(root["a"]["b"]["c"][3].get<json::Number>() == 3.5);
+		CHECK(root.at("a").at("list").at(0).get<json::Number>() == 10.0);
+		CHECK(root["a"]["list"][1][1].get<json::Number>() == 21.0);
+		CHECK(root["a"]["list"][2]["b"].get<json::Number>() == 30.0);
+		CHECK(root["a"]["list"][3].get<json::String>() == "\xC3\xA5 string");
+		CHECK(root["a"]["list"][4].is<json::Null>());
+		CHECK(root["a"]["list"][5].get<json::Boolean>() == true);
+		CHECK(root["skipped"]["y"].get<json::String>() == "\"[");
+	}
+
+	SECTION("Types") {
+		CHECK(root.is<json::Object>());
+		CHECK(root["a"]["list"].is<json::Array>());
+		CHECK(root["a"]["list"][0].is<json::Number>());
+		CHECK(root["a"]["list"][3].is<json::String>());
+		CHECK(root["a"]["list"][5].is<json::Boolean>());
+		CHECK(!root["a"]["list"][5].is<json::Null>());
+	}
+
+	SECTION("Subtrees") {
+		CHECK(root["a"]["b"].get<json::Value>() == json::Value{json::Object{{"c", json::Array{0, 1, 2, 3.5}}}});
+		CHECK(root["skipped"].get<json::Object>() == json::Value::parse(jsonString).as<json::Object>().at("skipped").as<json::Object>());
+		CHECK(root["skipped"]["z"].get<json::Array>() == json::Array{json::Array{}, json::Object{}});
+	}
+
+	SECTION("Missing values") {
+		CHECK(!root.find("missing"));
+		CHECK(root.find("a"));
+		CHECK_THROWS_AS(root["missing"], std::out_of_range);
+		CHECK_THROWS_AS(root["a"]["list"][6], std::out_of_range);
+		CHECK_THROWS_AS(root["a"]["list"]["b"], json::Error);
+		CHECK_THROWS_AS(root["a"][0], json::Error);
+		CHECK_THROWS_AS(root["a"]["list"][0].get<json::String>(), json::Error);
+	}
+
+	SECTION("Iteration") {
+		std::vector<std::string> names{};
+		root.forEachMember([&](std::string_view name, const json::Cursor& value) -> void {
+			names.emplace_back(name);
+			CHECK(value.getSourceLocation().lineNumber > 1);
+		});
+		CHECK(names == std::vector<std::string>{"skipped", "a", "a"});
+
+		json::Array items{};
+		root["a"]["list"].forEachItem([&](const json::Cursor& item) -> void { items.push_back(item.get<json::Value>()); });
+		CHECK(items == json::Value::parse(jsonString).as<json::Object>().at("a").as<json::Object>().at("list").as<json::Array>());
+	}
+
+	SECTION("Source locations") {
+		CHECK(root["a"].getSourceLocation() == json::SourceLocation{.lineNumber = 5, .columnNumber = 8});
+		CHECK(root["a"]["b"]["c"][3].getSourceLocation() == json::SourceLocation{.lineNumber = 7, .columnNumber = 26});
+		CHECK(root["a"]["list"][5].getSourceLocation() == json::SourceLocation{.lineNumber = 6, .columnNumber = 66});
+	}
+
+	SECTION("Invalid input") {
+		CHECK_THROWS_AS(json::Cursor{std::string_view{"{\"a\": [1, 2, \"b\": 1}"}}["b"], json::Error);
+		CHECK_THROWS_AS(json::Cursor{std::string_view{"{\"a\": \"unterminated}"}}["b"], json::Error);
+		CHECK_THROWS_AS(json::Cursor{std::string_view{"{\"a\" 1}"}}["a"], json::Error);
+		CHECK_THROWS_AS(json::Cursor{std::string_view{"[1 2]"}}[1], json::Error);
+		try {
+			(void)json::Cursor{std::string_view{"{\"a\": {\n  \"b\": [1, 2]\n} \"c\": 3}"}}["c"];
+			FAIL();
+		} catch (const json::Error& e) {
+			CHECK(e.source == json::SourceLocation{.lineNumber = 3, .columnNumber = 3});
+		}
+	}
+}
+
+TEST_CASE("Serialize to CBOR", "[json]") {
+	const auto toBytes = [](std::string_view string) -> std::vector<unsigned char> { return std::vector<unsigned char>(string.begin(), string.end()); };
+
+	SECTION("Encoding") {
+		const json::Value value{json::Object{{"a", 1}, {"b", json::Array{true, nullptr}}}};
+		std::ostringstream stream{};
+		json::serialize(stream, value, {.format = json::Format::CBOR});
+		CHECK(toBytes(std::move(stream).str()) == std::vector<unsigned char>{0xA2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0xF5, 0xF6});
+	}
+
+	SECTION("Numbers") {
+		const std::array<std::pair<json::Number, std::vector<unsigned char>>, 8> numbers{{
+			{0.0, {0x00}},
+			{23.0, {0x17}},
+			{24.0, {0x18, 0x18}},
+			{1000.0, {0x19, 0x03, 0xE8}},
+			{-1.0, {0x20}},
+			{-1000.0, {0x39, 0x03, 0xE7}},
+			{1.5, {0xFA, 0x3F, 0xC0, 0x00, 0x00}},
+			{1.1, {0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A}},
+		}};
+		for (const auto& [number, expectedBytes] : numbers) {
+			std::ostringstream stream{};
+			json::serialize(stream, number, {.format = json::Format::CBOR});
+			const std::string bytes = std::move(stream).str();
+			CHECK(toBytes(bytes) == expectedBytes);
+			json::Number result{};
+			json::deserialize(bytes, result, {.format = json::Format::CBOR});
+			CHECK(result == number);
+		}
+	}
+
+	SECTION("Round trip") {
+		struct Item {
+			int id;
+			float weight;
+			bool enabled;
+		};
+		const std::vector<Item> itemsA{{1, 0.5f, true}, {-300000, 1.25f, false}};
+		std::ostringstream streamA{};
+		json::serialize(streamA, itemsA, {.format = json::Format::CBOR});
+		std::vector<Item> itemsB{};
+		json::deserialize(std::move(streamA).str(), itemsB, {.format = json::Format::CBOR});
+		REQUIRE(itemsB.size() == 2);
+		CHECK(itemsB[0].id == 1);
+		CHECK(itemsB[0].weight == 0.5f);
+		CHECK(itemsB[0].enabled);
+		CHECK(itemsB[1].id == -300000);
+		CHECK(itemsB[1].weight == 1.25f);
+		CHECK(!itemsB[1].enabled);
+
+		const std::vector<std::optional<std::string>> stringsA{"first", std::nullopt, ""};
+		std::string bytes{};
+		json::Writer{bytes, {.format = json::Format::CBOR}}.serialize(stringsA);
+		std::vector<std::optional<std::string>> stringsB{};
+		json::deserialize(bytes, stringsB, {.format = json::Format::CBOR});
+		CHECK(stringsA == stringsB);
+
+		const json::Value valueA{json::Object{
+			{"string", "text \"with\" escapes\n"},
+			{"numbers", json::Array{0, -0.0, 1e300, std::numeric_limits<double>::infinity(), -123456789012}},
+			{"nested", json::Object{{"empty", json::Object{}}, {"null", nullptr}}},
+		}};
+		std::ostringstream streamB{};
+		json::serialize(streamB, valueA, {.format = json::Format::CBOR});
+		std::istringstream input{std::move(streamB).str()};
+		json::Value valueB{};
+		json::deserialize(input, valueB, {.format = json::Format::CBOR});
+		CHECK(valueA == valueB);
+	}
+
+	SECTION("Decoding features that are never encoded") {
+		json::Value value{};
+		json::deserialize(std::string_view{"\xF9\x3C\x00", 3}, value, {.format = json::Format::CBOR});
+		CHECK(value == json::Value{1.0});
+		json::deserialize(std::string_view{"\x9F\x01\x9F\xFF\xC1\x02\xFF", 7}, value, {.format = json::Format::CBOR});
+		CHECK(value == json::Value{json::Array{1, json::Array{}, 2}});
+		json::deserialize(std::string_view{"\xBF\x7F\x61\x61\x62\x62\x63\xFF\xF7\xFF", 10}, value, {.format = json::Format::CBOR});
+		CHECK(value == json::Value{json::Object{{"abc", nullptr}}});
+	}
+
+	SECTION("Truncated input") {
+		json::Value value{};
+		CHECK_THROWS_AS(json::deserialize(std::string_view{"\x82\x01", 2}, value, {.format = json::Format::CBOR}), json::Error);
+		CHECK_THROWS_AS(json::deserialize(std::string_view{"\x63\x61\x62", 3}, value, {.format = json::Format::CBOR}), json::Error);
+		CHECK_THROWS_AS(json::deserialize(std::string_view{"\x19\x03", 2}, value, {.format = json::Format::CBOR}), json::Error);
+		CHECK_THROWS_AS(json::deserialize(std::string_view{"\xC0", 1}, value, {.format = json::Format::CBOR}), json::Error);
+		CHECK_THROWS_AS(json::deserialize(std::string_view{"\x81\xC1", 2}, value, {.format = json::Format::CBOR}), json::Error);
+		CHECK_THROWS_AS(json::deserialize(std::string_view{"\xD9", 1}, value, {.format = json::Format::CBOR}), json::Error);
+	}
+}
+
+TEST_CASE("Serialize named aggregates", "[json]") {
+	const NamedPlayer playerA{.name = "Donut", .health = 80, .position{.x = 1.5f, .y = -2.0f}, .items{"sword"}};
+
+	SECTION("Output") {
+		std::ostringstream compactStream{};
+		json::serialize(compactStream, playerA, {.prettyPrint = false});
+		CHECK(std::move(compactStream).str() == R"({"name":"Donut","health":80,"position":{"x":1.5,"y":-2},"items":["sword"]})");
+		std::ostringstream prettyStream{};
+		json::serialize(prettyStream, playerA.position);
+		CHECK(std::move(prettyStream).str() == R"({ "x": 1.5, "y": -2 })");
+	}
+
+	SECTION("Round trip") {
+		for (const json::Format format : {json::Format::JSON, json::Format::CBOR}) {
+			std::ostringstream stream{};
+			json::serialize(stream, playerA, {.format = format});
+			NamedPlayer playerB{};
+			json::deserialize(std::move(stream).str(), playerB, {.format = format});
+			CHECK(playerB.name == playerA.name);
+			CHECK(playerB.health == playerA.health);
+			CHECK(playerB.position.x == playerA.position.x);
+			CHECK(playerB.position.y == playerA.position.y);
+			CHECK(playerB.items == playerA.items);
+		}
+	}
+
+	SECTION("Properties in any order, unknown properties and missing fields") {
+		NamedPlayer playerB{.name = "Unchanged", .health = 100, .position{}, .items{}};
+		json::deserialize(R"({position: {y: 3, x: 4}, unknown: {nested: [1, {health: 5}]}, health: 7, 'extra': null,})", playerB);
+		CHECK(playerB.name == "Unchanged");
+		CHECK(playerB.health == 7);
+		CHECK(playerB.position.x == 4.0f);
+		CHECK(playerB.position.y == 3.0f);
+		CHECK(playerB.items.empty());
+	}
+
+	SECTION("Many fields") {
+		ManyNamedFields fields{};
+		json::deserialize(R"({"f19": 19, "f3": 3, "f10": 10, "f1": 1, "f0": 0, "f11": 11, "f2": 2, "f9": 9, "f100": 100})", fields);
+		CHECK(fields.f0 == 0);
+		CHECK(fields.f1 == 1);
+		CHECK(fields.f2 == 2);
+		CHECK(fields.f3 == 3);
+		CHECK(fields.f9 == 9);
+		CHECK(fields.f10 == 10);
+		CHECK(fields.f11 == 11);
+		CHECK(fields.f19 == 19);
+		CHECK(fields.f18 == 0);
+	}
+
+	SECTION("Invalid input") {
+		NamedPoint point{};
+		CHECK_THROWS_AS(json::deserialize("[1, 2]", point), json::Error);
+		CHECK_THROWS_AS(json::deserialize(R"({"x": 1 "y": 2})", point), json::Error);
+		CHECK_THROWS_AS(json::deserialize(R"({"x": "one"})", point), json::Error);
+	}
+}
+
+TEST_CASE("Parse incrementally", "[json]") {
+	SECTION("Chunks split anywhere") {
+		const std::string_view input =
+			"{\r\n  // Comment \xC3\xA5\r\n  name: 'D\\u00f6nut \xC3\xA5',\r\n  \"values\": [1.5e3, -0x1F, true, null, -Infinity, /* * */ [], {},],\r\n}\r\n";
+		const std::string_view expectedEvents =
+			"1:1 {\n"
+			"3:3 name:\n"
+			"3:9 \"D\xC3\xB6nut \xC3\xA5\"\n"
+			"4:3 values:\n"
+			"4:13 [\n"
+			"4:14 1500\n"
+			"4:21 -31\n"
+			"4:28 true\n"
+			"4:34 null\n"
+			"4:40 -inf\n"
+			"4:59 [\n"
+			"4:60 ]\n"
+			"4:63 {\n"
+			"4:64 }\n"
+			"4:66 ]\n"
+			"5:1 }\n";
+		for (std::size_t chunkSize = 1; chunkSize <= input.size(); ++chunkSize) {
+			EventLog log{};
+			json::IncrementalParser parser{log};
+			for (std::size_t offset = 0; offset < input.size(); offset += chunkSize) {
+				parser.parse(input.substr(offset, chunkSize));
+			}
+			parser.finish();
+			CHECK(log.events == expectedEvents);
+		}
+	}
+
+	SECTION("Events are reported as soon as their tokens are complete") {
+		EventLog log{};
+		json::IncrementalParser parser{log};
+		parser.parse("[tr");
+		CHECK(log.events == "1:1 [\n");
+		parser.parse("ue, 12");
+		CHECK(log.events == "1:1 [\n1:2 true\n");
+		parser.parse("3]");
+		CHECK(log.events == "1:1 [\n1:2 true\n1:8 123\n1:11 ]\n");
+		parser.finish();
+	}
+
+	SECTION("Multiple top-level values") {
+		EventLog log{};
+		json::IncrementalParser parser{log, {.multipleTopLevelValues = true}};
+		parser.parse("1\n{\"a\": 2}\n[3");
+		parser.parse("]\n");
+		parser.finish();
+		CHECK(log.events == "1:1 1\n2:1 {\n2:2 a:\n2:7 2\n2:8 }\n3:1 [\n3:2 3\n3:3 ]\n");
+
+		parser.parse("4");
+		parser.finish();
+		CHECK(log.events.ends_with("1:1 4\n"));
+	}
+
+	SECTION("Invalid or incomplete input") {
+		for (const std::string_view input : {"[1, 2", "{\"a\" 1}", "1 2", "\"abc", "", "[1 2]", "{a: 1,, }", "/ 1"}) {
+			EventLog log{};
+			json::IncrementalParser parser{log};
+			CHECK_THROWS_AS(([&] {
+				parser.parse(input);
+				parser.finish();
+			}()),
+				json::Error);
+		}
+	}
+}
+
+TEST_CASE("Query paths", "[json]") {
+	const std::string_view jsonString = R"({
+		"players": [
+			{"name": "a", "stats": {"kills": 3, "deaths": 1}},
+			{"name": "b", "stats": {"deaths": 2}},
+			{"name": "c", "stats": {"kills": 5}},
+		],
+		"a/b": {"m~n": true},
+		"": 0,
+	})";
+	const json::Value root = json::Value::parse(jsonString);
+	const json::Cursor cursor{jsonString};
+
+	const auto getNumbers = [](const json::Query& query, const json::Value& value) -> std::vector<double> {
+		std::vector<double> result{};
+		query.forEachMatch(value, [&](const json::Value& match) -> void { result.push_back(match.get<json::Number>()); });
+		return result;
+	};
+
+	const auto getCursorNumbers = [](const json::Query& query, const json::Cursor& value) -> std::vector<double> {
+		std::vector<double> result{};
+		query.forEachMatch(value, [&](const json::Cursor& match) -> void { result.push_back(match.get<json::Number>()); });
+		return result;
+	};
+
+	SECTION("Wildcards") {
+		for (const std::string_view path : {"/players/*/stats/kills", "players.*.stats.kills"}) {
+			const json::Query query{path};
+			CHECK(getNumbers(query, root) == std::vector<double>{3.0, 5.0});
+			CHECK(getCursorNumbers(query, cursor) == std::vector<double>{3.0, 5.0});
+		}
+		CHECK(json::Query{"/players/*/stats/*"}.findAll(root).size() == 4);
+		CHECK(json::Query{"/*"}.findAll(cursor).size() == 3);
+	}
+
+	SECTION("Indices and escapes") {
+		const json::Query query{"/players/2/stats/kills"};
+		REQUIRE(query.find(root));
+		CHECK(query.find(root)->get<json::Number>() == 5.0);
+		CHECK(getCursorNumbers(query, cursor) == std::vector<double>{5.0});
+		CHECK(json::Query{"players.1.name"}.find(root)->get<json::String>() == "b");
+		CHECK(json::Query{"/a~1b/m~0n"}.find(root)->get<json::Boolean>());
+		CHECK(json::Query{"/a~1b/m~0n"}.findAll(cursor).front().get<json::Boolean>());
+		CHECK(json::Query{"/"}.find(root)->get<json::Number>() == 0.0);
+		CHECK(json::Query{""}.find(root) == &root);
+	}
+
+	SECTION("Missing values") {
+		for (const std::string_view path : {"/players/3", "/players/-", "/players/01", "/players/x", "/players/0/name/0", "/missing/*", "players.0.stats.kills.*"}) {
+			const json::Query query{path};
+			CHECK(query.find(root) == nullptr);
+			CHECK(query.findAll(cursor).empty());
+		}
+	}
+
+	SECTION("Invalid pointers") {
+		CHECK_THROWS_AS(json::Query{"/a~2"}, std::invalid_argument);
+		CHECK_THROWS_AS(json::Query{"/a~"}, std::invalid_argument);
+	}
+
+	SECTION("Batches") {
+		std::vector<std::string> strings{};
+		std::vector<json::Value> values{};
+		for (int i = 0; i < 37; ++i) {
+			strings.push_back(fmt::format(R"({{"players": [{{"stats": {{"kills": {}}}}}, {{"stats": {{"kills": {}}}}}]}})", i, -i));
+			values.push_back(json::Value::parse(strings.back()));
+		}
+		std::vector<json::Cursor> cursors{};
+		for (const std::string& string : strings) {
+			cursors.emplace_back(string);
+		}
+		const json::Query query{"/players/*/stats/kills"};
+		for (const std::size_t threadCount : std::array<std::size_t, 3>{1, 4, 0}) {
+			const std::vector<std::vector<const json::Value*>> valueResults = query.findAllInBatch(values, {.threadCount = threadCount});
+			const std::vector<std::vector<json::Cursor>> cursorResults = query.findAllInBatch(cursors, {.threadCount = threadCount});
+			REQUIRE(valueResults.size() == values.size());
+			REQUIRE(cursorResults.size() == cursors.size());
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				REQUIRE(valueResults[i].size() == 2);
+				REQUIRE(cursorResults[i].size() == 2);
+				CHECK(valueResults[i][1]->get<json::Number>() == -static_cast<double>(i));
+				CHECK(cursorResults[i][0].get<json::Number>() == static_cast<double>(i));
+			}
+		}
+		CHECK(query.findAllInBatch(std::span<const json::Value>{}, {.threadCount = 4}).empty());
+		CHECK_THROWS_AS(query.findAllInBatch(std::vector<json::Cursor>{json::Cursor{"{\"players\": [1, }"}}, {.threadCount = 2}), json::Error);
+	}
+}
+
 // NOLINTEND(misc-use-anonymous-namespace)
 
 /*
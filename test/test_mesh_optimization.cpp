@@ -0,0 +1,222 @@
+#include <donut/graphics/MeshOptimization.hpp>
+#include <donut/math.hpp>
+
+#include <algorithm>                    // std::sort, std::rotate, std::min_element, std::shuffle, std::copy
+#include <array>                        // std::array
+#include <catch2/catch_approx.hpp>      // Catch::Approx
+#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK, REQUIRE
+#include <cstddef>                      // std::size_t, std::ptrdiff_t
+#include <cstdint>                      // std::uint32_t
+#include <random>                       // std::mt19937
+#include <span>                         // std::span
+#include <vector>                       // std::vector
+
+namespace gfx = donut::graphics;
+
+namespace {
+
+struct GridMesh {
+	std::vector<donut::vec3> positions{};
+	std::vector<std::uint32_t> indices{};
+};
+
+[[nodiscard]] GridMesh makeGridMesh(std::size_t size) {
+	GridMesh mesh{};
+	for (std::size_t y = 0; y <= size; ++y) {
+		for (std::size_t x = 0; x <= size; ++x) {
+			mesh.positions.push_back({static_cast<float>(x), static_cast<float>(y), 0.0f});
+		}
+	}
+	for (std::size_t y = 0; y < size; ++y) {
+		for (std::size_t x = 0; x < size; ++x) {
+			const std::uint32_t a = static_cast<std::uint32_t>(y * (size + 1) + x);
+			const std::uint32_t b = a + 1;
+			const std::uint32_t c = a + static_cast<std::uint32_t>(size + 1);
+			const std::uint32_t d = c + 1;
+			mesh.indices.insert(mesh.indices.end(), {a, b, d, a, d, c});
+		}
+	}
+	return mesh;
+}
+
+void shuffleTriangles(std::span<std::uint32_t> indices) {
+	std::vector<std::array<std::uint32_t, 3>> triangles{};
+	for (std::size_t i = 0; i + 3 <= indices.size(); i += 3) {
+		triangles.push_back({indices[i], indices[i + 1], indices[i + 2]});
+	}
+	std::mt19937 generator{12345}; // NOLINT(cert-msc32-c, cert-msc51-cpp)
+	std::shuffle(triangles.begin(), triangles.end(), generator);
+	for (std::size_t i = 0; i < triangles.size(); ++i) {
+		std::copy(triangles[i].begin(), triangles[i].end(), indices.begin() + static_cast<std::ptrdiff_t>(i * 3));
+	}
+}
+
+// Sorted list of triangles, each rotated so that its smallest index comes first, for comparing triangle lists while respecting winding order.
+[[nodiscard]] std::vector<std::array<std::uint32_t, 3>> getCanonicalTriangles(std::span<const std::uint32_t> indices) {
+	std::vector<std::array<std::uint32_t, 3>> triangles{};
+	for (std::size_t i = 0; i + 3 <= indices.size(); i += 3) {
+		std::array<std::uint32_t, 3> triangle{indices[i], indices[i + 1], indices[i + 2]};
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+} // namespace
+
+// NOLINTBEGIN(misc-use-anonymous-namespace)
+
+TEST_CASE("Analyze vertex cache", "[mesh_optimization]") {
+	SECTION("Empty") {
+		const gfx::VertexCacheStatistics statistics = gfx::analyzeVertexCache({}, 0);
+		CHECK(statistics.averageCacheMissRatio == 0.0f);
+		CHECK(statistics.averageTransformToVertexRatio == 0.0f);
+	}
+
+	SECTION("Single triangle") {
+		const std::array<std::uint32_t, 3> indices{0, 1, 2};
+		const gfx::VertexCacheStatistics statistics = gfx::analyzeVertexCache(indices, 3);
+		CHECK(statistics.averageCacheMissRatio == Catch::Approx(3.0f));
+		CHECK(statistics.averageTransformToVertexRatio == Catch::Approx(1.0f));
+	}
+
+	SECTION("Shared edge") {
+		const std::array<std::uint32_t, 6> indices{0, 1, 2, 2, 1, 3};
+		const gfx::VertexCacheStatistics statistics = gfx::analyzeVertexCache(indices, 4);
+		CHECK(statistics.averageCacheMissRatio == Catch::Approx(2.0f));
+		CHECK(statistics.averageTransformToVertexRatio == Catch::Approx(1.0f));
+	}
+
+	SECTION("Eviction") {
+		const std::array<std::uint32_t, 9> indices{0, 1, 2, 3, 4, 5, 0, 1, 2};
+		CHECK(gfx::analyzeVertexCache(indices, 6, 6).averageCacheMissRatio == Catch::Approx(2.0f));
+		CHECK(gfx::analyzeVertexCache(indices, 6, 5).averageCacheMissRatio == Catch::Approx(3.0f));
+		CHECK(gfx::analyzeVertexCache(indices, 6, 5).averageTransformToVertexRatio == Catch::Approx(1.5f));
+	}
+}
+
+TEST_CASE("Optimize vertex cache", "[mesh_optimization]") {
+	GridMesh mesh = makeGridMesh(32);
+	shuffleTriangles(mesh.indices);
+	const std::vector<std::array<std::uint32_t, 3>> originalTriangles = getCanonicalTriangles(mesh.indices);
+	const gfx::VertexCacheStatistics before = gfx::analyzeVertexCache(mesh.indices, mesh.positions.size());
+
+	gfx::optimizeVertexCache(mesh.indices, mesh.positions.size());
+	const gfx::VertexCacheStatistics after = gfx::analyzeVertexCache(mesh.indices, mesh.positions.size());
+
+	CHECK(getCanonicalTriangles(mesh.indices) == originalTriangles);
+	CHECK(before.averageCacheMissRatio > 2.0f);
+	CHECK(after.averageCacheMissRatio < 0.8f);
+	CHECK(after.averageTransformToVertexRatio < 1.5f);
+
+	SECTION("Trailing indices are left untouched") {
+		std::vector<std::uint32_t> indices{0, 1, 2, 2, 1, 3, 3, 0};
+		gfx::optimizeVertexCache(indices, 4);
+		CHECK(indices[6] == 3);
+		CHECK(indices[7] == 0);
+		CHECK(getCanonicalTriangles(std::span{indices}.first(6)) == getCanonicalTriangles(std::array<std::uint32_t, 6>{0, 1, 2, 2, 1, 3}));
+	}
+}
+
+TEST_CASE("Optimize overdraw", "[mesh_optimization]") {
+	GridMesh mesh = makeGridMesh(32);
+	shuffleTriangles(mesh.indices);
+	gfx::optimizeVertexCache(mesh.indices, mesh.positions.size());
+	const std::vector<std::array<std::uint32_t, 3>> originalTriangles = getCanonicalTriangles(mesh.indices);
+	const gfx::VertexCacheStatistics before = gfx::analyzeVertexCache(mesh.indices, mesh.positions.size());
+
+	gfx::optimizeOverdraw(mesh.indices, mesh.positions, 1.05f);
+	const gfx::VertexCacheStatistics after = gfx::analyzeVertexCache(mesh.indices, mesh.positions.size());
+
+	CHECK(getCanonicalTriangles(mesh.indices) == originalTriangles);
+	CHECK(after.averageCacheMissRatio <= before.averageCacheMissRatio * 1.25f);
+
+	SECTION("Outward-facing clusters first") {
+		// Two parallel quads separated along the z axis, where the one facing the center of the mesh is listed first.
+		const std::vector<donut::vec3> positions{
+			{0.0f, 0.0f, 1.0f},
+			{1.0f, 0.0f, 1.0f},
+			{0.0f, 1.0f, 1.0f},
+			{1.0f, 1.0f, 1.0f},
+			{0.0f, 0.0f, -1.0f},
+			{1.0f, 0.0f, -1.0f},
+			{0.0f, 1.0f, -1.0f},
+			{1.0f, 1.0f, -1.0f},
+		};
+		std::vector<std::uint32_t> indices{0, 2, 1, 1, 2, 3, 4, 6, 5, 5, 6, 7};
+		gfx::optimizeOverdraw(indices, positions, 1.0f);
+		CHECK(indices == std::vector<std::uint32_t>{4, 6, 5, 5, 6, 7, 0, 2, 1, 1, 2, 3});
+
+		std::vector<std::uint32_t> sortedIndices{0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7};
+		gfx::optimizeOverdraw(sortedIndices, positions, 1.0f);
+		CHECK(sortedIndices == std::vector<std::uint32_t>{0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7});
+	}
+}
+
+TEST_CASE("Simplify mesh", "[mesh_optimization]") {
+	SECTION("Flat grid") {
+		const GridMesh mesh = makeGridMesh(16);
+		const std::size_t targetIndexCount = mesh.indices.size() / 4;
+		const gfx::MeshSimplificationResult result = gfx::simplifyMesh(mesh.indices, mesh.positions, {.targetIndexCount = targetIndexCount});
+		CHECK(result.indices.size() % 3 == 0);
+		CHECK(result.indices.size() <= targetIndexCount);
+		CHECK(result.indices.size() > 0);
+		CHECK(result.error == Catch::Approx(0.0f).margin(1e-4f));
+		for (std::size_t i = 0; i < result.indices.size(); i += 3) {
+			const donut::vec3 a = mesh.positions[result.indices[i]];
+			const donut::vec3 b = mesh.positions[result.indices[i + 1]];
+			const donut::vec3 c = mesh.positions[result.indices[i + 2]];
+			CHECK(cross(b - a, c - a).z > 0.0f);
+		}
+	}
+
+	SECTION("Border is preserved") {
+		const GridMesh mesh = makeGridMesh(8);
+		const gfx::MeshSimplificationResult result = gfx::simplifyMesh(mesh.indices, mesh.positions, {.targetIndexCount = 0});
+		std::vector<bool> used(mesh.positions.size(), false);
+		for (const std::uint32_t index : result.indices) {
+			used[index] = true;
+		}
+		for (std::size_t i = 0; i < mesh.positions.size(); ++i) {
+			const donut::vec3 position = mesh.positions[i];
+			if (position.x == 0.0f || position.y == 0.0f || position.x == 8.0f || position.y == 8.0f) {
+				CHECK(used[i]);
+			}
+		}
+	}
+
+	SECTION("Max error") {
+		GridMesh mesh = makeGridMesh(8);
+		for (donut::vec3& position : mesh.positions) {
+			position.z = 0.1f * (position.x * position.x + position.y * position.y);
+		}
+		const gfx::MeshSimplificationResult result = gfx::simplifyMesh(mesh.indices, mesh.positions, {.targetIndexCount = 0, .maxError = 0.001f});
+		CHECK(result.indices.size() == mesh.indices.size());
+		CHECK(result.error <= 0.001f);
+
+		const gfx::MeshSimplificationResult coarseResult = gfx::simplifyMesh(mesh.indices, mesh.positions, {.targetIndexCount = mesh.indices.size() / 2});
+		CHECK(coarseResult.indices.size() <= mesh.indices.size() / 2);
+		CHECK(coarseResult.error > 0.001f);
+	}
+}
+
+TEST_CASE("Optimize vertex fetch", "[mesh_optimization]") {
+	std::vector<donut::vec3> vertices{
+		{0.0f, 0.0f, 0.0f},
+		{1.0f, 0.0f, 0.0f},
+		{2.0f, 0.0f, 0.0f},
+		{3.0f, 0.0f, 0.0f},
+		{4.0f, 0.0f, 0.0f},
+	};
+	std::vector<std::uint32_t> indices{3, 1, 4, 4, 1, 0};
+	gfx::optimizeVertexFetch(std::span{vertices}, std::span{indices});
+	CHECK(indices == std::vector<std::uint32_t>{0, 1, 2, 2, 1, 3});
+	CHECK(vertices[0].x == 3.0f);
+	CHECK(vertices[1].x == 1.0f);
+	CHECK(vertices[2].x == 4.0f);
+	CHECK(vertices[3].x == 0.0f);
+	CHECK(vertices[4].x == 2.0f);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
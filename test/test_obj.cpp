@@ -0,0 +1,211 @@
+#include <donut/obj.hpp>
+
+#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK, REQUIRE, FAIL
+#include <cmath>                        // std::signbit
+#include <cstddef>                      // std::size_t
+#include <fmt/format.h>                 // fmt::format_to
+#include <iterator>                     // std::back_inserter
+#include <limits>                       // std::numeric_limits
+#include <span>                         // std::span
+#include <string>                       // std::string
+#include <string_view>                  // std::string_view
+
+namespace obj = donut::obj;
+
+namespace {
+
+constexpr std::string_view CUBE_OBJ = R"(# Cube
+mtllib cube.mtl
+o Cube
+v -1.0 -1.0 -1.0
+v 1.0 -1.0 -1.0
+v 1.0 1.0 -1.0
+v -1.0 1.0 -1.0
+v -1.0 -1.0 1.0
+v 1.0 -1.0 1.0
+v 1.0 1.0 1.0
+v -1.0 1.0 1.0
+vt 0.0 0.0
+vt 1.0 0.0
+vt 1.0 1.0
+vt 0.0 1.0
+vn 0.0 0.0 -1.0
+vn 0.0 0.0 1.0
+g Front
+usemtl Red
+f 1/1/1 2/2/1 3/3/1 4/4/1
+usemtl Green
+f 5/1/2 6/2/2 7/3/2
+f -2/-1/-1 -1/-2/-1 5/1/2
+o Floor
+v 0.5e1 -2.5E-1 +3
+f 1 2 -1
+)";
+
+[[nodiscard]] std::string generateObj(std::size_t targetSize) {
+	std::string result{};
+	result.reserve(targetSize + 256);
+	fmt::format_to(std::back_inserter(result), "mtllib grid.mtl\n");
+	for (std::size_t i = 0; result.size() < targetSize; ++i) {
+		if (i % 20000 == 10000) {
+			fmt::format_to(std::back_inserter(result), "o Grid{}\n", i / 20000);
+		}
+		if (i % 7000 == 3500) {
+			fmt::format_to(std::back_inserter(result), "g Rows{}\n", i / 7000);
+		}
+		if (i % 3000 == 0) {
+			fmt::format_to(std::back_inserter(result), "usemtl Material{}\n", i / 3000 % 4);
+		}
+		const float x = static_cast<float>(i % 1024) * 0.125f;
+		const float z = static_cast<float>(i / 1024) * 0.125f;
+		fmt::format_to(std::back_inserter(result), "v {:.6f} {:.6f} {:.6f}\nvt {:.6f} {:.6f}\nvn 0.000000 1.000000 0.000000\n", x, 0.0f, z, x / 128.0f, z / 128.0f);
+		if (i >= 1025 && i % 1024 != 0) {
+			if (i % 2 == 0) {
+				fmt::format_to(std::back_inserter(result), "f -1/-1/-1 -2/-2/-2 -1026/-1026/-1026 -1025/-1025/-1025\n");
+			} else {
+				fmt::format_to(std::back_inserter(result), "f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2} {3}/{3}/{3}\n", i + 1, i, i - 1024, i - 1023);
+			}
+		}
+	}
+	return result;
+}
+
+void checkFlatScene(const obj::FlatScene& scene, const obj::Scene& expected) {
+	CHECK(scene.materialLibraryFilenames == expected.materialLibraryFilenames);
+	CHECK(scene.vertices == expected.vertices);
+	CHECK(scene.textureCoordinates == expected.textureCoordinates);
+	CHECK(scene.normals == expected.normals);
+	REQUIRE(scene.objects.size() == expected.objects.size());
+	for (std::size_t objectIndex = 0; objectIndex < scene.objects.size(); ++objectIndex) {
+		const obj::FlatObject& object = scene.objects[objectIndex];
+		const obj::Object& expectedObject = expected.objects[objectIndex];
+		CHECK(scene.getString(object.name) == expectedObject.name);
+		REQUIRE(object.groupsEnd - object.groupsBegin == expectedObject.groups.size());
+		for (std::size_t groupIndex = object.groupsBegin; groupIndex < object.groupsEnd; ++groupIndex) {
+			const obj::FlatGroup& group = scene.groups[groupIndex];
+			const obj::Group& expectedGroup = expectedObject.groups[groupIndex - object.groupsBegin];
+			CHECK(scene.getString(group.name) == expectedGroup.name);
+			CHECK(scene.getString(group.materialName) == expectedGroup.materialName);
+			REQUIRE(group.facesEnd - group.facesBegin == expectedGroup.faces.size());
+			for (std::size_t faceIndex = group.facesBegin; faceIndex < group.facesEnd; ++faceIndex) {
+				const std::span<const obj::FaceVertex> face = scene.getFace(faceIndex);
+				const obj::Face& expectedFace = expectedGroup.faces[faceIndex - group.facesBegin];
+				REQUIRE(face.size() == expectedFace.vertices.size());
+				for (std::size_t i = 0; i < face.size(); ++i) {
+					CHECK(face[i].vertexIndex == expectedFace.vertices[i].vertexIndex);
+					CHECK(face[i].textureCoordinateIndex == expectedFace.vertices[i].textureCoordinateIndex);
+					CHECK(face[i].normalIndex == expectedFace.vertices[i].normalIndex);
+				}
+			}
+		}
+	}
+}
+
+} // namespace
+
+// NOLINTBEGIN(misc-use-anonymous-namespace)
+
+TEST_CASE("Parse OBJ scene", "[obj]") {
+	const obj::Scene scene = obj::Scene::parse(CUBE_OBJ);
+	REQUIRE(scene.materialLibraryFilenames.size() == 1);
+	CHECK(scene.materialLibraryFilenames[0] == "cube.mtl");
+	REQUIRE(scene.vertices.size() == 9);
+	CHECK(scene.vertices[8] == donut::vec3{5.0f, -0.25f, 3.0f});
+	REQUIRE(scene.objects.size() == 2);
+	CHECK(scene.objects[0].name == "Cube");
+	REQUIRE(scene.objects[0].groups.size() == 3);
+	CHECK(scene.objects[0].groups[1].name == "Front");
+	CHECK(scene.objects[0].groups[1].materialName == "Red");
+	CHECK(scene.objects[0].groups[2].materialName == "Green");
+	REQUIRE(scene.objects[0].groups[2].faces.size() == 2);
+	REQUIRE(scene.objects[0].groups[2].faces[1].vertices.size() == 3);
+	CHECK(scene.objects[0].groups[2].faces[1].vertices[0].vertexIndex == 6);
+	CHECK(scene.objects[0].groups[2].faces[1].vertices[0].textureCoordinateIndex == 3);
+	CHECK(scene.objects[0].groups[2].faces[1].vertices[1].normalIndex == 1);
+	CHECK(scene.objects[1].name == "Floor");
+	REQUIRE(scene.objects[1].groups.size() == 1);
+	REQUIRE(scene.objects[1].groups[0].faces.size() == 1);
+	CHECK(scene.objects[1].groups[0].faces[0].vertices[2].vertexIndex == 8);
+}
+
+TEST_CASE("Parse OBJ coordinates out of range", "[obj]") {
+	const obj::Scene scene = obj::Scene::parse("v 1e40 -1e40 1e-50\nv -0.0001e-42 123456789e35 0.00000000000000000000000000001e-30\n");
+	REQUIRE(scene.vertices.size() == 2);
+	CHECK(scene.vertices[0].x == std::numeric_limits<float>::infinity());
+	CHECK(scene.vertices[0].y == -std::numeric_limits<float>::infinity());
+	CHECK(scene.vertices[0].z == 0.0f);
+	CHECK(scene.vertices[1].x == 0.0f);
+	CHECK(std::signbit(scene.vertices[1].x));
+	CHECK(scene.vertices[1].y == std::numeric_limits<float>::infinity());
+	CHECK(scene.vertices[1].z == 0.0f);
+}
+
+TEST_CASE("Parse flat OBJ scene", "[obj]") {
+	const obj::Scene expected = obj::Scene::parse(CUBE_OBJ);
+
+	SECTION("Whole string") {
+		checkFlatScene(obj::FlatScene::parse(CUBE_OBJ), expected);
+	}
+
+	SECTION("Chunks of every size") {
+		for (std::size_t chunkSize = 1; chunkSize <= CUBE_OBJ.size(); ++chunkSize) {
+			obj::FlatSceneParser parser{};
+			for (std::size_t offset = 0; offset < CUBE_OBJ.size(); offset += chunkSize) {
+				parser.parse(CUBE_OBJ.substr(offset, chunkSize));
+			}
+			checkFlatScene(parser.finish(), expected);
+		}
+	}
+
+	SECTION("Missing final newline") {
+		obj::FlatSceneParser parser{};
+		parser.parse("v 1 2 3\nv 4 5");
+		parser.parse(" 6");
+		const obj::FlatScene scene = parser.finish();
+		REQUIRE(scene.vertices.size() == 2);
+		CHECK(scene.vertices[1] == donut::vec3{4.0f, 5.0f, 6.0f});
+	}
+
+	SECTION("Error line number") {
+		obj::FlatSceneParser parser{};
+		try {
+			parser.parse("v 1 2 3\r\nv 4 5 6\r");
+			parser.parse("\no \n");
+			(void)parser.finish();
+			FAIL("Expected an error.");
+		} catch (const obj::Error& e) {
+			CHECK(e.lineNumber == 3);
+		}
+	}
+}
+
+TEST_CASE("Parse flat OBJ scene in parallel", "[obj]") {
+	const std::string objString = generateObj(std::size_t{5} * 1024 * 1024);
+	const obj::Scene expected = obj::Scene::parse(objString);
+
+	SECTION("Split at line boundaries") {
+		for (const std::size_t threadCount : {std::size_t{2}, std::size_t{3}, std::size_t{4}, std::size_t{7}}) {
+			checkFlatScene(obj::FlatScene::parse(objString, {.threadCount = threadCount}), expected);
+		}
+	}
+
+	SECTION("Error line number") {
+		const std::size_t errorPosition = objString.find('\n', objString.size() * 2 / 3) + 1;
+		const std::string invalidObjString = objString.substr(0, errorPosition) + "usemtl \n" + objString.substr(errorPosition);
+		std::size_t expectedLineNumber = 0;
+		try {
+			(void)obj::Scene::parse(invalidObjString);
+		} catch (const obj::Error& e) {
+			expectedLineNumber = e.lineNumber;
+		}
+		REQUIRE(expectedLineNumber != 0);
+		try {
+			(void)obj::FlatScene::parse(invalidObjString, {.threadCount = 4});
+			FAIL("Expected an error.");
+		} catch (const obj::Error& e) {
+			CHECK(e.lineNumber == expectedLineNumber);
+		}
+	}
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
@@ -0,0 +1,86 @@
+#include <donut/graphics/VertexPacking.hpp>
+#include <donut/math.hpp>
+
+#include <catch2/catch_approx.hpp>      // Catch::Approx
+#include <catch2/catch_test_macros.hpp> // TEST_CASE, SECTION, CHECK
+#include <cmath>                        // std::isinf, std::isnan
+#include <cstdint>                      // std::uint32_t
+#include <limits>                       // std::numeric_limits
+
+namespace gfx = donut::graphics;
+
+// NOLINTBEGIN(misc-use-anonymous-namespace)
+
+TEST_CASE("Normalized vertex attributes", "[vertex_packing]") {
+	SECTION("Unsigned") {
+		const gfx::Normalized<donut::u16vec4> packed = gfx::Normalized<donut::u16vec4>::pack(donut::vec4{0.0f, 1.0f, 0.5f, 2.0f});
+		CHECK(packed.value.x == 0);
+		CHECK(packed.value.y == 65535);
+		CHECK(packed.value.z == 32768);
+		CHECK(packed.value.w == 65535);
+		const donut::vec4 unpacked = packed.unpack();
+		CHECK(unpacked.x == 0.0f);
+		CHECK(unpacked.y == 1.0f);
+		CHECK(unpacked.z == Catch::Approx(0.5f).margin(1.0f / 65535.0f));
+		CHECK(unpacked.w == 1.0f);
+	}
+
+	SECTION("Signed") {
+		const gfx::Normalized<donut::i8vec2> packed = gfx::Normalized<donut::i8vec2>::pack(donut::vec2{-1.0f, -2.0f});
+		CHECK(packed.value.x == -127);
+		CHECK(packed.value.y == -127);
+		CHECK(gfx::Normalized<donut::i8vec2>{.value{-128, 64}}.unpack().x == -1.0f);
+		CHECK(gfx::Normalized<donut::i8vec2>{.value{-128, 64}}.unpack().y == Catch::Approx(64.0f / 127.0f));
+	}
+}
+
+TEST_CASE("Packed half-precision vertex attributes", "[vertex_packing]") {
+	SECTION("Exact values") {
+		const gfx::PackedHalf2x16 packed = gfx::PackedHalf2x16::pack(donut::vec2{1.0f, -2.0f});
+		CHECK(packed.value == 0xC0003C00u);
+		CHECK(packed.unpack().x == 1.0f);
+		CHECK(packed.unpack().y == -2.0f);
+		CHECK(gfx::PackedHalf2x16::pack(donut::vec2{0.0f, 65504.0f}).value == 0x7BFF0000u);
+	}
+
+	SECTION("Rounding") {
+		for (const float value : {0.1f, 0.333f, 0.75f, 3.14159f, -0.6f, 100.37f}) {
+			const float unpacked = gfx::PackedHalf2x16::pack(donut::vec2{value, 0.0f}).unpack().x;
+			CHECK(unpacked == Catch::Approx(value).epsilon(1.0f / 2048.0f));
+		}
+		// Halfway between 1 and the next representable value 1 + 2^-10, which rounds to even.
+		CHECK(gfx::PackedHalf2x16::pack(donut::vec2{1.0f + 1.0f / 2048.0f, 0.0f}).value == 0x3C00u);
+		CHECK(gfx::PackedHalf2x16::pack(donut::vec2{1.0f + 3.0f / 2048.0f, 0.0f}).value == 0x3C02u);
+	}
+
+	SECTION("Subnormal values") {
+		const float smallest = 1.0f / 16777216.0f; // 2^-24
+		CHECK(gfx::PackedHalf2x16::pack(donut::vec2{smallest, 0.0f}).value == 0x0001u);
+		CHECK(gfx::PackedHalf2x16::pack(donut::vec2{smallest * 3.0f, 0.0f}).unpack().x == smallest * 3.0f);
+		CHECK(gfx::PackedHalf2x16::pack(donut::vec2{smallest * 0.25f, 0.0f}).value == 0x0000u);
+	}
+
+	SECTION("Special values") {
+		CHECK(std::isinf(gfx::PackedHalf2x16::pack(donut::vec2{70000.0f, 0.0f}).unpack().x));
+		CHECK(std::isinf(gfx::PackedHalf2x16::pack(donut::vec2{-std::numeric_limits<float>::infinity(), 0.0f}).unpack().x));
+		CHECK(std::isnan(gfx::PackedHalf2x16::pack(donut::vec2{std::numeric_limits<float>::quiet_NaN(), 0.0f}).unpack().x));
+	}
+}
+
+TEST_CASE("Packed 10:10:10:2 vertex attributes", "[vertex_packing]") {
+	const gfx::PackedSnorm3x10_1x2 packed = gfx::PackedSnorm3x10_1x2::pack(donut::vec4{1.0f, -1.0f, 0.0f, -1.0f});
+	CHECK(packed.value == (0x1FFu | (0x201u << 10) | (0x0u << 20) | (0x3u << 30)));
+	const donut::vec4 unpacked = packed.unpack();
+	CHECK(unpacked.x == 1.0f);
+	CHECK(unpacked.y == -1.0f);
+	CHECK(unpacked.z == 0.0f);
+	CHECK(unpacked.w == -1.0f);
+
+	const donut::vec4 direction = gfx::PackedSnorm3x10_1x2::pack(donut::vec4{0.6f, -0.48f, 0.64f, 1.0f}).unpack();
+	CHECK(direction.x == Catch::Approx(0.6f).margin(0.5f / 511.0f));
+	CHECK(direction.y == Catch::Approx(-0.48f).margin(0.5f / 511.0f));
+	CHECK(direction.z == Catch::Approx(0.64f).margin(0.5f / 511.0f));
+	CHECK(direction.w == 1.0f);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
@@ -0,0 +1,98 @@
+/**
+ * \file model_compiler.cpp
+ *
+ * \details Command-line tool that converts a model file to the compiled binary
+ *          model format, see donut::graphics::Model::compile().
+ *
+ *          Usage: donut-model-compiler [options] <input-directory> <input-filepath> <output-directory> <output-filepath>
+ *
+ *          Options:
+ *          - --optimize-vertex-cache: Optimize the triangle and vertex order
+ *            of each object, see donut::graphics::ModelOptions.
+ *          - --optimize-overdraw: Also reorder triangles to reduce overdraw.
+ *            Implies --optimize-vertex-cache.
+ *          - --levels-of-detail=<count>: Generate simplified levels of detail
+ *            for each object, up to a total of <count> levels.
+ *          - --vertex-format=<format>: Store the vertices in the given format,
+ *            which is one of standard (default), compact or quantized, see
+ *            donut::graphics::ModelVertexFormat.
+ *
+ *          When optimizing, the average cache miss ratio (ACMR) of each object
+ *          before and after optimization is printed to the standard output.
+ *
+ *          The input filepath is a virtual filepath relative to the input
+ *          directory, and the output filepath is a virtual filepath relative to
+ *          the output directory. Any material libraries and texture filepaths
+ *          referenced by the input model are resolved relative to the input
+ *          model file, and the texture filepaths are stored as-is in the
+ *          compiled model.
+ */
+
+#include <donut/Filesystem.hpp>
+#include <donut/graphics/Model.hpp>
+
+#include <charconv>     // std::from_chars
+#include <cstddef>      // std::size_t
+#include <cstdio>       // stderr
+#include <exception>    // std::exception
+#include <fmt/format.h> // fmt::print
+#include <string>       // std::string
+#include <string_view>  // std::string_view
+#include <system_error> // std::errc
+#include <vector>       // std::vector
+
+int main(int argc, char* argv[]) {
+	std::vector<donut::graphics::ModelOptimizationStatistics> optimizationStatistics{};
+	donut::graphics::ModelOptions options{.optimizationStatistics = &optimizationStatistics};
+	int argumentIndex = 1;
+	for (; argumentIndex < argc && std::string_view{argv[argumentIndex]}.starts_with("--"); ++argumentIndex) {
+		if (const std::string_view option = argv[argumentIndex]; option == "--optimize-vertex-cache") {
+			options.optimizeVertexCache = true;
+		} else if (option == "--optimize-overdraw") {
+			options.optimizeVertexCache = true;
+			options.optimizeOverdraw = true;
+		} else if (option.starts_with("--levels-of-detail=")) {
+			const std::string_view value = option.substr(std::string_view{"--levels-of-detail="}.size());
+			if (const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), options.levelOfDetailCount);
+				error != std::errc{} || end != value.data() + value.size() || options.levelOfDetailCount == 0) {
+				fmt::print(stderr, "Invalid level of detail count \"{}\".\n", value);
+				return 1;
+			}
+		} else if (option == "--vertex-format=standard") {
+			options.vertexFormat = donut::graphics::ModelVertexFormat::STANDARD;
+		} else if (option == "--vertex-format=compact") {
+			options.vertexFormat = donut::graphics::ModelVertexFormat::COMPACT;
+		} else if (option == "--vertex-format=quantized") {
+			options.vertexFormat = donut::graphics::ModelVertexFormat::QUANTIZED;
+		} else {
+			fmt::print(stderr, "Unknown option \"{}\".\n", option);
+			return 1;
+		}
+	}
+	if (argc - argumentIndex != 4) {
+		fmt::print(stderr, "Usage: {} [options] <input-directory> <input-filepath> <output-directory> <output-filepath>\n", (argc > 0) ? argv[0] : "donut-model-compiler");
+		fmt::print(stderr, "Options: --optimize-vertex-cache, --optimize-overdraw, --levels-of-detail=<count>, --vertex-format=<standard|compact|quantized>\n");
+		return 1;
+	}
+	const char* const inputDirectory = argv[argumentIndex];
+	const char* const inputFilepath = argv[argumentIndex + 1];
+	const char* const outputDirectory = argv[argumentIndex + 2];
+	const char* const outputFilepath = argv[argumentIndex + 3];
+	try {
+		donut::Filesystem filesystem{argv[0], {.dataDirectory = inputDirectory}};
+		filesystem.setOutputDirectory(outputDirectory);
+		if (const std::string_view outputFilepathView = outputFilepath; outputFilepathView.rfind('/') != std::string_view::npos) {
+			filesystem.createDirectory(std::string{outputFilepathView.substr(0, outputFilepathView.rfind('/'))}.c_str());
+		}
+		donut::graphics::Model::compile(filesystem, inputFilepath, outputFilepath, options);
+		for (std::size_t i = 0; i < optimizationStatistics.size(); ++i) {
+			fmt::print("{}: object {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}\n", inputFilepath, i, optimizationStatistics[i].before.averageCacheMissRatio,
+				optimizationStatistics[i].after.averageCacheMissRatio, optimizationStatistics[i].before.averageTransformToVertexRatio,
+				optimizationStatistics[i].after.averageTransformToVertexRatio);
+		}
+	} catch (const std::exception& e) {
+		fmt::print(stderr, "{}\n", e.what());
+		return 1;
+	}
+	return 0;
+}